@@ -0,0 +1,190 @@
+/**
+ * @file event_queue_benchmark.cpp
+ * @brief Throughput of ThreadSafeQueue vs a mutex + condition variable queue
+ *
+ * WHAT IT MEASURES:
+ * N producers and N consumers (N = 1, 2, 4, 8, 16, 32) move a fixed
+ * number of items through one queue. Reports millions of items/second.
+ * The baseline is the previous std::queue + mutex + condition_variable
+ * implementation, kept here only for comparison. The last column moves
+ * the same items with push_bulk/pop_bulk in batches of 64.
+ *
+ * USAGE:
+ * ./event_queue_benchmark [items]
+ */
+
+#include "dfs/events/event_queue.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <thread>
+#include <vector>
+
+using namespace dfs::events;
+
+namespace {
+
+/**
+ * @brief Previous ThreadSafeQueue design (unbounded, one lock)
+ */
+template<typename T>
+class MutexQueue {
+public:
+    void push(T item) {
+        {
+            std::lock_guard lock(mutex_);
+            queue_.push(std::move(item));
+        }
+        cv_.notify_one();
+    }
+
+    std::optional<T> pop() {
+        std::unique_lock lock(mutex_);
+        cv_.wait(lock, [this]() { return !queue_.empty() || shutdown_; });
+        if (queue_.empty()) {
+            return std::nullopt;
+        }
+        T item = std::move(queue_.front());
+        queue_.pop();
+        return item;
+    }
+
+    void shutdown() {
+        {
+            std::lock_guard lock(mutex_);
+            shutdown_ = true;
+        }
+        cv_.notify_all();
+    }
+
+private:
+    std::queue<T> queue_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    bool shutdown_ = false;
+};
+
+template<typename Queue>
+double run(Queue& queue, int threads, std::uint64_t items) {
+    const std::uint64_t per_producer = items / static_cast<std::uint64_t>(threads);
+    std::atomic<std::uint64_t> consumed{0};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < threads; ++c) {
+        consumers.emplace_back([&]() {
+            std::uint64_t local = 0;
+            while (queue.pop()) {
+                ++local;
+            }
+            consumed += local;
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < threads; ++p) {
+        producers.emplace_back([&]() {
+            for (std::uint64_t i = 0; i < per_producer; ++i) {
+                queue.push(i);
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    queue.shutdown();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(consumed.load()) / elapsed / 1e6;
+}
+
+double run_bulk(ThreadSafeQueue<std::uint64_t>& queue, int threads, std::uint64_t items) {
+    constexpr std::size_t kBatch = 64;
+    const std::uint64_t per_producer = items / static_cast<std::uint64_t>(threads);
+    std::atomic<std::uint64_t> consumed{0};
+    std::atomic<int> producers_left{threads};
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < threads; ++c) {
+        consumers.emplace_back([&]() {
+            std::vector<std::uint64_t> batch;
+            std::uint64_t local = 0;
+            for (;;) {
+                batch.clear();
+                std::size_t n = queue.pop_bulk(batch, kBatch, std::chrono::milliseconds(10));
+                local += n;
+                if (n == 0 && producers_left.load() == 0 && queue.empty()) {
+                    break;
+                }
+            }
+            consumed += local;
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < threads; ++p) {
+        producers.emplace_back([&]() {
+            std::vector<std::uint64_t> batch(kBatch);
+            for (std::uint64_t i = 0; i < per_producer; i += kBatch) {
+                std::size_t n = static_cast<std::size_t>(std::min<std::uint64_t>(kBatch, per_producer - i));
+                queue.push_bulk(batch.begin(), batch.begin() + static_cast<std::ptrdiff_t>(n));
+            }
+            producers_left--;
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(consumed.load()) / elapsed / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::uint64_t items = 4'000'000;
+    if (argc > 1) {
+        items = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    std::cout << "Queue throughput, " << items << " items, N producers + N consumers\n\n";
+    std::cout << std::left << std::setw(8) << "N"
+              << std::setw(22) << "mutex queue Mitems/s"
+              << std::setw(22) << "lock-free Mitems/s"
+              << "bulk x64 Mitems/s\n";
+
+    for (int threads : {1, 2, 4, 8, 16, 32}) {
+        MutexQueue<std::uint64_t> mutex_queue;
+        ThreadSafeQueue<std::uint64_t> lock_free_queue(8192);
+
+        double baseline = run(mutex_queue, threads, items);
+        double lock_free = run(lock_free_queue, threads, items);
+        ThreadSafeQueue<std::uint64_t> bulk_queue(8192);
+        double bulk = run_bulk(bulk_queue, threads, items);
+
+        std::cout << std::left << std::setw(8) << threads
+                  << std::setw(22) << std::fixed << std::setprecision(2) << baseline
+                  << std::setw(22) << lock_free
+                  << bulk << "\n";
+    }
+
+    return 0;
+}
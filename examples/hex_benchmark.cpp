@@ -0,0 +1,122 @@
+/**
+ * @file hex_benchmark.cpp
+ * @brief Hex encode/decode throughput: the old helpers vs dfs::hex kernels
+ *
+ * WHAT IT MEASURES:
+ * GB/s of binary data through each path, on one 4 MiB buffer (a few
+ * chunks of a file in the JSON sync API):
+ * - "old helpers": the encoder SyncService used (ostringstream, std::hex
+ *                  per byte) and the demo server's decoder (substr + stoi
+ *                  per byte)
+ * - "scalar", "ssse3", "avx2": dfs::hex with each kernel the CPU supports
+ * Every result is checked against the input.
+ *
+ * USAGE:
+ * ./hex_benchmark [size_mib] [repeats]
+ * Defaults: 4 MiB, 5 repeats (best kept).
+ */
+
+#include "dfs/core/hex.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using dfs::hex::Kernel;
+
+namespace {
+
+std::string stream_encode(const std::vector<std::uint8_t>& data) {
+    std::ostringstream oss;
+    for (auto byte : data) {
+        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
+    }
+    return oss.str();
+}
+
+std::vector<std::uint8_t> stoi_decode(const std::string& hex) {
+    std::vector<std::uint8_t> out;
+    out.reserve(hex.size() / 2);
+    for (std::size_t i = 0; i < hex.size(); i += 2) {
+        out.push_back(static_cast<std::uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+double best_gbps(const std::function<void()>& run, std::size_t bytes, std::size_t repeats) {
+    double best = 0;
+    for (std::size_t r = 0; r < repeats; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        best = std::max(best, static_cast<double>(bytes) / seconds / 1e9);
+    }
+    return best;
+}
+
+void print_row(const char* name, double encode, double decode, double baseline_encode, double baseline_decode) {
+    std::cout << std::left << std::setw(16) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << encode << std::setw(10) << std::setprecision(0) << encode / baseline_encode << "x"
+              << std::setprecision(3) << std::setw(12) << decode << std::setw(10) << std::setprecision(0)
+              << decode / baseline_decode << "x\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t size = (argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4) << 20;
+    std::size_t repeats = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 5;
+    if (repeats == 0) {
+        repeats = 1;
+    }
+
+    std::vector<std::uint8_t> data(size);
+    std::mt19937 rng(42);
+    for (auto& byte : data) {
+        byte = static_cast<std::uint8_t>(rng());
+    }
+    const std::string reference = dfs::hex::encode(data, Kernel::Scalar);
+
+    bool ok = true;
+    std::string text;
+    std::vector<std::uint8_t> bytes;
+
+    std::cout << (size >> 20) << " MiB of data, best of " << repeats << ", GB/s of binary data\n\n";
+    std::cout << std::left << std::setw(16) << "method" << std::right << std::setw(12) << "encode"
+              << std::setw(11) << "speedup" << std::setw(12) << "decode" << std::setw(11) << "speedup" << "\n";
+
+    double base_encode = best_gbps([&] { text = stream_encode(data); }, size, repeats);
+    ok &= text == reference;
+    double base_decode = best_gbps([&] { bytes = stoi_decode(reference); }, size, repeats);
+    ok &= bytes == data;
+    std::cout << std::left << std::setw(16) << "old helpers" << std::right << std::fixed << std::setprecision(3)
+              << std::setw(12) << base_encode << std::setw(11) << "1x" << std::setw(12) << base_decode
+              << std::setw(11) << "1x" << "\n";
+
+    const std::pair<Kernel, const char*> kernels[] = {
+        {Kernel::Scalar, "scalar"}, {Kernel::Ssse3, "ssse3"}, {Kernel::Avx2, "avx2"}};
+    for (auto [kernel, name] : kernels) {
+        if (!dfs::hex::supported(kernel)) {
+            std::cout << std::left << std::setw(16) << name << "not supported by this CPU\n";
+            continue;
+        }
+        double encode = best_gbps([&] {
+            text.clear();
+            dfs::hex::encode_to(text, data, kernel);
+        }, size, repeats);
+        ok &= text == reference;
+        double decode = best_gbps([&] { ok &= dfs::hex::decode_to(reference, bytes, kernel).is_ok(); }, size, repeats);
+        ok &= bytes == data;
+        print_row(name, encode, decode, base_encode, base_decode);
+    }
+
+    std::cout << "\n" << (ok ? "All outputs match" : "OUTPUT MISMATCH") << "\n";
+    return ok ? 0 : 1;
+}
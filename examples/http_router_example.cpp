@@ -41,7 +41,7 @@ void signal_handler(int signal) {
 // Homepage Routes
 // ════════════════════════════════════════════════════════════
 
-HttpResponse serve_homepage(const HttpContext& ctx) {
+HttpResponse serve_homepage(const HttpContext&) {
     HttpResponse response(HttpStatus::OK);
 
     std::string html = R"(
@@ -128,7 +128,7 @@ HttpResponse serve_homepage(const HttpContext& ctx) {
 // API Routes (Preview of Phase 2)
 // ════════════════════════════════════════════════════════════
 
-HttpResponse handle_health(const HttpContext& ctx) {
+HttpResponse handle_health(const HttpContext&) {
     json response_json = {
         {"status", "healthy"},
         {"service", "dfs-server"},
@@ -245,7 +245,7 @@ HttpResponse handle_file_download(const HttpContext& ctx) {
 // Middleware Examples
 // ════════════════════════════════════════════════════════════
 
-bool logging_middleware(const HttpContext& ctx, HttpResponse& response) {
+bool logging_middleware(const HttpContext& ctx, HttpResponse&) {
     // Log every request
     spdlog::info("{} {} from {}",
         HttpMethodUtils::to_string(ctx.request.method),
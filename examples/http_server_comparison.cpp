@@ -6,6 +6,12 @@
  * 1. HttpServerLegacy - Single-threaded (for comparison)
  * 2. HttpServer - Thread pool (Phase 1)
  * 3. HttpServerAsio - Event-driven (Phase 2)
+ * 4. HttpServerEpoll - Event-driven on native epoll, no Boost (Linux)
+ * 5. HttpServerUring - Experimental, I/O through io_uring (Linux 6.0+)
+ *
+ * Comparing syscalls: run the same load against each mode under
+ * `strace -c -f`, or read "enter_calls" from /stats in io_uring mode
+ * (one io_uring_enter covers a whole batch of accepts, recvs and sends).
  *
  * ═══════════════════════════════════════════════════════════
  * QUICK CONFIGURATION - CHANGE THESE TO TEST DIFFERENT SERVERS
@@ -19,6 +25,8 @@
 // #define USE_LEGACY_SERVER        // 🔴 Single-threaded (1 request at a time)
 //#define USE_THREADPOOL_SERVER    // 🔵 Thread pool (DEFAULT - recommended)
  #define USE_ASIO_SERVER          // 🟢 Event-driven (requires Boost.Asio)
+// #define USE_EPOLL_SERVER         // 🟣 Event-driven (native epoll, Linux only)
+// #define USE_URING_SERVER         // 🟠 Event-driven (io_uring, experimental)
 
 // ┌─────────────────────────────────────────────────────────┐
 // │  SERVER CONFIGURATION                                   │
@@ -35,6 +43,12 @@
 #ifdef DFS_HAS_BOOST_ASIO
 #include "dfs/network/http_server_asio.hpp"      // Asio event-driven
 #endif
+#ifdef DFS_HAS_EPOLL
+#include "dfs/network/http_server_epoll.hpp"     // Native epoll event loops
+#endif
+#ifdef DFS_HAS_IO_URING
+#include "dfs/network/http_server_uring.hpp"     // io_uring rings
+#endif
 #include <spdlog/spdlog.h>
 #include <iostream>
 #include <sstream>
@@ -49,6 +63,12 @@ HttpServerLegacy* g_server_legacy = nullptr;
 #ifdef DFS_HAS_BOOST_ASIO
 boost::asio::io_context* g_io_context = nullptr;
 #endif
+#ifdef DFS_HAS_EPOLL
+HttpServerEpoll* g_server_epoll = nullptr;
+#endif
+#ifdef DFS_HAS_IO_URING
+HttpServerUring* g_server_uring = nullptr;
+#endif
 
 void signal_handler(int signal) {
     if (signal == SIGINT) {
@@ -64,6 +84,16 @@ void signal_handler(int signal) {
         if (g_io_context) {
             g_io_context->stop();
         }
+#endif
+#ifdef DFS_HAS_EPOLL
+        if (g_server_epoll) {
+            g_server_epoll->stop();
+        }
+#endif
+#ifdef DFS_HAS_IO_URING
+        if (g_server_uring) {
+            g_server_uring->stop();
+        }
 #endif
     }
 }
@@ -167,9 +197,33 @@ curl -X POST http://localhost:8080/echo -d "Hello, Server!"
         if (g_server_threadpool) {
             json << ",\n  \"threadpool_stats\": {\n";
             json << "    \"active_connections\": " << g_server_threadpool->get_active_connections() << ",\n";
-            json << "    \"total_processed\": " << g_server_threadpool->get_total_processed() << "\n";
+            json << "    \"total_processed\": " << g_server_threadpool->get_total_processed() << ",\n";
+            const auto& admission = g_server_threadpool->admission();
+            json << "    \"overloaded\": " << (admission.is_overloaded() ? "true" : "false") << ",\n";
+            json << "    \"shed_queue_full\": " << admission.shed_queue_full() << ",\n";
+            json << "    \"shed_delay\": " << admission.shed_delay() << ",\n";
+            json << "    \"shed_client_limit\": " << admission.shed_client_limit() << ",\n";
+            json << "    \"priority_admits\": " << admission.priority_admits() << "\n";
+            json << "  }\n";
+        }
+#ifdef DFS_HAS_EPOLL
+        if (g_server_epoll) {
+            json << ",\n  \"epoll_stats\": {\n";
+            json << "    \"active_connections\": " << g_server_epoll->get_active_connections() << ",\n";
+            json << "    \"total_processed\": " << g_server_epoll->get_total_processed() << "\n";
             json << "  }\n";
         }
+#endif
+#ifdef DFS_HAS_IO_URING
+        if (g_server_uring) {
+            json << ",\n  \"uring_stats\": {\n";
+            json << "    \"active_connections\": " << g_server_uring->get_active_connections() << ",\n";
+            json << "    \"total_processed\": " << g_server_uring->get_total_processed() << ",\n";
+            json << "    \"enter_calls\": " << g_server_uring->get_enter_calls() << ",\n";
+            json << "    \"submitted_ops\": " << g_server_uring->get_submitted_ops() << "\n";
+            json << "  }\n";
+        }
+#endif
 
         json << "}\n";
 
@@ -287,6 +341,73 @@ int run_asio_server(uint16_t port) {
 }
 #endif
 
+#ifdef DFS_HAS_EPOLL
+/**
+ * @brief Run HttpServerEpoll (native epoll event loops)
+ */
+int run_epoll_server(uint16_t port, size_t num_loops) {
+    spdlog::info("Starting EPOLL event-driven server...");
+
+    HttpServerEpoll server(num_loops);
+    g_server_epoll = &server;
+
+    server.set_handler(handle_request);
+
+    auto listen_result = server.listen(port);
+    if (listen_result.is_error()) {
+        spdlog::error("Failed to start server: {}", listen_result.error());
+        return 1;
+    }
+
+    spdlog::info("🟣 Epoll server running on http://localhost:{}", port);
+    spdlog::info("Event loops: {} (keep-alive, edge-triggered)", num_loops);
+
+    auto serve_result = server.serve_forever();
+    if (serve_result.is_error()) {
+        spdlog::error("Server error: {}", serve_result.error());
+        return 1;
+    }
+
+    return 0;
+}
+#endif
+
+#ifdef DFS_HAS_IO_URING
+/**
+ * @brief Run HttpServerUring (io_uring rings, experimental)
+ */
+int run_uring_server(uint16_t port, size_t num_loops) {
+    spdlog::info("Starting IO_URING event-driven server...");
+
+    HttpServerUring server(num_loops);
+    g_server_uring = &server;
+
+    server.set_handler(handle_request);
+
+    auto listen_result = server.listen(port);
+    if (listen_result.is_error()) {
+        spdlog::error("Failed to start server: {}", listen_result.error());
+        return 1;
+    }
+
+    spdlog::info("🟠 io_uring server running on http://localhost:{}", port);
+    spdlog::info("Rings: {} (multishot accept/recv, provided buffers)", num_loops);
+
+    auto serve_result = server.serve_forever();
+    if (serve_result.is_error()) {
+        spdlog::error("Server error: {}", serve_result.error());
+        return 1;
+    }
+
+    size_t processed = server.get_total_processed();
+    if (processed > 0) {
+        spdlog::info("io_uring_enter calls per request: {:.3f}",
+                     static_cast<double>(server.get_enter_calls()) / static_cast<double>(processed));
+    }
+    return 0;
+}
+#endif
+
 void print_usage(const char* program_name) {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n\n";
     std::cout << "Options:\n";
@@ -294,6 +415,12 @@ void print_usage(const char* program_name) {
     std::cout << "  --threadpool [N]      Use thread pool server with N threads (default: auto)\n";
 #ifdef DFS_HAS_BOOST_ASIO
     std::cout << "  --asio                Use Boost.Asio event-driven server\n";
+#endif
+#ifdef DFS_HAS_EPOLL
+    std::cout << "  --epoll [N]           Use native epoll server with N event loops\n";
+#endif
+#ifdef DFS_HAS_IO_URING
+    std::cout << "  --uring [N]           Use io_uring server with N rings (experimental)\n";
 #endif
     std::cout << "  --port PORT           Port to listen on (default: 8080)\n";
     std::cout << "  --help                Show this help message\n";
@@ -324,6 +451,10 @@ int main(int argc, char* argv[]) {
     mode = "threadpool";
 #elif defined(USE_ASIO_SERVER)
     mode = "asio";
+#elif defined(USE_EPOLL_SERVER)
+    mode = "epoll";
+#elif defined(USE_URING_SERVER)
+    mode = "uring";
 #else
     // No define set - default to thread pool
     mode = "threadpool";
@@ -355,6 +486,36 @@ int main(int argc, char* argv[]) {
 #else
             spdlog::error("Asio support not compiled in. Build with Boost.Asio.");
             return 1;
+#endif
+        } else if (arg == "--epoll") {
+#ifdef DFS_HAS_EPOLL
+            mode = "epoll";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                try {
+                    num_threads = std::stoul(argv[++i]);
+                } catch (...) {
+                    spdlog::error("Invalid loop count: {}", argv[i]);
+                    return 1;
+                }
+            }
+#else
+            spdlog::error("Epoll server is only available on Linux.");
+            return 1;
+#endif
+        } else if (arg == "--uring") {
+#ifdef DFS_HAS_IO_URING
+            mode = "uring";
+            if (i + 1 < argc && argv[i + 1][0] != '-') {
+                try {
+                    num_threads = std::stoul(argv[++i]);
+                } catch (...) {
+                    spdlog::error("Invalid ring count: {}", argv[i]);
+                    return 1;
+                }
+            }
+#else
+            spdlog::error("io_uring server not compiled in (needs Linux io_uring headers).");
+            return 1;
 #endif
         } else if (arg == "--port") {
             if (i + 1 < argc) {
@@ -382,7 +543,7 @@ int main(int argc, char* argv[]) {
     spdlog::info("Configuration:");
     spdlog::info("  Mode: {}", mode);
     spdlog::info("  Port: {}", port);
-    if (mode == "threadpool") {
+    if (mode == "threadpool" || mode == "epoll" || mode == "uring") {
         spdlog::info("  Worker threads: {}", num_threads);
     }
     spdlog::info("");
@@ -402,6 +563,16 @@ int main(int argc, char* argv[]) {
     else if (mode == "asio") {
         result = run_asio_server(port);
     }
+#endif
+#ifdef DFS_HAS_EPOLL
+    else if (mode == "epoll") {
+        result = run_epoll_server(port, num_threads);
+    }
+#endif
+#ifdef DFS_HAS_IO_URING
+    else if (mode == "uring") {
+        result = run_uring_server(port, num_threads);
+    }
 #endif
     else {
         spdlog::error("Invalid mode: {}", mode);
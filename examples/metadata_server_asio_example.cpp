@@ -140,7 +140,7 @@ HttpResponse handle_get_metadata(const HttpContext& ctx) {
     return response;
 }
 
-HttpResponse handle_list_metadata(const HttpContext& ctx) {
+HttpResponse handle_list_metadata(const HttpContext&) {
     spdlog::info("Listing all metadata");
 
     auto all_metadata = g_metadata_store.list_all();
@@ -241,7 +241,7 @@ HttpResponse handle_delete_metadata(const HttpContext& ctx) {
     return response;
 }
 
-HttpResponse serve_homepage(const HttpContext& ctx) {
+HttpResponse serve_homepage(const HttpContext&) {
     HttpResponse response(HttpStatus::OK);
 
     std::string html = R"(
@@ -351,7 +351,7 @@ int main(int argc, char* argv[]) {
     HttpRouter router;
 
     // Logging middleware
-    router.use([](const HttpContext& ctx, HttpResponse& response) {
+    router.use([](const HttpContext& ctx, HttpResponse&) {
         spdlog::info("{} {} from {}",
             HttpMethodUtils::to_string(ctx.request.method),
             ctx.request.url,
@@ -143,7 +143,7 @@ HttpResponse handle_get_metadata(const HttpContext& ctx) {
     return response;
 }
 
-HttpResponse handle_list_metadata(const HttpContext& ctx) {
+HttpResponse handle_list_metadata(const HttpContext&) {
     auto all_metadata = g_metadata_store.list_all();
 
     json metadata_array = json::array();
@@ -270,7 +270,7 @@ HttpResponse handle_delete_metadata(const HttpContext& ctx) {
     return response;
 }
 
-HttpResponse serve_homepage(const HttpContext& ctx) {
+HttpResponse serve_homepage(const HttpContext&) {
     HttpResponse response(HttpStatus::OK);
 
     std::string html = R"(
@@ -399,7 +399,7 @@ int main(int argc, char* argv[]) {
     HttpRouter router;
 
     // Logging middleware
-    router.use([](const HttpContext& ctx, HttpResponse& response) {
+    router.use([](const HttpContext& ctx, HttpResponse&) {
         spdlog::debug("{} {} from {}",
             HttpMethodUtils::to_string(ctx.request.method),
             ctx.request.url,
@@ -222,7 +222,7 @@ HttpResponse handle_get_metadata(const HttpContext& ctx) {
  *   {"file_path": "/test2.txt", "hash": "def", "size": 200, ...}
  * ]
  */
-HttpResponse handle_list_metadata(const HttpContext& ctx) {
+HttpResponse handle_list_metadata(const HttpContext&) {
     spdlog::info("Listing all metadata");
 
     // Get all from store
@@ -374,7 +374,7 @@ HttpResponse handle_delete_metadata(const HttpContext& ctx) {
  * GET /
  * Homepage with documentation
  */
-HttpResponse serve_homepage(const HttpContext& ctx) {
+HttpResponse serve_homepage(const HttpContext&) {
     HttpResponse response(HttpStatus::OK);
 
     std::string html = R"(
@@ -499,7 +499,7 @@ int main(int argc, char* argv[]) {
     HttpRouter router;
 
     // Logging middleware
-    router.use([](const HttpContext& ctx, HttpResponse& response) {
+    router.use([](const HttpContext& ctx, HttpResponse&) {
         spdlog::info("{} {} from {}",
             HttpMethodUtils::to_string(ctx.request.method),
             ctx.request.url,
@@ -0,0 +1,189 @@
+/**
+ * @file scheduler_benchmark.cpp
+ * @brief WorkStealingPool vs the single mutex + condition variable queue
+ *
+ * WHAT IT MEASURES:
+ * Throughput (tasks/s) of three workloads on both schedulers:
+ * - external: one producer thread submits tiny tasks (HttpServer's accept
+ *   loop pattern)
+ * - fork-join: tasks recursively spawn two children (hashing/chunk I/O
+ *   fan-out pattern)
+ * - 4 KB hash: each task hashes a small buffer (FNV-1a), so per-task work
+ *   is small but real
+ *
+ * "mutex queue" is the design HttpServer used before: one std::queue,
+ * one mutex, notify_one per task.
+ *
+ * USAGE:
+ * ./scheduler_benchmark [threads] [tasks]
+ */
+
+#include "dfs/core/work_stealing_pool.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dfs::WorkStealingPool;
+
+namespace {
+
+// The old HttpServer scheduler, reduced to its essentials
+class MutexQueuePool {
+public:
+    explicit MutexQueuePool(std::size_t threads) {
+        for (std::size_t i = 0; i < threads; ++i) {
+            workers_.emplace_back([this] { run(); });
+        }
+    }
+
+    ~MutexQueuePool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_all();
+        for (auto& w : workers_) {
+            w.join();
+        }
+    }
+
+    template <typename Fn>
+    void submit(Fn&& fn) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace(std::forward<Fn>(fn));
+        }
+        cv_.notify_one();
+    }
+
+    void wait_idle() {
+        std::size_t pending = pending_.load();
+        while (pending != 0) {
+            pending_.wait(pending);
+            pending = pending_.load();
+        }
+    }
+
+private:
+    void run() {
+        while (true) {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                cv_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) {
+                    return;
+                }
+                task = std::move(tasks_.front());
+                tasks_.pop();
+            }
+            task();
+            if (pending_.fetch_sub(1) == 1) {
+                pending_.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::queue<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::atomic<std::size_t> pending_{0};
+    bool stopping_ = false;
+};
+
+std::atomic<std::uint64_t> g_sink{0};
+
+void hash_block() {
+    thread_local std::vector<std::uint8_t> block(4096, 0x5a);
+    std::uint64_t h = 14695981039346656037ULL;
+    for (std::uint8_t b : block) {
+        h = (h ^ b) * 1099511628211ULL;
+    }
+    g_sink.fetch_add(h & 1, std::memory_order_relaxed);
+}
+
+template <typename Pool>
+void fork(Pool& pool, int depth) {
+    if (depth == 0) {
+        g_sink.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pool.submit([&pool, depth] { fork(pool, depth - 1); });
+    pool.submit([&pool, depth] { fork(pool, depth - 1); });
+}
+
+template <typename Fn>
+double tasks_per_second(std::size_t tasks, Fn&& run) {
+    auto start = std::chrono::steady_clock::now();
+    run();
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return static_cast<double>(tasks) / seconds;
+}
+
+template <typename Pool>
+void run_suite(const char* label, std::size_t threads, std::size_t tasks, int depth) {
+    Pool pool(threads);
+
+    double external = tasks_per_second(tasks, [&] {
+        for (std::size_t i = 0; i < tasks; ++i) {
+            pool.submit([] { g_sink.fetch_add(1, std::memory_order_relaxed); });
+        }
+        pool.wait_idle();
+    });
+
+    std::size_t tree_tasks = (std::size_t{2} << depth) - 1;
+    double fork_join = tasks_per_second(tree_tasks, [&] {
+        pool.submit([&pool, depth] { fork(pool, depth); });
+        pool.wait_idle();
+    });
+
+    std::size_t hash_tasks = tasks / 4;
+    double hashing = tasks_per_second(hash_tasks, [&] {
+        for (std::size_t i = 0; i < hash_tasks; ++i) {
+            pool.submit(hash_block);
+        }
+        pool.wait_idle();
+    });
+
+    std::cout << std::left << std::setw(16) << label << std::right << std::fixed
+              << std::setprecision(0)
+              << std::setw(16) << external
+              << std::setw(16) << fork_join
+              << std::setw(16) << hashing << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t threads = std::max(2u, std::thread::hardware_concurrency());
+    std::size_t tasks = 1'000'000;
+    if (argc > 1) {
+        threads = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        tasks = std::strtoull(argv[2], nullptr, 10);
+    }
+    int depth = 18;   // 2^19 - 1 tasks
+
+    std::cout << "Scheduler throughput, " << threads << " workers, tasks/s\n\n";
+    std::cout << std::left << std::setw(16) << "scheduler" << std::right
+              << std::setw(16) << "external" << std::setw(16) << "fork-join"
+              << std::setw(16) << "4 KB hash" << "\n";
+
+    run_suite<MutexQueuePool>("mutex queue", threads, tasks, depth);
+    run_suite<WorkStealingPool>("work stealing", threads, tasks, depth);
+    return 0;
+}
@@ -0,0 +1,83 @@
+// Syncs a directory with sync_demo_server and prints where the time went.
+//
+//   sync_demo_client --root ./my_files --port 8080 --window 16 --parallel 8
+//
+// --watch N repeats the sync every N seconds; the first run uploads,
+// later runs only move what changed. --rpc talks the binary RPC
+// protocol instead of HTTP (needs sync_demo_server --epoll).
+
+#include "dfs/client/sync_client.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace {
+
+double ms(std::chrono::microseconds time) {
+    return static_cast<double>(time.count()) / 1000.0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    spdlog::set_level(spdlog::level::warn);   // Socket connects log at info
+
+    dfs::client::SyncClientConfig config;
+    fs::path root = fs::current_path() / "sync_client_data";
+    int watch_seconds = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--host" && i + 1 < argc) {
+            config.host = argv[++i];
+        } else if ((arg == "-p" || arg == "--port") && i + 1 < argc) {
+            config.port = static_cast<uint16_t>(std::stoi(argv[++i]));
+        } else if ((arg == "-r" || arg == "--root") && i + 1 < argc) {
+            root = fs::path(argv[++i]);
+        } else if (arg == "--id" && i + 1 < argc) {
+            config.client_id = argv[++i];
+        } else if (arg == "--window" && i + 1 < argc) {
+            config.upload_window = std::stoul(argv[++i]);
+        } else if (arg == "--parallel" && i + 1 < argc) {
+            config.download_parallelism = std::stoul(argv[++i]);
+        } else if (arg == "--chunk-kb" && i + 1 < argc) {
+            config.chunk_size = std::stoul(argv[++i]) * 1024;
+        } else if (arg == "--watch" && i + 1 < argc) {
+            watch_seconds = std::stoi(argv[++i]);
+        } else if (arg == "--rpc") {
+            config.transport = dfs::client::SyncTransport::Rpc;
+        } else if (arg == "-v" || arg == "--verbose") {
+            spdlog::set_level(spdlog::level::debug);
+        }
+    }
+
+    fs::create_directories(root);
+    dfs::client::SyncClient client(root, config);
+
+    while (true) {
+        auto result = client.sync();
+        if (result.is_error()) {
+            spdlog::error("Sync failed: {}", result.error());
+            return 1;
+        }
+        const auto& report = result.value();
+        spdlog::warn("client {}: scan {:.1f} ms | up {} files, {} chunks, {:.1f} MiB/s in {:.1f} ms | "
+                     "down {} files, {:.1f} MiB/s in {:.1f} ms | {} requests, {} retries, {} connects | "
+                     "total {:.1f} ms",
+                     client.client_id(), ms(report.scan_time), report.files_uploaded, report.chunks_uploaded,
+                     report.upload_mib_per_s(), ms(report.upload_time), report.files_downloaded,
+                     report.download_mib_per_s(), ms(report.download_time), report.requests, report.retries,
+                     report.connections_opened, ms(report.total_time));
+
+        if (watch_seconds <= 0) {
+            return 0;
+        }
+        std::this_thread::sleep_for(std::chrono::seconds(watch_seconds));
+    }
+}
@@ -1,19 +1,35 @@
+#include "dfs/core/hex.hpp"
+#include "dfs/core/trace.hpp"
+#include "dfs/core/work_stealing_pool.hpp"
 #include "dfs/events/components.hpp"
 #include "dfs/events/event_bus.hpp"
 #include "dfs/events/events.hpp"
+#include "dfs/events/prometheus.hpp"
 #include "dfs/metadata/store.hpp"
+#include "dfs/network/change_feed.hpp"
+#include "dfs/network/compression.hpp"
 #include "dfs/network/http_router.hpp"
 #include "dfs/network/http_server.hpp"
+#include "dfs/network/http_server_epoll.hpp"
+#include "dfs/sync/json_reader.hpp"
+#include "dfs/sync/json_writer.hpp"
+#include "dfs/sync/rpc_service.hpp"
 #include "dfs/sync/service.hpp"
+#include "dfs/sync/snapshot_cache.hpp"
+#include "dfs/sync/transfer.hpp"
 
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <charconv>
+#include <chrono>
 #include <filesystem>
-#include <iomanip>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <optional>
-#include <sstream>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -36,84 +52,113 @@ HttpResponse make_json_response(HttpStatus status, const json& body) {
     return response;
 }
 
-HttpResponse make_error(HttpStatus status, const std::string& message) {
-    return make_json_response(status, json{{"error", message}});
-}
-
-json metadata_to_json(const dfs::metadata::FileMetadata& metadata) {
-    json j;
-    j["file_path"] = metadata.file_path;
-    j["hash"] = metadata.hash;
-    j["size"] = metadata.size;
-    j["modified_time"] = metadata.modified_time;
-    j["created_time"] = metadata.created_time;
-    j["sync_state"] = static_cast<int>(metadata.sync_state);
-    return j;
+// Body already serialized (JsonWriter output)
+HttpResponse make_json_response(HttpStatus status, std::string body) {
+    HttpResponse response(status);
+    response.set_header("Content-Type", "application/json");
+    response.set_body(std::move(body));
+    return response;
 }
 
-std::vector<dfs::metadata::FileMetadata> metadata_list_from_json(const json& arr) {
-    std::vector<dfs::metadata::FileMetadata> items;
-    if (!arr.is_array()) {
-        return items;
-    }
-    for (const auto& entry : arr) {
-        dfs::metadata::FileMetadata metadata;
-        metadata.file_path = entry.value("file_path", "");
-        metadata.hash = entry.value("hash", "");
-        metadata.size = entry.value("size", 0);
-        metadata.modified_time = entry.value("modified_time", static_cast<std::time_t>(0));
-        metadata.created_time = entry.value("created_time", static_cast<std::time_t>(0));
-        metadata.sync_state = static_cast<dfs::metadata::SyncState>(entry.value("sync_state", 0));
-        items.push_back(metadata);
-    }
-    return items;
+HttpResponse make_error(HttpStatus status, const std::string& message) {
+    return make_json_response(status, json{{"error", message}});
 }
 
-json session_info_to_json(const dfs::sync::SyncSessionInfo& info) {
-    json j;
-    j["session_id"] = info.session_id;
-    j["client_id"] = info.client_id;
-    j["files_pending"] = info.files_pending;
-    j["bytes_pending"] = info.bytes_pending;
-    j["state"] = static_cast<int>(info.state);
-    j["last_error"] = info.last_error;
-    return j;
+// Bytes of the cached snapshot sent per chunk of a streamed /api/sync/start
+constexpr std::size_t kSnapshotSlice = 64 * 1024;
+
+// Bytes of a file read, hex-encoded and sent per chunk of /api/file/download
+constexpr std::size_t kDownloadSlice = 64 * 1024;
+
+// {"data": "<hex>", "hash": "..."} as a chunked stream, read from disk one
+// slice at a time. The hash is computed along the way, so it follows the
+// data; a file that changes mid-send fails the client's hash check.
+HttpResponse make_download_stream(std::ifstream input) {
+    struct State {
+        std::ifstream input;
+        dfs::sync::FileTransferService::ContentHasher hasher;
+        std::vector<std::uint8_t> buffer = std::vector<std::uint8_t>(kDownloadSlice);
+        bool head_sent = false;
+    };
+    auto state = std::make_shared<State>();
+    state->input = std::move(input);
+
+    HttpResponse response(HttpStatus::OK);
+    response.set_header("Content-Type", "application/json");
+    response.set_body_stream([state](std::string& chunk) {
+        if (!state->head_sent) {
+            chunk += "{\"data\":\"";
+            state->head_sent = true;
+        }
+        state->input.read(reinterpret_cast<char*>(state->buffer.data()),
+                          static_cast<std::streamsize>(state->buffer.size()));
+        const auto count = static_cast<std::size_t>(state->input.gcount());
+        state->hasher.update(state->buffer.data(), count);
+        dfs::hex::encode_to(chunk, std::span<const std::uint8_t>(state->buffer.data(), count));
+        if (count == state->buffer.size() && state->input) {
+            return true;
+        }
+        chunk += "\",\"hash\":\"" + state->hasher.hex() + "\"}";
+        return false;
+    });
+    return response;
 }
 
-std::vector<std::uint8_t> hex_to_bytes(const std::string& hex) {
-    std::vector<std::uint8_t> out;
-    if (hex.size() % 2 != 0) {
-        return out;
-    }
-    out.reserve(hex.size() / 2);
-    for (std::size_t i = 0; i < hex.size(); i += 2) {
-        auto chunk = hex.substr(i, 2);
-        try {
-            std::uint8_t value = static_cast<std::uint8_t>(std::stoi(chunk, nullptr, 16));
-            out.push_back(value);
-        } catch (...) {
-            out.clear();
-            return out;
+// {"session": ..., "server_snapshot": [...]} as a chunked stream. The
+// listing is the cached serialization, sent slice by slice; the stream
+// holds a reference to it, so a concurrent write cannot free it mid-send.
+HttpResponse make_snapshot_stream(const dfs::sync::SyncSessionInfo& session,
+                                  std::shared_ptr<const dfs::sync::SnapshotCache::Snapshot> snapshot) {
+    struct State {
+        std::string head;
+        std::shared_ptr<const dfs::sync::SnapshotCache::Snapshot> snapshot;
+        std::size_t next = 0;
+        bool head_sent = false;
+    };
+    auto state = std::make_shared<State>();
+    state->head = "{\"session\":" + dfs::sync::to_json(session) + ",\"server_snapshot\":";
+    state->snapshot = std::move(snapshot);
+
+    HttpResponse response(HttpStatus::OK);
+    response.set_header("Content-Type", "application/json");
+    response.set_header("ETag", state->snapshot->etag);
+    response.set_body_stream([state](std::string& chunk) {
+        if (!state->head_sent) {
+            chunk += state->head;
+            state->head_sent = true;
         }
-    }
-    return out;
+        const std::string& body = state->snapshot->body;
+        std::size_t length = std::min(kSnapshotSlice, body.size() - state->next);
+        chunk.append(body, state->next, length);
+        state->next += length;
+        if (state->next == body.size()) {
+            chunk += '}';
+            return false;
+        }
+        return true;
+    });
+    return response;
 }
 
-std::string fnv1a_hex(const std::vector<std::uint8_t>& data) {
-    const std::uint64_t offset = 0xcbf29ce484222325ULL;
-    const std::uint64_t prime  = 0x100000001b3ULL;
-    std::uint64_t hash = offset;
-    for (auto byte : data) {
-        hash ^= static_cast<std::uint64_t>(byte);
-        hash *= prime;
-    }
-    std::ostringstream oss;
-    oss << std::hex << std::setw(sizeof(hash) * 2) << std::setfill('0') << hash;
-    return oss.str();
+// The same document as one sized body, for clients that accept a content
+// coding: the compression filter only encodes sized bodies. Costs a copy
+// of the listing, which compression needs in one piece anyway.
+HttpResponse make_snapshot_body(const dfs::sync::SyncSessionInfo& session,
+                                const dfs::sync::SnapshotCache::Snapshot& snapshot) {
+    std::string body = "{\"session\":" + dfs::sync::to_json(session) + ",\"server_snapshot\":";
+    body.reserve(body.size() + snapshot.body.size() + 1);
+    body += snapshot.body;
+    body += '}';
+    auto response = make_json_response(HttpStatus::OK, std::move(body));
+    response.set_header("ETag", snapshot.etag);
+    return response;
 }
 
-std::string fnv1a_hex(const std::string& text) {
-    return fnv1a_hex(std::vector<std::uint8_t>(text.begin(), text.end()));
+// One-line change records for /api/changes and /api/events. Clients
+// fetch the file itself (or a diff) only for paths they care about.
+std::string change_record(std::string_view op, const std::string& path, const std::string& hash,
+                          std::size_t size) {
+    return json{{"op", op}, {"path", path}, {"hash", hash}, {"size", size}}.dump();
 }
 
 } // namespace
@@ -126,6 +171,7 @@ int main(int argc, char* argv[]) {
     fs::path data_root = fs::current_path() / "sync_data";
     fs::path staging_root = data_root / "staging";
     fs::path files_root = data_root / "files";
+    bool use_epoll = false;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
@@ -133,13 +179,22 @@ int main(int argc, char* argv[]) {
             port = static_cast<uint16_t>(std::stoi(argv[++i]));
         } else if ((arg == "-d" || arg == "--data") && i + 1 < argc) {
             files_root = fs::path(argv[++i]);
+        } else if (arg == "--trace") {
+            dfs::trace::Tracer::instance().enable();
+        } else if (arg == "--epoll") {
+            // Event loops instead of a thread per connection; change
+            // subscribers then park without holding a worker
+            use_epoll = true;
         }
     }
 
     fs::create_directories(files_root);
     fs::create_directories(staging_root);
 
-    dfs::events::EventBus event_bus;
+    // Handlers (spdlog, metrics) run on a dispatcher thread instead of inside
+    // SyncService while its mutex is held. One thread keeps global event order.
+    dfs::events::EventBus event_bus(dfs::events::AsyncDispatchOptions{
+        1, 4096, dfs::events::BackpressurePolicy::Block});
     dfs::metadata::MetadataStore metadata_store;
 
     dfs::events::LoggerComponent logger(event_bus);
@@ -148,12 +203,96 @@ int main(int argc, char* argv[]) {
 
     dfs::sync::SyncService service(files_root, staging_root, event_bus, metadata_store);
 
+    // Binary RPC workers; declared before the servers so they outlive them
+    std::unique_ptr<dfs::WorkStealingPool> rpc_pool;
+    std::unique_ptr<dfs::sync::SyncRpcService> rpc_service;
+
+    std::unique_ptr<HttpServer> pool_server;
+    std::unique_ptr<dfs::network::HttpServerEpoll> epoll_server;
+    if (use_epoll) {
+        epoll_server = std::make_unique<dfs::network::HttpServerEpoll>(4);
+        // Sync clients with --rpc share the port: framed binary requests,
+        // chunks as raw bytes, replies matched by id
+        rpc_pool = std::make_unique<dfs::WorkStealingPool>(4);
+        rpc_service = std::make_unique<dfs::sync::SyncRpcService>(service, *rpc_pool);
+        epoll_server->set_rpc_handler(rpc_service->handler());
+    } else {
+        pool_server = std::make_unique<HttpServer>(4);
+    }
+
+    // Registered once; each scrape only formats the current values
+    dfs::events::PrometheusExporter exporter;
+    dfs::events::add_metrics_component(exporter, metrics);
+    exporter.add_gauge("dfs_http_active_connections", "Connections being handled", [&] {
+        return static_cast<double>(use_epoll ? epoll_server->get_active_connections()
+                                             : pool_server->get_active_connections());
+    });
+    if (!use_epoll) {
+        exporter.add_gauge("dfs_http_queue_depth", "Accepted connections waiting for a worker",
+                           [&pool_server] { return static_cast<double>(pool_server->get_queue_depth()); });
+    }
+    exporter.add_gauge("dfs_store_files", "Files tracked by the metadata store",
+                       [&metadata_store] { return static_cast<double>(metadata_store.size()); });
+    exporter.add_gauge("dfs_sync_sessions_active", "Sync sessions not yet complete or failed",
+                       [&service] { return static_cast<double>(service.active_sessions()); });
+
+    // JSON listing of the store, written without a DOM and rebuilt on the
+    // first read after a write, not once per client
+    dfs::sync::SnapshotCache snapshots(metadata_store, dfs::sync::write_metadata_array);
+    exporter.add_counter("dfs_snapshot_cache_hits_total", "Snapshot requests served from the cache",
+                         [&snapshots] { return static_cast<double>(snapshots.hits()); });
+
+    // Change records for subscribers, published from the bus dispatcher
+    auto feed = std::make_shared<dfs::network::ChangeFeed>();
+    event_bus.subscribe<dfs::events::FileAddedEvent>([feed](const dfs::events::FileAddedEvent& e) {
+        feed->publish(change_record("added", e.metadata.file_path, e.metadata.hash, e.metadata.size));
+    });
+    event_bus.subscribe<dfs::events::FileModifiedEvent>([feed](const dfs::events::FileModifiedEvent& e) {
+        feed->publish(change_record("modified", e.file_path, e.new_hash, e.new_size));
+    });
+    event_bus.subscribe<dfs::events::FileDeletedEvent>([feed](const dfs::events::FileDeletedEvent& e) {
+        feed->publish(change_record("deleted", e.file_path, "", 0));
+    });
+    exporter.add_gauge("dfs_change_subscribers", "Long-poll and event-stream requests parked",
+                       [feed] { return static_cast<double>(feed->subscribers()); });
+
+    // Snapshots and diffs are JSON that compresses 10-20x. GET /api/snapshot
+    // carries the snapshot ETag, so each state is compressed only once;
+    // POST /api/sync/start embeds a per-session head and is compressed
+    // per request.
+    dfs::network::ResponseCompressor compressor;
+    exporter.add_counter("dfs_http_compressed_responses_total", "Responses sent compressed",
+                         [&compressor] { return static_cast<double>(compressor.compressed() +
+                                                                    compressor.cache_hits()); });
+
     HttpRouter router;
     router.use([](const HttpContext& ctx, HttpResponse&) {
         spdlog::info("{} {}", HttpMethodUtils::to_string(ctx.request.method), ctx.request.url);
         return true;
     });
 
+    router.use_after(compressor.filter());
+
+    router.get("/metrics", [&exporter](const HttpContext&) {
+        thread_local std::string page;   // Reused across scrapes on this worker
+        exporter.render(page);
+        HttpResponse response(HttpStatus::OK);
+        response.body.assign(page.begin(), page.end());
+        response.set_header("Content-Type", dfs::events::PrometheusExporter::kContentType);
+        response.set_header("Content-Length", std::to_string(response.body.size()));
+        return response;
+    });
+
+    // Spans recorded so far (start with --trace), as Chrome trace JSON
+    router.get("/debug/trace", [](const HttpContext&) {
+        std::string trace_json;
+        dfs::trace::Tracer::instance().write_chrome_trace(trace_json);
+        HttpResponse response(HttpStatus::OK);
+        response.set_body(trace_json);
+        response.set_header("Content-Type", "application/json");
+        return response;
+    });
+
     router.post("/api/register", [&](const HttpContext& ctx) {
         auto payload = json::parse(ctx.request.body_as_string(), nullptr, false);
         if (payload.is_discarded()) {
@@ -177,35 +316,48 @@ int main(int argc, char* argv[]) {
         if (result.is_error()) {
             return make_error(HttpStatus::BAD_REQUEST, result.error());
         }
-        auto snapshot = metadata_store.list_all();
-        json response;
-        response["session"] = session_info_to_json(result.value());
-        response["server_snapshot"] = json::array();
-        for (const auto& item : snapshot) {
-            response["server_snapshot"].push_back(metadata_to_json(item));
+        // A 304 would drop the new session, so an unchanged snapshot is
+        // reported in the body instead of being sent again
+        // Cursor read before the snapshot: a change in between is sent
+        // again rather than missed
+        const std::string cursor = std::to_string(feed->last_sequence());
+        auto snapshot = snapshots.current();
+        if (dfs::network::etag_matches(ctx.request.headers.get("If-None-Match"), snapshot->etag)) {
+            std::string body;
+            dfs::sync::JsonWriter writer(body);
+            writer.begin_object().key("session");
+            dfs::sync::write_json(writer, result.value());
+            writer.field("server_snapshot_unchanged", true).end_object();
+            auto response = make_json_response(HttpStatus::OK, std::move(body));
+            response.set_header("ETag", snapshot->etag);
+            response.set_header("X-Change-Cursor", cursor);
+            return response;
         }
-        return make_json_response(HttpStatus::OK, response);
+        const bool encoded = dfs::network::negotiate_encoding(ctx.request.headers.get("Accept-Encoding")) !=
+                             dfs::network::ContentEncoding::IDENTITY;
+        auto response = encoded ? make_snapshot_body(result.value(), *snapshot)
+                                : make_snapshot_stream(result.value(), std::move(snapshot));
+        response.set_header("X-Change-Cursor", cursor);
+        return response;
     });
 
     router.post("/api/sync/diff", [&](const HttpContext& ctx) {
-        auto payload = json::parse(ctx.request.body_as_string(), nullptr, false);
-        if (payload.is_discarded()) {
-            return make_error(HttpStatus::BAD_REQUEST, "Invalid JSON");
+        // Snapshots from large workspaces run to megabytes: decoded into
+        // FileMetadata directly, without a DOM
+        const auto& body = ctx.request.body;
+        auto request = dfs::sync::parse_diff_request(
+            std::string_view(reinterpret_cast<const char*>(body.data()), body.size()));
+        if (request.is_error()) {
+            return make_error(HttpStatus::BAD_REQUEST, request.error());
         }
-        std::string session_id = payload.value("session_id", "");
-        if (session_id.empty()) {
+        if (request.value().session_id.empty()) {
             return make_error(HttpStatus::BAD_REQUEST, "session_id required");
         }
-        auto snapshot = metadata_list_from_json(payload.value("snapshot", json::array()));
-        auto diff = service.compute_diff(session_id, snapshot);
+        auto diff = service.compute_diff(request.value().session_id, request.value().snapshot);
         if (diff.is_error()) {
             return make_error(HttpStatus::BAD_REQUEST, diff.error());
         }
-        json response;
-        response["files_to_upload"] = diff.value().files_to_upload;
-        response["files_to_download"] = diff.value().files_to_download;
-        response["files_to_delete_remote"] = diff.value().files_to_delete_remote;
-        return make_json_response(HttpStatus::OK, response);
+        return make_json_response(HttpStatus::OK, dfs::sync::to_json(diff.value()));
     });
 
     router.post("/api/file/upload_chunk", [&](const HttpContext& ctx) {
@@ -219,11 +371,13 @@ int main(int argc, char* argv[]) {
         chunk.chunk_index = payload.value("chunk_index", 0);
         chunk.total_chunks = payload.value("total_chunks", 0);
         chunk.chunk_size = payload.value("chunk_size", 0);
-        auto data_hex = payload.value("data", std::string{});
-        chunk.data = hex_to_bytes(data_hex);
         chunk.chunk_hash = payload.value("chunk_hash", std::string{});
-        if (chunk.data.empty() && !data_hex.empty()) {
-            return make_error(HttpStatus::BAD_REQUEST, "Invalid chunk data");
+        auto data = payload.find("data");
+        if (data != payload.end() && data->is_string()) {
+            if (auto decoded = dfs::hex::decode_to(data->get_ref<const std::string&>(), chunk.data);
+                decoded.is_error()) {
+                return make_error(HttpStatus::BAD_REQUEST, "Invalid chunk data: " + decoded.error());
+            }
         }
         auto result = service.ingest_chunk(chunk);
         if (result.is_error()) {
@@ -247,7 +401,7 @@ int main(int argc, char* argv[]) {
         if (finalize.is_error()) {
             return make_error(HttpStatus::BAD_REQUEST, finalize.error());
         }
-        return make_json_response(HttpStatus::OK, metadata_to_json(finalize.value()));
+        return make_json_response(HttpStatus::OK, dfs::sync::to_json(finalize.value()));
     });
 
     router.post("/api/file/download", [&](const HttpContext& ctx) {
@@ -259,16 +413,68 @@ int main(int argc, char* argv[]) {
         if (file_path.empty()) {
             return make_error(HttpStatus::BAD_REQUEST, "file_path required");
         }
-        auto data_hex = service.read_file_hex(file_path);
-        if (data_hex.is_error()) {
-            return make_error(HttpStatus::NOT_FOUND, data_hex.error());
+        // Streamed from disk: memory per download is one slice, not the file
+        const auto stored = service.stored_path(file_path);
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(stored, ec);
+        std::ifstream input(stored, std::ios::binary);
+        if (ec || !input) {
+            return make_error(HttpStatus::NOT_FOUND, "File not found: " + file_path);
         }
-        auto decoded = hex_to_bytes(data_hex.value());
-        const std::string hash = fnv1a_hex(decoded);
-        dfs::events::FileDownloadCompletedEvent evt{"manual", file_path, decoded.size()};
+        dfs::events::FileDownloadCompletedEvent evt{"manual", file_path, static_cast<std::size_t>(size)};
         event_bus.emit(evt);
 
-        return make_json_response(HttpStatus::OK, json{{"data", data_hex.value()}, {"hash", hash}});
+        return make_download_stream(std::move(input));
+    });
+
+    // Whole-store listing, served from the snapshot cache. The ETag is the
+    // Merkle root; a client that already has this state gets a 304.
+    // X-Change-Cursor is where to start /api/changes or /api/events.
+    router.get("/api/snapshot", [&](const HttpContext& ctx) {
+        const std::string cursor = std::to_string(feed->last_sequence());
+        auto snapshot = snapshots.current();
+        if (dfs::network::etag_matches(ctx.request.headers.get("If-None-Match"), snapshot->etag)) {
+            HttpResponse response(HttpStatus::NOT_MODIFIED);
+            response.set_header("ETag", snapshot->etag);
+            response.set_header("X-Change-Cursor", cursor);
+            return response;
+        }
+        HttpResponse response(HttpStatus::OK);
+        response.set_header("Content-Type", "application/json");
+        response.set_header("ETag", snapshot->etag);
+        response.set_header("X-Change-Cursor", cursor);
+        response.set_body(snapshot->body);
+        return response;
+    });
+
+    // Long-poll: answers as soon as there are changes after the cursor,
+    // or with an empty list after the timeout
+    router.get("/api/changes/:since", [&feed](const HttpContext& ctx) {
+        uint64_t since = 0;
+        const std::string param = ctx.get_param("since");
+        auto [end, ec] = std::from_chars(param.data(), param.data() + param.size(), since);
+        if (ec != std::errc{} || end != param.data() + param.size()) {
+            return make_error(HttpStatus::BAD_REQUEST, "since must be a change cursor");
+        }
+        HttpResponse response(HttpStatus::OK);
+        response.set_header("Content-Type", "application/json");
+        response.set_header("Cache-Control", "no-store");
+        response.set_body_push(feed->long_poll(since));
+        return response;
+    });
+
+    // Server-Sent Events; EventSource resumes from Last-Event-ID on reconnect
+    router.get("/api/events", [&feed](const HttpContext& ctx) {
+        uint64_t since = feed->last_sequence();
+        std::string_view last_id = ctx.request.headers.get("Last-Event-ID");
+        if (!last_id.empty()) {
+            std::from_chars(last_id.data(), last_id.data() + last_id.size(), since);
+        }
+        HttpResponse response(HttpStatus::OK);
+        response.set_header("Content-Type", dfs::network::ChangeFeed::kEventStreamType);
+        response.set_header("Cache-Control", "no-store");
+        response.set_body_push(feed->event_stream(since));
+        return response;
     });
 
     router.get("/api/sync/status", [&](const HttpContext& ctx) {
@@ -280,7 +486,7 @@ int main(int argc, char* argv[]) {
         if (info.is_error()) {
             return make_error(HttpStatus::BAD_REQUEST, info.error());
         }
-        return make_json_response(HttpStatus::OK, session_info_to_json(info.value()));
+        return make_json_response(HttpStatus::OK, dfs::sync::to_json(info.value()));
     });
 
     router.post("/api/sync/status", [&](const HttpContext& ctx) {
@@ -296,25 +502,36 @@ int main(int argc, char* argv[]) {
         if (info.is_error()) {
             return make_error(HttpStatus::BAD_REQUEST, info.error());
         }
-        return make_json_response(HttpStatus::OK, session_info_to_json(info.value()));
-    });
-
-    HttpServer server(4);
-    server.set_handler([&router](const dfs::network::HttpRequest& request) {
-        return router.handle_request(request);
+        return make_json_response(HttpStatus::OK, dfs::sync::to_json(info.value()));
     });
 
-    auto listen_result = server.listen(port);
-    if (listen_result.is_error()) {
-        spdlog::error("Failed to listen on port {}: {}", port, listen_result.error());
-        return 1;
-    }
+    auto run = [&](auto& server) {
+        server.set_handler([&router, &metrics](const dfs::network::HttpRequest& request) {
+            auto started = std::chrono::steady_clock::now();
+            auto response = router.handle_request(request);
+            metrics.record_request_latency(std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - started));
+            return response;
+        });
+
+        auto listen_result = server.listen(port);
+        if (listen_result.is_error()) {
+            spdlog::error("Failed to listen on port {}: {}", port, listen_result.error());
+            return 1;
+        }
 
-    spdlog::info("Sync demo server listening on port {}", port);
-    auto serve_result = server.serve_forever();
-    if (serve_result.is_error()) {
-        spdlog::error("Server error: {}", serve_result.error());
-        return 1;
-    }
-    return 0;
+        spdlog::info("Sync demo server listening on port {}{}", port, use_epoll ? " (epoll)" : "");
+        auto serve_result = server.serve_forever();
+        if (serve_result.is_error()) {
+            spdlog::error("Server error: {}", serve_result.error());
+            return 1;
+        }
+        return 0;
+    };
+    const int exit_code = use_epoll ? run(*epoll_server) : run(*pool_server);
+
+    // Deliver what is still queued while the components and the service the
+    // handlers call into are alive, then stop the dispatcher thread
+    event_bus.shutdown();
+    return exit_code;
 }
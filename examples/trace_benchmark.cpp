@@ -0,0 +1,96 @@
+/**
+ * @file trace_benchmark.cpp
+ * @brief Cost of one trace::Span, tracing disabled vs enabled
+ *
+ * WHAT IT MEASURES:
+ * Nanoseconds per empty scoped span on one thread and on several threads
+ * at once (each writing its own ring). "baseline" is the empty loop.
+ *
+ * USAGE:
+ * ./trace_benchmark [iterations] [trace.json]
+ * If a path is given, the enabled run's spans are dumped there as
+ * Chrome trace JSON (open in ui.perfetto.dev).
+ */
+
+#include "dfs/core/trace.hpp"
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dfs::trace::Span;
+using dfs::trace::Tracer;
+
+namespace {
+
+double measure_ns_per_span(std::size_t iterations, bool with_span) {
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) {
+        if (with_span) {
+            Span span("bench.span", "session-1");
+        }
+        asm volatile("" ::: "memory");
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           static_cast<double>(iterations);
+}
+
+double measure_threads(std::size_t iterations, unsigned threads) {
+    std::vector<double> results(threads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t) {
+        workers.emplace_back([&results, t, iterations] {
+            results[t] = measure_ns_per_span(iterations, true);
+        });
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+    double total = 0;
+    for (double r : results) {
+        total += r;
+    }
+    return total / threads;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    std::size_t iterations = 10'000'000;
+    if (argc > 1) {
+        iterations = std::strtoull(argv[1], nullptr, 10);
+    }
+
+    auto& tracer = Tracer::instance();
+    std::cout << "Span cost, " << iterations << " iterations\n\n";
+    std::cout << std::left << std::setw(26) << "mode" << "ns/span\n";
+
+    double baseline = measure_ns_per_span(iterations, false);
+    std::cout << std::setw(26) << "baseline (no span)" << std::fixed << std::setprecision(2)
+              << baseline << "\n";
+
+    tracer.disable();
+    std::cout << std::setw(26) << "disabled" << measure_ns_per_span(iterations, true) << "\n";
+
+    tracer.enable();
+    std::cout << std::setw(26) << "enabled, 1 thread" << measure_ns_per_span(iterations, true) << "\n";
+
+    unsigned threads = std::max(2u, std::thread::hardware_concurrency());
+    std::cout << std::setw(26) << ("enabled, " + std::to_string(threads) + " threads")
+              << measure_threads(iterations / threads, threads) << "\n";
+    tracer.disable();
+
+    if (argc > 2) {
+        auto result = tracer.dump_chrome_trace(argv[2]);
+        if (result.is_error()) {
+            std::cerr << result.error() << "\n";
+            return 1;
+        }
+        std::cout << "\nWrote " << argv[2] << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "dfs/client/http_connection.hpp"
+#include "dfs/core/result.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace dfs {
+namespace client {
+
+/**
+ * @brief Keep-alive connections to one server, shared by client threads
+ *
+ * A sync is hundreds of small requests; a TCP handshake (and a fresh
+ * server-side connection) for each would cost more than the request.
+ *
+ * Architecture:
+ * - acquire() hands out an idle connection, or opens one. The Lease
+ *   returns it on destruction if the server left it open, so a
+ *   connection answered with "Connection: close" is simply dropped.
+ * - Up to max_idle connections are kept; extra ones are closed when
+ *   their lease ends, so a burst of parallel downloads does not leave a
+ *   pile of idle sockets behind.
+ * - A reused connection may have been closed by the server in the
+ *   meantime (idle timeout). Lease::reused() lets callers retry such a
+ *   failure at once on a fresh connection instead of backing off.
+ *
+ * Thread safety: acquire() and lease destruction may run on any thread.
+ */
+class ConnectionPool {
+public:
+    class Lease {
+    public:
+        Lease(Lease&& other) noexcept
+            : pool_(other.pool_), connection_(std::move(other.connection_)), reused_(other.reused_) {}
+        Lease& operator=(Lease&&) = delete;
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        ~Lease() {
+            if (connection_) {
+                pool_->release(std::move(connection_));
+            }
+        }
+
+        HttpConnection* operator->() const { return connection_.get(); }
+        HttpConnection& operator*() const { return *connection_; }
+
+        // Came from the idle list rather than a new connect()
+        bool reused() const { return reused_; }
+
+        // Close instead of returning it (e.g. after a protocol error)
+        void discard() { connection_.reset(); }
+
+    private:
+        friend class ConnectionPool;
+        Lease(ConnectionPool* pool, std::unique_ptr<HttpConnection> connection, bool reused)
+            : pool_(pool), connection_(std::move(connection)), reused_(reused) {}
+
+        ConnectionPool* pool_;
+        std::unique_ptr<HttpConnection> connection_;
+        bool reused_;
+    };
+
+    ConnectionPool(std::string host, uint16_t port, size_t max_idle,
+                   std::chrono::milliseconds timeout = std::chrono::seconds(30));
+
+    ConnectionPool(const ConnectionPool&) = delete;
+    ConnectionPool& operator=(const ConnectionPool&) = delete;
+
+    Result<Lease> acquire();
+
+    /**
+     * @brief Open a new connection even if idle ones exist
+     */
+    Result<Lease> acquire_fresh();
+
+    // "host:port", for the Host header
+    const std::string& authority() const { return authority_; }
+
+    size_t opened() const { return opened_.load(std::memory_order_relaxed); }
+    size_t reused() const { return reused_.load(std::memory_order_relaxed); }
+
+private:
+    void release(std::unique_ptr<HttpConnection> connection);
+
+    std::string host_;
+    uint16_t port_;
+    std::string authority_;
+    size_t max_idle_;
+    std::chrono::milliseconds timeout_;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<HttpConnection>> idle_;
+
+    std::atomic<size_t> opened_{0};
+    std::atomic<size_t> reused_{0};
+};
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/network/http_headers.hpp"
+#include "dfs/network/socket.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace dfs {
+namespace client {
+
+/**
+ * @brief A response read by HttpConnection
+ */
+struct ClientResponse {
+    int status = 0;
+    network::HttpHeaders headers;
+    std::string body;
+
+    bool ok() const { return status >= 200 && status < 300; }
+};
+
+/**
+ * @brief One keep-alive HTTP/1.1 connection to the sync server
+ *
+ * Sending and receiving are separate calls, so a caller can pipeline:
+ * write several requests with send(), then read the responses in order
+ * with receive(). Requests are built with write_request(); several can be
+ * appended to one buffer and sent with a single write.
+ *
+ * Architecture:
+ * - Blocking socket with send/receive timeouts and TCP_NODELAY (a
+ *   pipelined window of small requests must not wait for Nagle).
+ * - Responses are parsed from one receive buffer; bytes that belong to
+ *   the next pipelined response stay in it.
+ * - Bodies framed by Content-Length or chunked encoding keep the
+ *   connection usable. "Connection: close", or a body that ends at EOF,
+ *   marks it not reusable.
+ *
+ * Thread safety: none; one thread uses a connection at a time (see
+ * ConnectionPool).
+ */
+class HttpConnection {
+public:
+    /**
+     * @brief Connect to host:port (numeric IPv4)
+     * @param timeout Send/receive timeout; a silent server fails the call
+     */
+    static Result<std::unique_ptr<HttpConnection>> open(const std::string& host, uint16_t port,
+                                                       std::chrono::milliseconds timeout);
+
+    HttpConnection(const HttpConnection&) = delete;
+    HttpConnection& operator=(const HttpConnection&) = delete;
+
+    /**
+     * @brief Append one serialized request to out
+     *
+     * @param extra_headers Complete header lines ("Name: value\r\n"), or empty
+     */
+    static void write_request(std::string& out, std::string_view method, std::string_view target,
+                              std::string_view host, std::string_view body,
+                              std::string_view extra_headers = {});
+
+    /**
+     * @brief Write all of wire (one or more requests)
+     */
+    Result<void> send(std::string_view wire);
+
+    /**
+     * @brief Read the next response
+     */
+    Result<ClientResponse> receive();
+
+    /**
+     * @brief False once the server closed or asked to close the connection
+     */
+    bool reusable() const { return reusable_; }
+
+    /**
+     * @brief Responses read so far; 0 means the server never answered on it
+     */
+    uint64_t responses() const { return responses_; }
+
+private:
+    HttpConnection() = default;
+
+    // Read more bytes into buffer_; 0 at EOF
+    Result<size_t> fill();
+
+    // Make sure `count` unread bytes are buffered
+    Result<void> need(size_t count);
+
+    // Unread text up to the next CRLF (consumed, CRLF excluded)
+    Result<std::string_view> read_line();
+
+    network::Socket socket_;
+    std::string buffer_;
+    size_t offset_ = 0;       // First unread byte of buffer_
+    bool reusable_ = true;
+    uint64_t responses_ = 0;
+};
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/network/rpc.hpp"
+#include "dfs/network/socket.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace dfs {
+namespace client {
+
+/**
+ * @brief Outcome of one RPC: the reply payload, or why there is none
+ */
+struct RpcResult {
+    std::vector<uint8_t> payload;
+    std::string error;      // Set when the server failed the request or the connection broke
+    bool busy = false;      // Not run by the server; safe to send again later
+    bool broken = false;    // The connection failed; the server may or may not have run it
+
+    bool ok() const { return error.empty(); }
+    bool retryable() const { return busy || broken; }
+};
+
+/**
+ * @brief One persistent binary RPC connection with multiplexed calls
+ *
+ * The RPC counterpart of HttpConnection (framing in
+ * dfs/network/rpc.hpp). Any number of threads may call() at once; each
+ * call gets a request id and a future, and replies are matched by id in
+ * whatever order the server finishes them.
+ *
+ * Architecture:
+ * - Blocking socket, TCP_NODELAY. Senders write whole frames under a
+ *   mutex, so frames of concurrent calls never interleave.
+ * - A reader thread reads replies and completes their futures. When the
+ *   connection breaks (or a reply is overdue by the timeout), every
+ *   outstanding call fails and the client is no longer usable().
+ *
+ * Thread safety: all methods are thread-safe.
+ */
+class RpcClient {
+public:
+    /**
+     * @brief Connect to host:port (numeric IPv4) and send the preamble
+     * @param timeout How long a call may wait for its reply
+     */
+    static Result<std::unique_ptr<RpcClient>> connect(const std::string& host, uint16_t port,
+                                                      std::chrono::milliseconds timeout);
+
+    ~RpcClient();
+
+    RpcClient(const RpcClient&) = delete;
+    RpcClient& operator=(const RpcClient&) = delete;
+
+    /**
+     * @brief Send one request; the future completes when its reply arrives
+     */
+    std::future<RpcResult> call(uint8_t type, const std::vector<uint8_t>& payload);
+
+    /**
+     * @brief call() and wait
+     */
+    RpcResult request(uint8_t type, const std::vector<uint8_t>& payload) { return call(type, payload).get(); }
+
+    /**
+     * @brief False once the connection broke; open a new client
+     */
+    bool usable() const { return !broken_.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Calls sent and not yet answered
+     */
+    size_t in_flight() const;
+
+private:
+    struct Pending {
+        std::promise<RpcResult> promise;
+        std::chrono::steady_clock::time_point sent;
+    };
+
+    explicit RpcClient(std::chrono::milliseconds timeout) : timeout_(timeout) {}
+
+    void read_replies();
+
+    // Fail every outstanding call and refuse new ones
+    void fail_all(const std::string& error);
+
+    network::Socket socket_;
+    std::chrono::milliseconds timeout_;
+    std::thread reader_;
+
+    std::mutex send_mutex_;
+    mutable std::mutex calls_mutex_;
+    std::unordered_map<uint32_t, Pending> calls_;
+    uint32_t next_id_ = 0;
+    std::string broken_reason_;     // Why calls fail once broken_
+    std::atomic<bool> broken_{false};
+};
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,223 @@
+#pragma once
+
+#include "dfs/client/connection_pool.hpp"
+#include "dfs/client/http_connection.hpp"
+#include "dfs/client/rpc_client.hpp"
+#include "dfs/core/result.hpp"
+#include "dfs/sync/change_detector.hpp"
+#include "dfs/sync/rpc.hpp"
+#include "dfs/sync/transfer.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs {
+namespace client {
+
+/**
+ * @brief When and how often a failed request is tried again
+ *
+ * Transport errors, 429 and 5xx are retried; other statuses are final.
+ */
+struct RetryPolicy {
+    // Attempts per request, the first one included
+    int max_attempts = 4;
+    std::chrono::milliseconds initial_backoff{50};
+    std::chrono::milliseconds max_backoff{std::chrono::seconds(2)};
+    double multiplier = 2.0;
+
+    /**
+     * @brief Delay before attempt number `attempt` (2, 3, ...)
+     *
+     * Exponential, with the upper half jittered so clients shed together
+     * by one overloaded server do not come back together. A server's
+     * Retry-After (in ms, 0 if none) raises the delay, capped at max_backoff.
+     */
+    std::chrono::milliseconds backoff(int attempt, std::chrono::milliseconds retry_after = {}) const;
+
+    static bool retryable(int status) { return status == 429 || status >= 500; }
+};
+
+/**
+ * @brief How SyncClient talks to the server
+ *
+ * Http: the JSON API, on pooled keep-alive connections.
+ * Rpc: binary frames (dfs/sync/rpc.hpp) multiplexed on one connection;
+ * needs HttpServerEpoll with a SyncRpcService.
+ */
+enum class SyncTransport { Http, Rpc };
+
+/**
+ * @brief Tuning for SyncClient
+ */
+struct SyncClientConfig {
+    std::string host = "127.0.0.1";
+    uint16_t port = 8080;
+    SyncTransport transport = SyncTransport::Http;
+
+    // Asked for at registration; the server may assign another
+    std::string client_id;
+
+    size_t chunk_size = sync::FileTransferService::kDefaultChunkSize;
+
+    // Chunk requests sent ahead of their responses on the upload
+    // connection. 1 = stop-and-wait; more hides the round trip.
+    size_t upload_window = 8;
+
+    // Files downloaded at once, each on its own pooled connection (over
+    // RPC: download calls in flight on the one connection)
+    size_t download_parallelism = 4;
+
+    size_t max_idle_connections = 8;
+    std::chrono::milliseconds timeout{std::chrono::seconds(30)};
+    RetryPolicy retry;
+};
+
+/**
+ * @brief What one sync() did, and how fast
+ */
+struct SyncReport {
+    size_t files_uploaded = 0;
+    size_t files_downloaded = 0;
+    uint64_t bytes_uploaded = 0;      // File bytes, not wire bytes
+    uint64_t bytes_downloaded = 0;
+    size_t chunks_uploaded = 0;
+
+    size_t requests = 0;              // Responses received, retries included
+    size_t retries = 0;               // Requests sent again
+    size_t connections_opened = 0;
+
+    std::chrono::microseconds scan_time{0};
+    std::chrono::microseconds upload_time{0};
+    std::chrono::microseconds download_time{0};
+    std::chrono::microseconds total_time{0};
+
+    double upload_mib_per_s() const { return rate(bytes_uploaded, upload_time); }
+    double download_mib_per_s() const { return rate(bytes_downloaded, download_time); }
+
+private:
+    static double rate(uint64_t bytes, std::chrono::microseconds time) {
+        return time.count() > 0 ? static_cast<double>(bytes) / (1024.0 * 1024.0) /
+                                      (static_cast<double>(time.count()) / 1e6)
+                                : 0.0;
+    }
+};
+
+/**
+ * @brief Native client for the sync server's HTTP API
+ *
+ * Runs the whole register / start / diff / upload / download sequence
+ * that each client used to script by hand, with the knobs that decide
+ * end-to-end throughput in one place.
+ *
+ * Architecture:
+ * - Local state comes from a ChangeDetector over the sync root, kept
+ *   across sync() calls. Its file hashes are the server's (see
+ *   FileTransferService::file_hash), so unchanged files diff as equal.
+ * - Uploads: FileTransferService splits each file into chunks, which are
+ *   pipelined on one keep-alive connection with up to upload_window
+ *   requests in flight. A file is completed only once all its chunks
+ *   are acknowledged; its upload_complete then travels in the pipeline
+ *   ahead of the next file's chunks. A server that closes after every
+ *   response (the thread-pool HttpServer) drops the window to 1.
+ * - Downloads: download_parallelism workers fetch files concurrently over
+ *   the ConnectionPool. Each file is checked against the server's hash
+ *   and renamed into place, so a failed sync never leaves half a file.
+ * - Retries: every request follows the RetryPolicy. Chunks are
+ *   idempotent (written at their offset), so a pipelined chunk that
+ *   failed is simply sent again later in the window.
+ * - SyncTransport::Rpc runs the same sequence as binary calls on one
+ *   RpcClient: up to upload_window chunks and download_parallelism
+ *   downloads in flight, answered in any order. Busy replies and broken
+ *   connections are retried like 5xx; error replies are final, except
+ *   a file too large for one reply, which is downloaded over HTTP.
+ *
+ * Thread safety: one sync() at a time per client.
+ *
+ * Usage:
+ * ```cpp
+ * SyncClientConfig config;
+ * config.port = 8080;
+ * config.upload_window = 16;
+ * SyncClient client("/home/me/Sync", config);
+ * auto report = client.sync();
+ * if (report.is_ok()) {
+ *     spdlog::info("up {:.1f} MiB/s", report.value().upload_mib_per_s());
+ * }
+ * ```
+ */
+class SyncClient {
+public:
+    SyncClient(std::filesystem::path root, SyncClientConfig config = {});
+
+    SyncClient(const SyncClient&) = delete;
+    SyncClient& operator=(const SyncClient&) = delete;
+
+    /**
+     * @brief Register with the server (sync() does this on first use)
+     */
+    Result<std::string> register_client();
+
+    /**
+     * @brief Bring the server and the sync root up to date with each other
+     */
+    Result<SyncReport> sync();
+
+    const std::string& client_id() const { return client_id_; }
+    const ConnectionPool& pool() const { return pool_; }
+
+    /**
+     * @brief One JSON request with retries; non-2xx is returned as an error
+     */
+    Result<ClientResponse> call(std::string_view method, std::string_view target, std::string_view body,
+                                std::string_view extra_headers = {});
+
+private:
+    class UploadPipeline;
+    class RpcWindow;
+
+    Result<std::string> start_session();
+    Result<sync::DiffResponse> request_diff(const std::string& session_id,
+                                            const std::vector<metadata::FileMetadata>& snapshot);
+
+    Result<void> upload(const std::string& session_id, const std::vector<std::string>& paths,
+                        const std::vector<metadata::FileMetadata>& snapshot, SyncReport& report);
+    Result<void> download(const std::vector<std::string>& paths, SyncReport& report);
+    Result<uint64_t> download_file(const std::string& path);
+
+    // Rename a downloaded file into place after checking its hash
+    Result<void> store_download(const std::string& path, const std::vector<std::uint8_t>& data,
+                                const std::string& hash);
+
+    // The RPC transport: one call with retries (first_attempt 2 when it
+    // is already a retry), on a connection opened again as needed
+    Result<std::vector<uint8_t>> rpc_call(sync::rpc::Op op, const std::vector<uint8_t>& payload,
+                                          int first_attempt = 1);
+    Result<RpcClient*> rpc_connection();
+    Result<void> download_rpc(const std::vector<std::string>& paths, SyncReport& report);
+
+    std::filesystem::path root_;
+    SyncClientConfig config_;
+    ConnectionPool pool_;
+    std::unique_ptr<RpcClient> rpc_;
+    size_t rpc_opened_ = 0;
+    sync::FileTransferService transfer_;
+    std::optional<sync::ChangeDetector> detector_;   // Created once the client id is known
+
+    std::string client_id_;
+    std::string snapshot_etag_;   // Last snapshot seen, sent as If-None-Match
+
+    std::atomic<size_t> requests_{0};
+    std::atomic<size_t> retries_{0};
+};
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,405 @@
+/**
+ * @file trace.hpp
+ * @brief Low-overhead scoped span tracing with Chrome trace export
+ *
+ * WHY THIS FILE EXISTS:
+ * When a sync is slow, logs say *that* it was slow, not where the time
+ * went: socket reads, parsing, routing, waiting for the SyncService
+ * mutex, hashing or flushing to disk. Spans answer that, and Chrome's
+ * trace viewer (chrome://tracing, ui.perfetto.dev) draws them per thread.
+ *
+ * WHAT IT DOES:
+ * - trace::Span: RAII timer; records {name, start, duration, session}
+ *   when it goes out of scope (or on end())
+ * - Each thread writes into its own fixed-size ring buffer - no locks,
+ *   no allocation, no shared cache lines on the hot path
+ * - Tracer::write_chrome_trace() collects all rings and emits Trace
+ *   Event Format JSON ("ph":"X" complete events)
+ *
+ * COST:
+ * - Disabled (the default): one relaxed atomic load per span
+ * - Enabled: two steady_clock reads plus a 64-byte slot write. The
+ *   clock reads dominate: examples/trace_benchmark.cpp measured ~118 ns
+ *   per span on a VM where one steady_clock read costs ~61 ns. The slot
+ *   write is a few ns, so with a vDSO TSC clock (~20 ns per read) a span
+ *   costs under 50 ns.
+ *
+ * RING SEMANTICS:
+ * Every thread keeps its most recent kRingCapacity spans; older ones are
+ * overwritten. Dumping never stops writers: each slot carries a sequence
+ * number (a seqlock) and slots overwritten mid-read are skipped.
+ *
+ * EXAMPLE:
+ * trace::Tracer::instance().enable();
+ * {
+ *     trace::Span span("sync.hash", session_id);
+ *     hash = compute_file_hash(path);
+ * }
+ * trace::Tracer::instance().dump_chrome_trace("/tmp/dfs-trace.json");
+ *
+ * Span names must be string literals (or otherwise outlive the tracer):
+ * only the pointer is stored.
+ */
+
+#pragma once
+
+#include "dfs/core/result.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs::trace {
+
+/// Spans kept per thread (power of two)
+inline constexpr std::size_t kRingCapacity = 4096;
+
+/// Session tags longer than this are truncated
+inline constexpr std::size_t kSessionTagSize = 32;
+
+/**
+ * @brief One finished span, as returned by Tracer::collect()
+ */
+struct SpanRecord {
+    const char* name = nullptr;
+    std::uint64_t start_ns = 0;        ///< steady_clock nanoseconds
+    std::uint64_t duration_ns = 0;
+    std::uint32_t thread_id = 0;       ///< Tracer-assigned, stable per ring
+    std::string session;
+};
+
+namespace detail {
+
+inline std::atomic<bool> g_enabled{false};
+
+inline std::uint64_t now_ns() noexcept {
+    return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+/**
+ * @brief Single-writer ring of spans for one thread
+ *
+ * Slot fields are relaxed atomics so a concurrent reader is well
+ * defined; on x86 and ARM they compile to plain loads and stores.
+ */
+class ThreadRing {
+public:
+    explicit ThreadRing(std::uint32_t id) : id_(id) {}
+
+    std::uint32_t id() const noexcept { return id_; }
+
+    // Owner thread only
+    void write(const char* name, std::uint64_t start, std::uint64_t duration,
+               std::string_view session) noexcept {
+        std::uint64_t n = head_.load(std::memory_order_relaxed);
+        Slot& slot = slots_[n & (kRingCapacity - 1)];
+
+        slot.seq.store(2 * n + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        slot.name.store(name, std::memory_order_relaxed);
+        slot.start.store(start, std::memory_order_relaxed);
+        slot.duration.store(duration, std::memory_order_relaxed);
+
+        std::array<std::uint64_t, kTagWords> words{};
+        std::memcpy(words.data(), session.data(), std::min(session.size(), kSessionTagSize));
+        for (std::size_t i = 0; i < kTagWords; ++i) {
+            slot.tag[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        slot.seq.store(2 * n + 2, std::memory_order_release);
+        head_.store(n + 1, std::memory_order_release);
+    }
+
+    // Any thread; appends spans that were stable while being read
+    void collect(std::vector<SpanRecord>& out) const {
+        std::uint64_t head = head_.load(std::memory_order_acquire);
+        std::uint64_t first = std::max(floor_.load(std::memory_order_relaxed),
+                                       head > kRingCapacity ? head - kRingCapacity : 0);
+
+        for (std::uint64_t n = first; n < head; ++n) {
+            const Slot& slot = slots_[n & (kRingCapacity - 1)];
+            std::uint64_t before = slot.seq.load(std::memory_order_acquire);
+            if (before != 2 * n + 2) {
+                continue;   // Being rewritten by a newer span
+            }
+
+            SpanRecord record;
+            record.name = slot.name.load(std::memory_order_relaxed);
+            record.start_ns = slot.start.load(std::memory_order_relaxed);
+            record.duration_ns = slot.duration.load(std::memory_order_relaxed);
+            record.thread_id = id_;
+            std::array<std::uint64_t, kTagWords> words;
+            for (std::size_t i = 0; i < kTagWords; ++i) {
+                words[i] = slot.tag[i].load(std::memory_order_relaxed);
+            }
+
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.seq.load(std::memory_order_relaxed) != before) {
+                continue;
+            }
+
+            const char* tag = reinterpret_cast<const char*>(words.data());
+            record.session.assign(tag, strnlen(tag, kSessionTagSize));
+            out.push_back(std::move(record));
+        }
+    }
+
+    // Any thread; hides everything written so far from collect()
+    void clear() noexcept {
+        floor_.store(head_.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> in_use{true};
+
+private:
+    static constexpr std::size_t kTagWords = kSessionTagSize / sizeof(std::uint64_t);
+
+    struct alignas(64) Slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<const char*> name{nullptr};
+        std::atomic<std::uint64_t> start{0};
+        std::atomic<std::uint64_t> duration{0};
+        std::array<std::atomic<std::uint64_t>, kTagWords> tag{};
+    };
+
+    std::uint32_t id_;
+    std::atomic<std::uint64_t> head_{0};
+    std::atomic<std::uint64_t> floor_{0};
+    std::array<Slot, kRingCapacity> slots_{};
+};
+
+} // namespace detail
+
+/**
+ * @brief Process-wide span registry
+ *
+ * THREAD SAFETY:
+ * All methods may be called from any thread. Registering a thread's
+ * ring (its first span) takes a mutex; recording never does. A ring is
+ * handed to a new thread once its owner exits, so the number of rings
+ * tracks the peak thread count, not the total ever started.
+ */
+class Tracer {
+public:
+    static Tracer& instance() {
+        static Tracer tracer;
+        return tracer;
+    }
+
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    void enable() noexcept { detail::g_enabled.store(true, std::memory_order_relaxed); }
+    void disable() noexcept { detail::g_enabled.store(false, std::memory_order_relaxed); }
+
+    static bool enabled() noexcept {
+        return detail::g_enabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Record a finished span on the calling thread's ring
+     */
+    void record(const char* name, std::uint64_t start_ns, std::uint64_t end_ns,
+                std::string_view session = {}) {
+        local_ring().write(name, start_ns, end_ns - start_ns, session);
+    }
+
+    /**
+     * @brief Snapshot every thread's spans, ordered by start time
+     */
+    std::vector<SpanRecord> collect() const {
+        std::vector<SpanRecord> spans;
+        {
+            std::lock_guard lock(mutex_);
+            for (const auto& ring : rings_) {
+                ring->collect(spans);
+            }
+        }
+        std::sort(spans.begin(), spans.end(), [](const SpanRecord& a, const SpanRecord& b) {
+            return a.start_ns < b.start_ns;
+        });
+        return spans;
+    }
+
+    /**
+     * @brief Forget all spans recorded so far
+     */
+    void clear() {
+        std::lock_guard lock(mutex_);
+        for (const auto& ring : rings_) {
+            ring->clear();
+        }
+    }
+
+    /**
+     * @brief Render collected spans as Chrome Trace Event Format JSON
+     *
+     * Timestamps are microseconds relative to the earliest span.
+     */
+    void write_chrome_trace(std::string& out) const {
+        auto spans = collect();
+        std::uint64_t origin = spans.empty() ? 0 : spans.front().start_ns;
+
+        out.clear();
+        out += "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        for (const auto& span : spans) {
+            out += first ? "\n" : ",\n";
+            first = false;
+            out += "{\"name\":\"";
+            append_escaped(out, span.name != nullptr ? span.name : "?");
+            out += "\",\"cat\":\"dfs\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            append_uint(out, span.thread_id);
+            out += ",\"ts\":";
+            append_micros(out, span.start_ns - origin);
+            out += ",\"dur\":";
+            append_micros(out, span.duration_ns);
+            if (!span.session.empty()) {
+                out += ",\"args\":{\"session\":\"";
+                append_escaped(out, span.session);
+                out += "\"}";
+            }
+            out += '}';
+        }
+        out += "\n]}\n";
+    }
+
+    /**
+     * @brief Write the Chrome trace JSON to a file
+     */
+    Result<void> dump_chrome_trace(const std::filesystem::path& path) const {
+        std::string json;
+        write_chrome_trace(json);
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return Err<void>(std::string("Cannot open trace file: ") + path.string());
+        }
+        file.write(json.data(), static_cast<std::streamsize>(json.size()));
+        if (!file) {
+            return Err<void>(std::string("Failed to write trace file: ") + path.string());
+        }
+        return Ok();
+    }
+
+private:
+    Tracer() = default;
+
+    // Returns the ring to the pool when its thread exits
+    struct RingLease {
+        std::shared_ptr<detail::ThreadRing> ring;
+        ~RingLease() {
+            if (ring) {
+                ring->in_use.store(false, std::memory_order_release);
+            }
+        }
+    };
+
+    detail::ThreadRing& local_ring() {
+        thread_local RingLease lease;
+        if (!lease.ring) {
+            lease.ring = acquire_ring();
+        }
+        return *lease.ring;
+    }
+
+    std::shared_ptr<detail::ThreadRing> acquire_ring() {
+        std::lock_guard lock(mutex_);
+        for (const auto& ring : rings_) {
+            bool idle = false;
+            if (ring->in_use.compare_exchange_strong(idle, true, std::memory_order_acquire)) {
+                return ring;
+            }
+        }
+        auto ring = std::make_shared<detail::ThreadRing>(static_cast<std::uint32_t>(rings_.size() + 1));
+        rings_.push_back(ring);
+        return ring;
+    }
+
+    static void append_uint(std::string& out, std::uint64_t value) {
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        out.append(digits, end);
+    }
+
+    // ns -> "us.fff"
+    static void append_micros(std::string& out, std::uint64_t ns) {
+        append_uint(out, ns / 1000);
+        std::uint64_t frac = ns % 1000;
+        out += '.';
+        out += static_cast<char>('0' + frac / 100);
+        out += static_cast<char>('0' + frac / 10 % 10);
+        out += static_cast<char>('0' + frac % 10);
+    }
+
+    static void append_escaped(std::string& out, std::string_view text) {
+        static constexpr char kHex[] = "0123456789abcdef";
+        for (char c : text) {
+            auto u = static_cast<unsigned char>(c);
+            if (c == '"' || c == '\\') {
+                out += '\\';
+                out += c;
+            } else if (u < 0x20) {
+                out += "\\u00";
+                out += kHex[u >> 4];
+                out += kHex[u & 0xF];
+            } else {
+                out += c;
+            }
+        }
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::shared_ptr<detail::ThreadRing>> rings_;
+};
+
+/**
+ * @brief Times a scope and records it on destruction
+ *
+ * session is copied (up to kSessionTagSize bytes) only when the span
+ * ends, so the viewed string must stay alive until then.
+ */
+class Span {
+public:
+    explicit Span(const char* name, std::string_view session = {}) noexcept
+        : name_(Tracer::enabled() ? name : nullptr),
+          session_(session),
+          start_(name_ != nullptr ? detail::now_ns() : 0) {}
+
+    ~Span() {
+        end();
+    }
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    /**
+     * @brief Stop timing now instead of at scope exit
+     */
+    void end() noexcept {
+        if (name_ != nullptr) {
+            Tracer::instance().record(name_, start_, detail::now_ns(), session_);
+            name_ = nullptr;
+        }
+    }
+
+private:
+    const char* name_;
+    std::string_view session_;
+    std::uint64_t start_;
+};
+
+} // namespace dfs::trace
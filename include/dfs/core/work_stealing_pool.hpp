@@ -0,0 +1,492 @@
+/**
+ * @file work_stealing_pool.hpp
+ * @brief Work-stealing thread pool: per-worker deques, random stealing,
+ *        parking on std::atomic::wait
+ *
+ * WHY THIS FILE EXISTS:
+ * HttpServer used one std::queue guarded by a mutex and a condition
+ * variable. Every accept and every worker pop went through that lock,
+ * and every pop could trigger a futex wake. At high connection rates the
+ * lock is the serialization point. Hashing and chunk I/O want a shared
+ * pool too, and those tasks often spawn more tasks.
+ *
+ * WHAT IT DOES:
+ * - Each worker owns a Chase-Lev deque. A task submitted from a worker
+ *   goes to the bottom of its own deque and is popped LIFO, so it stays
+ *   cache-hot and needs no lock
+ * - Tasks submitted from other threads (e.g. the accept loop) go to a
+ *   per-worker inbox, picked round-robin. The lock is per worker, so
+ *   submitters and workers rarely meet on the same mutex
+ * - An idle worker drains its inbox first, then steals FIFO from the top
+ *   of other workers' deques and inboxes, starting at a random victim
+ * - A worker with nothing to do spins briefly and then parks on an
+ *   atomic epoch counter (std::atomic::wait, a futex on Linux).
+ *   Submitters only bump the epoch and notify when someone is parked,
+ *   so a busy pool makes no wake syscalls
+ *
+ * EXAMPLE:
+ * WorkStealingPool pool(4);
+ * pool.submit([] { process(); });
+ * auto hash = pool.async([&] { return compute_hash(path); });
+ * pool.wait_idle();                      // Everything submitted so far is done
+ * std::string h = hash.get();
+ *
+ * THREAD SAFETY:
+ * All methods are thread-safe. Tasks may submit further tasks. Tasks run
+ * in no particular order. A task that throws is logged and dropped;
+ * async() forwards the exception through its future instead.
+ */
+
+#pragma once
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dfs {
+
+namespace detail {
+
+/**
+ * @brief Type-erased, move-only unit of work
+ *
+ * std::function needs copyable callables. Connection tasks own a
+ * unique_ptr<Socket> and async() tasks own a packaged_task, so neither is
+ * copyable.
+ */
+class PoolTask {
+public:
+    virtual ~PoolTask() = default;
+    virtual void run() = 0;
+};
+
+template <typename Fn>
+class PoolTaskImpl final : public PoolTask {
+public:
+    explicit PoolTaskImpl(Fn fn) : fn_(std::move(fn)) {}
+    void run() override { fn_(); }
+
+private:
+    Fn fn_;
+};
+
+/**
+ * @brief Chase-Lev work-stealing deque of task pointers
+ *
+ * The owner pushes and takes at the bottom. Thieves take from the top
+ * with a CAS. Follows Le, Pop, Cohen, Zappa Nardelli, "Correct and
+ * Efficient Work-Stealing for Weak Memory Models" (PPoPP 2013). When the
+ * buffer fills up it doubles. Old buffers are retired, not freed, until
+ * the deque dies, because a thief may still be reading one.
+ */
+class StealDeque {
+public:
+    explicit StealDeque(std::int64_t capacity = 256)
+        : array_(new Array(capacity)) {
+        retired_.emplace_back(array_.load(std::memory_order_relaxed));
+    }
+
+    StealDeque(const StealDeque&) = delete;
+    StealDeque& operator=(const StealDeque&) = delete;
+
+    // Owner only
+    void push(PoolTask* task) {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed);
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        Array* a = array_.load(std::memory_order_relaxed);
+        if (b - t > a->capacity - 1) {
+            a = grow(a, b, t);
+        }
+        a->put(b, task);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only: newest task, or nullptr
+    PoolTask* take() {
+        std::int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* a = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            bottom_.store(b + 1, std::memory_order_relaxed);   // Was empty
+            return nullptr;
+        }
+        PoolTask* task = a->get(b);
+        if (t == b) {
+            // Last element: race thieves for it
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                              std::memory_order_relaxed)) {
+                task = nullptr;
+            }
+            bottom_.store(b + 1, std::memory_order_relaxed);
+        }
+        return task;
+    }
+
+    // Any thread: oldest task, or nullptr if empty or the race was lost
+    PoolTask* steal() {
+        std::int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t b = bottom_.load(std::memory_order_acquire);
+        if (t >= b) {
+            return nullptr;
+        }
+        PoolTask* task = array_.load(std::memory_order_acquire)->get(t);
+        if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return task;
+    }
+
+    bool empty() const {
+        return top_.load(std::memory_order_acquire) >= bottom_.load(std::memory_order_acquire);
+    }
+
+private:
+    struct Array {
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<PoolTask*>[]> slots;
+
+        explicit Array(std::int64_t cap)
+            : capacity(cap), slots(new std::atomic<PoolTask*>[static_cast<std::size_t>(cap)]) {}
+
+        PoolTask* get(std::int64_t i) const {
+            return slots[static_cast<std::size_t>(i & (capacity - 1))].load(std::memory_order_relaxed);
+        }
+        void put(std::int64_t i, PoolTask* task) {
+            slots[static_cast<std::size_t>(i & (capacity - 1))].store(task, std::memory_order_relaxed);
+        }
+    };
+
+    Array* grow(Array* old, std::int64_t b, std::int64_t t) {
+        auto* bigger = new Array(old->capacity * 2);
+        for (std::int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+        retired_.emplace_back(bigger);
+        array_.store(bigger, std::memory_order_release);
+        return bigger;
+    }
+
+    alignas(64) std::atomic<std::int64_t> top_{0};
+    alignas(64) std::atomic<std::int64_t> bottom_{0};
+    std::atomic<Array*> array_;
+    std::vector<std::unique_ptr<Array>> retired_;   // Owns every buffer ever used
+};
+
+} // namespace detail
+
+/**
+ * @brief Fixed-size work-stealing thread pool
+ */
+class WorkStealingPool {
+public:
+    /**
+     * @param threads Worker count (at least 1)
+     */
+    explicit WorkStealingPool(std::size_t threads = std::thread::hardware_concurrency())
+        : thread_count_(std::max<std::size_t>(1, threads)) {
+        workers_.reserve(thread_count_);
+        for (std::size_t i = 0; i < thread_count_; ++i) {
+            workers_.push_back(std::make_unique<Worker>());
+            workers_.back()->rng_state = 0x9E3779B97F4A7C15ULL * (i + 1);
+        }
+        for (std::size_t i = 0; i < thread_count_; ++i) {
+            workers_[i]->thread = std::thread([this, i] { run_worker(i); });
+        }
+    }
+
+    /**
+     * @brief Runs every task already submitted, then joins the workers
+     */
+    ~WorkStealingPool() {
+        shutdown();
+    }
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    /**
+     * @brief Queue fn() to run on some worker
+     *
+     * Submitting after shutdown() has started is not supported.
+     */
+    template <typename Fn>
+    void submit(Fn&& fn) {
+        using Task = detail::PoolTaskImpl<std::decay_t<Fn>>;
+        enqueue(new Task(std::forward<Fn>(fn)));
+    }
+
+    /**
+     * @brief Queue fn() and get its result (or exception) through a future
+     */
+    template <typename Fn>
+    auto async(Fn&& fn) -> std::future<std::invoke_result_t<std::decay_t<Fn>>> {
+        using R = std::invoke_result_t<std::decay_t<Fn>>;
+        std::packaged_task<R()> task(std::forward<Fn>(fn));
+        auto future = task.get_future();
+        submit(std::move(task));
+        return future;
+    }
+
+    /**
+     * @brief Block until every task submitted so far (and every task
+     *        those spawn) has finished
+     *
+     * Must not be called from a pool worker.
+     */
+    void wait_idle() const {
+        std::size_t pending = pending_.load(std::memory_order_acquire);
+        while (pending != 0) {
+            pending_.wait(pending, std::memory_order_acquire);
+            pending = pending_.load(std::memory_order_acquire);
+        }
+    }
+
+    /**
+     * @brief Finish queued tasks and join the workers (idempotent)
+     */
+    void shutdown() {
+        if (stopping_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
+        wake_all();
+        for (auto& worker : workers_) {
+            if (worker->thread.joinable()) {
+                worker->thread.join();
+            }
+        }
+    }
+
+    std::size_t size() const { return thread_count_; }
+
+    /**
+     * @brief Tasks queued or running
+     */
+    std::size_t pending() const { return pending_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Tasks a worker took from another worker's deque or inbox
+     */
+    std::size_t steal_count() const { return steals_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Index of the calling worker in this pool, or -1
+     */
+    int current_worker() const {
+        return tls_pool == this ? static_cast<int>(tls_index) : -1;
+    }
+
+private:
+    static constexpr int kSpinRounds = 64;
+
+    struct alignas(64) Worker {
+        detail::StealDeque deque;
+        std::mutex inbox_mutex;
+        std::deque<detail::PoolTask*> inbox;                 // From non-worker threads
+        std::atomic<std::size_t> inbox_size{0};              // Lock-free emptiness check
+        std::uint64_t rng_state = 0;
+        std::thread thread;
+    };
+
+    inline static thread_local const WorkStealingPool* tls_pool = nullptr;
+    inline static thread_local std::size_t tls_index = 0;
+
+    void enqueue(detail::PoolTask* task) {
+        pending_.fetch_add(1, std::memory_order_relaxed);
+
+        if (tls_pool == this) {
+            workers_[tls_index]->deque.push(task);
+        } else {
+            std::size_t target = next_inbox_.fetch_add(1, std::memory_order_relaxed) % thread_count_;
+            Worker& worker = *workers_[target];
+            std::lock_guard<std::mutex> lock(worker.inbox_mutex);
+            worker.inbox.push_back(task);
+            worker.inbox_size.store(worker.inbox.size(), std::memory_order_relaxed);
+        }
+
+        // Pairs with the fence in park(): either the parking worker sees
+        // this task, or we see it registered as a sleeper.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (sleepers_.load(std::memory_order_relaxed) > 0) {
+            epoch_.fetch_add(1, std::memory_order_relaxed);
+            epoch_.notify_one();
+        }
+    }
+
+    void run_worker(std::size_t index) {
+        tls_pool = this;
+        tls_index = index;
+
+        while (true) {
+            detail::PoolTask* task = find_task(index);
+            for (int spin = 0; task == nullptr && spin < kSpinRounds; ++spin) {
+                std::this_thread::yield();
+                task = find_task(index);
+            }
+            if (task == nullptr) {
+                task = park(index);
+            }
+            if (task == nullptr) {
+                break;   // Shutting down and nothing left
+            }
+            run_task(task);
+        }
+
+        tls_pool = nullptr;
+    }
+
+    // Parks until there is work; returns nullptr when the pool is done
+    detail::PoolTask* park(std::size_t index) {
+        while (true) {
+            std::uint32_t epoch = epoch_.load(std::memory_order_relaxed);
+            sleepers_.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            detail::PoolTask* task = find_task(index);
+            if (task != nullptr || done()) {
+                sleepers_.fetch_sub(1, std::memory_order_relaxed);
+                return task;
+            }
+            epoch_.wait(epoch, std::memory_order_relaxed);
+            sleepers_.fetch_sub(1, std::memory_order_relaxed);
+
+            task = find_task(index);
+            if (task != nullptr || done()) {
+                return task;
+            }
+        }
+    }
+
+    bool done() const {
+        return stopping_.load(std::memory_order_acquire) &&
+               pending_.load(std::memory_order_acquire) == 0;
+    }
+
+    detail::PoolTask* find_task(std::size_t index) {
+        Worker& self = *workers_[index];
+
+        if (detail::PoolTask* task = self.deque.take()) {
+            return task;
+        }
+        if (detail::PoolTask* task = drain_inbox(self)) {
+            return task;
+        }
+
+        // Steal, starting at a random victim so thieves spread out
+        std::size_t start = static_cast<std::size_t>(next_random(self) % thread_count_);
+        for (std::size_t k = 0; k < thread_count_; ++k) {
+            std::size_t victim = (start + k) % thread_count_;
+            if (victim == index) {
+                continue;
+            }
+            Worker& other = *workers_[victim];
+            detail::PoolTask* task = other.deque.steal();
+            if (task == nullptr) {
+                task = steal_inbox(other);
+            }
+            if (task != nullptr) {
+                steals_.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+        return nullptr;
+    }
+
+    // Move the whole inbox into the own deque under one lock; run the first
+    detail::PoolTask* drain_inbox(Worker& self) {
+        if (self.inbox_size.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        std::deque<detail::PoolTask*> batch;
+        {
+            std::lock_guard<std::mutex> lock(self.inbox_mutex);
+            batch.swap(self.inbox);
+            self.inbox_size.store(0, std::memory_order_relaxed);
+        }
+        if (batch.empty()) {
+            return nullptr;
+        }
+        detail::PoolTask* first = batch.front();
+        // Push newest first so the own LIFO pops keep arrival order
+        for (auto it = batch.rbegin(); it != batch.rend() - 1; ++it) {
+            self.deque.push(*it);
+        }
+        return first;
+    }
+
+    static detail::PoolTask* steal_inbox(Worker& victim) {
+        if (victim.inbox_size.load(std::memory_order_relaxed) == 0) {
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(victim.inbox_mutex, std::try_to_lock);
+        if (!lock.owns_lock() || victim.inbox.empty()) {
+            return nullptr;
+        }
+        detail::PoolTask* task = victim.inbox.front();
+        victim.inbox.pop_front();
+        victim.inbox_size.store(victim.inbox.size(), std::memory_order_relaxed);
+        return task;
+    }
+
+    void run_task(detail::PoolTask* task) {
+        try {
+            task->run();
+        } catch (const std::exception& e) {
+            spdlog::error("WorkStealingPool task threw: {}", e.what());
+        } catch (...) {
+            spdlog::error("WorkStealingPool task threw unknown exception");
+        }
+        delete task;
+
+        if (pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            pending_.notify_all();
+            if (stopping_.load(std::memory_order_acquire)) {
+                wake_all();
+            }
+        }
+    }
+
+    void wake_all() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        epoch_.notify_all();
+    }
+
+    static std::uint64_t next_random(Worker& worker) {
+        // xorshift64
+        std::uint64_t x = worker.rng_state;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        worker.rng_state = x;
+        return x;
+    }
+
+    std::size_t thread_count_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    alignas(64) std::atomic<std::size_t> pending_{0};
+    alignas(64) std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> sleepers_{0};
+    std::atomic<std::size_t> next_inbox_{0};
+    std::atomic<std::size_t> steals_{0};
+    std::atomic<bool> stopping_{false};
+};
+
+} // namespace dfs
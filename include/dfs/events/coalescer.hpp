@@ -0,0 +1,292 @@
+/**
+ * @file coalescer.hpp
+ * @brief Merges high-frequency chunk progress events
+ *
+ * WHY THIS FILE EXISTS:
+ * A large upload produces one FileChunkReceivedEvent per chunk, and every
+ * subscriber handles every one. Subscribers only care about progress, so
+ * at high chunk rates most of that work is wasted.
+ *
+ * WHAT IT DOES:
+ * - Tracks progress per (session, file)
+ * - Emits at most one FileChunkReceivedEvent per window per file; chunks
+ *   arriving in between are merged into it (bytes summed, count kept)
+ * - Always emits immediately for the first chunk of a file and once all
+ *   of its chunks have arrived. Completion is tracked by the distinct
+ *   chunk indices seen, not read from the latest index: pipelined uploads
+ *   deliver chunks out of order, and a chunk re-sent after a transport
+ *   error arrives twice (the repeat is ignored)
+ * - flush() pushes out pending progress before the caller emits a
+ *   completion/failure event, so those are never reordered or absorbed;
+ *   flush_session() does the same for every file of a session that ended
+ * - Files with no chunk for idle_timeout (an upload abandoned without
+ *   finalize or failure) are flushed and forgotten
+ *
+ * Coalescing happens when chunks arrive - there is no timer thread. If an
+ * upload stalls mid-window its pending progress waits for the next chunk
+ * or for flush(). Idle files are swept from add() too, at most once per
+ * idle_timeout.
+ *
+ * EXAMPLE:
+ * ChunkProgressCoalescer progress(bus, std::chrono::milliseconds(100));
+ * progress.add(FileChunkReceivedEvent{session, path, index, total, bytes});
+ * // add() takes one event per chunk, as SyncService emits them
+ * ...
+ * progress.flush(session, path);
+ * bus.emit(FileUploadCompletedEvent{...});
+ */
+
+#pragma once
+
+#include "dfs/events/event_bus.hpp"
+#include "dfs/events/events.hpp"
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace dfs::events {
+
+/**
+ * @brief Per-file throttle for FileChunkReceivedEvent
+ *
+ * THREAD SAFETY:
+ * All methods are thread-safe. Events are emitted after the internal
+ * lock is released, so handlers may call back into the coalescer.
+ */
+class ChunkProgressCoalescer {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr std::chrono::milliseconds kDefaultIdleTimeout = std::chrono::minutes(10);
+
+    /**
+     * @param window       Minimum spacing between progress events for one
+     *                     file; zero disables coalescing
+     * @param idle_timeout A file with no chunk for this long is forgotten
+     */
+    ChunkProgressCoalescer(EventBus& bus, std::chrono::milliseconds window,
+                           std::chrono::milliseconds idle_timeout = kDefaultIdleTimeout)
+        : bus_(bus), window_(window), idle_timeout_(idle_timeout), last_sweep_(Clock::now()) {}
+
+    /**
+     * @brief Record a chunk; emits now or merges into pending progress
+     */
+    void add(const FileChunkReceivedEvent& event) {
+        if (window_.count() <= 0) {
+            bus_.emit(event);
+            return;
+        }
+
+        std::vector<FileChunkReceivedEvent> ready;
+        {
+            std::lock_guard lock(mutex_);
+            auto now = Clock::now();
+            sweep_idle(now, ready);
+            auto& entry = entries_[make_key(event.session_id, event.file_path)];
+            entry.last_add = now;
+
+            if (event.chunk_index < event.total_chunks) {
+                if (entry.seen.size() < event.total_chunks) {
+                    entry.seen.resize(event.total_chunks);
+                }
+                if (entry.seen[event.chunk_index]) {
+                    duplicates_++;   // Re-sent: progress did not move
+                    return;
+                }
+                entry.seen[event.chunk_index] = true;
+                entry.chunks_seen++;
+            }
+
+            if (entry.pending) {
+                auto& merged = *entry.pending;
+                merged.chunk_index = event.chunk_index;
+                merged.total_chunks = event.total_chunks;
+                merged.bytes_received += event.bytes_received;
+                merged.chunks_merged += event.chunks_merged;
+                merged.timestamp = event.timestamp;
+            } else {
+                entry.pending = event;
+            }
+
+            const bool last_chunk = entry.chunks_seen >= event.total_chunks;
+            const bool due = !entry.emitted_once || now - entry.last_emit >= window_;
+
+            if (last_chunk || due) {
+                ready.push_back(std::move(*entry.pending));
+                entry.pending.reset();
+                entry.emitted_once = true;
+                entry.last_emit = now;
+                if (last_chunk) {
+                    entries_.erase(make_key(event.session_id, event.file_path));
+                }
+            } else {
+                coalesced_++;
+            }
+        }
+
+        for (auto& progress : ready) {
+            bus_.emit(std::move(progress));
+        }
+    }
+
+    /**
+     * @brief Emit pending progress for one file and forget it
+     *
+     * Call before emitting that file's completion or failure event.
+     */
+    void flush(const std::string& session_id, const std::string& file_path) {
+        std::optional<FileChunkReceivedEvent> ready;
+        {
+            std::lock_guard lock(mutex_);
+            auto it = entries_.find(make_key(session_id, file_path));
+            if (it == entries_.end()) {
+                return;
+            }
+            ready = std::move(it->second.pending);
+            entries_.erase(it);
+        }
+
+        if (ready) {
+            bus_.emit(std::move(*ready));
+        }
+    }
+
+    /**
+     * @brief Emit pending progress for every file of a session and forget them
+     *
+     * Call when the session completes or fails, before its final event.
+     */
+    void flush_session(const std::string& session_id) {
+        std::vector<FileChunkReceivedEvent> ready;
+        {
+            std::lock_guard lock(mutex_);
+            const std::string prefix = make_key(session_id, {});
+            for (auto it = entries_.begin(); it != entries_.end();) {
+                if (it->first.compare(0, prefix.size(), prefix) != 0) {
+                    ++it;
+                    continue;
+                }
+                if (it->second.pending) {
+                    ready.push_back(std::move(*it->second.pending));
+                }
+                it = entries_.erase(it);
+            }
+        }
+
+        for (auto& event : ready) {
+            bus_.emit(std::move(event));
+        }
+    }
+
+    /**
+     * @brief Emit all pending progress (e.g. on shutdown)
+     */
+    void flush_all() {
+        std::vector<FileChunkReceivedEvent> ready;
+        {
+            std::lock_guard lock(mutex_);
+            for (auto& [key, entry] : entries_) {
+                if (entry.pending) {
+                    ready.push_back(std::move(*entry.pending));
+                }
+            }
+            entries_.clear();
+        }
+
+        for (auto& event : ready) {
+            bus_.emit(std::move(event));
+        }
+    }
+
+    /**
+     * @brief Number of files with progress waiting to be emitted
+     */
+    size_t pending() const {
+        std::lock_guard lock(mutex_);
+        size_t count = 0;
+        for (const auto& [key, entry] : entries_) {
+            if (entry.pending) {
+                ++count;
+            }
+        }
+        return count;
+    }
+
+    /**
+     * @brief Files being tracked, with or without pending progress
+     */
+    size_t tracked_files() const {
+        std::lock_guard lock(mutex_);
+        return entries_.size();
+    }
+
+    /**
+     * @brief Chunks merged into a later event instead of emitted
+     */
+    uint64_t coalesced_events() const {
+        std::lock_guard lock(mutex_);
+        return coalesced_;
+    }
+
+    /**
+     * @brief Chunks ignored because their index had already arrived
+     */
+    uint64_t duplicate_chunks() const {
+        std::lock_guard lock(mutex_);
+        return duplicates_;
+    }
+
+private:
+    struct Entry {
+        std::optional<FileChunkReceivedEvent> pending;
+        Clock::time_point last_emit{};
+        Clock::time_point last_add{};
+        std::vector<bool> seen;            // By chunk index
+        std::uint64_t chunks_seen = 0;     // Distinct indices in seen
+        bool emitted_once = false;
+    };
+
+    // Called with mutex_ held; collects the pending progress of idle files
+    void sweep_idle(Clock::time_point now, std::vector<FileChunkReceivedEvent>& ready) {
+        if (now - last_sweep_ < idle_timeout_) {
+            return;
+        }
+        last_sweep_ = now;
+        for (auto it = entries_.begin(); it != entries_.end();) {
+            if (now - it->second.last_add < idle_timeout_) {
+                ++it;
+                continue;
+            }
+            if (it->second.pending) {
+                ready.push_back(std::move(*it->second.pending));
+            }
+            it = entries_.erase(it);
+        }
+    }
+
+    static std::string make_key(const std::string& session_id, const std::string& file_path) {
+        std::string key;
+        key.reserve(session_id.size() + 1 + file_path.size());
+        key.append(session_id);
+        key.push_back('\0');
+        key.append(file_path);
+        return key;
+    }
+
+    EventBus& bus_;
+    std::chrono::milliseconds window_;
+    std::chrono::milliseconds idle_timeout_;
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> entries_;
+    Clock::time_point last_sweep_;   // Guarded by mutex_
+    uint64_t coalesced_ = 0;
+    uint64_t duplicates_ = 0;
+};
+
+} // namespace dfs::events
@@ -17,14 +17,60 @@
 
 #include "dfs/events/event_bus.hpp"
 #include "dfs/events/events.hpp"
+#include "dfs/events/metrics.hpp"
 #include <spdlog/spdlog.h>
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <mutex>
 #include <optional>
 #include <queue>
+#include <vector>
 
 namespace dfs::events {
 
+/**
+ * @brief Subscriptions owned by a component
+ *
+ * WHAT IT DOES:
+ * Remembers every handler a component subscribes and removes them in
+ * cancel(), then waits for deliveries already running on dispatcher
+ * threads. Components call cancel() first thing in their destructor,
+ * so an async bus never calls into a half-destroyed component.
+ */
+class Subscriptions {
+public:
+    explicit Subscriptions(EventBus& bus) : bus_(bus) {}
+
+    ~Subscriptions() {
+        cancel();
+    }
+
+    Subscriptions(const Subscriptions&) = delete;
+    Subscriptions& operator=(const Subscriptions&) = delete;
+
+    template<typename EventType>
+    void add(std::function<void(const EventType&)> handler) {
+        const size_t id = bus_.subscribe<EventType>(std::move(handler));
+        cancels_.push_back([this, id]() { bus_.unsubscribe<EventType>(id); });
+    }
+
+    void cancel() {
+        if (cancels_.empty()) {
+            return;
+        }
+        for (auto& cancel_one : cancels_) {
+            cancel_one();
+        }
+        cancels_.clear();
+        bus_.flush();
+    }
+
+private:
+    EventBus& bus_;
+    std::vector<std::function<void()>> cancels_;
+};
+
 /**
  * @brief Logger component - logs all file events
  *
@@ -38,53 +84,58 @@ namespace dfs::events {
  */
 class LoggerComponent {
 public:
-    explicit LoggerComponent(EventBus& bus) : bus_(bus) {
+    explicit LoggerComponent(EventBus& bus) : bus_(bus), subscriptions_(bus) {
         // Subscribe to all file events
-        bus_.subscribe<FileAddedEvent>([this](const FileAddedEvent& e) {
+        subscriptions_.add<FileAddedEvent>([this](const FileAddedEvent& e) {
             on_file_added(e);
         });
 
-        bus_.subscribe<FileModifiedEvent>([this](const FileModifiedEvent& e) {
+        subscriptions_.add<FileModifiedEvent>([this](const FileModifiedEvent& e) {
             on_file_modified(e);
         });
 
-        bus_.subscribe<FileDeletedEvent>([this](const FileDeletedEvent& e) {
+        subscriptions_.add<FileDeletedEvent>([this](const FileDeletedEvent& e) {
             on_file_deleted(e);
         });
 
-        bus_.subscribe<ServerStartedEvent>([this](const ServerStartedEvent& e) {
+        subscriptions_.add<ServerStartedEvent>([this](const ServerStartedEvent& e) {
             on_server_started(e);
         });
 
-        bus_.subscribe<ServerShuttingDownEvent>([this](const ServerShuttingDownEvent& e) {
+        subscriptions_.add<ServerShuttingDownEvent>([this](const ServerShuttingDownEvent& e) {
             on_server_shutdown(e);
         });
 
-        bus_.subscribe<FileUploadStartedEvent>([this](const FileUploadStartedEvent& e) {
+        subscriptions_.add<FileUploadStartedEvent>([this](const FileUploadStartedEvent& e) {
             on_file_upload_started(e);
         });
 
-        bus_.subscribe<FileChunkReceivedEvent>([this](const FileChunkReceivedEvent& e) {
+        subscriptions_.add<FileChunkReceivedEvent>([this](const FileChunkReceivedEvent& e) {
             on_file_chunk_received(e);
         });
 
-        bus_.subscribe<FileUploadCompletedEvent>([this](const FileUploadCompletedEvent& e) {
+        subscriptions_.add<FileUploadCompletedEvent>([this](const FileUploadCompletedEvent& e) {
             on_file_upload_completed(e);
         });
 
-        bus_.subscribe<FileDownloadCompletedEvent>([this](const FileDownloadCompletedEvent& e) {
+        subscriptions_.add<FileDownloadCompletedEvent>([this](const FileDownloadCompletedEvent& e) {
             on_file_download_completed(e);
         });
 
-        bus_.subscribe<FileConflictDetectedEvent>([this](const FileConflictDetectedEvent& e) {
+        subscriptions_.add<FileConflictDetectedEvent>([this](const FileConflictDetectedEvent& e) {
             on_conflict_detected(e);
         });
 
-        bus_.subscribe<FileConflictResolvedEvent>([this](const FileConflictResolvedEvent& e) {
+        subscriptions_.add<FileConflictResolvedEvent>([this](const FileConflictResolvedEvent& e) {
             on_conflict_resolved(e);
         });
     }
 
+    // Stop deliveries before any member they touch is destroyed
+    ~LoggerComponent() {
+        subscriptions_.cancel();
+    }
+
 private:
     void on_file_added(const FileAddedEvent& e) {
         spdlog::info("[FileAdded] path={} hash={} size={} source={}",
@@ -128,8 +179,9 @@ private:
     }
 
     void on_file_chunk_received(const FileChunkReceivedEvent& e) {
-        spdlog::debug("[ChunkReceived] session={} path={} chunk={}/{} bytes={}",
-                      e.session_id, e.file_path, e.chunk_index + 1, e.total_chunks, e.bytes_received);
+        spdlog::debug("[ChunkReceived] session={} path={} chunk={}/{} bytes={} merged={}",
+                      e.session_id, e.file_path, e.chunk_index + 1, e.total_chunks, e.bytes_received,
+                      e.chunks_merged);
     }
 
     void on_file_upload_completed(const FileUploadCompletedEvent& e) {
@@ -154,6 +206,7 @@ private:
     }
 
     EventBus& bus_;
+    Subscriptions subscriptions_;
 };
 
 /**
@@ -170,54 +223,96 @@ private:
  */
 class MetricsComponent {
 public:
+    /**
+     * Counters are sharded per thread (see ShardedCounter), so handlers
+     * running on several dispatcher threads don't fight over one cache
+     * line. Read them with load(), as with std::atomic.
+     */
     struct Stats {
-        std::atomic<uint64_t> files_added{0};
-        std::atomic<uint64_t> files_modified{0};
-        std::atomic<uint64_t> files_deleted{0};
-        std::atomic<uint64_t> total_bytes_added{0};
-        std::atomic<uint64_t> total_bytes_modified{0};
-        std::atomic<uint64_t> files_uploaded{0};
-        std::atomic<uint64_t> bytes_uploaded{0};
-        std::atomic<uint64_t> files_downloaded{0};
-        std::atomic<uint64_t> bytes_downloaded{0};
-        std::atomic<uint64_t> conflicts_detected{0};
-        std::atomic<uint64_t> conflicts_resolved{0};
+        ShardedCounter files_added;
+        ShardedCounter files_modified;
+        ShardedCounter files_deleted;
+        ShardedCounter total_bytes_added;
+        ShardedCounter total_bytes_modified;
+        ShardedCounter files_uploaded;
+        ShardedCounter bytes_uploaded;
+        ShardedCounter files_downloaded;
+        ShardedCounter bytes_downloaded;
+        ShardedCounter conflicts_detected;
+        ShardedCounter conflicts_resolved;
+    };
+
+    /**
+     * Latency and size distributions. The unit is part of the name.
+     */
+    struct Histograms {
+        HdrHistogram upload_duration_ms;   ///< FileUploadCompletedEvent::duration
+        HdrHistogram sync_duration_ms;     ///< SyncCompletedEvent::duration
+        HdrHistogram chunk_size_bytes;     ///< Per chunk, from FileChunkReceivedEvent
+        HdrHistogram request_latency_us;   ///< Fed by record_request_latency()
     };
 
-    explicit MetricsComponent(EventBus& bus) : bus_(bus) {
-        bus_.subscribe<FileAddedEvent>([this](const FileAddedEvent& e) {
+    explicit MetricsComponent(EventBus& bus) : bus_(bus), subscriptions_(bus) {
+        subscriptions_.add<FileAddedEvent>([this](const FileAddedEvent& e) {
             on_file_added(e);
         });
 
-        bus_.subscribe<FileModifiedEvent>([this](const FileModifiedEvent& e) {
+        subscriptions_.add<FileModifiedEvent>([this](const FileModifiedEvent& e) {
             on_file_modified(e);
         });
 
-        bus_.subscribe<FileDeletedEvent>([this](const FileDeletedEvent& e) {
+        subscriptions_.add<FileDeletedEvent>([this](const FileDeletedEvent& e) {
             on_file_deleted(e);
         });
 
-        bus_.subscribe<FileUploadCompletedEvent>([this](const FileUploadCompletedEvent& e) {
+        subscriptions_.add<FileUploadCompletedEvent>([this](const FileUploadCompletedEvent& e) {
             on_file_upload_completed(e);
         });
 
-        bus_.subscribe<FileDownloadCompletedEvent>([this](const FileDownloadCompletedEvent& e) {
+        subscriptions_.add<FileDownloadCompletedEvent>([this](const FileDownloadCompletedEvent& e) {
             on_file_download_completed(e);
         });
 
-        bus_.subscribe<FileConflictDetectedEvent>([this](const FileConflictDetectedEvent&) {
+        subscriptions_.add<FileChunkReceivedEvent>([this](const FileChunkReceivedEvent& e) {
+            on_file_chunk_received(e);
+        });
+
+        subscriptions_.add<SyncCompletedEvent>([this](const SyncCompletedEvent& e) {
+            histograms_.sync_duration_ms.record(to_count(e.duration));
+        });
+
+        subscriptions_.add<FileConflictDetectedEvent>([this](const FileConflictDetectedEvent&) {
             stats_.conflicts_detected++;
         });
 
-        bus_.subscribe<FileConflictResolvedEvent>([this](const FileConflictResolvedEvent&) {
+        subscriptions_.add<FileConflictResolvedEvent>([this](const FileConflictResolvedEvent&) {
             stats_.conflicts_resolved++;
         });
     }
 
+    // Stop deliveries before any member they touch is destroyed
+    ~MetricsComponent() {
+        subscriptions_.cancel();
+    }
+
     const Stats& get_stats() const {
         return stats_;
     }
 
+    const Histograms& get_histograms() const {
+        return histograms_;
+    }
+
+    /**
+     * @brief Record how long one HTTP request took to handle
+     *
+     * There is no event per request (that would double the bus traffic),
+     * so the server calls this directly. Safe from any worker thread.
+     */
+    void record_request_latency(std::chrono::microseconds latency) {
+        histograms_.request_latency_us.record(to_count(latency));
+    }
+
     void print_stats() const {
         spdlog::info("═══════════════════════════════════════");
         spdlog::info("Session Statistics:");
@@ -232,10 +327,28 @@ public:
         spdlog::info("  Bytes downloaded:{}", stats_.bytes_downloaded.load());
         spdlog::info("  Conflicts det.:  {}", stats_.conflicts_detected.load());
         spdlog::info("  Conflicts res.:  {}", stats_.conflicts_resolved.load());
+        print_histogram("Upload duration", "ms", histograms_.upload_duration_ms);
+        print_histogram("Sync duration", "ms", histograms_.sync_duration_ms);
+        print_histogram("Chunk size", "B", histograms_.chunk_size_bytes);
+        print_histogram("Request latency", "us", histograms_.request_latency_us);
         spdlog::info("═══════════════════════════════════════");
     }
 
 private:
+    template<typename Rep, typename Period>
+    static std::uint64_t to_count(std::chrono::duration<Rep, Period> d) {
+        return d.count() > 0 ? static_cast<std::uint64_t>(d.count()) : 0;
+    }
+
+    static void print_histogram(const char* name, const char* unit, const HdrHistogram& h) {
+        auto snap = h.snapshot();
+        if (snap.count == 0) {
+            return;
+        }
+        spdlog::info("  {} ({}): n={} p50={} p99={} p999={} max={}",
+                     name, unit, snap.count, snap.p50, snap.p99, snap.p999, snap.max);
+    }
+
     void on_file_added(const FileAddedEvent& e) {
         stats_.files_added++;
         stats_.total_bytes_added += e.metadata.size;
@@ -246,13 +359,14 @@ private:
         stats_.total_bytes_modified += e.new_size;
     }
 
-    void on_file_deleted(const FileDeletedEvent& e) {
+    void on_file_deleted(const FileDeletedEvent&) {
         stats_.files_deleted++;
     }
 
     void on_file_upload_completed(const FileUploadCompletedEvent& e) {
         stats_.files_uploaded++;
         stats_.bytes_uploaded += e.total_bytes;
+        histograms_.upload_duration_ms.record(to_count(e.duration));
     }
 
     void on_file_download_completed(const FileDownloadCompletedEvent& e) {
@@ -260,8 +374,17 @@ private:
         stats_.bytes_downloaded += e.total_bytes;
     }
 
+    // A coalesced event stands for chunks_merged chunks; record their
+    // average size once per chunk so the distribution stays per chunk.
+    void on_file_chunk_received(const FileChunkReceivedEvent& e) {
+        std::uint32_t chunks = e.chunks_merged == 0 ? 1 : e.chunks_merged;
+        histograms_.chunk_size_bytes.record(e.bytes_received / chunks, chunks);
+    }
+
     EventBus& bus_;
+    Subscriptions subscriptions_;
     Stats stats_;
+    Histograms histograms_;
 };
 
 /**
@@ -280,16 +403,21 @@ private:
  */
 class SyncComponent {
 public:
-    explicit SyncComponent(EventBus& bus) : bus_(bus) {
-        bus_.subscribe<FileAddedEvent>([this](const FileAddedEvent& e) {
+    explicit SyncComponent(EventBus& bus) : bus_(bus), subscriptions_(bus) {
+        subscriptions_.add<FileAddedEvent>([this](const FileAddedEvent& e) {
             on_file_added(e);
         });
 
-        bus_.subscribe<FileModifiedEvent>([this](const FileModifiedEvent& e) {
+        subscriptions_.add<FileModifiedEvent>([this](const FileModifiedEvent& e) {
             on_file_modified(e);
         });
     }
 
+    // Stop deliveries before any member they touch is destroyed
+    ~SyncComponent() {
+        subscriptions_.cancel();
+    }
+
     size_t queue_size() const {
         std::lock_guard lock(mutex_);
         return sync_queue_.size();
@@ -325,6 +453,7 @@ private:
     }
 
     EventBus& bus_;
+    Subscriptions subscriptions_;
     mutable std::mutex mutex_;
     std::queue<std::string> sync_queue_;
 };
@@ -12,26 +12,65 @@
  * - Thread-safe concurrent access
  * - Support for any event type
  * - Handler registration and unregistration
+ * - Optional asynchronous dispatch on dedicated worker threads
  *
  * EXAMPLE:
  * EventBus bus;
  * bus.subscribe<MyEvent>([](const MyEvent& e) { ... });
  * bus.emit(MyEvent{...});
+ *
+ * // Async mode: handlers run on 2 dispatcher threads
+ * EventBus async_bus(AsyncDispatchOptions{2, 1024, BackpressurePolicy::Block});
  */
 
 #pragma once
 
+#include "dfs/events/reader_epochs.hpp"
 #include <functional>
 #include <memory>
-#include <typeindex>
 #include <unordered_map>
 #include <vector>
 #include <mutex>
-#include <shared_mutex>
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
 
 namespace dfs::events {
 
+/**
+ * @brief What emit() does when a dispatcher queue is full (async mode only)
+ *
+ * Block    - emitter waits until the dispatcher frees a slot (lossless)
+ * Drop     - the new event is discarded for that subscriber
+ * Coalesce - the new event replaces the subscriber's newest queued event
+ *            when it is of the same type (latest value wins); otherwise
+ *            behaves like Block so ordering is never violated
+ */
+enum class BackpressurePolicy {
+    Block,
+    Drop,
+    Coalesce
+};
+
+/**
+ * @brief Configuration for asynchronous dispatch
+ *
+ * Each subscriber is pinned to one dispatcher thread, so a subscriber
+ * always sees events in the order they were emitted.
+ */
+struct AsyncDispatchOptions {
+    std::size_t dispatcher_threads = 1;
+    std::size_t queue_capacity = 1024;   ///< Pending deliveries per dispatcher thread
+    BackpressurePolicy backpressure = BackpressurePolicy::Block;
+};
+
 /**
  * @brief Type-safe event bus
  *
@@ -41,21 +80,65 @@ namespace dfs::events {
  * THREAD SAFETY:
  * - Multiple threads can emit events concurrently
  * - Multiple threads can subscribe concurrently
- * - Handlers are called synchronously in emitting thread
- * - Per-event-type locking for better concurrency
+ * - Synchronous mode (default): handlers run in the emitting thread
+ * - Async mode: handlers run on dispatcher threads; emit() only enqueues
+ *
+ * EMIT FAST PATH:
+ * Every event type gets a fixed slot index the first time the type is
+ * used. Each slot holds an immutable handler list published through an
+ * atomic pointer. subscribe()/unsubscribe() copy the list, modify the
+ * copy and swap it in (copy-on-write); emit() just loads the pointer and
+ * walks the list. No lock, no allocation, no refcount traffic.
+ *
+ * Replaced lists are retired and freed once no emit() can still be
+ * walking them (see reader_epochs.hpp). An emit() publishes the epoch
+ * it reads in with plain stores to its thread's own cache line; writers
+ * free every retired list older than the oldest epoch still being read,
+ * on each subscribe/unsubscribe and in flush(). Readers never block a
+ * writer for longer than one emit(), so retired lists stay bounded
+ * under subscribe/unsubscribe churn.
+ *
+ * ASYNC MODE:
+ * emit() moves the event into a pooled slot and queues one delivery per
+ * subscriber on that subscriber's dispatcher thread. Deliveries still
+ * queued for a handler are skipped once it is unsubscribed; an object
+ * whose handlers capture `this` should unsubscribe and then flush()
+ * before it is destroyed, so that no delivery is still running.
  */
 class EventBus {
 public:
     EventBus() = default;
-    ~EventBus() = default;
+
+    /**
+     * @brief Create a bus that dispatches on background threads
+     */
+    explicit EventBus(AsyncDispatchOptions options)
+        : async_options_(options) {
+        const std::size_t thread_count = std::max<std::size_t>(1, options.dispatcher_threads);
+        async_options_.dispatcher_threads = thread_count;
+        async_options_.queue_capacity = std::max<std::size_t>(1, options.queue_capacity);
+
+        dispatchers_.reserve(thread_count);
+        for (std::size_t i = 0; i < thread_count; ++i) {
+            dispatchers_.push_back(std::make_unique<Dispatcher>());
+        }
+        for (auto& dispatcher : dispatchers_) {
+            Dispatcher* raw = dispatcher.get();
+            raw->thread = std::thread([this, raw]() { dispatch_loop(*raw); });
+        }
+    }
+
+    ~EventBus() {
+        shutdown();
+    }
 
     // Non-copyable (would duplicate handlers)
     EventBus(const EventBus&) = delete;
     EventBus& operator=(const EventBus&) = delete;
 
-    // Moveable
-    EventBus(EventBus&&) = default;
-    EventBus& operator=(EventBus&&) = default;
+    // Non-moveable (dispatcher threads hold a pointer to the bus)
+    EventBus(EventBus&&) = delete;
+    EventBus& operator=(EventBus&&) = delete;
 
     /**
      * @brief Subscribe to events of a specific type
@@ -77,17 +160,19 @@ public:
      */
     template<typename EventType>
     size_t subscribe(std::function<void(const EventType&)> handler) {
-        std::unique_lock lock(mutex_);
+        std::lock_guard lock(write_mutex_);
 
-        // Get type index for this event type
-        auto type_id = std::type_index(typeid(EventType));
+        // Get slot for this event type
+        const size_t slot = checked_type_slot<EventType>();
 
         // Create handler wrapper
         auto wrapper = std::make_shared<HandlerImpl<EventType>>(std::move(handler));
         size_t handler_id = next_handler_id_++;
 
-        // Store handler
-        handlers_[type_id].push_back({handler_id, wrapper});
+        // Copy current list, append, publish
+        auto updated = copy_list(slot);
+        updated->push_back({handler_id, std::move(wrapper)});
+        publish(slot, std::move(updated));
 
         return handler_id;
     }
@@ -105,21 +190,27 @@ public:
      */
     template<typename EventType>
     void unsubscribe(size_t handler_id) {
-        std::unique_lock lock(mutex_);
+        std::lock_guard lock(write_mutex_);
 
-        auto type_id = std::type_index(typeid(EventType));
-        auto it = handlers_.find(type_id);
-
-        if (it != handlers_.end()) {
-            auto& handler_list = it->second;
-            handler_list.erase(
-                std::remove_if(handler_list.begin(), handler_list.end(),
-                    [handler_id](const auto& pair) {
-                        return pair.first == handler_id;
-                    }),
-                handler_list.end()
-            );
+        const size_t slot = type_slot<EventType>();
+        if (slot >= kMaxEventTypes || !slots_[slot].load(std::memory_order_relaxed)) {
+            return;
         }
+
+        auto updated = copy_list(slot);
+        updated->erase(
+            std::remove_if(updated->begin(), updated->end(),
+                [handler_id](const auto& pair) {
+                    if (pair.first != handler_id) {
+                        return false;
+                    }
+                    // Deliveries already queued for it are skipped
+                    pair.second->live.store(false, std::memory_order_release);
+                    return true;
+                }),
+            updated->end()
+        );
+        publish(slot, std::move(updated));
     }
 
     /**
@@ -129,12 +220,12 @@ public:
      * EventType - The event type (usually deduced from argument)
      *
      * PARAMETERS:
-     * event - The event to emit
+     * event - The event to emit (rvalues are moved into the async slot)
      *
      * HOW IT WORKS:
-     * 1. Lock handlers for this event type
-     * 2. Call each handler synchronously
-     * 3. Handlers run in emitting thread
+     * 1. Load the handler list for this event type (one atomic load)
+     * 2. Sync mode: call each handler in the emitting thread
+     * 3. Async mode: queue one delivery per handler on its dispatcher
      *
      * EXCEPTION SAFETY:
      * If a handler throws, exception is caught and logged,
@@ -144,57 +235,147 @@ public:
      * bus.emit(FileAddedEvent{metadata, "http"});
      */
     template<typename EventType>
-    void emit(const EventType& event) {
-        // Get handlers (make a copy to avoid deadlock if handler subscribes)
-        std::vector<std::shared_ptr<HandlerBase>> handlers_copy;
-        {
-            std::shared_lock lock(mutex_);
-            auto type_id = std::type_index(typeid(EventType));
-            auto it = handlers_.find(type_id);
-
-            if (it == handlers_.end()) {
-                return;  // No subscribers for this event
+    void emit(EventType&& event) {
+        using Event = std::decay_t<EventType>;
+
+        // Immutable snapshot: safe to walk even if a handler subscribes
+        const size_t slot = type_slot<Event>();
+        if (slot >= kMaxEventTypes) {
+            return;  // Type never subscribed (slot table exhausted)
+        }
+        detail::ReadSection section;
+        const HandlerList* handlers = slots_[slot].load(std::memory_order_acquire);
+        if (handlers == nullptr || handlers->empty()) {
+            return;  // No subscribers for this event
+        }
+
+        if (dispatchers_.empty() || stopped_.load(std::memory_order_acquire)) {
+            for (const auto& [id, handler] : *handlers) {
+                invoke(*handler, &event);
+            }
+            return;
+        }
+
+        enqueue<Event>(std::forward<EventType>(event), *handlers, slot);
+    }
+
+    /**
+     * @brief Wait until every event emitted before this call is delivered
+     *
+     * No-op in synchronous mode. Intended for tests and orderly shutdown.
+     * When called from a handler, the caller's own dispatcher is skipped
+     * (it cannot wait for itself).
+     */
+    void flush() {
+        for (auto& dispatcher : dispatchers_) {
+            if (current_dispatcher() == dispatcher.get()) {
+                continue;
             }
+            std::unique_lock lock(dispatcher->mutex);
+            const uint64_t target = dispatcher->enqueued;
+            dispatcher->drained.wait(lock, [&dispatcher, target]() {
+                return dispatcher->completed >= target || dispatcher->stopping;
+            });
+        }
+
+        // Quiescent point: free every retired list no concurrent emit()
+        // is still walking
+        std::lock_guard lock(write_mutex_);
+        reclaim();
+    }
+
+    /**
+     * @brief Drain pending deliveries and stop dispatcher threads
+     *
+     * Called by the destructor. Events emitted afterwards are delivered
+     * synchronously in the emitting thread.
+     */
+    void shutdown() {
+        if (dispatchers_.empty() || stopped_.exchange(true, std::memory_order_acq_rel)) {
+            return;
+        }
 
-            // Copy handler pointers
-            for (const auto& [id, handler] : it->second) {
-                handlers_copy.push_back(handler);
+        for (auto& dispatcher : dispatchers_) {
+            {
+                std::lock_guard lock(dispatcher->mutex);
+                dispatcher->stopping = true;
             }
+            dispatcher->not_empty.notify_all();
+            dispatcher->not_full.notify_all();
         }
 
-        // Call handlers without holding lock
-        for (auto& handler : handlers_copy) {
-            try {
-                handler->call(&event);
-            } catch (const std::exception& e) {
-                // Log but don't crash - one bad handler shouldn't kill all
-                // In production, use spdlog
-                // spdlog::error("Event handler exception: {}", e.what());
-            } catch (...) {
-                // Catch all exceptions
+        for (auto& dispatcher : dispatchers_) {
+            if (dispatcher->thread.joinable() &&
+                dispatcher->thread.get_id() != std::this_thread::get_id()) {
+                dispatcher->thread.join();
             }
         }
     }
 
+    /**
+     * @brief True if handlers run on dispatcher threads
+     */
+    bool is_async() const {
+        return !dispatchers_.empty() && !stopped_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Deliveries discarded by BackpressurePolicy::Drop
+     */
+    uint64_t dropped_events() const {
+        return dropped_events_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Deliveries merged by BackpressurePolicy::Coalesce
+     */
+    uint64_t coalesced_events() const {
+        return coalesced_events_.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Get number of subscribers for an event type
      */
     template<typename EventType>
     size_t subscriber_count() const {
-        std::shared_lock lock(mutex_);
-        auto type_id = std::type_index(typeid(EventType));
-        auto it = handlers_.find(type_id);
-        return it != handlers_.end() ? it->second.size() : 0;
+        const size_t slot = type_slot<EventType>();
+        if (slot >= kMaxEventTypes) {
+            return 0;
+        }
+        detail::ReadSection section;
+        const HandlerList* handlers = slots_[slot].load(std::memory_order_acquire);
+        return handlers != nullptr ? handlers->size() : 0;
+    }
+
+    /**
+     * @brief Replaced handler lists not yet freed (for tests and metrics)
+     */
+    size_t retired_lists() const {
+        std::lock_guard lock(write_mutex_);
+        return retired_.size();
     }
 
     /**
      * @brief Remove all subscribers
      */
     void clear() {
-        std::unique_lock lock(mutex_);
-        handlers_.clear();
+        std::lock_guard lock(write_mutex_);
+        for (size_t slot = 0; slot < kMaxEventTypes; ++slot) {
+            const HandlerList* current = slots_[slot].load(std::memory_order_relaxed);
+            if (current != nullptr) {
+                for (const auto& [id, handler] : *current) {
+                    handler->live.store(false, std::memory_order_release);
+                }
+                publish(slot, std::make_unique<HandlerList>());
+            }
+        }
     }
 
+    /**
+     * @brief Upper bound on distinct event types per process
+     */
+    static constexpr size_t kMaxEventTypes = 128;
+
 private:
     // ════════════════════════════════════════════════════════
     // Type Erasure Implementation
@@ -206,6 +387,9 @@ private:
     struct HandlerBase {
         virtual ~HandlerBase() = default;
         virtual void call(const void* event) = 0;
+
+        // Cleared by unsubscribe()/clear()
+        std::atomic<bool> live{true};
     };
 
     /**
@@ -225,21 +409,347 @@ private:
         }
     };
 
+    // ════════════════════════════════════════════════════════
+    // Copy-on-Write Handler Lists
+    // ════════════════════════════════════════════════════════
+
+    using HandlerList = std::vector<std::pair<size_t, std::shared_ptr<HandlerBase>>>;
+
+    /**
+     * @brief Process-wide slot index for an event type
+     *
+     * Assigned once per type on first use; afterwards it is a plain read
+     * of a function-local static, so emit() never hashes a type_index.
+     */
+    template<typename EventType>
+    static size_t type_slot() {
+        static const size_t slot = next_type_slot().fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    template<typename EventType>
+    static size_t checked_type_slot() {
+        const size_t slot = type_slot<EventType>();
+        if (slot >= kMaxEventTypes) {
+            throw std::length_error("EventBus: too many distinct event types");
+        }
+        return slot;
+    }
+
+    static std::atomic<size_t>& next_type_slot() {
+        static std::atomic<size_t> counter{0};
+        return counter;
+    }
+
+    // Caller holds write_mutex_
+    std::unique_ptr<HandlerList> copy_list(size_t slot) const {
+        const HandlerList* current = slots_[slot].load(std::memory_order_relaxed);
+        return current ? std::make_unique<HandlerList>(*current)
+                       : std::make_unique<HandlerList>();
+    }
+
+    // Caller holds write_mutex_
+    void publish(size_t slot, std::unique_ptr<HandlerList> list) {
+        slots_[slot].store(list.get(), std::memory_order_release);
+        if (live_[slot]) {
+            retired_.emplace_back(detail::advance_epoch(), std::move(live_[slot]));
+        }
+        live_[slot] = std::move(list);
+        reclaim();
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Epoch-Based Reclamation
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Free retired lists no emit() can still be walking
+     *
+     * A list retired with stamp E was unpublished before the epoch moved
+     * past E, so only readers that entered at epoch E or earlier can hold
+     * it. Caller holds write_mutex_.
+     */
+    void reclaim() {
+        if (retired_.empty()) {
+            return;
+        }
+        const uint64_t safe = detail::safe_epoch();
+        retired_.erase(
+            std::remove_if(retired_.begin(), retired_.end(),
+                [safe](const auto& entry) { return entry.first < safe; }),
+            retired_.end());
+    }
+
+    static void invoke(HandlerBase& handler, const void* event) {
+        try {
+            handler.call(event);
+        } catch (const std::exception&) {
+            // Log but don't crash - one bad handler shouldn't kill all
+            // In production, use spdlog
+        } catch (...) {
+            // Catch all exceptions
+        }
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Async Dispatch Implementation
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Pooled storage for one in-flight event
+     *
+     * Shared by all deliveries of the same emit(); returned to its pool
+     * when the last subscriber has been called.
+     */
+    struct EventSlot {
+        virtual ~EventSlot() = default;
+        virtual const void* get() const = 0;
+        virtual void release() = 0;
+
+        std::atomic<size_t> pending{0};
+    };
+
+    struct SlotPoolBase {
+        virtual ~SlotPoolBase() = default;
+    };
+
+    /**
+     * @brief Free list of slots for one event type
+     *
+     * Slots are reused, so steady-state async emit does not allocate
+     * the slot itself - only the event's own members move in.
+     */
+    template<typename EventType>
+    class SlotPool : public SlotPoolBase {
+    public:
+        struct Slot : EventSlot {
+            std::optional<EventType> event;
+            SlotPool* pool = nullptr;
+
+            const void* get() const override { return &*event; }
+            void release() override { pool->recycle(this); }
+        };
+
+        template<typename Arg>
+        Slot* acquire(Arg&& value) {
+            Slot* slot = nullptr;
+            {
+                std::lock_guard lock(mutex_);
+                if (free_.empty()) {
+                    all_.push_back(std::make_unique<Slot>());
+                    all_.back()->pool = this;
+                    slot = all_.back().get();
+                } else {
+                    slot = free_.back();
+                    free_.pop_back();
+                }
+            }
+            slot->event.emplace(std::forward<Arg>(value));
+            return slot;
+        }
+
+        void recycle(Slot* slot) {
+            slot->event.reset();
+            std::lock_guard lock(mutex_);
+            free_.push_back(slot);
+        }
+
+    private:
+        std::mutex mutex_;
+        std::vector<std::unique_ptr<Slot>> all_;
+        std::vector<Slot*> free_;
+    };
+
+    /**
+     * @brief One pending handler call
+     */
+    struct DispatchTask {
+        EventSlot* slot = nullptr;
+        std::shared_ptr<HandlerBase> handler;   // Outlives the list it came from
+        size_t handler_id = 0;
+        size_t type_slot = 0;
+    };
+
+    /**
+     * @brief Bounded FIFO served by a single thread
+     *
+     * enqueued/completed are monotonic counters used by flush().
+     */
+    struct Dispatcher {
+        std::mutex mutex;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::condition_variable drained;
+        std::deque<DispatchTask> tasks;
+        uint64_t enqueued = 0;
+        uint64_t completed = 0;
+        bool stopping = false;
+        std::thread thread;
+    };
+
+    template<typename EventType>
+    SlotPool<EventType>& slot_pool(size_t type_slot) {
+        std::lock_guard lock(pools_mutex_);
+        auto& pool = pools_[type_slot];
+        if (!pool) {
+            pool = std::make_unique<SlotPool<EventType>>();
+        }
+        return static_cast<SlotPool<EventType>&>(*pool);
+    }
+
+    template<typename Event, typename Arg>
+    void enqueue(Arg&& event, const HandlerList& handlers, size_t type_slot) {
+        EventSlot* slot = slot_pool<Event>(type_slot).acquire(std::forward<Arg>(event));
+
+        // Hold one extra reference while fanning out so the slot cannot be
+        // recycled by a fast dispatcher before the loop finishes.
+        slot->pending.store(handlers.size() + 1, std::memory_order_relaxed);
+
+        for (const auto& [id, handler] : handlers) {
+            Dispatcher& dispatcher = *dispatchers_[id % dispatchers_.size()];
+            if (!push_task(dispatcher, DispatchTask{slot, handler, id, type_slot})) {
+                release_slot(slot);
+            }
+        }
+        release_slot(slot);
+    }
+
+    /**
+     * @brief Queue a delivery, applying the backpressure policy
+     *
+     * RETURNS: false if the task was not queued (dropped, coalesced into
+     * an older entry, or delivered inline after shutdown)
+     */
+    bool push_task(Dispatcher& dispatcher, DispatchTask task) {
+        std::unique_lock lock(dispatcher.mutex);
+
+        const size_t capacity = async_options_.queue_capacity;
+        // A dispatcher emitting into its own full queue must not wait on itself
+        const bool own_thread = current_dispatcher() == &dispatcher;
+
+        if (dispatcher.tasks.size() >= capacity && !own_thread && !dispatcher.stopping) {
+            switch (async_options_.backpressure) {
+                case BackpressurePolicy::Drop:
+                    dropped_events_.fetch_add(1, std::memory_order_relaxed);
+                    return false;
+
+                case BackpressurePolicy::Coalesce:
+                    // Only the subscriber's newest queued task may be replaced,
+                    // otherwise the event would overtake later ones.
+                    for (auto it = dispatcher.tasks.rbegin(); it != dispatcher.tasks.rend(); ++it) {
+                        if (it->handler_id != task.handler_id) {
+                            continue;
+                        }
+                        if (it->type_slot == task.type_slot) {
+                            EventSlot* replaced = it->slot;
+                            it->slot = task.slot;
+                            coalesced_events_.fetch_add(1, std::memory_order_relaxed);
+                            lock.unlock();
+                            release_slot(replaced);
+                            // New slot's reference is now owned by the queued task
+                            return true;
+                        }
+                        break;
+                    }
+                    [[fallthrough]];
+
+                case BackpressurePolicy::Block:
+                    dispatcher.not_full.wait(lock, [&dispatcher, capacity]() {
+                        return dispatcher.tasks.size() < capacity || dispatcher.stopping;
+                    });
+                    break;
+            }
+        }
+
+        if (dispatcher.stopping) {
+            lock.unlock();
+            invoke(*task.handler, task.slot->get());
+            return false;
+        }
+
+        dispatcher.tasks.push_back(std::move(task));
+        ++dispatcher.enqueued;
+        lock.unlock();
+        dispatcher.not_empty.notify_one();
+        return true;
+    }
+
+    void dispatch_loop(Dispatcher& dispatcher) {
+        current_dispatcher() = &dispatcher;
+
+        while (true) {
+            DispatchTask task;
+            {
+                std::unique_lock lock(dispatcher.mutex);
+                dispatcher.not_empty.wait(lock, [&dispatcher]() {
+                    return !dispatcher.tasks.empty() || dispatcher.stopping;
+                });
+
+                if (dispatcher.tasks.empty()) {
+                    break;  // Stopping and fully drained
+                }
+
+                task = std::move(dispatcher.tasks.front());
+                dispatcher.tasks.pop_front();
+            }
+            dispatcher.not_full.notify_one();
+
+            // The subscriber may have left after this was queued
+            if (task.handler->live.load(std::memory_order_acquire)) {
+                invoke(*task.handler, task.slot->get());
+            }
+            release_slot(task.slot);
+
+            {
+                std::lock_guard lock(dispatcher.mutex);
+                ++dispatcher.completed;
+            }
+            dispatcher.drained.notify_all();
+        }
+
+        dispatcher.drained.notify_all();
+        current_dispatcher() = nullptr;
+    }
+
+    static void release_slot(EventSlot* slot) {
+        if (slot->pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            slot->release();
+        }
+    }
+
+    static Dispatcher*& current_dispatcher() {
+        thread_local Dispatcher* dispatcher = nullptr;
+        return dispatcher;
+    }
+
     // ════════════════════════════════════════════════════════
     // Member Variables
     // ════════════════════════════════════════════════════════
 
-    // Map: event type -> list of (handler_id, handler)
-    std::unordered_map<
-        std::type_index,
-        std::vector<std::pair<size_t, std::shared_ptr<HandlerBase>>>
-    > handlers_;
+    // Event type slot -> current list of (handler_id, handler)
+    std::array<std::atomic<const HandlerList*>, kMaxEventTypes> slots_{};
+
+    // Owners of the published lists, and of replaced lists stamped with
+    // the epoch they were retired in
+    std::array<std::unique_ptr<HandlerList>, kMaxEventTypes> live_{};
+    std::vector<std::pair<uint64_t, std::unique_ptr<HandlerList>>> retired_;
 
-    // Thread safety
-    mutable std::shared_mutex mutex_;
+    // Serializes subscribe/unsubscribe/clear/reclaim; emit never takes it
+    mutable std::mutex write_mutex_;
 
     // Handler ID counter
     size_t next_handler_id_ = 0;
+
+    // Async dispatch (empty in synchronous mode)
+    AsyncDispatchOptions async_options_{};
+    std::vector<std::unique_ptr<Dispatcher>> dispatchers_;
+    std::atomic<bool> stopped_{false};
+    std::atomic<uint64_t> dropped_events_{0};
+    std::atomic<uint64_t> coalesced_events_{0};
+
+    // Event type slot -> slot pool (only used in async mode)
+    std::mutex pools_mutex_;
+    std::unordered_map<size_t, std::unique_ptr<SlotPoolBase>> pools_;
 };
 
 } // namespace dfs::events
@@ -6,34 +6,214 @@
  * Provides async event processing via a background thread.
  * Allows emitting events without blocking on handler execution.
  *
+ * HOW IT WORKS:
+ * Bounded lock-free MPMC ring buffer (Vyukov design). Every cell carries
+ * a sequence number that says whose turn it is: a producer may write a
+ * cell when sequence == position, a consumer may read it when
+ * sequence == position + 1. Producers and consumers claim positions with
+ * one CAS on their own index; the two indices live on separate cache
+ * lines so producers and consumers don't invalidate each other.
+ *
+ * Blocking calls spin briefly, then park the thread on a futex (Linux)
+ * or std::atomic::wait (elsewhere). The fast path never takes a lock,
+ * and a producer only makes a wake-up syscall when a consumer is parked.
+ *
+ * Bulk calls claim a whole run of cells with a single CAS and wake
+ * sleepers once per batch, so draining thousands of small events costs
+ * a handful of atomics instead of a few per item.
+ *
  * EXAMPLE:
- * ThreadSafeQueue<Event> queue;
- * queue.push(event);  // Producer
+ * ThreadSafeQueue<Event> queue;        // default capacity
+ * ThreadSafeQueue<Event> small(256);   // rounded up to a power of two
+ * queue.push(event);  // Producer (blocks while full)
  * auto event = queue.pop();  // Consumer (blocks until available)
+ *
+ * queue.push_bulk(batch.begin(), batch.end());
+ * auto events = queue.pop_bulk(512, std::chrono::milliseconds(10));
  */
 
 #pragma once
 
-#include <queue>
-#include <mutex>
-#include <condition_variable>
-#include <optional>
+#include <algorithm>
+#include <atomic>
 #include <chrono>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <iterator>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(__linux__)
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 namespace dfs::events {
 
+namespace detail {
+
+// Fixed instead of std::hardware_destructive_interference_size, which
+// GCC warns about when used in headers (ABI can change with -mtune)
+inline constexpr std::size_t kCacheLineSize = 64;
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#elif defined(__aarch64__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::this_thread::yield();
+#endif
+}
+
+/**
+ * @brief Sleep while word == expected, up to timeout (if given)
+ *
+ * May return spuriously; callers re-check their condition.
+ */
+inline void park(std::atomic<std::uint32_t>& word, std::uint32_t expected,
+                 std::optional<std::chrono::nanoseconds> timeout) {
+#if defined(__linux__)
+    static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(std::uint32_t));
+    timespec ts{};
+    timespec* ts_ptr = nullptr;
+    if (timeout) {
+        auto ns = std::max<std::int64_t>(0, timeout->count());
+        ts.tv_sec = static_cast<time_t>(ns / 1'000'000'000);
+        ts.tv_nsec = static_cast<long>(ns % 1'000'000'000);
+        ts_ptr = &ts;
+    }
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAIT_PRIVATE, expected, ts_ptr, nullptr, 0);
+#else
+    if (!timeout) {
+        word.wait(expected, std::memory_order_acquire);
+    } else {
+        // std::atomic::wait has no timeout; poll with a short sleep
+        std::this_thread::sleep_for(
+            std::min<std::chrono::nanoseconds>(*timeout, std::chrono::microseconds(200)));
+    }
+#endif
+}
+
+/**
+ * @brief Wake up to count threads parked on word
+ */
+inline void unpark(std::atomic<std::uint32_t>& word, int count) {
+#if defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word),
+            FUTEX_WAKE_PRIVATE, count, nullptr, nullptr, 0);
+#else
+    if (count == 1) {
+        word.notify_one();
+    } else {
+        word.notify_all();
+    }
+#endif
+}
+
+/**
+ * @brief Lets threads sleep until "something changed" without a lock
+ *
+ * Waiter:   e = prepare_wait(); re-check condition; wait(e) or cancel_wait()
+ * Notifier: make the change; notify_one()
+ *
+ * notify_one() is a fence and a load when nobody sleeps. While a wake-up
+ * is in flight further notifies skip the syscall, so a burst of pushes
+ * to a sleeping consumer costs one futex wake, not one per item.
+ */
+class EventCount {
+public:
+    std::uint32_t prepare_wait() {
+        waiters_.fetch_add(1, std::memory_order_seq_cst);
+        const std::uint32_t epoch = epoch_.load(std::memory_order_seq_cst);
+        // Cleared after reading the epoch: any notifier that sets the flag
+        // from here on also bumps the epoch past the value we sleep on
+        wake_pending_.store(false, std::memory_order_seq_cst);
+        return epoch;
+    }
+
+    void cancel_wait() {
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void wait(std::uint32_t epoch, std::optional<std::chrono::nanoseconds> timeout) {
+        park(epoch_, epoch, timeout);
+        wake_pending_.store(false, std::memory_order_relaxed);
+        waiters_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void notify_one() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (waiters_.load(std::memory_order_relaxed) == 0) {
+            return;
+        }
+        if (wake_pending_.exchange(true, std::memory_order_seq_cst)) {
+            return;  // A woken thread hasn't run yet
+        }
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        unpark(epoch_, 1);
+    }
+
+    void notify_all() {
+        epoch_.fetch_add(1, std::memory_order_seq_cst);
+        unpark(epoch_, INT_MAX);
+    }
+
+    bool has_waiters() const {
+        return waiters_.load(std::memory_order_relaxed) > 0;
+    }
+
+private:
+    std::atomic<std::uint32_t> epoch_{0};
+    std::atomic<std::uint32_t> waiters_{0};
+    std::atomic<bool> wake_pending_{false};
+};
+
+} // namespace detail
+
 /**
- * @brief Thread-safe FIFO queue
+ * @brief Thread-safe bounded FIFO queue
  *
  * THREAD SAFETY:
  * - Multiple producers can push concurrently
  * - Multiple consumers can pop concurrently
- * - Uses condition variable for blocking wait
+ * - No locks; blocking calls spin, then park on a futex
+ *
+ * CAPACITY:
+ * Fixed at construction (rounded up to a power of two). push() blocks
+ * while the queue is full; try_push() fails instead.
+ *
+ * ORDERING:
+ * FIFO with respect to the order in which pushes claim a position.
  */
 template<typename T>
 class ThreadSafeQueue {
 public:
-    ThreadSafeQueue() = default;
+    static constexpr std::size_t kDefaultCapacity = 4096;
+
+    explicit ThreadSafeQueue(std::size_t capacity = kDefaultCapacity)
+        : capacity_(round_up_pow2(capacity < 2 ? 2 : capacity)),
+          mask_(capacity_ - 1),
+          cells_(std::make_unique<Cell[]>(capacity_)) {
+        for (std::size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~ThreadSafeQueue() {
+        // Destroy items still in the queue
+        while (try_pop()) {
+        }
+    }
 
     // Non-copyable
     ThreadSafeQueue(const ThreadSafeQueue&) = delete;
@@ -42,15 +222,96 @@ public:
     /**
      * @brief Push item to queue
      *
+     * RETURNS: true once queued; false if shutdown() is called while the
+     *          queue is full (item is dropped)
      * THREAD SAFE: Yes
-     * BLOCKS: No
+     * BLOCKS: Only while the queue is full
+     */
+    bool push(T item) {
+        for (int spin = 0;; ++spin) {
+            if (enqueue(item)) {
+                not_empty_.notify_one();
+                return true;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            if (spin < spin_limit()) {
+                detail::cpu_relax();
+                continue;
+            }
+
+            // Park until a consumer frees a cell
+            const std::uint32_t epoch = not_full_.prepare_wait();
+            if (enqueue(item)) {
+                not_full_.cancel_wait();
+                not_empty_.notify_one();
+                return true;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                not_full_.cancel_wait();
+                return false;
+            }
+            not_full_.wait(epoch, std::nullopt);
+        }
+    }
+
+    /**
+     * @brief Push a batch of items (moved from [first, last))
+     *
+     * Claims as many free cells as possible per CAS and wakes consumers
+     * once per claimed run rather than once per item.
+     *
+     * RETURNS: Number of items queued; less than the batch size only if
+     *          shutdown() is called while the queue is full
+     * THREAD SAFE: Yes
+     * BLOCKS: Only while the queue is full
+     */
+    template<typename ForwardIt>
+    size_t push_bulk(ForwardIt first, ForwardIt last) {
+        size_t pushed = 0;
+        for (int spin = 0; first != last; ++spin) {
+            if (size_t n = enqueue_bulk(first, last)) {
+                pushed += n;
+                not_empty_.notify_one();
+                spin = 0;
+                continue;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                break;
+            }
+            if (spin < spin_limit()) {
+                detail::cpu_relax();
+                continue;
+            }
+
+            const std::uint32_t epoch = not_full_.prepare_wait();
+            if (size_t n = enqueue_bulk(first, last)) {
+                not_full_.cancel_wait();
+                pushed += n;
+                not_empty_.notify_one();
+                continue;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                not_full_.cancel_wait();
+                break;
+            }
+            not_full_.wait(epoch, std::nullopt);
+        }
+        return pushed;
+    }
+
+    /**
+     * @brief Try to push item (non-blocking)
+     *
+     * RETURNS: false if the queue is full (item is left untouched)
      */
-    void push(T item) {
-        {
-            std::unique_lock lock(mutex_);
-            queue_.push(std::move(item));
+    bool try_push(T& item) {
+        if (!enqueue(item)) {
+            return false;
         }
-        cv_.notify_one();  // Wake up one waiting consumer
+        not_empty_.notify_one();
+        return true;
     }
 
     /**
@@ -61,39 +322,23 @@ public:
      * BLOCKS: No
      */
     std::optional<T> try_pop() {
-        std::unique_lock lock(mutex_);
-
-        if (queue_.empty()) {
-            return std::nullopt;
+        std::optional<T> item = dequeue();
+        if (item) {
+            not_full_.notify_one();
         }
-
-        T item = std::move(queue_.front());
-        queue_.pop();
         return item;
     }
 
     /**
      * @brief Pop item (blocking)
      *
-     * RETURNS: Item (waits until available)
+     * RETURNS: Item (waits until available); nullopt after shutdown
+     *          once the queue is drained
      * THREAD SAFE: Yes
      * BLOCKS: Yes, until item available or shutdown
      */
     std::optional<T> pop() {
-        std::unique_lock lock(mutex_);
-
-        // Wait until item available or shutting down
-        cv_.wait(lock, [this]() {
-            return !queue_.empty() || shutdown_;
-        });
-
-        if (shutdown_ && queue_.empty()) {
-            return std::nullopt;
-        }
-
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+        return pop_wait([this]() { return try_pop(); }, std::nullopt);
     }
 
     /**
@@ -105,63 +350,323 @@ public:
      */
     template<typename Rep, typename Period>
     std::optional<T> pop_for(const std::chrono::duration<Rep, Period>& timeout) {
-        std::unique_lock lock(mutex_);
+        return pop_wait([this]() { return try_pop(); }, deadline_after(timeout));
+    }
 
-        if (!cv_.wait_for(lock, timeout, [this]() {
-            return !queue_.empty() || shutdown_;
-        })) {
-            return std::nullopt;  // Timeout
-        }
+    /**
+     * @brief Pop up to max_items in one go
+     *
+     * Waits up to timeout for the first item, then takes whatever is
+     * already queued (up to max_items) without waiting further.
+     *
+     * RETURNS: Items in FIFO order; empty on timeout or shutdown
+     * THREAD SAFE: Yes
+     * BLOCKS: Yes, up to timeout duration
+     */
+    template<typename Rep, typename Period>
+    std::vector<T> pop_bulk(size_t max_items, const std::chrono::duration<Rep, Period>& timeout) {
+        std::vector<T> items;
+        pop_bulk(items, max_items, timeout);
+        return items;
+    }
 
-        if (shutdown_ && queue_.empty()) {
-            return std::nullopt;
+    /**
+     * @brief Pop up to max_items, appending to out
+     *
+     * Lets a consumer loop reuse one vector's capacity between batches.
+     *
+     * RETURNS: Number of items appended
+     */
+    template<typename Rep, typename Period>
+    size_t pop_bulk(std::vector<T>& out, size_t max_items,
+                    const std::chrono::duration<Rep, Period>& timeout) {
+        if (max_items == 0) {
+            return 0;
         }
+        return pop_wait([this, &out, max_items]() { return try_pop_bulk(out, max_items); },
+                        deadline_after(timeout));
+    }
 
-        T item = std::move(queue_.front());
-        queue_.pop();
-        return item;
+    /**
+     * @brief Pop up to max_items that are already queued (non-blocking)
+     *
+     * RETURNS: Number of items appended to out
+     */
+    size_t try_pop_bulk(std::vector<T>& out, size_t max_items) {
+        size_t popped = 0;
+        while (popped < max_items) {
+            size_t n = dequeue_bulk(out, max_items - popped);
+            if (n == 0) {
+                break;
+            }
+            popped += n;
+        }
+        if (popped > 0) {
+            not_full_.notify_one();
+        }
+        return popped;
     }
 
     /**
      * @brief Get queue size
+     *
+     * Lock-free snapshot; may be stale by the time it returns.
      */
     size_t size() const {
-        std::unique_lock lock(mutex_);
-        return queue_.size();
+        const std::size_t head = dequeue_pos_.value.load(std::memory_order_acquire);
+        const std::size_t tail = enqueue_pos_.value.load(std::memory_order_acquire);
+        return tail > head ? std::min(tail - head, capacity_) : 0;
     }
 
     /**
      * @brief Check if queue is empty
      */
     bool empty() const {
-        std::unique_lock lock(mutex_);
-        return queue_.empty();
+        return size() == 0;
+    }
+
+    /**
+     * @brief Maximum number of queued items
+     */
+    size_t capacity() const {
+        return capacity_;
     }
 
     /**
      * @brief Signal shutdown (wake up all waiting threads)
      */
     void shutdown() {
-        {
-            std::unique_lock lock(mutex_);
-            shutdown_ = true;
-        }
-        cv_.notify_all();
+        shutdown_.store(true, std::memory_order_seq_cst);
+        not_empty_.notify_all();
+        not_full_.notify_all();
     }
 
     /**
      * @brief Reset shutdown flag
      */
     void reset() {
-        std::unique_lock lock(mutex_);
-        shutdown_ = false;
+        shutdown_.store(false, std::memory_order_seq_cst);
     }
 
 private:
-    std::queue<T> queue_;
-    mutable std::mutex mutex_;
-    std::condition_variable cv_;
-    bool shutdown_ = false;
+    // Spinning only pays off when the other side can run at the same time
+    static int spin_limit() {
+        static const int limit = std::thread::hardware_concurrency() > 1 ? 64 : 0;
+        return limit;
+    }
+
+    struct Cell {
+        std::atomic<std::size_t> sequence{0};
+        alignas(T) unsigned char storage[sizeof(T)];
+
+        T* item() {
+            return std::launder(reinterpret_cast<T*>(storage));
+        }
+    };
+
+    struct alignas(detail::kCacheLineSize) PaddedIndex {
+        std::atomic<std::size_t> value{0};
+    };
+
+    static std::size_t round_up_pow2(std::size_t n) {
+        std::size_t p = 1;
+        while (p < n) {
+            p <<= 1;
+        }
+        return p;
+    }
+
+    // Claims a cell and moves item into it. item is untouched on failure.
+    bool enqueue(T& item) {
+        std::size_t pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos_.value.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Full
+            } else {
+                pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        ::new (static_cast<void*>(cell->storage)) T(std::move(item));
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Claims the longest run of free cells (up to the batch) with one CAS
+    template<typename ForwardIt>
+    size_t enqueue_bulk(ForwardIt& first, ForwardIt last) {
+        const size_t wanted = static_cast<size_t>(std::distance(first, last));
+        std::size_t pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+        size_t n = 0;
+        for (;;) {
+            n = 0;
+            std::intptr_t head_diff = 0;
+            while (n < wanted && n < capacity_) {
+                const std::size_t seq = cells_[(pos + n) & mask_].sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + n);
+                if (n == 0) {
+                    head_diff = diff;
+                }
+                if (diff != 0) {
+                    break;
+                }
+                ++n;
+            }
+            if (n == 0) {
+                if (head_diff < 0) {
+                    return 0;  // Full
+                }
+                pos = enqueue_pos_.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (enqueue_pos_.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        for (size_t i = 0; i < n; ++i, ++first) {
+            Cell& cell = cells_[(pos + i) & mask_];
+            ::new (static_cast<void*>(cell.storage)) T(std::move(*first));
+            cell.sequence.store(pos + i + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    // Claims the longest run of filled cells (up to max_items) with one CAS
+    size_t dequeue_bulk(std::vector<T>& out, size_t max_items) {
+        std::size_t pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+        size_t n = 0;
+        for (;;) {
+            n = 0;
+            std::intptr_t head_diff = 0;
+            while (n < max_items && n < capacity_) {
+                const std::size_t seq = cells_[(pos + n) & mask_].sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + n + 1);
+                if (n == 0) {
+                    head_diff = diff;
+                }
+                if (diff != 0) {
+                    break;
+                }
+                ++n;
+            }
+            if (n == 0) {
+                if (head_diff < 0) {
+                    return 0;  // Empty
+                }
+                pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+                continue;
+            }
+            if (dequeue_pos_.value.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed)) {
+                break;
+            }
+        }
+
+        out.reserve(out.size() + n);
+        for (size_t i = 0; i < n; ++i) {
+            Cell& cell = cells_[(pos + i) & mask_];
+            out.push_back(std::move(*cell.item()));
+            cell.item()->~T();
+            cell.sequence.store(pos + i + mask_ + 1, std::memory_order_release);
+        }
+        return n;
+    }
+
+    std::optional<T> dequeue() {
+        std::size_t pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+        Cell* cell = nullptr;
+        for (;;) {
+            cell = &cells_[pos & mask_];
+            const std::size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos_.value.compare_exchange_weak(
+                        pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return std::nullopt;  // Empty
+            } else {
+                pos = dequeue_pos_.value.load(std::memory_order_relaxed);
+            }
+        }
+
+        std::optional<T> item(std::move(*cell->item()));
+        cell->item()->~T();
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return item;
+    }
+
+    template<typename Rep, typename Period>
+    static std::chrono::steady_clock::time_point deadline_after(
+        const std::chrono::duration<Rep, Period>& timeout) {
+        return std::chrono::steady_clock::now() +
+               std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout);
+    }
+
+    // Shared wait loop for pop/pop_for/pop_bulk. try_take() returns an
+    // optional or a count; a value-initialized result means "nothing".
+    template<typename TryTake>
+    auto pop_wait(TryTake try_take, std::optional<std::chrono::steady_clock::time_point> deadline)
+        -> decltype(try_take()) {
+        for (int spin = 0; spin < spin_limit(); ++spin) {
+            if (auto item = try_take()) {
+                return item;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                break;
+            }
+            detail::cpu_relax();
+        }
+
+        for (bool woken = false;; woken = true) {
+            const std::uint32_t epoch = not_empty_.prepare_wait();
+
+            if (auto item = try_take()) {
+                not_empty_.cancel_wait();
+                if (woken && !empty()) {
+                    not_empty_.notify_one();  // Pass the wake-up on
+                }
+                return item;
+            }
+            if (shutdown_.load(std::memory_order_acquire)) {
+                not_empty_.cancel_wait();
+                return try_take();
+            }
+
+            std::optional<std::chrono::nanoseconds> remaining;
+            if (deadline) {
+                remaining = *deadline - std::chrono::steady_clock::now();
+                if (remaining->count() <= 0) {
+                    not_empty_.cancel_wait();
+                    return {};  // Timeout
+                }
+            }
+            not_empty_.wait(epoch, remaining);
+        }
+    }
+
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Producer and consumer indices on separate cache lines
+    PaddedIndex enqueue_pos_;
+    PaddedIndex dequeue_pos_;
+
+    // Parking state (written only when a thread has to sleep)
+    alignas(detail::kCacheLineSize) detail::EventCount not_empty_;
+    detail::EventCount not_full_;
+    std::atomic<bool> shutdown_{false};
 };
 
 } // namespace dfs::events
@@ -230,12 +230,21 @@ struct FileUploadStartedEvent {
     std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
 };
 
+/**
+ * @brief Upload progress for one file
+ *
+ * May stand for several chunks when emitted through
+ * ChunkProgressCoalescer: chunk_index is then the latest chunk,
+ * bytes_received the sum over all merged chunks and chunks_merged their
+ * count. Summing bytes_received across events stays correct either way.
+ */
 struct FileChunkReceivedEvent {
     std::string session_id;
     std::string file_path;
     std::uint32_t chunk_index;
     std::uint32_t total_chunks;
     std::size_t bytes_received;
+    std::uint32_t chunks_merged{1};
     std::chrono::system_clock::time_point timestamp{std::chrono::system_clock::now()};
 };
 
@@ -0,0 +1,225 @@
+/**
+ * @file journal.hpp
+ * @brief Durable append-only event journal with replay
+ *
+ * WHY THIS FILE EXISTS:
+ * Events are fire-and-forget. If the server restarts, subscribers such
+ * as SyncComponent lose everything they had queued. A journal records
+ * every event so state can be rebuilt by replaying it, and so past
+ * activity can be analysed offline without rerunning syncs.
+ *
+ * WHAT IT DOES:
+ * - EventCodec: compact binary encoding of every event in events.hpp
+ * - EventJournal: appends encoded events to segmented, memory-mapped
+ *   log files and fsyncs them in batches
+ * - replay(): streams events back from any offset
+ * - attach(): subscribes the journal to every event type on a bus
+ *
+ * ON-DISK FORMAT:
+ * <directory>/<base offset, 20 digits>.log
+ *   [magic "DFSJRNL1": 8 bytes][base_offset: 8 bytes LE]
+ *   repeated records:
+ *     [payload_length: 4 bytes LE][crc32(payload): 4 bytes LE][payload]
+ *   payload = [event type: 1 byte][fields...]
+ *   Integers are LEB128 varints (signed ones zigzag-encoded), strings
+ *   are varint length + bytes, timestamps are nanoseconds since epoch.
+ *
+ * Offsets are record numbers, not byte positions: the first event ever
+ * written is offset 0, the next is 1, and so on across segments.
+ *
+ * DURABILITY:
+ * Segments are preallocated and mapped; append() is a memcpy into the
+ * mapping. Dirty pages are msync'ed every fsync_every_records records
+ * or once fsync_interval has passed since the last sync (checked on
+ * append - there is no background thread), on sync(), on segment roll
+ * and on close. After a crash, recovery stops at the first record with
+ * a zero length or bad checksum, so a torn write loses only that record.
+ *
+ * EXAMPLE:
+ * auto opened = EventJournal::open({"/var/lib/dfs/journal"});
+ * auto journal = std::move(opened.value());
+ * journal->attach(bus);              // Every emitted event is recorded
+ * ...
+ * // After restart: rebuild SyncComponent's queue
+ * SyncComponent sync(bus);
+ * journal->replay_into(bus, 0);
+ */
+
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/events/event_bus.hpp"
+#include "dfs/events/events.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace dfs::events {
+
+/**
+ * @brief Any event the journal can store
+ *
+ * The variant index (plus one) is the type byte on disk, so new event
+ * types must only ever be appended to the end of this list.
+ */
+using JournalEvent = std::variant<
+    FileAddedEvent,
+    FileModifiedEvent,
+    FileDeletedEvent,
+    ServerStartedEvent,
+    ServerShuttingDownEvent,
+    SyncStartedEvent,
+    SyncCompletedEvent,
+    SyncFailedEvent,
+    FileUploadStartedEvent,
+    FileChunkReceivedEvent,
+    FileUploadCompletedEvent,
+    FileDownloadCompletedEvent,
+    FileConflictDetectedEvent,
+    FileConflictResolvedEvent
+>;
+
+/**
+ * @brief Binary encoder/decoder for journal payloads
+ *
+ * Stateless utility, like metadata::Serializer.
+ */
+class EventCodec {
+public:
+    /**
+     * @brief Append the encoding of event to out
+     */
+    static void encode(const JournalEvent& event, std::vector<std::uint8_t>& out);
+
+    /**
+     * @brief Decode one payload produced by encode()
+     *
+     * Returns an error for unknown type bytes, truncated data or
+     * trailing garbage.
+     */
+    static Result<JournalEvent> decode(const std::uint8_t* data, std::size_t size);
+};
+
+struct JournalOptions {
+    std::filesystem::path directory;
+    std::size_t segment_bytes = 64 * 1024 * 1024;   ///< Preallocated size per segment
+    std::size_t fsync_every_records = 256;          ///< Sync after this many appends...
+    std::chrono::milliseconds fsync_interval{50};   ///< ...or after this much time
+};
+
+/**
+ * @brief One event read back from the journal
+ */
+struct JournalRecord {
+    std::uint64_t offset;
+    JournalEvent event;
+};
+
+/**
+ * @brief Segmented, memory-mapped, append-only event log
+ *
+ * THREAD SAFETY:
+ * append(), sync() and replay() may be called from any thread. Appends
+ * are serialized by an internal mutex; replay() snapshots the journal
+ * end and reads without holding it, so it runs alongside appends.
+ *
+ * PLATFORM:
+ * Uses POSIX mmap/msync. open() returns an error on other platforms.
+ */
+class EventJournal {
+public:
+    /**
+     * @brief Open (or create) a journal directory and recover its tail
+     */
+    static Result<std::unique_ptr<EventJournal>> open(JournalOptions options);
+
+    ~EventJournal();
+
+    EventJournal(const EventJournal&) = delete;
+    EventJournal& operator=(const EventJournal&) = delete;
+
+    /**
+     * @brief Append one event
+     *
+     * RETURNS: Offset assigned to the event
+     */
+    Result<std::uint64_t> append(const JournalEvent& event);
+
+    /**
+     * @brief Subscribe to every journaled event type on bus
+     *
+     * Append errors are logged, not thrown, since they happen inside
+     * event handlers. detach() (or destroying the journal) unsubscribes,
+     * so the bus must outlive an attached journal.
+     */
+    void attach(EventBus& bus);
+    void detach();
+
+    /**
+     * @brief Flush all appended records to stable storage
+     */
+    Result<void> sync();
+
+    /**
+     * @brief Read events with offset >= from_offset, in order
+     *
+     * RETURNS: Number of events visited
+     */
+    Result<std::uint64_t> replay(std::uint64_t from_offset,
+                                 const std::function<void(const JournalRecord&)>& visitor) const;
+
+    /**
+     * @brief Re-emit journaled events on bus (e.g. to rebuild components)
+     *
+     * Call before attach() on the same bus, or the replayed events are
+     * journaled a second time.
+     */
+    Result<std::uint64_t> replay_into(EventBus& bus, std::uint64_t from_offset) const;
+
+    /**
+     * @brief Offset the next append will get
+     */
+    std::uint64_t next_offset() const;
+
+    /**
+     * @brief Oldest offset still on disk
+     */
+    std::uint64_t first_offset() const;
+
+    /**
+     * @brief Number of segment files
+     */
+    std::size_t segment_count() const;
+
+private:
+    struct Segment;
+
+    explicit EventJournal(JournalOptions options);
+
+    Result<void> recover();
+    Result<void> open_active(std::uint64_t base_offset, std::size_t min_capacity);
+    Result<void> close_active();
+    Result<void> sync_locked();
+
+    JournalOptions options_;
+
+    mutable std::mutex mutex_;
+    std::vector<std::uint64_t> segment_bases_;   // Sorted; last one is active
+    std::unique_ptr<Segment> active_;
+    std::uint64_t next_offset_ = 0;
+    std::size_t unsynced_records_ = 0;
+    std::chrono::steady_clock::time_point last_sync_;
+    std::vector<std::uint8_t> scratch_;           // Reused encode buffer
+
+    std::vector<std::function<void()>> unsubscribers_;
+};
+
+} // namespace dfs::events
@@ -0,0 +1,390 @@
+/**
+ * @file metrics.hpp
+ * @brief Contention-free counters and HDR-style histograms
+ *
+ * WHY THIS FILE EXISTS:
+ * A plain std::atomic<uint64_t> counter bumped from every worker thread
+ * bounces one cache line between all cores on every increment. And a
+ * counter alone can't answer "how slow is the slowest 1% of uploads?".
+ *
+ * WHAT IT DOES:
+ * - ShardedCounter: one padded atomic per shard; each thread writes its
+ *   own shard, readers sum them all
+ * - HdrHistogram: log-linear buckets (fixed relative error, like
+ *   HdrHistogram) with p50/p99/p999 queries that run while writers keep
+ *   recording
+ *
+ * HOW SHARDING WORKS:
+ * Every thread gets a small sequential id the first time it records
+ * anything (thread_local). The id modulo the shard count picks the
+ * shard, so with up to kShards writer threads no two share a cache line.
+ * More threads than shards just share - still correct, only slower.
+ *
+ * EXAMPLE:
+ * ShardedCounter requests;
+ * requests++;                          // From any thread
+ * uint64_t total = requests.load();    // Sum over shards
+ *
+ * HdrHistogram latency_us;
+ * latency_us.record(420);
+ * auto snap = latency_us.snapshot();   // snap.p99, snap.p999, ...
+ */
+
+#pragma once
+
+#include "dfs/events/event_queue.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+
+namespace dfs::events {
+
+namespace detail {
+
+/**
+ * @brief Small per-thread id used to pick a shard
+ */
+inline std::size_t metrics_thread_id() noexcept {
+    static std::atomic<std::size_t> next{0};
+    thread_local const std::size_t id = next.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+} // namespace detail
+
+// ════════════════════════════════════════════════════════
+// ShardedCounter
+// ════════════════════════════════════════════════════════
+
+/**
+ * @brief Monotonic counter split across cache-line-sized shards
+ *
+ * Drop-in for the std::atomic<uint64_t> counters it replaces: supports
+ * ++, += and load(). Writes are relaxed; load() is a relaxed sum, so a
+ * concurrent reader sees some value between the totals before and after
+ * the in-flight increments.
+ *
+ * THREAD SAFETY:
+ * All methods are safe from any thread. reset() racing with writers may
+ * lose those writers' increments.
+ */
+class ShardedCounter {
+public:
+    static constexpr std::size_t kShards = 16;
+
+    ShardedCounter() = default;
+    ShardedCounter(const ShardedCounter&) = delete;
+    ShardedCounter& operator=(const ShardedCounter&) = delete;
+
+    void add(std::uint64_t n = 1) noexcept {
+        shards_[detail::metrics_thread_id() % kShards].value.fetch_add(n, std::memory_order_relaxed);
+    }
+
+    ShardedCounter& operator++() noexcept {
+        add(1);
+        return *this;
+    }
+
+    void operator++(int) noexcept {
+        add(1);
+    }
+
+    ShardedCounter& operator+=(std::uint64_t n) noexcept {
+        add(n);
+        return *this;
+    }
+
+    std::uint64_t load() const noexcept {
+        std::uint64_t total = 0;
+        for (const auto& shard : shards_) {
+            total += shard.value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    void reset() noexcept {
+        for (auto& shard : shards_) {
+            shard.value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    struct alignas(detail::kCacheLineSize) Shard {
+        std::atomic<std::uint64_t> value{0};
+    };
+
+    std::array<Shard, kShards> shards_{};
+};
+
+// ════════════════════════════════════════════════════════
+// HdrHistogram
+// ════════════════════════════════════════════════════════
+
+/**
+ * @brief Point-in-time summary of a histogram
+ *
+ * Percentiles are the highest value equivalent to the bucket they fall
+ * in (capped at max), so they never under-report.
+ */
+struct HistogramSnapshot {
+    std::uint64_t count = 0;
+    std::uint64_t min = 0;
+    std::uint64_t max = 0;
+    double mean = 0.0;
+    std::uint64_t p50 = 0;
+    std::uint64_t p90 = 0;
+    std::uint64_t p99 = 0;
+    std::uint64_t p999 = 0;
+};
+
+/**
+ * @brief Log-linear histogram of non-negative integer values
+ *
+ * HOW IT WORKS:
+ * Values below 2^kSubBucketBits each get their own bucket. Above that,
+ * every power-of-two range [2^k, 2^(k+1)) is split into
+ * 2^(kSubBucketBits-1) equal sub-buckets, so any recorded value is off
+ * by at most 1/64 (~1.6%) of itself - two significant digits, from one
+ * microsecond to days. Values at or above 2^kMaxValueBits are clamped.
+ *
+ * The unit is whatever the caller records (ms, us, bytes); a histogram
+ * should stick to one.
+ *
+ * Buckets are sharded like ShardedCounter, because latencies cluster:
+ * most writers would otherwise hit the same bucket's cache line.
+ *
+ * THREAD SAFETY:
+ * record() is wait-free (relaxed increments plus a rarely taken CAS for
+ * min/max). percentile()/snapshot() read the buckets without locks and
+ * never block writers; a read during heavy recording reflects a mix of
+ * before/after states, which is fine for monitoring.
+ */
+class HdrHistogram {
+public:
+    static constexpr unsigned kSubBucketBits = 7;
+    static constexpr unsigned kMaxValueBits = 40;
+    static constexpr std::size_t kSubBucketCount = std::size_t{1} << kSubBucketBits;
+    static constexpr std::size_t kSubBucketHalf = kSubBucketCount / 2;
+    static constexpr std::size_t kBucketCount =
+        kSubBucketCount + (kMaxValueBits - kSubBucketBits) * kSubBucketHalf;
+    static constexpr std::uint64_t kMaxValue = (std::uint64_t{1} << kMaxValueBits) - 1;
+    static constexpr std::size_t kShards = 4;
+
+    HdrHistogram() : shards_(std::make_unique<Shard[]>(kShards)) {}
+
+    HdrHistogram(const HdrHistogram&) = delete;
+    HdrHistogram& operator=(const HdrHistogram&) = delete;
+
+    /**
+     * @brief Record value, count times
+     */
+    void record(std::uint64_t value, std::uint64_t count = 1) noexcept {
+        if (count == 0) {
+            return;
+        }
+        value = std::min(value, kMaxValue);
+
+        auto& shard = shards_[detail::metrics_thread_id() % kShards];
+        shard.buckets[bucket_index(value)].fetch_add(count, std::memory_order_relaxed);
+        total_count_ += count;
+        total_sum_ += value * count;
+
+        update_min(value);
+        update_max(value);
+    }
+
+    /**
+     * @brief Number of recorded values
+     */
+    std::uint64_t count() const noexcept {
+        return total_count_.load();
+    }
+
+    std::uint64_t min() const noexcept {
+        std::uint64_t v = min_.load(std::memory_order_relaxed);
+        return v == std::numeric_limits<std::uint64_t>::max() ? 0 : v;
+    }
+
+    std::uint64_t max() const noexcept {
+        return max_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Sum of recorded values (clamped values count as kMaxValue)
+     */
+    std::uint64_t sum() const noexcept {
+        return total_sum_.load();
+    }
+
+    double mean() const noexcept {
+        std::uint64_t n = count();
+        return n == 0 ? 0.0 : static_cast<double>(sum()) / static_cast<double>(n);
+    }
+
+    /**
+     * @brief Value at percentile (0-100)
+     *
+     * RETURNS: 0 if nothing has been recorded
+     */
+    std::uint64_t percentile(double percent) const noexcept {
+        std::array<double, 1> wanted{percent};
+        std::array<std::uint64_t, 1> out{};
+        percentiles(wanted.data(), out.data(), 1);
+        return out[0];
+    }
+
+    /**
+     * @brief Count, min/max/mean and p50/p90/p99/p999 in one pass
+     */
+    HistogramSnapshot snapshot() const noexcept {
+        static constexpr std::array<double, 4> kPercents{50.0, 90.0, 99.0, 99.9};
+        std::array<std::uint64_t, 4> values{};
+        std::uint64_t n = percentiles(kPercents.data(), values.data(), kPercents.size());
+
+        HistogramSnapshot snap;
+        snap.count = n;
+        snap.min = min();
+        snap.max = max();
+        snap.mean = mean();
+        snap.p50 = values[0];
+        snap.p90 = values[1];
+        snap.p99 = values[2];
+        snap.p999 = values[3];
+        return snap;
+    }
+
+    /**
+     * @brief Visit every non-empty bucket in ascending value order
+     *
+     * visitor(highest_equivalent_value, count) - e.g. to export buckets.
+     */
+    template<typename Visitor>
+    void for_each_bucket(Visitor&& visitor) const {
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            std::uint64_t n = bucket_count(i);
+            if (n != 0) {
+                visitor(highest_equivalent(i), n);
+            }
+        }
+    }
+
+    void reset() noexcept {
+        for (std::size_t s = 0; s < kShards; ++s) {
+            for (auto& bucket : shards_[s].buckets) {
+                bucket.store(0, std::memory_order_relaxed);
+            }
+        }
+        total_count_.reset();
+        total_sum_.reset();
+        min_.store(std::numeric_limits<std::uint64_t>::max(), std::memory_order_relaxed);
+        max_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Bucket holding value
+     */
+    static constexpr std::size_t bucket_index(std::uint64_t value) noexcept {
+        unsigned bits = static_cast<unsigned>(std::bit_width(value));
+        if (bits <= kSubBucketBits) {
+            return static_cast<std::size_t>(value);
+        }
+        unsigned shift = bits - kSubBucketBits;
+        return kSubBucketCount + (shift - 1) * kSubBucketHalf +
+               static_cast<std::size_t>((value >> shift) - kSubBucketHalf);
+    }
+
+    /**
+     * @brief Largest value that lands in the same bucket as index
+     */
+    static constexpr std::uint64_t highest_equivalent(std::size_t index) noexcept {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        std::size_t rest = index - kSubBucketCount;
+        unsigned shift = static_cast<unsigned>(rest / kSubBucketHalf) + 1;
+        std::uint64_t sub = rest % kSubBucketHalf + kSubBucketHalf;
+        return ((sub + 1) << shift) - 1;
+    }
+
+private:
+    struct alignas(detail::kCacheLineSize) Shard {
+        std::array<std::atomic<std::uint64_t>, kBucketCount> buckets{};
+    };
+
+    std::uint64_t bucket_count(std::size_t index) const noexcept {
+        std::uint64_t n = 0;
+        for (std::size_t s = 0; s < kShards; ++s) {
+            n += shards_[s].buckets[index].load(std::memory_order_relaxed);
+        }
+        return n;
+    }
+
+    // percents must be ascending. Returns the total the ranks were taken
+    // from (summed from the buckets, so consistent with the result).
+    std::uint64_t percentiles(const double* percents, std::uint64_t* out, std::size_t n) const noexcept {
+        std::array<std::uint64_t, kBucketCount> counts;
+        std::uint64_t total = 0;
+        for (std::size_t i = 0; i < kBucketCount; ++i) {
+            counts[i] = bucket_count(i);
+            total += counts[i];
+        }
+        if (total == 0) {
+            std::fill(out, out + n, std::uint64_t{0});
+            return 0;
+        }
+
+        std::uint64_t cap = max();
+        std::uint64_t seen = 0;
+        std::size_t bucket = 0;
+        for (std::size_t k = 0; k < n; ++k) {
+            double clamped = std::clamp(percents[k], 0.0, 100.0);
+            auto rank = static_cast<std::uint64_t>(clamped / 100.0 * static_cast<double>(total) + 0.5);
+            rank = std::clamp<std::uint64_t>(rank, 1, total);
+            while (seen + counts[bucket] < rank) {
+                seen += counts[bucket];
+                ++bucket;
+            }
+            out[k] = std::min(highest_equivalent(bucket), std::max(cap, lowest_in(bucket)));
+        }
+        return total;
+    }
+
+    // The max_ update may trail the bucket increment; never report less
+    // than the bucket's own lower bound because of that.
+    static constexpr std::uint64_t lowest_in(std::size_t index) noexcept {
+        if (index < kSubBucketCount) {
+            return index;
+        }
+        std::size_t rest = index - kSubBucketCount;
+        unsigned shift = static_cast<unsigned>(rest / kSubBucketHalf) + 1;
+        return (rest % kSubBucketHalf + kSubBucketHalf) << shift;
+    }
+
+    void update_min(std::uint64_t value) noexcept {
+        std::uint64_t current = min_.load(std::memory_order_relaxed);
+        while (value < current &&
+               !min_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    void update_max(std::uint64_t value) noexcept {
+        std::uint64_t current = max_.load(std::memory_order_relaxed);
+        while (value > current &&
+               !max_.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::unique_ptr<Shard[]> shards_;
+    ShardedCounter total_count_;
+    ShardedCounter total_sum_;
+    std::atomic<std::uint64_t> min_{std::numeric_limits<std::uint64_t>::max()};
+    std::atomic<std::uint64_t> max_{0};
+};
+
+} // namespace dfs::events
@@ -0,0 +1,262 @@
+/**
+ * @file prometheus.hpp
+ * @brief Prometheus text-format exporter for counters, gauges and histograms
+ *
+ * WHY THIS FILE EXISTS:
+ * MetricsComponent::print_stats() only writes to the log. Monitoring
+ * wants to scrape numbers over HTTP, often every second, and a scrape
+ * must not cost more than the requests it is measuring.
+ *
+ * WHAT IT DOES:
+ * - Metrics are registered once at startup (name, help text, source)
+ * - Everything that doesn't change between scrapes - HELP/TYPE lines,
+ *   series names, bucket labels - is formatted at registration
+ * - render(out) clears out and appends the current values using
+ *   std::to_chars; once out has grown to the page size, a scrape does
+ *   no heap allocation at all
+ *
+ * OUTPUT (text exposition format 0.0.4):
+ * # HELP dfs_files_uploaded_total Files uploaded
+ * # TYPE dfs_files_uploaded_total counter
+ * dfs_files_uploaded_total 42
+ * # TYPE dfs_request_latency_microseconds histogram
+ * dfs_request_latency_microseconds_bucket{le="100"} 17
+ * ...
+ * dfs_request_latency_microseconds_bucket{le="+Inf"} 20
+ * dfs_request_latency_microseconds_sum 2310
+ * dfs_request_latency_microseconds_count 20
+ *
+ * EXAMPLE:
+ * PrometheusExporter exporter;
+ * add_metrics_component(exporter, metrics);
+ * exporter.add_gauge("dfs_http_active_connections", "Open connections",
+ *                    [&] { return double(server.get_active_connections()); });
+ *
+ * router.get("/metrics", [&](const HttpContext&) {
+ *     thread_local std::string page;
+ *     exporter.render(page);
+ *     ...
+ * });
+ */
+
+#pragma once
+
+#include "dfs/events/components.hpp"
+#include "dfs/events/metrics.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dfs::events {
+
+/**
+ * @brief Registry of metrics rendered in Prometheus text format
+ *
+ * THREAD SAFETY:
+ * Register everything before the first render(). After that, render()
+ * is const and may run on any number of threads at once (each with its
+ * own output buffer). Sources are read with relaxed loads, so rendering
+ * never blocks the threads updating them.
+ *
+ * The exporter keeps references to registered counters and histograms;
+ * they must outlive it.
+ */
+class PrometheusExporter {
+public:
+    using ValueFn = std::function<double()>;
+
+    static constexpr std::string_view kContentType = "text/plain; version=0.0.4; charset=utf-8";
+
+    /**
+     * @brief Bucket bounds start, start*factor, ... (count values)
+     */
+    static std::vector<std::uint64_t> exponential_bounds(std::uint64_t start, std::uint64_t factor,
+                                                         std::size_t count) {
+        std::vector<std::uint64_t> bounds;
+        bounds.reserve(count);
+        for (std::uint64_t b = start; bounds.size() < count; b *= factor) {
+            bounds.push_back(b);
+        }
+        return bounds;
+    }
+
+    void add_counter(std::string_view name, std::string_view help, const ShardedCounter& counter) {
+        Metric& m = add(Kind::Counter, name, help, "counter");
+        m.counter = &counter;
+    }
+
+    /**
+     * @brief Counter read through a callback (e.g. an existing atomic)
+     */
+    void add_counter(std::string_view name, std::string_view help, ValueFn value) {
+        Metric& m = add(Kind::CounterFn, name, help, "counter");
+        m.value = std::move(value);
+    }
+
+    void add_gauge(std::string_view name, std::string_view help, ValueFn value) {
+        Metric& m = add(Kind::Gauge, name, help, "gauge");
+        m.value = std::move(value);
+    }
+
+    /**
+     * @brief Export an HdrHistogram as a Prometheus histogram
+     *
+     * bounds are the upper bucket limits ("le"), ascending, in the
+     * histogram's own unit. Cumulative counts are derived from the HDR
+     * buckets, so a value within ~1.6% of a bound may land on either side.
+     */
+    void add_histogram(std::string_view name, std::string_view help, const HdrHistogram& histogram,
+                       std::vector<std::uint64_t> bounds) {
+        Metric& m = add(Kind::Histogram, name, help, "histogram");
+        m.histogram = &histogram;
+        m.bounds = std::move(bounds);
+
+        char digits[24];
+        for (std::uint64_t bound : m.bounds) {
+            auto end = std::to_chars(digits, digits + sizeof(digits), bound).ptr;
+            m.bucket_series.push_back(m.name + "_bucket{le=\"" + std::string(digits, end) + "\"} ");
+        }
+        m.bucket_series.push_back(m.name + "_bucket{le=\"+Inf\"} ");
+        m.sum_series = m.name + "_sum ";
+        m.count_series = m.name + "_count ";
+    }
+
+    /**
+     * @brief Replace out with the current exposition page
+     *
+     * Keeps out's capacity, so passing the same buffer every scrape
+     * avoids reallocating it.
+     */
+    void render(std::string& out) const {
+        out.clear();
+        for (const auto& m : metrics_) {
+            out += m.header;
+            switch (m.kind) {
+                case Kind::Counter:
+                    out += m.name;
+                    out += ' ';
+                    append_uint(out, m.counter->load());
+                    out += '\n';
+                    break;
+                case Kind::CounterFn:
+                case Kind::Gauge:
+                    out += m.name;
+                    out += ' ';
+                    append_double(out, m.value());
+                    out += '\n';
+                    break;
+                case Kind::Histogram:
+                    render_histogram(out, m);
+                    break;
+            }
+        }
+    }
+
+    std::size_t metric_count() const {
+        return metrics_.size();
+    }
+
+private:
+    enum class Kind { Counter, CounterFn, Gauge, Histogram };
+
+    struct Metric {
+        Kind kind;
+        std::string name;
+        std::string header;                       // "# HELP ...\n# TYPE ...\n"
+        const ShardedCounter* counter = nullptr;
+        ValueFn value;
+        const HdrHistogram* histogram = nullptr;
+        std::vector<std::uint64_t> bounds;
+        std::vector<std::string> bucket_series;   // One per bound, then +Inf
+        std::string sum_series;
+        std::string count_series;
+    };
+
+    Metric& add(Kind kind, std::string_view name, std::string_view help, std::string_view type) {
+        Metric& m = metrics_.emplace_back();
+        m.kind = kind;
+        m.name = std::string(name);
+        m.header.append("# HELP ").append(name).append(" ").append(help).append("\n");
+        m.header.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+        return m;
+    }
+
+    static void render_histogram(std::string& out, const Metric& m) {
+        // HDR buckets arrive in ascending order; every HDR bucket whose
+        // values are all <= bound counts towards that bound.
+        std::size_t next_bound = 0;
+        std::uint64_t cumulative = 0;
+        m.histogram->for_each_bucket([&](std::uint64_t highest, std::uint64_t n) {
+            while (next_bound < m.bounds.size() && highest > m.bounds[next_bound]) {
+                append_series(out, m.bucket_series[next_bound], cumulative);
+                ++next_bound;
+            }
+            cumulative += n;
+        });
+        for (; next_bound < m.bounds.size(); ++next_bound) {
+            append_series(out, m.bucket_series[next_bound], cumulative);
+        }
+        append_series(out, m.bucket_series.back(), cumulative);
+        append_series(out, m.sum_series, m.histogram->sum());
+        append_series(out, m.count_series, cumulative);
+    }
+
+    static void append_series(std::string& out, const std::string& series, std::uint64_t value) {
+        out += series;
+        append_uint(out, value);
+        out += '\n';
+    }
+
+    static void append_uint(std::string& out, std::uint64_t value) {
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        out.append(digits, end);
+    }
+
+    static void append_double(std::string& out, double value) {
+        char digits[32];
+        auto end = std::to_chars(digits, digits + sizeof(digits), value).ptr;
+        out.append(digits, end);
+    }
+
+    std::vector<Metric> metrics_;
+};
+
+/**
+ * @brief Register every MetricsComponent counter and histogram
+ *
+ * Names follow Prometheus conventions: prefix + "_total" for counters,
+ * the unit as a suffix for histograms.
+ */
+inline void add_metrics_component(PrometheusExporter& exporter, const MetricsComponent& metrics,
+                                  const std::string& prefix = "dfs") {
+    const auto& s = metrics.get_stats();
+    exporter.add_counter(prefix + "_files_added_total", "Files added", s.files_added);
+    exporter.add_counter(prefix + "_files_modified_total", "Files modified", s.files_modified);
+    exporter.add_counter(prefix + "_files_deleted_total", "Files deleted", s.files_deleted);
+    exporter.add_counter(prefix + "_bytes_added_total", "Bytes in added files", s.total_bytes_added);
+    exporter.add_counter(prefix + "_bytes_modified_total", "Bytes in modified files", s.total_bytes_modified);
+    exporter.add_counter(prefix + "_files_uploaded_total", "Files uploaded", s.files_uploaded);
+    exporter.add_counter(prefix + "_bytes_uploaded_total", "Bytes uploaded", s.bytes_uploaded);
+    exporter.add_counter(prefix + "_files_downloaded_total", "Files downloaded", s.files_downloaded);
+    exporter.add_counter(prefix + "_bytes_downloaded_total", "Bytes downloaded", s.bytes_downloaded);
+    exporter.add_counter(prefix + "_conflicts_detected_total", "Conflicts detected", s.conflicts_detected);
+    exporter.add_counter(prefix + "_conflicts_resolved_total", "Conflicts resolved", s.conflicts_resolved);
+
+    const auto& h = metrics.get_histograms();
+    exporter.add_histogram(prefix + "_upload_duration_milliseconds", "Upload duration",
+                           h.upload_duration_ms, PrometheusExporter::exponential_bounds(10, 4, 8));
+    exporter.add_histogram(prefix + "_sync_duration_milliseconds", "Sync session duration",
+                           h.sync_duration_ms, PrometheusExporter::exponential_bounds(10, 4, 8));
+    exporter.add_histogram(prefix + "_chunk_size_bytes", "Received chunk size",
+                           h.chunk_size_bytes, PrometheusExporter::exponential_bounds(1024, 4, 8));
+    exporter.add_histogram(prefix + "_request_latency_microseconds", "HTTP request handling time",
+                           h.request_latency_us, PrometheusExporter::exponential_bounds(50, 4, 9));
+}
+
+} // namespace dfs::events
@@ -0,0 +1,224 @@
+/**
+ * @file reader_epochs.hpp
+ * @brief Per-thread reader epochs for freeing copy-on-write handler lists
+ *
+ * WHY THIS FILE EXISTS:
+ * EventBus and StaticEventBus publish immutable handler lists through an
+ * atomic pointer and replace them on subscribe/unsubscribe. A replaced
+ * list may still be walked by a concurrent emit(), so it can only be
+ * freed once every such emit() has finished. Tracking readers with a
+ * shared counter puts an atomic read-modify-write on one contended cache
+ * line into every emit(); this file keeps the reader side to plain
+ * stores on a cache line the thread owns.
+ *
+ * HOW IT WORKS:
+ * - One global epoch counter, advanced by writers each time they
+ *   unpublish a list. Retired lists are stamped with the epoch value
+ *   returned by that advance.
+ * - Every thread that emits gets a ReaderRecord on its own cache line.
+ *   A read section stores the global epoch into it on entry and zero on
+ *   exit. Nested sections (a handler emitting) keep the outer value.
+ * - A writer frees retired lists stamped below the oldest epoch any
+ *   thread is currently reading in (all of them when nobody reads).
+ *
+ * The reader's epoch store must be visible before it loads the list
+ * pointer. Instead of a full fence in every emit(), the writer issues
+ * membarrier(MEMBARRIER_CMD_PRIVATE_EXPEDITED) before scanning, which
+ * acts as that fence on every running thread of the process; the
+ * reader only needs a compiler barrier. Where membarrier is missing
+ * (non-Linux, old kernels, ThreadSanitizer builds) readers fall back to
+ * std::atomic_thread_fence.
+ *
+ * Records are never freed: a thread's record is marked unused when the
+ * thread exits and handed to the next new thread.
+ *
+ * THREAD SAFETY:
+ * ReadSection is used by any thread. advance_epoch() may be called from any
+ * thread; safe_epoch() should be called by the owner of the retired
+ * lists while it holds its own writer lock.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#if defined(__linux__)
+#include <linux/membarrier.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace dfs::events::detail {
+
+/**
+ * @brief One thread's published read epoch (0 = not reading)
+ */
+struct alignas(64) ReaderRecord {
+    std::atomic<uint64_t> epoch{0};
+    std::atomic<bool> in_use{true};
+    ReaderRecord* next = nullptr;
+};
+
+/**
+ * @brief Process-wide state shared by every bus
+ *
+ * Constant-initialized so the emit() path needs no static guard.
+ */
+struct ReaderEpochs {
+    alignas(64) std::atomic<uint64_t> global_epoch{1};
+    alignas(64) std::atomic<ReaderRecord*> records{nullptr};
+    // Set once before any reader or writer relies on it; see init_fence()
+    std::atomic<bool> asymmetric_fence{false};
+};
+
+inline constinit ReaderEpochs reader_epochs{};
+
+/**
+ * @brief Decide once whether writers can fence for the readers
+ *
+ * Called on every thread's first read section and by every writer
+ * before scanning, so the flag is settled before anyone depends on it.
+ */
+inline bool init_fence() {
+    static const bool asymmetric = []() {
+        bool ok = false;
+#if defined(__linux__) && defined(SYS_membarrier) && \
+    !defined(__SANITIZE_THREAD__)
+        const long supported = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0);
+        ok = supported > 0 &&
+            (supported & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0 &&
+            syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0) == 0;
+#endif
+        reader_epochs.asymmetric_fence.store(ok, std::memory_order_relaxed);
+        return ok;
+    }();
+    return asymmetric;
+}
+
+/**
+ * @brief The calling thread's record and read-section nesting depth
+ *
+ * Trivially destructible so the thread_local needs no init guard; the
+ * record is released by a separate ReaderRelease object created on the
+ * thread's first read section.
+ */
+struct ThreadReader {
+    ReaderRecord* record = nullptr;
+    size_t depth = 0;
+};
+
+inline thread_local constinit ThreadReader thread_reader{};
+
+/**
+ * @brief Marks the thread's record unused when the thread exits
+ */
+struct ReaderRelease {
+    ~ReaderRelease() {
+        if (ReaderRecord* record = thread_reader.record) {
+            thread_reader.record = nullptr;
+            record->epoch.store(0, std::memory_order_release);
+            record->in_use.store(false, std::memory_order_release);
+        }
+    }
+};
+
+/**
+ * @brief Claim a free record or add a new one (first read on a thread)
+ */
+inline ReaderRecord& acquire_record() {
+    init_fence();
+    thread_local ReaderRelease release;
+    (void)release;
+
+    for (ReaderRecord* r = reader_epochs.records.load(std::memory_order_acquire); r; r = r->next) {
+        bool expected = false;
+        if (!r->in_use.load(std::memory_order_relaxed) &&
+            r->in_use.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            return *(thread_reader.record = r);
+        }
+    }
+    auto* fresh = new ReaderRecord();
+    fresh->next = reader_epochs.records.load(std::memory_order_relaxed);
+    while (!reader_epochs.records.compare_exchange_weak(fresh->next, fresh,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed)) {
+    }
+    return *(thread_reader.record = fresh);
+}
+
+/**
+ * @brief Marks the calling thread as reading for its lifetime
+ *
+ * Cost per section: a thread_local lookup, a load of the global epoch
+ * (read-mostly, stays cached) and two plain stores to the thread's own
+ * record. No read-modify-write and no shared cache line is written.
+ */
+class ReadSection {
+public:
+    ReadSection() {
+        ThreadReader& reader = thread_reader;
+        if (reader.depth++ != 0) {
+            return;  // Nested emit: the outer epoch already covers us
+        }
+        ReaderRecord& record = reader.record ? *reader.record : acquire_record();
+        // Acquire pairs with advance_epoch(): a reader that sees the new
+        // epoch also sees the list published before it
+        record.epoch.store(reader_epochs.global_epoch.load(std::memory_order_acquire),
+                           std::memory_order_relaxed);
+        if (reader_epochs.asymmetric_fence.load(std::memory_order_relaxed)) {
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        } else {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+    }
+
+    ~ReadSection() {
+        ThreadReader& reader = thread_reader;
+        if (--reader.depth == 0) {
+            reader.record->epoch.store(0, std::memory_order_release);
+        }
+    }
+
+    ReadSection(const ReadSection&) = delete;
+    ReadSection& operator=(const ReadSection&) = delete;
+};
+
+/**
+ * @brief Advance the epoch after unpublishing a list
+ *
+ * RETURNS: the stamp for the unpublished list
+ */
+inline uint64_t advance_epoch() {
+    return reader_epochs.global_epoch.fetch_add(1, std::memory_order_seq_cst);
+}
+
+/**
+ * @brief Lists stamped below this value can no longer be read
+ *
+ * Issues the writer side of the fence, then returns the oldest epoch
+ * any thread is reading in, or UINT64_MAX if no thread is reading.
+ */
+inline uint64_t safe_epoch() {
+#if defined(__linux__) && defined(SYS_membarrier)
+    if (init_fence()) {
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0);
+    } else {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+#else
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+
+    uint64_t oldest = UINT64_MAX;
+    for (ReaderRecord* r = reader_epochs.records.load(std::memory_order_acquire); r; r = r->next) {
+        const uint64_t epoch = r->epoch.load(std::memory_order_acquire);
+        if (epoch != 0 && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+    return oldest;
+}
+
+} // namespace dfs::events::detail
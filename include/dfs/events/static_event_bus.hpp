@@ -0,0 +1,370 @@
+/**
+ * @file static_event_bus.hpp
+ * @brief Event bus over a closed, compile-time list of event types
+ *
+ * WHY THIS FILE EXISTS:
+ * The events in events.hpp are a fixed set of structs, but EventBus still
+ * pays for full runtime type erasure: a type slot lookup, a virtual
+ * HandlerBase::call(const void*) and a cast back to the event type.
+ * When the set of events is known up front, all of that can be resolved
+ * by the compiler.
+ *
+ * WHAT IT DOES:
+ * - Takes the event types as a template parameter pack
+ * - Stores one handler list per event type in a std::tuple
+ * - emit<E>() picks the list with std::get at compile time and calls the
+ *   handlers directly - no type lookup, no virtual call, no void*
+ * - Same subscribe/unsubscribe/emit/subscriber_count/clear API as EventBus
+ * - Emitting or subscribing to a type outside the list is a compile error
+ *
+ * Handlers subscribed at runtime are still stored as std::function, so
+ * each call is an indirect one. When the subscribers are also known at
+ * compile time, StaticHandlerBus takes the handler types themselves as
+ * template parameters: emit<E>() expands to a direct call of every
+ * handler that accepts E, which the compiler can inline.
+ *
+ * WHEN TO USE WHICH:
+ * - EventBus: open set of events, async dispatch, plugins
+ * - StaticEventBus: hot paths with a known event set (synchronous only)
+ * - StaticHandlerBus: known event set and known subscribers
+ *
+ * EXAMPLE:
+ * StaticEventBus<FileAddedEvent, FileDeletedEvent> bus;
+ * bus.subscribe<FileAddedEvent>([](const FileAddedEvent& e) { ... });
+ * bus.emit(FileAddedEvent{metadata, "http"});
+ * // bus.emit(SyncStartedEvent{...});  // compile error: not in the list
+ *
+ * StaticHandlerBus handlers(
+ *     [&](const FileAddedEvent& e) { index.add(e.metadata); },
+ *     [&](const FileDeletedEvent& e) { index.remove(e.file_path); });
+ * handlers.emit(FileAddedEvent{metadata, "http"});  // inlined call
+ */
+
+#pragma once
+
+#include "dfs/events/events.hpp"
+#include "dfs/events/reader_epochs.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace dfs::events {
+
+/**
+ * @brief True if T appears in the pack Ts...
+ */
+template<typename T, typename... Ts>
+inline constexpr bool is_one_of_v = (std::is_same_v<T, Ts> || ...);
+
+/**
+ * @brief Statically typed event bus
+ *
+ * THREAD SAFETY:
+ * Same model as EventBus: each event type's handler list is immutable
+ * and published through an atomic pointer. emit() marks its thread as
+ * reading (reader_epochs.hpp), does one acquire load and calls the
+ * handlers directly; subscribe()/unsubscribe() copy-on-write under a
+ * mutex and free replaced lists once no emit() can still be walking
+ * them, so memory stays bounded under subscribe/unsubscribe churn.
+ *
+ * Handlers run synchronously in the emitting thread. A handler that
+ * throws is skipped; remaining handlers still run.
+ */
+template<typename... Events>
+class StaticEventBus {
+    static_assert(sizeof...(Events) > 0, "StaticEventBus needs at least one event type");
+
+public:
+    template<typename EventType>
+    using Handler = std::function<void(const EventType&)>;
+
+    StaticEventBus() = default;
+
+    // Non-copyable, non-moveable (same as EventBus)
+    StaticEventBus(const StaticEventBus&) = delete;
+    StaticEventBus& operator=(const StaticEventBus&) = delete;
+    StaticEventBus(StaticEventBus&&) = delete;
+    StaticEventBus& operator=(StaticEventBus&&) = delete;
+
+    /**
+     * @brief Subscribe to events of a specific type
+     *
+     * RETURNS:
+     * Subscription ID for unsubscribing later
+     */
+    template<typename EventType>
+    size_t subscribe(Handler<EventType> handler) {
+        static_assert(is_one_of_v<EventType, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+
+        std::lock_guard lock(write_mutex_);
+        auto& slot = std::get<Slot<EventType>>(slots_);
+
+        size_t handler_id = next_handler_id_++;
+        auto updated = slot.copy();
+        updated->push_back({handler_id, std::move(handler)});
+        slot.publish(std::move(updated));
+        reclaim();
+        return handler_id;
+    }
+
+    /**
+     * @brief Unsubscribe a specific handler
+     */
+    template<typename EventType>
+    void unsubscribe(size_t handler_id) {
+        static_assert(is_one_of_v<EventType, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+
+        std::lock_guard lock(write_mutex_);
+        auto& slot = std::get<Slot<EventType>>(slots_);
+
+        auto updated = slot.copy();
+        updated->erase(
+            std::remove_if(updated->begin(), updated->end(),
+                [handler_id](const auto& pair) {
+                    return pair.first == handler_id;
+                }),
+            updated->end()
+        );
+        slot.publish(std::move(updated));
+        reclaim();
+    }
+
+    /**
+     * @brief Emit an event to all subscribers of its type
+     *
+     * HOW IT WORKS:
+     * The handler list is found by type at compile time (std::get on the
+     * tuple), so emit compiles down to a load and a loop of calls.
+     */
+    template<typename EventType>
+    void emit(const EventType& event) {
+        using Event = std::decay_t<EventType>;
+        static_assert(is_one_of_v<Event, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+
+        detail::ReadSection section;
+        const HandlerList<Event>* handlers =
+            std::get<Slot<Event>>(slots_).current.load(std::memory_order_acquire);
+        if (handlers == nullptr) {
+            return;
+        }
+
+        for (const auto& entry : *handlers) {
+            try {
+                entry.second(event);
+            } catch (...) {
+                // One bad handler shouldn't stop the others
+            }
+        }
+    }
+
+    /**
+     * @brief Get number of subscribers for an event type
+     */
+    template<typename EventType>
+    size_t subscriber_count() const {
+        static_assert(is_one_of_v<EventType, Events...>,
+                      "EventType is not registered with this StaticEventBus");
+
+        detail::ReadSection section;
+        const auto* handlers =
+            std::get<Slot<EventType>>(slots_).current.load(std::memory_order_acquire);
+        return handlers != nullptr ? handlers->size() : 0;
+    }
+
+    /**
+     * @brief Remove all subscribers
+     */
+    void clear() {
+        std::lock_guard lock(write_mutex_);
+        std::apply([](auto&... slot) {
+            (slot.publish(nullptr), ...);
+        }, slots_);
+        reclaim();
+    }
+
+    /**
+     * @brief Replaced handler lists not yet freed (for tests and metrics)
+     */
+    size_t retired_lists() const {
+        std::lock_guard lock(write_mutex_);
+        return std::apply([](const auto&... slot) {
+            return (size_t{0} + ... + slot.retired.size());
+        }, slots_);
+    }
+
+    /**
+     * @brief Number of event types this bus accepts
+     */
+    static constexpr size_t event_type_count() {
+        return sizeof...(Events);
+    }
+
+private:
+    template<typename EventType>
+    using HandlerList = std::vector<std::pair<size_t, Handler<EventType>>>;
+
+    /**
+     * @brief Copy-on-write handler list for one event type
+     */
+    template<typename EventType>
+    struct Slot {
+        std::atomic<const HandlerList<EventType>*> current{nullptr};
+        // Owner of the published list, and replaced lists stamped with
+        // the epoch they were retired in
+        std::unique_ptr<HandlerList<EventType>> live;
+        std::vector<std::pair<uint64_t, std::unique_ptr<HandlerList<EventType>>>> retired;
+
+        // Caller holds write_mutex_
+        std::unique_ptr<HandlerList<EventType>> copy() const {
+            const auto* list = current.load(std::memory_order_relaxed);
+            return list ? std::make_unique<HandlerList<EventType>>(*list)
+                        : std::make_unique<HandlerList<EventType>>();
+        }
+
+        // Caller holds write_mutex_ and calls reclaim() afterwards
+        void publish(std::unique_ptr<HandlerList<EventType>> list) {
+            if (!list) {
+                list = std::make_unique<HandlerList<EventType>>();
+            }
+            current.store(list.get(), std::memory_order_release);
+            if (live) {
+                retired.emplace_back(detail::advance_epoch(), std::move(live));
+            }
+            live = std::move(list);
+        }
+
+        // Caller holds write_mutex_
+        void free_before(uint64_t safe) {
+            retired.erase(
+                std::remove_if(retired.begin(), retired.end(),
+                    [safe](const auto& entry) { return entry.first < safe; }),
+                retired.end());
+        }
+    };
+
+    /**
+     * @brief Free retired lists no emit() can still be walking
+     *
+     * Same rule as EventBus::reclaim(). Caller holds write_mutex_.
+     */
+    void reclaim() {
+        const bool any_retired = std::apply([](const auto&... slot) {
+            return (!slot.retired.empty() || ...);
+        }, slots_);
+        if (!any_retired) {
+            return;
+        }
+        const uint64_t safe = detail::safe_epoch();
+        std::apply([safe](auto&... slot) {
+            (slot.free_before(safe), ...);
+        }, slots_);
+    }
+
+    std::tuple<Slot<Events>...> slots_;
+    mutable std::mutex write_mutex_;
+    size_t next_handler_id_ = 0;
+};
+
+/**
+ * @brief Event bus whose subscribers are fixed at compile time
+ *
+ * Each handler is any callable taking one or more event types by const
+ * reference; its type is a template parameter and the object is stored
+ * by value in a std::tuple. emit<E>() is a fold over the tuple that calls
+ * each handler invocable with `const E&` and skips the rest at compile
+ * time - no list, no std::function, no indirect call. Emitting an event
+ * no handler accepts compiles to nothing.
+ *
+ * THREAD SAFETY:
+ * The handler set never changes, so emit() takes no lock and loads
+ * nothing. Handlers that keep state must synchronize it themselves if
+ * emit() is called from several threads.
+ *
+ * Handlers run synchronously in the emitting thread. A handler that
+ * throws is skipped; remaining handlers still run.
+ */
+template<typename... Handlers>
+class StaticHandlerBus {
+public:
+    explicit StaticHandlerBus(Handlers... handlers)
+        : handlers_(std::move(handlers)...) {}
+
+    // Non-copyable, non-moveable (same as EventBus)
+    StaticHandlerBus(const StaticHandlerBus&) = delete;
+    StaticHandlerBus& operator=(const StaticHandlerBus&) = delete;
+    StaticHandlerBus(StaticHandlerBus&&) = delete;
+    StaticHandlerBus& operator=(StaticHandlerBus&&) = delete;
+
+    /**
+     * @brief Call every handler that accepts this event type, in order
+     */
+    template<typename EventType>
+    void emit(const EventType& event) {
+        std::apply([&event](auto&... handler) {
+            (call_if_accepted(handler, event), ...);
+        }, handlers_);
+    }
+
+    /**
+     * @brief Number of handlers that accept an event type
+     */
+    template<typename EventType>
+    static constexpr size_t subscriber_count() {
+        return (size_t{0} + ... + size_t{std::is_invocable_v<Handlers&, const EventType&>});
+    }
+
+    /**
+     * @brief Access the I-th handler (e.g. to read state it collected)
+     */
+    template<size_t I>
+    auto& handler() {
+        return std::get<I>(handlers_);
+    }
+
+private:
+    template<typename Handler, typename EventType>
+    static void call_if_accepted(Handler& handler, const EventType& event) {
+        if constexpr (std::is_invocable_v<Handler&, const EventType&>) {
+            try {
+                handler(event);
+            } catch (...) {
+                // One bad handler shouldn't stop the others
+            }
+        }
+    }
+
+    std::tuple<Handlers...> handlers_;
+};
+
+/**
+ * @brief Static bus over every event defined in events.hpp
+ */
+using FileSyncEventBus = StaticEventBus<
+    FileAddedEvent,
+    FileModifiedEvent,
+    FileDeletedEvent,
+    ServerStartedEvent,
+    ServerShuttingDownEvent,
+    SyncStartedEvent,
+    SyncCompletedEvent,
+    SyncFailedEvent,
+    FileUploadStartedEvent,
+    FileChunkReceivedEvent,
+    FileUploadCompletedEvent,
+    FileDownloadCompletedEvent,
+    FileConflictDetectedEvent,
+    FileConflictResolvedEvent
+>;
+
+} // namespace dfs::events
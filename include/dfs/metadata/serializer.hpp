@@ -124,7 +124,21 @@ public:
      */
     static std::vector<uint8_t> serialize(const FileMetadata& metadata) {
         std::vector<uint8_t> buffer;
+        serialize_into(buffer, metadata);
+        return buffer;
+    }
 
+    /**
+     * Append the serialized metadata to an existing buffer
+     *
+     * WHY THIS METHOD:
+     * RPC payloads (dfs/sync/rpc.hpp) embed metadata records between
+     * other fields. Appending avoids a temporary vector per record.
+     *
+     * @param buffer Buffer to append to
+     * @param metadata FileMetadata to serialize
+     */
+    static void serialize_into(std::vector<uint8_t>& buffer, const FileMetadata& metadata) {
         // Version byte (for future format changes)
         // If we change format in Phase 3, we can bump this to version 2
         // and handle both formats in deserialize()
@@ -157,8 +171,6 @@ public:
             write_uint32(buffer, replica.version);
             write_int64(buffer, replica.modified_time);
         }
-
-        return buffer;
     }
 
     /**
@@ -197,6 +209,22 @@ public:
      */
     static Result<FileMetadata> deserialize(const std::vector<uint8_t>& data) {
         size_t cursor = 0;
+        return deserialize(data, cursor);
+    }
+
+    /**
+     * Deserialize one record starting at cursor
+     *
+     * WHY THIS METHOD:
+     * Counterpart of serialize_into(): reads a record embedded in a
+     * larger payload and leaves cursor just past it, ready for the next
+     * field.
+     *
+     * @param data Buffer holding the record
+     * @param cursor Position of the record; advanced past it
+     * @return Result<FileMetadata> - metadata if valid, error if corrupt
+     */
+    static Result<FileMetadata> deserialize(const std::vector<uint8_t>& data, size_t& cursor) {
         FileMetadata metadata;
 
         // Read version byte
@@ -293,7 +321,6 @@ public:
         return Ok(metadata);
     }
 
-private:
     /**
      * Helper functions for writing primitive types to buffer
      *
@@ -302,6 +329,10 @@ private:
      * - Reduce code duplication
      * - Make serialize() more readable
      *
+     * WHY PUBLIC:
+     * The binary RPC payloads (dfs/sync/rpc.hpp) use the same encoding for
+     * their own fields, so a reply is one format end to end.
+     *
      * BYTE ORDER:
      * Different CPUs store multi-byte integers differently:
      * - Little-endian (x86, ARM): 0x1234 stored as [34 12]
@@ -341,6 +372,12 @@ private:
         buffer.insert(buffer.end(), str.begin(), str.end());
     }
 
+    static void write_bytes(std::vector<uint8_t>& buffer, const uint8_t* data, size_t size) {
+        // Same layout as a string: 4-byte length, then the raw bytes
+        write_uint32(buffer, static_cast<uint32_t>(size));
+        buffer.insert(buffer.end(), data, data + size);
+    }
+
     /**
      * Helper functions for reading primitive types from buffer
      *
@@ -414,6 +451,24 @@ private:
         return Ok(value);
     }
 
+    static Result<std::vector<uint8_t>> read_bytes(const std::vector<uint8_t>& buffer, size_t& cursor) {
+        auto length_result = read_uint32(buffer, cursor);
+        if (length_result.is_error()) {
+            return Err<std::vector<uint8_t>, std::string>(length_result.error());
+        }
+        uint32_t length = length_result.value();
+
+        if (cursor + length > buffer.size()) {
+            return Err<std::vector<uint8_t>, std::string>("Buffer underflow reading bytes");
+        }
+
+        std::vector<uint8_t> value(buffer.begin() + static_cast<std::ptrdiff_t>(cursor),
+                                   buffer.begin() + static_cast<std::ptrdiff_t>(cursor + length));
+        cursor += length;
+        return Ok(std::move(value));
+    }
+
+private:
     /**
      * Byte order conversion helpers
      *
@@ -53,7 +53,10 @@
 
 #include "dfs/metadata/types.hpp"
 #include "dfs/core/result.hpp"
+#include <atomic>
+#include <cstdint>
 #include <unordered_map>
+#include <mutex>
 #include <shared_mutex>
 #include <vector>
 #include <string>
@@ -129,6 +132,7 @@ public:
 
         // Add to store
         metadata_[metadata.file_path] = metadata;
+        bump_version();
 
         return Ok();
     }
@@ -209,6 +213,7 @@ public:
 
         // Update
         it->second = metadata;
+        bump_version();
 
         return Ok();
     }
@@ -234,6 +239,7 @@ public:
     void add_or_update(const FileMetadata& metadata) {
         std::unique_lock lock(mutex_);
         metadata_[metadata.file_path] = metadata;
+        bump_version();
     }
 
     /**
@@ -265,6 +271,7 @@ public:
         }
 
         metadata_.erase(it);
+        bump_version();
 
         return Ok();
     }
@@ -331,6 +338,54 @@ public:
         return result;
     }
 
+    /**
+     * Version of the store's contents
+     *
+     * WHY THIS METHOD:
+     * Responses built from the whole store (snapshots) are identical for
+     * every client until the next write. The version lets callers tell
+     * "same state as before" with one load instead of comparing listings,
+     * e.g. to reuse a compressed snapshot.
+     *
+     * HOW IT WORKS:
+     * Every write (add, update, add_or_update, remove, clear) increments
+     * it while holding the exclusive lock. Reading it takes no lock.
+     *
+     * @return Counter that changes whenever the contents change
+     */
+    uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * All metadata together with the version it belongs to
+     *
+     * WHY THIS METHOD:
+     * Calling list_all() and version() separately can pair a listing with
+     * the version of a later write. Both are read under one shared lock
+     * here, so the version identifies exactly this listing.
+     *
+     * EXAMPLE:
+     * auto snapshot = store.snapshot();
+     * response.set_header("ETag", "\"" + std::to_string(snapshot.version) + "\"");
+     */
+    struct Snapshot {
+        std::vector<FileMetadata> files;
+        uint64_t version = 0;
+    };
+
+    Snapshot snapshot() const {
+        std::shared_lock lock(mutex_);
+
+        Snapshot result;
+        result.version = version_.load(std::memory_order_relaxed);
+        result.files.reserve(metadata_.size());
+        for (const auto& [path, metadata] : metadata_) {
+            result.files.push_back(metadata);
+        }
+        return result;
+    }
+
     /**
      * Get count of files in store
      *
@@ -358,6 +413,7 @@ public:
     void clear() {
         std::unique_lock lock(mutex_);
         metadata_.clear();
+        bump_version();
     }
 
     /**
@@ -414,6 +470,11 @@ private:
      */
     mutable std::shared_mutex mutex_;  // Reader-writer lock
     std::unordered_map<std::string, FileMetadata> metadata_;
+    std::atomic<uint64_t> version_{0};  // Bumped by every write (under unique lock)
+
+    void bump_version() {
+        version_.fetch_add(1, std::memory_order_release);
+    }
 
     /**
      * THREAD SAFETY VISUALIZATION:
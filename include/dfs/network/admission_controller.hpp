@@ -0,0 +1,245 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Tuning for AdmissionController
+ */
+struct AdmissionConfig {
+    // CoDel: a queue is "standing" once even its fastest connection waited
+    // longer than target_delay for a whole interval.
+    std::chrono::microseconds target_delay{std::chrono::milliseconds(5)};
+    std::chrono::microseconds interval{std::chrono::milliseconds(100)};
+
+    // Connections one client address may have queued or in service
+    // (0 = unlimited)
+    size_t max_in_flight_per_client = 32;
+
+    // Sent back with every 503
+    int retry_after_seconds = 1;
+
+    // Cheap routes that are never shed for queue delay. A request matches
+    // if its path equals an entry or continues it with a '/'.
+    std::vector<std::string> priority_paths{"/api/sync/status", "/health", "/metrics"};
+};
+
+/**
+ * @brief Decides which connections are served and which get a fast 503
+ *
+ * A queue limit alone reacts too late: after an outage every client
+ * starts syncing at once, the queue fills, and each connection waits
+ * behind thousands of others until its client has given up and retries.
+ * The server then spends its capacity on requests nobody is waiting for
+ * any more. Shedding early, with a 503 and Retry-After, keeps the
+ * latency of the requests that are admitted bounded.
+ *
+ * Architecture:
+ * - Queue delay (CoDel): workers report how long each connection
+ *   waited between accept and pickup. At the end of every interval the
+ *   minimum delay seen is compared with target_delay. If even the fastest
+ *   connection waited too long, the queue is standing (not just a
+ *   burst) and the controller is overloaded. While overloaded,
+ *   connections that waited longer than target_delay are shed.
+ * - Priority paths: a connection the delay check would shed is first
+ *   classified by peeking at its request line. Cheap routes (sync status,
+ *   health checks) are still served, since answering them costs less
+ *   than the retry they would cause.
+ * - Per-client in-flight limit: a table of counters indexed by a hash
+ *   of the client address. Collisions only make the limit stricter, and
+ *   the table needs no lock and no allocation.
+ * - The 503 is serialized once, at construction, so shedding writes a
+ *   constant buffer and never touches the parser or the arena.
+ *
+ * Thread safety: all methods may be called concurrently; state is
+ * atomics only. configure() must not run while the server is serving.
+ *
+ * Usage:
+ * ```cpp
+ * AdmissionController admission;
+ * if (!admission.try_enter(peer)) { send(admission.overload_response()); return; }
+ * auto waited = now - accepted_at;
+ * if (admission.should_shed(now, waited) && !admission.is_priority(request_line)) { ... }
+ * admission.leave(peer);
+ * ```
+ */
+class AdmissionController {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr size_t kClientSlots = 4096;
+
+    explicit AdmissionController(AdmissionConfig config = {}) {
+        configure(std::move(config));
+    }
+
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    void configure(AdmissionConfig config) {
+        config_ = std::move(config);
+        overload_response_ = build_overload_response(config_.retry_after_seconds);
+        window_start_ns_.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+        window_min_ns_.store(kNoSample, std::memory_order_relaxed);
+        overloaded_.store(false, std::memory_order_relaxed);
+    }
+
+    const AdmissionConfig& config() const { return config_; }
+
+    // ════════════════════════════════════════════════════════
+    // Per-client limit
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Count a new connection from this client; false if over limit
+     *
+     * Every successful try_enter() must be paired with leave().
+     */
+    bool try_enter(uint32_t client) {
+        if (config_.max_in_flight_per_client == 0) {
+            return true;
+        }
+        auto& slot = slots_[slot_index(client)];
+        if (slot.fetch_add(1, std::memory_order_relaxed) >= config_.max_in_flight_per_client) {
+            slot.fetch_sub(1, std::memory_order_relaxed);
+            shed_client_limit_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        return true;
+    }
+
+    void leave(uint32_t client) {
+        if (config_.max_in_flight_per_client != 0) {
+            slots_[slot_index(client)].fetch_sub(1, std::memory_order_relaxed);
+        }
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Queue delay (CoDel)
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Record a connection's queue delay; true if it should be shed
+     *
+     * Call once per connection when a worker picks it up. A true result
+     * means "shed unless it is a priority request".
+     */
+    bool should_shed(Clock::time_point now, std::chrono::nanoseconds waited) {
+        int64_t now_ns = now.time_since_epoch().count();
+        int64_t waited_ns = waited.count();
+
+        // Track the minimum delay of the current interval
+        int64_t current_min = window_min_ns_.load(std::memory_order_relaxed);
+        while (waited_ns < current_min &&
+               !window_min_ns_.compare_exchange_weak(current_min, waited_ns, std::memory_order_relaxed)) {
+        }
+
+        // Close the interval: whoever wins the CAS evaluates it
+        int64_t start = window_start_ns_.load(std::memory_order_relaxed);
+        int64_t interval_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(config_.interval).count();
+        if (now_ns - start >= interval_ns &&
+            window_start_ns_.compare_exchange_strong(start, now_ns, std::memory_order_relaxed)) {
+            int64_t window_min = window_min_ns_.exchange(kNoSample, std::memory_order_relaxed);
+            bool standing = window_min != kNoSample && window_min > target_ns();
+            overloaded_.store(standing, std::memory_order_relaxed);
+        }
+
+        return overloaded_.load(std::memory_order_relaxed) && waited_ns > target_ns();
+    }
+
+    bool is_overloaded() const { return overloaded_.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief True if the request line targets a priority path
+     *
+     * @param head The first bytes of the request ("GET /path HTTP/1.1...")
+     */
+    bool is_priority(std::string_view head) const {
+        size_t path_start = head.find(' ');
+        if (path_start == std::string_view::npos) {
+            return false;
+        }
+        std::string_view rest = head.substr(path_start + 1);
+        std::string_view path = rest.substr(0, rest.find_first_of(" ?"));
+        for (const auto& prefix : config_.priority_paths) {
+            if (path.size() >= prefix.size() && path.compare(0, prefix.size(), prefix) == 0 &&
+                (path.size() == prefix.size() || path[prefix.size()] == '/')) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Rejection
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief The complete 503 response, ready to write to the socket
+     */
+    std::string_view overload_response() const { return overload_response_; }
+
+    void record_queue_shed() { shed_queue_full_.fetch_add(1, std::memory_order_relaxed); }
+    void record_delay_shed() { shed_delay_.fetch_add(1, std::memory_order_relaxed); }
+    void record_priority_admit() { priority_admits_.fetch_add(1, std::memory_order_relaxed); }
+
+    uint64_t shed_queue_full() const { return shed_queue_full_.load(std::memory_order_relaxed); }
+    uint64_t shed_delay() const { return shed_delay_.load(std::memory_order_relaxed); }
+    uint64_t shed_client_limit() const { return shed_client_limit_.load(std::memory_order_relaxed); }
+    uint64_t priority_admits() const { return priority_admits_.load(std::memory_order_relaxed); }
+
+    uint64_t shed_total() const {
+        return shed_queue_full() + shed_delay() + shed_client_limit();
+    }
+
+private:
+    static constexpr int64_t kNoSample = std::numeric_limits<int64_t>::max();
+
+    int64_t target_ns() const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(config_.target_delay).count();
+    }
+
+    static size_t slot_index(uint32_t client) {
+        // Fibonacci hashing spreads neighbouring addresses across slots
+        return static_cast<size_t>((client * 2654435769u) >> 20) % kClientSlots;
+    }
+
+    static std::string build_overload_response(int retry_after_seconds) {
+        constexpr std::string_view body = "Server overloaded, please retry later\n";
+        std::string response = "HTTP/1.1 503 Service Unavailable\r\n";
+        response += "Retry-After: " + std::to_string(retry_after_seconds) + "\r\n";
+        response += "Content-Type: text/plain\r\n";
+        response += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+        response += "Connection: close\r\n\r\n";
+        response += body;
+        return response;
+    }
+
+    AdmissionConfig config_;
+    std::string overload_response_;
+
+    std::atomic<int64_t> window_start_ns_{0};
+    std::atomic<int64_t> window_min_ns_{kNoSample};
+    std::atomic<bool> overloaded_{false};
+
+    std::array<std::atomic<uint32_t>, kClientSlots> slots_{};
+
+    std::atomic<uint64_t> shed_queue_full_{0};
+    std::atomic<uint64_t> shed_delay_{0};
+    std::atomic<uint64_t> shed_client_limit_{0};
+    std::atomic<uint64_t> priority_admits_{0};
+};
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Slab-allocated pool of fixed-size receive buffers
+ *
+ * Socket::receive() allocates a new vector on every call. A server that
+ * reads into a leased buffer instead allocates nothing per read: buffers
+ * are carved out of slabs (one allocation per kSlabBuffers buffers) and
+ * go back on a free list when the lease ends.
+ *
+ * Architecture:
+ * - Slabs are never freed while the pool lives, so a buffer's address
+ *   stays valid for the whole lease
+ * - acquire() pops the free list and only adds a slab when it is empty,
+ *   so a server in steady state never allocates
+ * - One mutex guards the free list. It is taken once per acquire and
+ *   once per release (per connection, not per read), so it stays cold.
+ *
+ * Thread safety: all methods are thread-safe. A Lease is owned by one
+ * thread at a time.
+ *
+ * Usage:
+ * ```cpp
+ * auto buffer = BufferPool::shared().acquire();
+ * auto n = socket.receive_into(buffer.data(), buffer.size());
+ * ```
+ */
+class BufferPool {
+public:
+    static constexpr size_t kDefaultBufferSize = 16 * 1024;
+    static constexpr size_t kSlabBuffers = 32;
+
+    /**
+     * @brief RAII handle on one pooled buffer; returns it on destruction
+     */
+    class Lease {
+    public:
+        Lease() = default;
+        Lease(BufferPool* pool, uint8_t* data) : pool_(pool), data_(data) {}
+
+        ~Lease() { release(); }
+
+        Lease(Lease&& other) noexcept
+            : pool_(std::exchange(other.pool_, nullptr))
+            , data_(std::exchange(other.data_, nullptr)) {}
+
+        Lease& operator=(Lease&& other) noexcept {
+            if (this != &other) {
+                release();
+                pool_ = std::exchange(other.pool_, nullptr);
+                data_ = std::exchange(other.data_, nullptr);
+            }
+            return *this;
+        }
+
+        Lease(const Lease&) = delete;
+        Lease& operator=(const Lease&) = delete;
+
+        uint8_t* data() const { return data_; }
+        size_t size() const { return pool_ != nullptr ? pool_->buffer_size_ : 0; }
+        explicit operator bool() const { return data_ != nullptr; }
+
+    private:
+        void release() {
+            if (pool_ != nullptr && data_ != nullptr) {
+                pool_->give_back(data_);
+            }
+            pool_ = nullptr;
+            data_ = nullptr;
+        }
+
+        BufferPool* pool_ = nullptr;
+        uint8_t* data_ = nullptr;
+    };
+
+    explicit BufferPool(size_t buffer_size = kDefaultBufferSize)
+        : buffer_size_(buffer_size) {}
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * @brief Process-wide pool of kDefaultBufferSize buffers
+     */
+    static BufferPool& shared() {
+        static BufferPool pool;
+        return pool;
+    }
+
+    Lease acquire() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (free_.empty()) {
+            add_slab();
+        }
+        uint8_t* data = free_.back();
+        free_.pop_back();
+        return Lease(this, data);
+    }
+
+    size_t buffer_size() const { return buffer_size_; }
+
+    size_t slab_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return slabs_.size();
+    }
+
+    size_t free_count() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return free_.size();
+    }
+
+private:
+    void add_slab() {
+        slabs_.push_back(std::make_unique<uint8_t[]>(buffer_size_ * kSlabBuffers));
+        uint8_t* base = slabs_.back().get();
+        // Capacity for every buffer the pool owns, so give_back never allocates
+        free_.reserve(slabs_.size() * kSlabBuffers);
+        for (size_t i = kSlabBuffers; i-- > 0;) {
+            free_.push_back(base + i * buffer_size_);
+        }
+    }
+
+    void give_back(uint8_t* data) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        free_.push_back(data);
+    }
+
+    size_t buffer_size_;
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<uint8_t[]>> slabs_;
+    std::vector<uint8_t*> free_;
+};
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,148 @@
+#pragma once
+
+#include "dfs/network/http_types.hpp"
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Tuning for ChangeFeed
+ */
+struct ChangeFeedConfig {
+    // Records kept for subscribers that fall behind or reconnect. A cursor
+    // older than this gets a "resync" instead of the records it missed.
+    size_t history = 4096;
+
+    // A long-poll with nothing to report answers empty after this long
+    std::chrono::milliseconds long_poll_timeout{std::chrono::seconds(25)};
+
+    // Comment line sent on an idle event stream, so proxies keep it open
+    // and a vanished client is noticed when the write fails
+    std::chrono::milliseconds heartbeat{std::chrono::seconds(15)};
+
+    // Records per long-poll reply / per event-stream chunk
+    size_t max_batch = 256;
+};
+
+/**
+ * @brief Sequenced change records pushed to long-poll and SSE subscribers
+ *
+ * Clients used to learn about remote changes only by starting a new sync
+ * session and downloading the whole snapshot. A subscriber instead parks
+ * one request and receives compact records as changes happen.
+ *
+ * Architecture:
+ * - publish() appends a record (e.g. one line of JSON) under the next
+ *   sequence number to a bounded history, then wakes every subscriber.
+ * - Subscribers are PushBody responses (see http_types.hpp). A cursor
+ *   (the last sequence the client saw) makes them stateless on the
+ *   server side: pull() reads the history after the cursor. A client
+ *   that reconnects with its cursor misses nothing that is still in
+ *   the history.
+ * - long_poll(): answers once, with the records after the cursor, or
+ *   empty after long_poll_timeout:
+ *     {"cursor":12,"changes":[...]}   /   {"cursor":12,"resync":true,"changes":[]}
+ * - event_stream(): text/event-stream, one "change" event per record
+ *   with the sequence as event id (so EventSource's Last-Event-ID resumes
+ *   it), and a "resync" event if the cursor fell out of the history.
+ * - Waking a subscriber is a function call that only flags its
+ *   connection; on HttpServerEpoll many wakes for one loop cost a single
+ *   eventfd write, so thousands of idle subscribers need no threads.
+ *
+ * Thread safety: publish() and the factories may be called from any
+ * thread. Bodies are driven by one server thread at a time.
+ *
+ * Usage:
+ * ```cpp
+ * auto feed = std::make_shared<ChangeFeed>();
+ * bus.subscribe<FileAddedEvent>([feed](const FileAddedEvent& e) { feed->publish(to_json(e)); });
+ * router.get("/api/changes/:since", [feed](const HttpContext& ctx) {
+ *     HttpResponse res(HttpStatus::OK);
+ *     res.set_header("Content-Type", "application/json");
+ *     res.set_body_push(feed->long_poll(std::stoull(ctx.get_param("since"))));
+ *     return res;
+ * });
+ * ```
+ */
+class ChangeFeed : public std::enable_shared_from_this<ChangeFeed> {
+public:
+    static constexpr std::string_view kEventStreamType = "text/event-stream";
+
+    struct Record {
+        uint64_t sequence;
+        std::string data;
+    };
+
+    explicit ChangeFeed(ChangeFeedConfig config = {});
+
+    ChangeFeed(const ChangeFeed&) = delete;
+    ChangeFeed& operator=(const ChangeFeed&) = delete;
+
+    /**
+     * @brief Append a record and wake subscribers; returns its sequence (from 1)
+     */
+    uint64_t publish(std::string data);
+
+    /**
+     * @brief Sequence of the newest record (0 before the first)
+     */
+    uint64_t last_sequence() const;
+
+    /**
+     * @brief Copy up to max records newer than cursor into out
+     * @return false if records after cursor were already dropped from history
+     */
+    bool read_since(uint64_t cursor, size_t max, std::vector<Record>& out) const;
+
+    // ════════════════════════════════════════════════════════
+    // Subscriptions (the feed must be owned by a shared_ptr)
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief One JSON reply with the changes after cursor, sent as soon as there are any
+     */
+    std::shared_ptr<PushBody> long_poll(uint64_t cursor);
+
+    /**
+     * @brief Server-Sent Events stream of the changes after cursor
+     */
+    std::shared_ptr<PushBody> event_stream(uint64_t cursor);
+
+    /**
+     * @brief Subscribers currently parked (bodies with a watcher)
+     */
+    size_t subscribers() const;
+
+    const ChangeFeedConfig& config() const { return config_; }
+
+private:
+    friend class FeedBody;
+
+    size_t add_watcher(std::function<void()> wake);
+    void remove_watcher(size_t id);
+
+    ChangeFeedConfig config_;
+
+    mutable std::mutex history_mutex_;
+    std::deque<Record> history_;
+    uint64_t last_sequence_ = 0;
+
+    // Held while waking, so remove_watcher() returning means no wake runs
+    mutable std::mutex watchers_mutex_;
+    std::unordered_map<size_t, std::function<void()>> watchers_;
+    size_t next_watcher_ = 1;
+};
+
+} // namespace network
+} // namespace dfs
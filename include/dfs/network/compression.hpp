@@ -0,0 +1,184 @@
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/network/http_router.hpp"
+#include "dfs/network/http_types.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Content codings the server can produce
+ */
+enum class ContentEncoding : uint8_t {
+    IDENTITY = 0,
+    GZIP,       // Only when built with zlib (DFS_HAS_ZLIB)
+    ZSTD,       // Only when built with zstd (DFS_HAS_ZSTD)
+};
+
+/**
+ * @brief Token used in Accept-Encoding / Content-Encoding ("gzip", ...)
+ */
+std::string_view encoding_name(ContentEncoding encoding);
+
+/**
+ * @brief True if this build can compress with the given coding
+ */
+bool encoding_available(ContentEncoding encoding);
+
+/**
+ * @brief Pick the coding for a response from the request's Accept-Encoding
+ *
+ * Honors q-values (q=0 refuses a coding) and "*". Among codings with the
+ * same weight zstd is preferred over gzip. Codings this build lacks are
+ * never chosen. Returns IDENTITY if the header is empty or nothing
+ * acceptable is available.
+ */
+ContentEncoding negotiate_encoding(std::string_view accept_encoding);
+
+/**
+ * @brief True for media types worth compressing (text, JSON, XML, JS)
+ */
+bool is_compressible_type(std::string_view content_type);
+
+/**
+ * @brief Compress input into out (replacing its contents)
+ *
+ * Uses a compression context owned by the calling thread: the first call
+ * on a thread sets it up, later calls only reset it. zlib's deflate state
+ * is ~256 KB, so creating one per response would cost more than many of
+ * the responses themselves.
+ *
+ * @param level Codec level (gzip 1-9, zstd 1-19)
+ */
+Result<void> compress(ContentEncoding encoding, std::string_view input, int level, std::string& out);
+
+/**
+ * @brief Tuning for ResponseCompressor
+ */
+struct CompressionOptions {
+    // Bodies smaller than this are sent as they are: the coding's framing
+    // and the CPU time cost more than the bytes saved.
+    size_t min_size = 1024;
+
+    // Keep the compressed body only if it is at most this fraction of the
+    // original; otherwise the body is treated as incompressible.
+    double max_ratio = 0.9;
+
+    int gzip_level = 6;
+    int zstd_level = 3;
+
+    // Compressed responses kept for reuse (0 disables the cache)
+    size_t cache_entries = 64;
+};
+
+/**
+ * @brief Response filter that compresses bodies per Accept-Encoding
+ *
+ * Snapshot and diff responses are JSON listings that compress 10-20x.
+ * Sending them raw costs more in transfer time than compressing them
+ * costs in CPU, but compressing the same snapshot again for every client
+ * that asks for it would move the cost instead of removing it.
+ *
+ * Architecture:
+ * - Runs as an HttpRouter response filter (use_after), so handlers stay
+ *   unaware of codings.
+ * - Skipped for: non-200 responses, streamed bodies, bodies below
+ *   min_size, media types that are not text-like, and responses that
+ *   already carry Content-Encoding. Compressed output that is not smaller
+ *   than max_ratio of the input is discarded and the body sent as is.
+ * - Compression uses the calling thread's context (see compress()).
+ * - Cache: a GET response with a strong ETag is fully identified by its
+ *   URL and ETag, so its compressed form is kept, keyed by (URL, coding)
+ *   and validated by the ETag. Handlers that serve store-wide state put
+ *   the store version in the ETag (MetadataStore::snapshot()); a write
+ *   changes the ETag and the next request replaces the entry. Bodies
+ *   found incompressible are remembered the same way. Least recently
+ *   used entries are evicted once cache_entries is reached.
+ * - A compressed representation is a different representation, so a
+ *   strong ETag gets the coding appended ("v7" becomes "v7-gzip").
+ * - Vary: Accept-Encoding is added to every response that could have
+ *   been compressed, so shared caches keep the codings apart.
+ *
+ * Two threads that miss on the same entry at once both compress it; the
+ * second insert wins. That costs one extra compression per change and
+ * keeps the cache lock out of the compression path.
+ *
+ * Thread safety: apply() may be called concurrently from all workers.
+ *
+ * Usage:
+ * ```cpp
+ * ResponseCompressor compressor;
+ * router.use_after(compressor.filter());
+ * ```
+ */
+class ResponseCompressor {
+public:
+    explicit ResponseCompressor(CompressionOptions options = {});
+
+    ResponseCompressor(const ResponseCompressor&) = delete;
+    ResponseCompressor& operator=(const ResponseCompressor&) = delete;
+
+    /**
+     * @brief Compress the response in place if the request allows it
+     */
+    void apply(const HttpContext& ctx, HttpResponse& response);
+
+    /**
+     * @brief apply() as a router filter; the compressor must outlive the router
+     */
+    ResponseFilter filter();
+
+    const CompressionOptions& options() const { return options_; }
+
+    // ════════════════════════════════════════════════════════
+    // Statistics
+    // ════════════════════════════════════════════════════════
+
+    uint64_t compressed() const { return compressed_.load(std::memory_order_relaxed); }
+    uint64_t incompressible() const { return incompressible_.load(std::memory_order_relaxed); }
+    uint64_t cache_hits() const { return cache_hits_.load(std::memory_order_relaxed); }
+    uint64_t bytes_in() const { return bytes_in_.load(std::memory_order_relaxed); }
+    uint64_t bytes_out() const { return bytes_out_.load(std::memory_order_relaxed); }
+
+private:
+    struct CacheEntry {
+        std::string url;
+        ContentEncoding encoding;
+        std::string etag;
+        std::shared_ptr<const std::string> body;   // nullptr: incompressible
+        uint64_t last_used;
+    };
+
+    // Returns false on a miss; on a hit, body may be null (incompressible)
+    bool cache_lookup(std::string_view url, ContentEncoding encoding, std::string_view etag,
+                      std::shared_ptr<const std::string>& body);
+    void cache_store(std::string_view url, ContentEncoding encoding, std::string_view etag,
+                     std::shared_ptr<const std::string> body);
+
+    void set_encoded(HttpResponse& response, ContentEncoding encoding, std::string_view body);
+
+    CompressionOptions options_;
+
+    std::mutex cache_mutex_;
+    std::vector<CacheEntry> cache_;
+    uint64_t tick_ = 0;   // Guarded by cache_mutex_
+
+    std::atomic<uint64_t> compressed_{0};
+    std::atomic<uint64_t> incompressible_{0};
+    std::atomic<uint64_t> cache_hits_{0};
+    std::atomic<uint64_t> bytes_in_{0};
+    std::atomic<uint64_t> bytes_out_{0};
+};
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Per-connection bump allocator for request/response objects
+ *
+ * A request goes through the parser, the handler and serialization, and
+ * at each step strings, header nodes and byte vectors are created and
+ * freed again. With the global heap every one of those is a malloc/free
+ * pair under allocator locks. An arena allocates them by bumping a
+ * pointer and frees them all at once in reset(), when the request is done.
+ *
+ * Architecture:
+ * - A std::pmr::monotonic_buffer_resource over an initial block
+ *   taken from `upstream` once, at construction
+ * - A request larger than the initial block takes extra blocks from
+ *   upstream. reset() hands them back and rewinds to the initial block.
+ *   With a pooling upstream (e.g. std::pmr::unsynchronized_pool_resource)
+ *   even those blocks are recycled instead of hitting the global heap.
+ *
+ * Binding to a thread (ArenaScope):
+ * HttpRequest and HttpResponse take their memory from request_resource(),
+ * which is the arena bound to the calling thread by ArenaScope, or the
+ * default resource if there is none. So a handler that builds a response
+ * with `HttpResponse res(HttpStatus::OK)` allocates from the arena
+ * without being told about it.
+ *
+ * LIFETIME RULE: objects allocated from an arena must be destroyed
+ * before reset(). Copies of HttpRequest/HttpResponse use the default
+ * resource, so copy (don't move) one you want to keep, e.g. in a cache.
+ *
+ * Thread safety: none - an arena belongs to one connection (or one
+ * worker) at a time.
+ *
+ * Usage:
+ * ```cpp
+ * ConnectionArena arena;
+ * {
+ *     ArenaScope scope(arena);
+ *     HttpResponse response = handler(request);   // Allocates from arena
+ *     send(response);
+ * }
+ * arena.reset();
+ * ```
+ */
+class ConnectionArena {
+public:
+    static constexpr size_t kDefaultInitialSize = 8 * 1024;
+
+    explicit ConnectionArena(
+        std::pmr::memory_resource* upstream = std::pmr::get_default_resource(),
+        size_t initial_size = kDefaultInitialSize)
+        : upstream_(upstream)
+        , initial_size_(initial_size)
+        , initial_(upstream->allocate(initial_size, alignof(std::max_align_t)))
+        , monotonic_(initial_, initial_size_, upstream_) {}
+
+    ~ConnectionArena() {
+        monotonic_.release();
+        upstream_->deallocate(initial_, initial_size_, alignof(std::max_align_t));
+    }
+
+    ConnectionArena(const ConnectionArena&) = delete;
+    ConnectionArena& operator=(const ConnectionArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &monotonic_; }
+
+    /**
+     * @brief Free everything allocated since the last reset
+     */
+    void reset() { monotonic_.release(); }
+
+    size_t initial_size() const { return initial_size_; }
+
+private:
+    std::pmr::memory_resource* upstream_;
+    size_t initial_size_;
+    void* initial_;
+    std::pmr::monotonic_buffer_resource monotonic_;
+};
+
+namespace detail {
+inline thread_local std::pmr::memory_resource* tls_request_resource = nullptr;
+} // namespace detail
+
+/**
+ * @brief Memory resource for HttpRequest/HttpResponse created on this thread
+ *
+ * The arena bound by the innermost ArenaScope, else the default resource.
+ */
+inline std::pmr::memory_resource* request_resource() {
+    std::pmr::memory_resource* resource = detail::tls_request_resource;
+    return resource != nullptr ? resource : std::pmr::get_default_resource();
+}
+
+/**
+ * @brief Binds an arena to the calling thread for the scope's lifetime
+ *
+ * Scopes nest; the previous binding is restored on destruction.
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(ConnectionArena& arena)
+        : previous_(detail::tls_request_resource) {
+        detail::tls_request_resource = arena.resource();
+    }
+
+    ~ArenaScope() {
+        detail::tls_request_resource = previous_;
+    }
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    std::pmr::memory_resource* previous_;
+};
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,371 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory_resource>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * @brief Headers the server itself looks at on every request
+ *
+ * Recognized once, when a header is stored, so later lookups compare a
+ * byte instead of a case-insensitive string.
+ */
+enum class HeaderId : uint8_t {
+    OTHER = 0,
+    CONTENT_LENGTH,
+    CONNECTION,
+    CONTENT_TYPE,
+    TRANSFER_ENCODING,
+    COUNT_   // Number of well-known ids + 1; keep last
+};
+
+/**
+ * @brief ASCII case-insensitive equality (header names, Connection tokens)
+ */
+inline bool ascii_iequals(std::string_view a, std::string_view b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        unsigned char x = static_cast<unsigned char>(a[i]);
+        unsigned char y = static_cast<unsigned char>(b[i]);
+        if (x >= 'A' && x <= 'Z') x |= 0x20;
+        if (y >= 'A' && y <= 'Z') y |= 0x20;
+        if (x != y) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Canonical spelling of a well-known header
+ */
+inline std::string_view header_name(HeaderId id) {
+    switch (id) {
+        case HeaderId::CONTENT_LENGTH: return "Content-Length";
+        case HeaderId::CONNECTION: return "Connection";
+        case HeaderId::CONTENT_TYPE: return "Content-Type";
+        case HeaderId::TRANSFER_ENCODING: return "Transfer-Encoding";
+        default: return {};
+    }
+}
+
+/**
+ * @brief Well-known id of a header name (any case), or OTHER
+ */
+inline HeaderId header_id(std::string_view name) {
+    // Lengths differ, so one comparison decides
+    switch (name.size()) {
+        case 14:
+            return ascii_iequals(name, "Content-Length") ? HeaderId::CONTENT_LENGTH : HeaderId::OTHER;
+        case 10:
+            return ascii_iequals(name, "Connection") ? HeaderId::CONNECTION : HeaderId::OTHER;
+        case 12:
+            return ascii_iequals(name, "Content-Type") ? HeaderId::CONTENT_TYPE : HeaderId::OTHER;
+        case 17:
+            return ascii_iequals(name, "Transfer-Encoding") ? HeaderId::TRANSFER_ENCODING : HeaderId::OTHER;
+        default:
+            return HeaderId::OTHER;
+    }
+}
+
+/**
+ * @brief True if an If-None-Match header value matches the current ETag
+ *
+ * Uses the weak comparison RFC 9110 prescribes for If-None-Match ("W/"
+ * is ignored on both sides), and accepts "*" and lists of tags. A tag
+ * carrying a content-coding suffix ("abc-gzip", added by
+ * ResponseCompressor) matches the uncoded ETag "abc": a client that got
+ * the compressed representation has the same state.
+ */
+inline bool etag_matches(std::string_view if_none_match, std::string_view etag) {
+    auto opaque = [](std::string_view tag) {
+        if (tag.size() >= 2 && tag[0] == 'W' && tag[1] == '/') {
+            tag.remove_prefix(2);
+        }
+        return tag;
+    };
+    etag = opaque(etag);
+    if (etag.empty()) {
+        return false;
+    }
+
+    while (!if_none_match.empty()) {
+        size_t comma = if_none_match.find(',');
+        std::string_view tag = if_none_match.substr(0, comma);
+        if_none_match = comma == std::string_view::npos ? std::string_view{} : if_none_match.substr(comma + 1);
+
+        while (!tag.empty() && (tag.front() == ' ' || tag.front() == '\t')) tag.remove_prefix(1);
+        while (!tag.empty() && (tag.back() == ' ' || tag.back() == '\t')) tag.remove_suffix(1);
+        if (tag == "*") {
+            return true;
+        }
+        tag = opaque(tag);
+        if (tag == etag) {
+            return true;
+        }
+        // "abc-gzip" vs "abc": same tag once the coding suffix is dropped
+        for (std::string_view suffix : {std::string_view("-gzip\""), std::string_view("-zstd\"")}) {
+            if (tag.size() == etag.size() + suffix.size() - 1 &&
+                tag.substr(tag.size() - suffix.size()) == suffix &&
+                tag.substr(0, etag.size() - 1) == etag.substr(0, etag.size() - 1)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * @brief Flat, case-insensitive HTTP header list
+ *
+ * The previous std::unordered_map<std::string, std::string> made one
+ * node and up to two string allocations per header, and its lookups were
+ * case-sensitive: a client sending "content-length" was not seen by code
+ * that looked up "Content-Length". Requests carry ten or so headers, so
+ * a linear scan over a flat array is faster than hashing anyway.
+ *
+ * Architecture:
+ * - All names and values are appended to one text block; fields are
+ *   (offset, length) pairs into it and are handed out as string_views.
+ *   Adding a header allocates only when the block or the field array
+ *   has to grow, and both keep their capacity.
+ * - Each field records its HeaderId. Well-known headers also have their
+ *   field index cached, so get(HeaderId::CONTENT_LENGTH) is O(1).
+ * - Names compare ASCII case-insensitively. Insertion order is kept, so
+ *   serialized responses list headers in the order they were set.
+ * - set() replaces an existing header; add() appends a duplicate.
+ *
+ * Memory comes from the resource given at construction (the request's
+ * arena, see connection_arena.hpp). Copies use the default resource,
+ * like the pmr containers do.
+ *
+ * Views returned by get() and by iteration stay valid until the headers
+ * are modified.
+ *
+ * Thread safety: none (owned by one request/response).
+ *
+ * Usage:
+ * ```cpp
+ * HttpHeaders headers;
+ * headers.set("Content-Type", "text/plain");
+ * headers.get("content-type");                 // "text/plain"
+ * headers.get(HeaderId::CONTENT_TYPE);         // Same, without comparing names
+ * for (auto [name, value] : headers) { ... }
+ * ```
+ */
+class HttpHeaders {
+    struct Field {
+        uint32_t name_offset;
+        uint32_t value_offset;
+        uint32_t name_length;
+        uint32_t value_length;
+        HeaderId id;
+    };
+
+public:
+    using value_type = std::pair<std::string_view, std::string_view>;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = HttpHeaders::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = value_type;
+
+        const_iterator() = default;
+        const_iterator(const HttpHeaders* headers, size_t index) : headers_(headers), index_(index) {}
+
+        value_type operator*() const { return headers_->field(index_); }
+
+        const_iterator& operator++() {
+            ++index_;
+            return *this;
+        }
+
+        const_iterator operator++(int) {
+            const_iterator previous = *this;
+            ++index_;
+            return previous;
+        }
+
+        bool operator==(const const_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const const_iterator& other) const { return index_ != other.index_; }
+
+    private:
+        const HttpHeaders* headers_ = nullptr;
+        size_t index_ = 0;
+    };
+
+    explicit HttpHeaders(std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        : text_(resource), fields_(resource) {
+        known_.fill(kNone);
+    }
+
+    HttpHeaders(const HttpHeaders&) = default;
+    HttpHeaders(HttpHeaders&&) = default;
+    HttpHeaders& operator=(const HttpHeaders&) = default;
+    HttpHeaders& operator=(HttpHeaders&&) = default;
+
+    // ════════════════════════════════════════════════════════
+    // Lookup
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Value of a header (any case), empty if absent
+     */
+    std::string_view get(std::string_view name) const {
+        size_t index = find(name);
+        return index != kNone ? value_at(index) : std::string_view{};
+    }
+
+    std::string_view get(HeaderId id) const {
+        size_t index = known_[static_cast<size_t>(id)];
+        return index != kNone ? value_at(index) : std::string_view{};
+    }
+
+    bool contains(std::string_view name) const { return find(name) != kNone; }
+    bool contains(HeaderId id) const { return known_[static_cast<size_t>(id)] != kNone; }
+
+    // ════════════════════════════════════════════════════════
+    // Modification
+    // ════════════════════════════════════════════════════════
+
+    /**
+     * @brief Set a header, replacing any existing one with the same name
+     */
+    void set(std::string_view name, std::string_view value) {
+        size_t index = find(name);
+        if (index == kNone) {
+            add(name, value);
+            return;
+        }
+
+        Field& existing = fields_[index];
+        if (value.size() <= existing.value_length) {
+            // Overwrite in place; the block does not grow
+            text_.replace(existing.value_offset, value.size(), value);
+        } else {
+            existing.value_offset = static_cast<uint32_t>(text_.size());
+            text_.append(value);
+        }
+        existing.value_length = static_cast<uint32_t>(value.size());
+    }
+
+    void set(HeaderId id, std::string_view value) {
+        set(header_name(id), value);
+    }
+
+    /**
+     * @brief Append a header without looking for an existing one
+     *
+     * For a well-known id, lookups by id see the first one added.
+     */
+    void add(std::string_view name, std::string_view value) {
+        Field field{};
+        field.id = header_id(name);
+        field.name_offset = static_cast<uint32_t>(text_.size());
+        field.name_length = static_cast<uint32_t>(name.size());
+        text_.append(name);
+        field.value_offset = static_cast<uint32_t>(text_.size());
+        field.value_length = static_cast<uint32_t>(value.size());
+        text_.append(value);
+
+        size_t& known = known_[static_cast<size_t>(field.id)];
+        if (field.id != HeaderId::OTHER && known == kNone) {
+            known = fields_.size();
+        }
+        fields_.push_back(field);
+    }
+
+    /**
+     * @brief Remove every header with this name; returns how many
+     */
+    size_t erase(std::string_view name) {
+        size_t before = fields_.size();
+        size_t kept = 0;
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            if (!ascii_iequals(name_at(i), name)) {
+                fields_[kept++] = fields_[i];
+            }
+        }
+        fields_.resize(kept);
+        reindex();
+        return before - kept;
+    }
+
+    void clear() {
+        text_.clear();
+        fields_.clear();
+        known_.fill(kNone);
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Iteration
+    // ════════════════════════════════════════════════════════
+
+    size_t size() const { return fields_.size(); }
+    bool empty() const { return fields_.empty(); }
+
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, fields_.size()); }
+
+    value_type field(size_t index) const { return {name_at(index), value_at(index)}; }
+    HeaderId id_at(size_t index) const { return fields_[index].id; }
+
+    std::pmr::memory_resource* resource() const { return fields_.get_allocator().resource(); }
+
+private:
+    static constexpr size_t kNone = static_cast<size_t>(-1);
+
+    std::string_view name_at(size_t index) const {
+        const Field& f = fields_[index];
+        return std::string_view(text_.data() + f.name_offset, f.name_length);
+    }
+
+    std::string_view value_at(size_t index) const {
+        const Field& f = fields_[index];
+        return std::string_view(text_.data() + f.value_offset, f.value_length);
+    }
+
+    size_t find(std::string_view name) const {
+        HeaderId id = header_id(name);
+        if (id != HeaderId::OTHER) {
+            return known_[static_cast<size_t>(id)];
+        }
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            if (fields_[i].id == HeaderId::OTHER && ascii_iequals(name_at(i), name)) {
+                return i;
+            }
+        }
+        return kNone;
+    }
+
+    void reindex() {
+        known_.fill(kNone);
+        for (size_t i = 0; i < fields_.size(); ++i) {
+            size_t& known = known_[static_cast<size_t>(fields_[i].id)];
+            if (fields_[i].id != HeaderId::OTHER && known == kNone) {
+                known = i;
+            }
+        }
+    }
+
+    std::pmr::string text_;                 // Names and values, back to back
+    std::pmr::vector<Field> fields_;
+    std::array<size_t, static_cast<size_t>(HeaderId::COUNT_)> known_;   // Field index per id
+};
+
+} // namespace network
+} // namespace dfs
@@ -2,7 +2,10 @@
 
 #include "http_types.hpp"
 #include "dfs/core/result.hpp"
+#include <charconv>
+#include <optional>
 #include <string>
+#include <string_view>
 #include <cctype>
 
 namespace dfs {
@@ -31,7 +34,11 @@ enum class ParseState {
     VERSION,         // Parsing HTTP version
     HEADER_NAME,     // Parsing header field name
     HEADER_VALUE,    // Parsing header field value
-    BODY,            // Parsing request body
+    BODY,            // Parsing request body (Content-Length)
+    CHUNK_SIZE,      // Parsing a chunk-size line (Transfer-Encoding: chunked)
+    CHUNK_DATA,      // Parsing chunk data
+    CHUNK_DATA_END,  // Expecting the CRLF after chunk data
+    CHUNK_TRAILER,   // Parsing trailer lines after the last chunk
     COMPLETE,        // Parsing complete, request ready
     PARSE_ERROR      // Parsing error occurred (renamed to avoid Windows macro conflict)
 };
@@ -42,6 +49,14 @@ enum class ParseState {
  * This parser can handle incremental data (streaming). You can feed it
  * data chunk by chunk as it arrives from the socket.
  *
+ * Bodies are delimited by Content-Length or by "Transfer-Encoding: chunked"
+ * (chunks are joined into request.body; extensions and trailers are skipped).
+ *
+ * Bodies are capped at max_body_size() (64 MiB unless changed with
+ * set_max_body_size()). A Content-Length over the cap, or a chunked body
+ * whose chunks add up to more, fails the parse before the body is
+ * buffered, and error_status() turns to 413 Payload Too Large.
+ *
  * Usage example:
  * ```cpp
  * HttpParser parser;
@@ -63,8 +78,31 @@ enum class ParseState {
  */
 class HttpParser {
 public:
+    static constexpr size_t kDefaultMaxBodySize = 64 * 1024 * 1024;
+
     HttpParser() { reset(); }
 
+    /**
+     * @brief Largest request body accepted; kept across reset()
+     */
+    void set_max_body_size(size_t bytes) {
+        max_body_size_ = bytes;
+    }
+
+    size_t max_body_size() const {
+        return max_body_size_;
+    }
+
+    /**
+     * @brief Status to answer the last failed parse() with
+     *
+     * PAYLOAD_TOO_LARGE if the body exceeded max_body_size(), otherwise
+     * BAD_REQUEST.
+     */
+    HttpStatus error_status() const {
+        return error_status_;
+    }
+
     /**
      * @brief Parse incoming data
      *
@@ -113,6 +151,9 @@ public:
 
                 case ParseState::HEADER_NAME:
                     if (!parse_header_name(c)) {
+                        if (error_status_ == HttpStatus::PAYLOAD_TOO_LARGE) {
+                            return body_too_large();
+                        }
                         return Err<bool, std::string>("Failed to parse header name at line " +
                                        std::to_string(line_));
                     }
@@ -129,7 +170,33 @@ public:
                     parse_body(c);
                     break;
 
+                case ParseState::CHUNK_SIZE:
+                    if (!parse_chunk_size(c)) {
+                        if (error_status_ == HttpStatus::PAYLOAD_TOO_LARGE) {
+                            return body_too_large();
+                        }
+                        return Err<bool, std::string>("Failed to parse chunk size at line " +
+                                       std::to_string(line_));
+                    }
+                    break;
+
+                case ParseState::CHUNK_DATA:
+                    parse_chunk_data(c);
+                    break;
+
+                case ParseState::CHUNK_DATA_END:
+                    if (!parse_chunk_data_end(c)) {
+                        return Err<bool, std::string>("Missing CRLF after chunk data at line " +
+                                       std::to_string(line_));
+                    }
+                    break;
+
+                case ParseState::CHUNK_TRAILER:
+                    parse_chunk_trailer(c);
+                    break;
+
                 case ParseState::COMPLETE:
+                    consumed_ = i;
                     return Ok(true);
 
                 case ParseState::PARSE_ERROR:
@@ -138,11 +205,13 @@ public:
 
             // Check if parsing is complete
             if (state_ == ParseState::COMPLETE) {
+                consumed_ = i + 1;
                 return Ok(true);
             }
         }
 
         // More data needed
+        consumed_ = len;
         return Ok(false);
     }
 
@@ -154,7 +223,27 @@ public:
      * @return The parsed HTTP request
      */
     HttpRequest get_request() const {
-        return request_;
+        return *request_;
+    }
+
+    /**
+     * @brief The parsed request, in place (no copy)
+     *
+     * Allocated from the resource that was current at the last reset()
+     * (see ArenaScope). Valid until the next reset().
+     */
+    HttpRequest& request() {
+        return *request_;
+    }
+
+    /**
+     * @brief Bytes of the last parse() input that belong to this request
+     *
+     * When parse() returns true this may be less than len: the rest is
+     * the start of the next request on a keep-alive connection.
+     */
+    size_t consumed() const {
+        return consumed_;
     }
 
     /**
@@ -167,28 +256,46 @@ public:
     /**
      * @brief Reset parser to initial state
      *
-     * Call this to reuse the parser for a new request.
+     * Call this to reuse the parser for a new request. The next request
+     * allocates from request_resource(), i.e. the arena bound by an
+     * ArenaScope active at this point, if any. Token buffers keep their
+     * capacity, so a reused parser stops allocating for them.
      */
     void reset() {
         state_ = ParseState::METHOD;
-        request_ = HttpRequest();
+        request_.emplace(request_resource());
         buffer_.clear();
         current_header_name_.clear();
+        body_length_ = 0;
         body_bytes_read_ = 0;
+        chunk_remaining_ = 0;
+        in_chunk_extension_ = false;
+        consumed_ = 0;
         line_ = 1;
         column_ = 0;
         last_char_was_cr_ = false;
+        error_status_ = HttpStatus::BAD_REQUEST;
     }
 
 private:
     ParseState state_;
-    HttpRequest request_;
+    std::optional<HttpRequest> request_;
     std::string buffer_;                // Temporary buffer for current token
     std::string current_header_name_;   // Current header name being parsed
+    size_t body_length_;                // Content-Length, parsed once
     size_t body_bytes_read_;            // Number of body bytes read so far
+    size_t chunk_remaining_;            // Bytes left in the current chunk
+    bool in_chunk_extension_;           // Skipping ";name=value" after a chunk size
+    size_t consumed_;                   // Bytes used by the last parse() call
     size_t line_;                       // Current line (for error reporting)
     size_t column_;                     // Current column (for error reporting)
     bool last_char_was_cr_;             // Track \r for CRLF detection
+    size_t max_body_size_ = kDefaultMaxBodySize;
+    HttpStatus error_status_ = HttpStatus::BAD_REQUEST;
+
+    Result<bool> body_too_large() const {
+        return Err<bool, std::string>("Request body exceeds " + std::to_string(max_body_size_) + " bytes");
+    }
 
     /**
      * @brief Parse HTTP method (GET, POST, etc.)
@@ -203,8 +310,8 @@ private:
             if (buffer_.empty()) {
                 return false; // Empty method
             }
-            request_.method = HttpMethodUtils::from_string(buffer_);
-            if (request_.method == HttpMethod::UNKNOWN) {
+            request_->method = HttpMethodUtils::from_string(buffer_);
+            if (request_->method == HttpMethod::UNKNOWN) {
                 return false; // Unknown HTTP method
             }
             buffer_.clear();
@@ -234,7 +341,7 @@ private:
             if (buffer_.empty()) {
                 return false; // Empty URL
             }
-            request_.url = buffer_;
+            request_->url.assign(buffer_);
             buffer_.clear();
             state_ = ParseState::VERSION;
             return true;
@@ -265,9 +372,9 @@ private:
         if (c == '\n' && last_char_was_cr_) {
             // CRLF marks end of request line
             if (buffer_ == "HTTP/1.1") {
-                request_.version = HttpVersion::HTTP_1_1;
+                request_->version = HttpVersion::HTTP_1_1;
             } else if (buffer_ == "HTTP/1.0") {
-                request_.version = HttpVersion::HTTP_1_0;
+                request_->version = HttpVersion::HTTP_1_0;
             } else {
                 return false; // Unknown HTTP version
             }
@@ -302,12 +409,26 @@ private:
             // Empty line - headers complete, check for body
             last_char_was_cr_ = false;
 
-            // Check if request has a body (Content-Length header)
-            std::string content_length = request_.get_header("Content-Length");
+            // Chunked body: sizes come inline, Content-Length is ignored
+            if (ascii_iequals(request_->headers.get(HeaderId::TRANSFER_ENCODING), "chunked")) {
+                state_ = ParseState::CHUNK_SIZE;
+                return true;
+            }
+
+            // Check if request has a body (Content-Length header, any case)
+            std::string_view content_length = request_->headers.get(HeaderId::CONTENT_LENGTH);
             if (!content_length.empty()) {
-                size_t body_length = std::stoull(content_length);
-                if (body_length > 0) {
-                    request_.body.reserve(body_length);
+                const char* end = content_length.data() + content_length.size();
+                auto [ptr, ec] = std::from_chars(content_length.data(), end, body_length_);
+                if (ec != std::errc() || ptr != end) {
+                    return false; // Content-Length is not a number
+                }
+                if (body_length_ > max_body_size_) {
+                    error_status_ = HttpStatus::PAYLOAD_TOO_LARGE;
+                    return false; // Refused before reserving anything
+                }
+                if (body_length_ > 0) {
+                    request_->body.reserve(body_length_);
                     state_ = ParseState::BODY;
                     return true;
                 }
@@ -362,7 +483,7 @@ private:
 
         if (c == '\n' && last_char_was_cr_) {
             // CRLF marks end of header
-            request_.headers[current_header_name_] = buffer_;
+            request_->headers.set(current_header_name_, buffer_);
             buffer_.clear();
             current_header_name_.clear();
             last_char_was_cr_ = false;
@@ -382,17 +503,107 @@ private:
      * We read exactly that many bytes.
      */
     void parse_body(char c) {
-        request_.body.push_back(static_cast<uint8_t>(c));
+        request_->body.push_back(static_cast<uint8_t>(c));
         body_bytes_read_++;
 
         // Check if we've read the entire body
-        std::string content_length = request_.get_header("Content-Length");
-        size_t expected_length = std::stoull(content_length);
-
-        if (body_bytes_read_ >= expected_length) {
+        if (body_bytes_read_ >= body_length_) {
             state_ = ParseState::COMPLETE;
         }
     }
+
+    /**
+     * @brief Parse a chunk-size line (hex size, optional extensions, CRLF)
+     *
+     * Example: "1a;name=value\r\n" -> a 26-byte chunk follows.
+     * A size of 0 is the last chunk; trailer lines follow.
+     */
+    bool parse_chunk_size(char c) {
+        if (c == '\r') {
+            last_char_was_cr_ = true;
+            return true;
+        }
+
+        if (c == '\n' && last_char_was_cr_) {
+            last_char_was_cr_ = false;
+            in_chunk_extension_ = false;
+            if (buffer_.empty()) {
+                return false; // No size
+            }
+            const char* end = buffer_.data() + buffer_.size();
+            auto [ptr, ec] = std::from_chars(buffer_.data(), end, chunk_remaining_, 16);
+            if (ec != std::errc() || ptr != end) {
+                return false; // Not hex, or too large
+            }
+            if (chunk_remaining_ > max_body_size_ - request_->body.size()) {
+                error_status_ = HttpStatus::PAYLOAD_TOO_LARGE;
+                return false; // Joined chunks would pass the limit
+            }
+            buffer_.clear();
+            state_ = chunk_remaining_ == 0 ? ParseState::CHUNK_TRAILER : ParseState::CHUNK_DATA;
+            return true;
+        }
+
+        last_char_was_cr_ = false;
+        if (in_chunk_extension_) {
+            return true; // Extensions carry nothing we use
+        }
+        if (c == ';') {
+            in_chunk_extension_ = true;
+            return true;
+        }
+        if (!std::isxdigit(static_cast<unsigned char>(c)) || buffer_.size() >= 16) {
+            return false;
+        }
+
+        buffer_ += c;
+        return true;
+    }
+
+    void parse_chunk_data(char c) {
+        request_->body.push_back(static_cast<uint8_t>(c));
+        if (--chunk_remaining_ == 0) {
+            state_ = ParseState::CHUNK_DATA_END;
+        }
+    }
+
+    bool parse_chunk_data_end(char c) {
+        if (c == '\r' && !last_char_was_cr_) {
+            last_char_was_cr_ = true;
+            return true;
+        }
+        if (c == '\n' && last_char_was_cr_) {
+            last_char_was_cr_ = false;
+            state_ = ParseState::CHUNK_SIZE;
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Skip trailer fields; an empty line ends the request
+     *
+     * buffer_ holds the current trailer line only to tell an empty line
+     * from a field.
+     */
+    void parse_chunk_trailer(char c) {
+        if (c == '\r') {
+            last_char_was_cr_ = true;
+            return;
+        }
+
+        if (c == '\n' && last_char_was_cr_) {
+            last_char_was_cr_ = false;
+            if (buffer_.empty()) {
+                state_ = ParseState::COMPLETE;
+            }
+            buffer_.clear();
+            return;
+        }
+
+        last_char_was_cr_ = false;
+        buffer_ += c;
+    }
 };
 
 } // namespace network
@@ -6,6 +6,7 @@
 #include <unordered_map>
 #include <regex>
 #include <memory>
+#include <string_view>
 
 namespace dfs {
 namespace network {
@@ -40,6 +41,11 @@ using RouteHandler = std::function<HttpResponse(const HttpContext&)>;
  */
 using Middleware = std::function<bool(const HttpContext&, HttpResponse&)>;
 
+/**
+ * @brief Response filter type (runs after the handler, may rewrite the response)
+ */
+using ResponseFilter = std::function<void(const HttpContext&, HttpResponse&)>;
+
 /**
  * @brief Single route in the router
  */
@@ -53,10 +59,10 @@ struct Route {
     Route(HttpMethod m, const std::string& pat, RouteHandler h);
 
     // Check if this route matches the request
-    bool matches(HttpMethod method, const std::string& url) const;
+    bool matches(HttpMethod method, std::string_view url) const;
 
     // Extract URL parameters from matched URL
-    std::unordered_map<std::string, std::string> extract_params(const std::string& url) const;
+    std::unordered_map<std::string, std::string> extract_params(std::string_view url) const;
 };
 
 /**
@@ -66,6 +72,7 @@ struct Route {
  * - Method-based routing (GET, POST, PUT, DELETE, etc.)
  * - URL parameter extraction (/users/:id)
  * - Middleware support (logging, auth, etc.)
+ * - Response filters (compression, common headers)
  * - Route groups (/api/v1/...)
  * - Custom 404 handlers
  *
@@ -196,6 +203,23 @@ public:
      */
     void use(Middleware middleware);
 
+    /**
+     * @brief Add a filter to run on every response before it is returned
+     * @param filter Function that may rewrite the response (headers, body)
+     *
+     * Filters run in the order they're added, after the route handler, the
+     * 404 handler, or a middleware that short-circuited. Use them for work
+     * that needs the finished response, such as compression.
+     *
+     * Example:
+     * @code
+     * router.use_after([](const HttpContext& ctx, HttpResponse& res) {
+     *     res.set_header("X-Served-By", "dfs");
+     * });
+     * @endcode
+     */
+    void use_after(ResponseFilter filter);
+
     // ────────────────────────────────────────────────────────────
     // Custom Handlers
     // ────────────────────────────────────────────────────────────
@@ -236,6 +260,7 @@ public:
 private:
     std::vector<Route> routes_;
     std::vector<Middleware> middlewares_;
+    std::vector<ResponseFilter> filters_;
     RouteHandler not_found_handler_;
     std::string prefix_;  // For route groups
 
@@ -243,7 +268,10 @@ private:
     static HttpResponse default_not_found_handler(const HttpContext& ctx);
 
     // Find matching route for request
-    const Route* find_route(HttpMethod method, const std::string& url) const;
+    const Route* find_route(HttpMethod method, std::string_view url) const;
+
+    // Run middleware, then the matching handler (or 404 handler)
+    HttpResponse dispatch(HttpContext& ctx);
 };
 
 // ────────────────────────────────────────────────────────────
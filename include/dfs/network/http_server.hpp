@@ -1,18 +1,17 @@
 #pragma once
 
 #include "socket.hpp"
+#include "admission_controller.hpp"
 #include "http_parser.hpp"
 #include "http_types.hpp"
 #include "dfs/core/result.hpp"
+#include "dfs/core/work_stealing_pool.hpp"
 #include <functional>
 #include <memory>
 #include <string>
-#include <vector>
 #include <thread>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
 #include <atomic>
+#include <chrono>
 
 namespace dfs {
 namespace network {
@@ -33,17 +32,21 @@ using HttpRequestHandler = std::function<HttpResponse(const HttpRequest&)>;
  * maintaining bounded resource usage.
  *
  * Architecture:
- * - Main acceptor thread: Accepts connections and enqueues them
- * - Worker thread pool: Fixed number of threads that process requests
- * - Task queue: Decouples connection acceptance from processing
- * - Condition variables: Efficient synchronization without busy-waiting
+ * - Main acceptor thread: Accepts connections and submits them to the pool
+ * - WorkStealingPool: Fixed number of workers, each with its own queue;
+ *   idle workers steal, so there is no single queue lock to contend on
+ * - Idle workers park on an atomic wait instead of a condition variable
+ * - AdmissionController: sheds load with a pre-serialized 503 when the
+ *   queue is full, a client has too many connections, or the queue delay
+ *   stays above target (CoDel). Cheap routes are exempt from the last.
  *
  * Key features:
  * - Concurrent request handling (configurable thread count)
  * - HTTP/1.1 compliant parsing
  * - Graceful shutdown with thread joining
- * - Queue overflow protection (503 responses)
+ * - Load shedding with fast 503 + Retry-After (see AdmissionController)
  * - Connection tracking and monitoring
+ * - Per-worker request arena and pooled receive buffers (no per-request heap use)
  *
  * Thread safety:
  * - All public methods are thread-safe
@@ -99,6 +102,16 @@ public:
      */
     void set_handler(HttpRequestHandler handler);
 
+    /**
+     * @brief Configure load shedding (call before serve_forever)
+     */
+    void set_admission_config(AdmissionConfig config);
+
+    /**
+     * @brief Load shedding state and counters
+     */
+    const AdmissionController& admission() const { return admission_; }
+
     /**
      * @brief Start listening on a port
      *
@@ -123,8 +136,9 @@ public:
     /**
      * @brief Stop the server gracefully
      *
-     * Signals all worker threads to stop, wakes them up, and joins them.
-     * The serve_forever() loop will exit after cleanup completes.
+     * Stops accepting and closes the listener. serve_forever() then lets
+     * the workers finish the connections already queued, joins them and
+     * returns.
      */
     void stop();
 
@@ -145,6 +159,13 @@ public:
         return active_connections_.load(std::memory_order_relaxed);
     }
 
+    /**
+     * @brief Get number of accepted connections waiting for a worker
+     */
+    size_t get_queue_depth() const {
+        return queue_depth_.load(std::memory_order_relaxed);
+    }
+
     /**
      * @brief Get total number of requests processed
      */
@@ -158,31 +179,36 @@ private:
     HttpRequestHandler handler_;      // User-provided request handler
     uint16_t port_;                   // Port we're listening on
 
-    // Thread pool
-    std::vector<std::thread> worker_threads_;
+    // Thread pool (created by serve_forever)
+    std::unique_ptr<WorkStealingPool> pool_;
     size_t thread_pool_size_;
-
-    // Task queue
-    std::queue<std::unique_ptr<Socket>> task_queue_;
-    std::mutex queue_mutex_;
-    std::condition_variable queue_cv_;
     size_t max_queue_size_;
+    AdmissionController admission_;
 
     // State management (atomic for thread-safe access)
     std::atomic<bool> running_;
     std::atomic<size_t> active_connections_;
+    std::atomic<size_t> queue_depth_;  // Submitted connections not yet picked up
     std::atomic<size_t> total_processed_;
 
     /**
-     * @brief Worker thread function
+     * @brief Pool task for one accepted connection
      *
-     * Each worker thread runs this function in a loop:
-     * 1. Wait for task in queue (blocking on condition variable)
-     * 2. Pop task from queue
-     * 3. Process the connection
-     * 4. Repeat until shutdown signal
+     * Runs on a worker: sheds the connection if it waited too long in the
+     * queue, otherwise processes it, and updates the connection counters.
+     */
+    void process_connection(std::unique_ptr<Socket> client,
+                            std::chrono::steady_clock::time_point accepted_at);
+
+    /**
+     * @brief Peek at the request line: is it for a priority route?
+     */
+    bool is_priority_request(Socket& client);
+
+    /**
+     * @brief Write the pre-serialized 503 and close, without parsing
      */
-    void worker_thread();
+    void reject(Socket& client);
 
     /**
      * @brief Handle a single client connection
@@ -196,15 +222,28 @@ private:
     Result<void> handle_connection(std::unique_ptr<Socket> client);
 
     /**
-     * @brief Read a complete HTTP request from socket
+     * @brief Read, handle and answer one request
+     *
+     * Runs inside the worker's ArenaScope: the request, the response and
+     * the serialized bytes all come from the arena.
+     */
+    Result<void> serve_request(Socket& client, HttpParser& parser);
+
+    /**
+     * @brief Read a complete HTTP request from socket into parser.request()
      */
-    Result<HttpRequest> read_request(Socket& socket, HttpParser& parser);
+    Result<void> read_request(Socket& socket, HttpParser& parser);
 
     /**
      * @brief Send HTTP response to client
      */
     Result<void> send_response(Socket& socket, const HttpResponse& response);
 
+    /**
+     * @brief Send a pushed body, waiting on this worker for its wakes
+     */
+    Result<void> send_push(Socket& socket, const HttpResponse& response);
+
     /**
      * @brief Create an error response
      */
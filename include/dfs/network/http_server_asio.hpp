@@ -62,9 +62,10 @@ private:
     /**
      * @brief Handle parsing/protocol errors
      *
+     * @param status Response status (400, or 413 for an oversized body)
      * @param message Error message
      */
-    void handle_error(const std::string& message);
+    void handle_error(HttpStatus status, const std::string& message);
 
     /**
      * @brief Create error response (same logic as other servers)
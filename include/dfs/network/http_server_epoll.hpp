@@ -0,0 +1,174 @@
+#pragma once
+
+#include "socket.hpp"
+#include "http_parser.hpp"
+#include "http_types.hpp"
+#include "rpc.hpp"
+#include "dfs/core/result.hpp"
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+// Reuse the same handler type
+using HttpRequestHandler = std::function<HttpResponse(const HttpRequest&)>;
+
+/**
+ * @brief Event-driven HTTP/1.1 server on native Linux epoll
+ *
+ * HttpServer parks a worker thread on every in-flight connection, and
+ * HttpServerAsio needs Boost. This server gets Asio-style scalability
+ * from the kernel directly: a few threads each multiplex thousands of
+ * non-blocking sockets.
+ *
+ * Architecture:
+ * - N event loops, one per thread, each with its own epoll instance
+ * - The listening Socket (non-blocking) is registered in every loop with
+ *   EPOLLEXCLUSIVE, so the kernel wakes one loop per incoming connection;
+ *   that loop accepts and owns the connection for its lifetime
+ * - Connections are edge-triggered (EPOLLET): on each wakeup a loop reads
+ *   or writes until EAGAIN, then waits for the next edge
+ * - Keep-alive and pipelining: several requests can arrive on one
+ *   connection; responses are queued and written in order. Once more
+ *   than 1 MiB of responses is queued, the connection stops reading and
+ *   parsing (or dispatching RPC frames) until the peer has read them, so
+ *   a client that pipelines without reading cannot grow server memory
+ *   without bound
+ * - Per-loop hashed timer wheel closes connections idle longer than
+ *   idle_timeout (slowloris protection) at O(1) cost per activity
+ * - An eventfd per loop lets stop() wake loops blocked in epoll_wait
+ * - Binary RPC (see rpc.hpp) on the same port: a connection that opens
+ *   with kRpcPreamble switches to length-prefixed frames for good. Each
+ *   frame goes to the RPC handler with an RpcReply; replies sent from
+ *   other threads are queued to the loop and cost one eventfd write per
+ *   burst, so a connection has many requests in flight and gets their
+ *   replies in completion order
+ *
+ * Thread safety:
+ * - All public methods are thread-safe
+ * - Handler runs on the loop thread that owns the connection and may be
+ *   called concurrently from different loops. A slow handler delays the
+ *   other connections of its loop, as with HttpServerAsio.
+ * - The RPC handler runs on the loop thread too; anything slow should
+ *   move its RpcReply to a worker and return
+ *
+ * Platform: Linux only (built when CMake targets Linux; DFS_HAS_EPOLL).
+ *
+ * Usage:
+ * ```cpp
+ * HttpServerEpoll server(4);   // 4 event loops
+ * server.set_handler([](const HttpRequest& req) {
+ *     HttpResponse res(HttpStatus::OK);
+ *     res.set_body("Hello from epoll!");
+ *     return res;
+ * });
+ * auto result = server.listen(8080);
+ * if (result.is_ok()) {
+ *     server.serve_forever();
+ * }
+ * ```
+ */
+class HttpServerEpoll {
+public:
+    /**
+     * @brief Construct epoll server
+     *
+     * @param loop_count Number of event loop threads (default: CPU cores)
+     * @param idle_timeout Close connections with no I/O for this long
+     */
+    explicit HttpServerEpoll(
+        size_t loop_count = std::thread::hardware_concurrency(),
+        std::chrono::milliseconds idle_timeout = std::chrono::seconds(30)
+    );
+
+    ~HttpServerEpoll();
+
+    // Prevent copying and moving (loops point back at the server)
+    HttpServerEpoll(const HttpServerEpoll&) = delete;
+    HttpServerEpoll& operator=(const HttpServerEpoll&) = delete;
+    HttpServerEpoll(HttpServerEpoll&&) = delete;
+    HttpServerEpoll& operator=(HttpServerEpoll&&) = delete;
+
+    /**
+     * @brief Set the request handler function
+     *
+     * Must be set before serve_forever().
+     */
+    void set_handler(HttpRequestHandler handler);
+
+    /**
+     * @brief Serve binary RPC connections with this handler
+     *
+     * Optional; without it, a connection opening with kRpcPreamble gets
+     * a 400 like any other malformed request. Must be set before
+     * serve_forever().
+     */
+    void set_rpc_handler(RpcHandler handler);
+
+    /**
+     * @brief Bind, listen and create the event loops
+     *
+     * Port 0 picks a free port; get_port() returns it afterwards.
+     */
+    Result<void> listen(uint16_t port, const std::string& address = "0.0.0.0");
+
+    /**
+     * @brief Run all event loops (blocking)
+     *
+     * Loop 0 runs on the calling thread, the others on their own
+     * threads. Returns after stop() once every loop has exited.
+     */
+    Result<void> serve_forever();
+
+    /**
+     * @brief Ask all loops to exit; open connections are closed
+     */
+    void stop();
+
+    bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+    uint16_t get_port() const { return port_; }
+
+    /**
+     * @brief Currently open connections across all loops
+     */
+    size_t get_active_connections() const {
+        return active_connections_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Requests answered so far
+     */
+    size_t get_total_processed() const {
+        return total_processed_.load(std::memory_order_relaxed);
+    }
+
+private:
+    class EventLoop;
+
+    Socket listener_;
+    HttpRequestHandler handler_;
+    RpcHandler rpc_handler_;
+    uint16_t port_ = 0;
+    size_t loop_count_;
+    std::chrono::milliseconds idle_timeout_;
+
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> active_connections_{0};
+    std::atomic<size_t> total_processed_{0};
+
+    HttpResponse handle_request(const HttpRequest& request);
+    void handle_rpc(RpcRequest request, RpcReply reply);
+    static HttpResponse create_error_response(HttpStatus status, const std::string& message);
+};
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,172 @@
+#pragma once
+
+#include "socket.hpp"
+#include "http_parser.hpp"
+#include "http_types.hpp"
+#include "dfs/core/result.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+// Reuse the same handler type
+using HttpRequestHandler = std::function<HttpResponse(const HttpRequest&)>;
+
+/**
+ * @brief Experimental HTTP/1.1 server driven entirely by io_uring
+ *
+ * HttpServerEpoll still pays one syscall per accept, recv and send plus
+ * one epoll_wait per wakeup. Here the kernel performs the I/O itself and
+ * the loop only submits requests and reaps completions, so one
+ * io_uring_enter() covers a whole batch of accepts, receives and sends.
+ *
+ * Architecture:
+ * - N event loops, one per thread, each with its own ring (set up with
+ *   raw syscalls; liburing is not required)
+ * - Multishot accept: one submission per loop keeps producing a
+ *   completion for every new connection on the shared listener
+ * - Multishot recv with a provided buffer ring: the kernel picks a free
+ *   receive buffer from a per-loop pool when data arrives, so idle
+ *   connections hold no buffer; the loop hands it back after parsing
+ * - Linked send -> shutdown -> close: a response that ends the connection
+ *   is submitted together with its teardown in a single batch
+ * - Keep-alive and pipelining as in HttpServerEpoll, including the 1 MiB
+ *   cap on queued responses: past it the connection's multishot recv is
+ *   cancelled and re-armed once everything queued has been sent
+ * - A read on an eventfd per loop lets stop() wake a loop blocked in
+ *   io_uring_enter()
+ *
+ * Differences from HttpServerEpoll:
+ * - No idle timeout yet (connections stay open until the peer closes)
+ * - Needs Linux 6.0+ (multishot recv); listen() fails cleanly if the
+ *   kernel or a seccomp policy refuses io_uring
+ *
+ * Thread safety:
+ * - All public methods are thread-safe
+ * - Handler runs on the loop thread that owns the connection and may be
+ *   called concurrently from different loops
+ *
+ * Platform: Linux only (built when the kernel headers provide the ring
+ * buffer API; DFS_HAS_IO_URING).
+ *
+ * Usage:
+ * ```cpp
+ * HttpServerUring server(4);   // 4 rings
+ * server.set_handler([](const HttpRequest& req) {
+ *     HttpResponse res(HttpStatus::OK);
+ *     res.set_body("Hello from io_uring!");
+ *     return res;
+ * });
+ * auto result = server.listen(8080);
+ * if (result.is_ok()) {
+ *     server.serve_forever();
+ * }
+ * ```
+ */
+class HttpServerUring {
+public:
+    /**
+     * @brief Construct io_uring server
+     *
+     * @param loop_count Number of event loop threads, one ring each (default: CPU cores)
+     */
+    explicit HttpServerUring(size_t loop_count = std::thread::hardware_concurrency());
+
+    ~HttpServerUring();
+
+    // Prevent copying and moving (loops point back at the server)
+    HttpServerUring(const HttpServerUring&) = delete;
+    HttpServerUring& operator=(const HttpServerUring&) = delete;
+    HttpServerUring(HttpServerUring&&) = delete;
+    HttpServerUring& operator=(HttpServerUring&&) = delete;
+
+    /**
+     * @brief Set the request handler function
+     *
+     * Must be set before serve_forever().
+     */
+    void set_handler(HttpRequestHandler handler);
+
+    /**
+     * @brief Bind, listen and set up one ring per loop
+     *
+     * Port 0 picks a free port; get_port() returns it afterwards.
+     * Fails if io_uring is unavailable.
+     */
+    Result<void> listen(uint16_t port, const std::string& address = "0.0.0.0");
+
+    /**
+     * @brief Run all event loops (blocking)
+     *
+     * Loop 0 runs on the calling thread, the others on their own
+     * threads. Returns after stop() once every loop has exited.
+     */
+    Result<void> serve_forever();
+
+    /**
+     * @brief Ask all loops to exit; open connections are closed
+     */
+    void stop();
+
+    bool is_running() const { return running_.load(std::memory_order_acquire); }
+
+    uint16_t get_port() const { return port_; }
+
+    /**
+     * @brief Currently open connections across all loops
+     */
+    size_t get_active_connections() const {
+        return active_connections_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Requests answered so far
+     */
+    size_t get_total_processed() const {
+        return total_processed_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief io_uring_enter() calls made by all loops
+     *
+     * Together with get_total_processed() this gives syscalls per
+     * request, the number to compare against the epoll server.
+     */
+    size_t get_enter_calls() const {
+        return enter_calls_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Submission queue entries handed to the kernel
+     */
+    size_t get_submitted_ops() const {
+        return submitted_ops_.load(std::memory_order_relaxed);
+    }
+
+private:
+    class EventLoop;
+
+    Socket listener_;
+    HttpRequestHandler handler_;
+    uint16_t port_ = 0;
+    size_t loop_count_;
+
+    std::vector<std::unique_ptr<EventLoop>> loops_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<size_t> active_connections_{0};
+    std::atomic<size_t> total_processed_{0};
+    std::atomic<size_t> enter_calls_{0};
+    std::atomic<size_t> submitted_ops_{0};
+
+    HttpResponse handle_request(const HttpRequest& request);
+    static HttpResponse create_error_response(HttpStatus status, const std::string& message);
+};
+
+} // namespace network
+} // namespace dfs
@@ -1,16 +1,16 @@
 #pragma once
 
+#include "connection_arena.hpp"
+#include "http_headers.hpp"
+#include <charconv>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <memory_resource>
 #include <string>
-#include <unordered_map>
+#include <string_view>
 #include <vector>
 #include <cstdint>
-#include <sstream>
-#include <cstring>  // For _stricmp on Windows, strcasecmp on Unix
-
-// For strcasecmp on Unix/Linux
-#ifndef _WIN32
-#include <strings.h>
-#endif
 
 namespace dfs {
 namespace network {
@@ -56,11 +56,13 @@ enum class HttpStatus {
     OK = 200,                    // Request succeeded
     CREATED = 201,               // Resource created
     NO_CONTENT = 204,            // Success but no content to return
+    NOT_MODIFIED = 304,          // Conditional GET: client's copy is current
     BAD_REQUEST = 400,           // Client error - malformed request
     UNAUTHORIZED = 401,          // Authentication required
     FORBIDDEN = 403,             // Access denied
     NOT_FOUND = 404,             // Resource not found
     METHOD_NOT_ALLOWED = 405,    // Method not supported for resource
+    PAYLOAD_TOO_LARGE = 413,     // Request body over the server's limit
     INTERNAL_SERVER_ERROR = 500, // Server error
     NOT_IMPLEMENTED = 501,       // Method not implemented
     SERVICE_UNAVAILABLE = 503    // Server overloaded or down
@@ -86,57 +88,85 @@ enum class HttpStatus {
  * because body might contain binary data (images, files, etc.)
  */
 struct HttpRequest {
+    using Headers = HttpHeaders;
+
     HttpMethod method = HttpMethod::UNKNOWN;
-    std::string url;                                      // Request URI (e.g., "/api/files")
+    std::pmr::string url;                                 // Request URI (e.g., "/api/files")
     HttpVersion version = HttpVersion::HTTP_1_1;
-    std::unordered_map<std::string, std::string> headers; // Case-sensitive headers
-    std::vector<uint8_t> body;                           // Request body (optional)
+    Headers headers;                                      // Case-insensitive headers
+    std::pmr::vector<uint8_t> body;                       // Request body (optional)
+
+    // Allocates from the arena bound to this thread, if any (see connection_arena.hpp)
+    HttpRequest() : HttpRequest(request_resource()) {}
+
+    explicit HttpRequest(std::pmr::memory_resource* resource)
+        : url(resource), headers(resource), body(resource) {}
+
+    // Copies always use the default resource, so they may outlive the arena
+    HttpRequest(const HttpRequest&) = default;
+    HttpRequest(HttpRequest&&) = default;
+    HttpRequest& operator=(const HttpRequest&) = default;
+    HttpRequest& operator=(HttpRequest&&) = default;
+
+    std::string get_header(std::string_view name) const {
+        return std::string(headers.get(name));
+    }
+
+    bool has_header(std::string_view name) const {
+        return headers.contains(name);
+    }
+
+    std::string body_as_string() const {
+        return std::string(body.begin(), body.end());
+    }
+};
+
+/**
+ * @brief Body of a response that stays open and is fed by events
+ *
+ * Long-poll and Server-Sent Events responses wait for something to
+ * happen elsewhere (a file changes) before they have output. Blocking a
+ * thread per waiting client does not scale to thousands of idle clients,
+ * so instead the server parks the connection and calls pull() again only
+ * when the body wakes it (watch()) or its deadline() passes.
+ *
+ * Output is sent chunked, one chunk per pull() that produced bytes.
+ *
+ * Backends:
+ * - HttpServerEpoll parks the connection on its event loop.
+ * - HttpServer keeps the worker thread waiting (works, does not scale).
+ * - serialize_into() (HttpServerUring) sends what is ready at once and
+ *   ends the body: a long-poll returns immediately.
+ */
+class PushBody {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    virtual ~PushBody() = default;
 
     /**
-     * @brief Get a header value (case-insensitive lookup)
-     *
-     * HTTP headers are case-insensitive per RFC 7230, but we store them
-     * as-is. This helper performs case-insensitive lookup.
-     *
-     * @param name Header name (e.g., "Content-Type" or "content-type")
-     * @return Header value if found, empty string otherwise
+     * @brief Append output that is ready now to out
+     * @return false once the body is complete (out holds its last piece)
      */
-    std::string get_header(const std::string& name) const {
-        // Simple case-insensitive comparison
-        for (const auto& [key, value] : headers) {
-            if (strcasecmp_cross_platform(key.c_str(), name.c_str()) == 0) {
-                return value;
-            }
-        }
-        return "";
-    }
+    virtual bool pull(std::string& out, Clock::time_point now) = 0;
 
     /**
-     * @brief Check if a specific header exists
+     * @brief pull() is due at this time even without a wake (timeouts, heartbeats)
      */
-    bool has_header(const std::string& name) const {
-        return !get_header(name).empty();
-    }
+    virtual Clock::time_point deadline() const = 0;
 
     /**
-     * @brief Get the body as a string (for text content)
+     * @brief Call wake (from any thread) whenever pull() may have new output
      *
-     * Warning: Only use this if you know the body contains text!
-     * For binary data, use the body vector directly.
+     * At most one watcher at a time. wake must be cheap and must not call
+     * back into the body.
      */
-    std::string body_as_string() const {
-        return std::string(body.begin(), body.end());
-    }
+    virtual void watch(std::function<void()> wake) = 0;
 
-private:
-    // Cross-platform case-insensitive string comparison
-    static int strcasecmp_cross_platform(const char* s1, const char* s2) {
-#ifdef _WIN32
-        return _stricmp(s1, s2);
-#else
-        return strcasecmp(s1, s2);
-#endif
-    }
+    /**
+     * @brief Drop the watcher; once this returns wake is not running and never runs again
+     */
+    virtual void unwatch() = 0;
 };
 
 /**
@@ -154,108 +184,222 @@ private:
  * Content-Length: 13
  *
  * Hello, World!
+ *
+ * Streamed bodies: instead of a complete body, a response can carry a
+ * BodyProducer (set_body_stream). It is sent with
+ * "Transfer-Encoding: chunked", one chunk per producer call, so a large
+ * listing starts flowing before it is fully built and the server holds
+ * one piece of it at a time.
+ *
+ * Pushed bodies (set_body_push) are streams whose pieces arrive later,
+ * driven by events rather than pulled back to back; see PushBody.
  */
 struct HttpResponse {
-    HttpVersion version = HttpVersion::HTTP_1_1;
-    int status_code = 200;
-    std::string reason_phrase;                            // e.g., "OK", "Not Found"
-    std::unordered_map<std::string, std::string> headers;
-    std::vector<uint8_t> body;
+    using Headers = HttpHeaders;
 
     /**
-     * @brief Construct a response with a status code
+     * @brief Pull-based body source for streamed responses
      *
-     * Automatically sets the reason phrase based on the status code.
+     * Called repeatedly with an empty string to append the next piece of
+     * the body to. Returns false once the piece it just wrote is the last.
+     * A producer is copied along with its response, so it should keep its
+     * state behind a shared_ptr.
      */
-    HttpResponse() = default;
+    using BodyProducer = std::function<bool(std::string& chunk)>;
+
+    HttpVersion version = HttpVersion::HTTP_1_1;
+    int status_code = 200;
+    std::pmr::string reason_phrase;                       // e.g., "OK", "Not Found"
+    Headers headers;
+    std::pmr::vector<uint8_t> body;
+    BodyProducer stream;                                  // Replaces body when set
+    std::shared_ptr<PushBody> push;                       // Replaces body when set
+
+    // Allocates from the arena bound to this thread, if any (see connection_arena.hpp)
+    HttpResponse() : HttpResponse(request_resource()) {}
+
+    explicit HttpResponse(std::pmr::memory_resource* resource)
+        : reason_phrase(resource), headers(resource), body(resource) {}
 
     explicit HttpResponse(HttpStatus status)
-        : status_code(static_cast<int>(status))
-        , reason_phrase(get_reason_phrase(status)) {
+        : HttpResponse() {
+        status_code = static_cast<int>(status);
+        reason_phrase = get_reason_phrase(status);
     }
 
-    /**
-     * @brief Set response body from a string
-     *
-     * This is a convenience method for text responses.
-     * Automatically sets Content-Length header.
-     *
-     * @param content Text content to set as body
-     */
-    void set_body(const std::string& content) {
+    // Copies always use the default resource, so they may outlive the arena
+    HttpResponse(const HttpResponse&) = default;
+    HttpResponse(HttpResponse&&) = default;
+    HttpResponse& operator=(const HttpResponse&) = default;
+    HttpResponse& operator=(HttpResponse&&) = default;
+
+    void set_body(std::string_view content) {
         body.assign(content.begin(), content.end());
-        headers["Content-Length"] = std::to_string(body.size());
+        set_content_length();
+    }
+
+    void set_body(const std::vector<uint8_t>& data) {
+        body.assign(data.begin(), data.end());
+        set_content_length();
     }
 
     /**
-     * @brief Set response body from binary data
-     *
-     * @param data Binary data to set as body
+     * @brief Stream the body from a producer with chunked encoding
      */
-    void set_body(const std::vector<uint8_t>& data) {
-        body = data;
-        headers["Content-Length"] = std::to_string(body.size());
+    void set_body_stream(BodyProducer producer) {
+        stream = std::move(producer);
+        body.clear();
+        headers.erase(header_name(HeaderId::CONTENT_LENGTH));
+        headers.set(HeaderId::TRANSFER_ENCODING, "chunked");
+    }
+
+    bool is_streaming() const {
+        return static_cast<bool>(stream);
     }
 
     /**
-     * @brief Set a header value
+     * @brief Keep the response open and send what the body pushes, chunked
      */
-    void set_header(const std::string& name, const std::string& value) {
-        headers[name] = value;
+    void set_body_push(std::shared_ptr<PushBody> body) {
+        push = std::move(body);
+        stream = nullptr;
+        this->body.clear();
+        headers.erase(header_name(HeaderId::CONTENT_LENGTH));
+        headers.set(HeaderId::TRANSFER_ENCODING, "chunked");
+    }
+
+    bool is_push() const {
+        return static_cast<bool>(push);
+    }
+
+    void set_header(std::string_view name, std::string_view value) {
+        headers.set(name, value);
     }
 
     /**
-     * @brief Serialize the response to bytes for transmission
+     * @brief Append the wire format to out (any byte container)
      *
-     * Converts the response object into the HTTP wire format.
-     * This is what gets sent over the socket.
-     *
-     * Format:
-     * HTTP/1.1 200 OK\r\n
-     * Content-Type: text/html\r\n
-     * Content-Length: 13\r\n
-     * \r\n
-     * Hello, World!
-     *
-     * @return Serialized response as byte vector
+     * Builds nothing on the heap itself: with a pmr vector from the same
+     * arena, serializing a response allocates only from the arena. A
+     * streamed body is drained completely here; servers that want to send
+     * it piece by piece use serialize_head_into() and write_next_chunk().
      */
-    std::vector<uint8_t> serialize() const {
-        std::ostringstream oss;
+    template <typename Bytes>
+    void serialize_into(Bytes& out) const {
+        serialize_head_into(out);
+        if (is_streaming()) {
+            std::string scratch;
+            while (write_next_chunk(out, scratch)) {
+            }
+            return;
+        }
+        if (is_push()) {
+            // No event loop to park on: send what is ready and end the body
+            std::string scratch;
+            push->pull(scratch, PushBody::Clock::now());
+            write_chunk(out, scratch);
+            write_last_chunk(out);
+            return;
+        }
+        out.insert(out.end(), body.begin(), body.end());
+    }
+
+    /**
+     * @brief Append the status line, headers and the blank line after them
+     */
+    template <typename Bytes>
+    void serialize_head_into(Bytes& out) const {
+        auto append = [&out](std::string_view text) {
+            out.insert(out.end(), text.begin(), text.end());
+        };
 
         // Status line
-        oss << version_to_string(version) << " "
-            << status_code << " "
-            << reason_phrase << "\r\n";
+        char code[16];
+        auto code_end = std::to_chars(code, code + sizeof(code), status_code).ptr;
+        append(version_to_string(version));
+        append(" ");
+        append(std::string_view(code, static_cast<size_t>(code_end - code)));
+        append(" ");
+        append(reason_phrase);
+        append("\r\n");
 
         // Headers
         for (const auto& [name, value] : headers) {
-            oss << name << ": " << value << "\r\n";
+            append(name);
+            append(": ");
+            append(value);
+            append("\r\n");
         }
 
         // Empty line separates headers from body
-        oss << "\r\n";
-
-        // Convert to bytes
-        std::string header_str = oss.str();
-        std::vector<uint8_t> result(header_str.begin(), header_str.end());
+        append("\r\n");
+    }
 
-        // Append body
-        result.insert(result.end(), body.begin(), body.end());
+    /**
+     * @brief Pull one piece from the producer and append it chunk-encoded
+     *
+     * @param scratch Reused buffer for the producer's output
+     * @return true if more chunks follow; false once the terminating
+     *         zero-length chunk has been appended as well
+     */
+    template <typename Bytes>
+    bool write_next_chunk(Bytes& out, std::string& scratch) const {
+        return pull_chunk(stream, out, scratch);
+    }
 
-        return result;
+    /**
+     * @brief write_next_chunk() for a producer detached from its response
+     */
+    template <typename Bytes>
+    static bool pull_chunk(const BodyProducer& producer, Bytes& out, std::string& scratch) {
+        scratch.clear();
+        bool more = producer(scratch);
+        write_chunk(out, scratch);
+        if (!more) {
+            write_last_chunk(out);
+        }
+        return more;
     }
 
     /**
-     * @brief Get the standard reason phrase for a status code
+     * @brief Append data as one chunk (nothing if data is empty)
      */
-    static std::string get_reason_phrase(HttpStatus status) {
+    template <typename Bytes>
+    static void write_chunk(Bytes& out, std::string_view data) {
+        if (data.empty()) {
+            return;   // A zero-size chunk would end the body
+        }
+        // chunk = chunk-size (hex) CRLF chunk-data CRLF
+        char size[24];
+        auto size_end = std::to_chars(size, size + sizeof(size), data.size(), 16).ptr;
+        out.insert(out.end(), size, size_end);
+        out.insert(out.end(), {'\r', '\n'});
+        out.insert(out.end(), data.begin(), data.end());
+        out.insert(out.end(), {'\r', '\n'});
+    }
+
+    template <typename Bytes>
+    static void write_last_chunk(Bytes& out) {
+        constexpr std::string_view last_chunk = "0\r\n\r\n";
+        out.insert(out.end(), last_chunk.begin(), last_chunk.end());
+    }
+
+    std::vector<uint8_t> serialize() const {
+        std::vector<uint8_t> result;
+        serialize_into(result);
+        return result;
+    }
+
+    static std::string_view get_reason_phrase(HttpStatus status) {
         switch (status) {
             case HttpStatus::OK: return "OK";
             case HttpStatus::CREATED: return "Created";
             case HttpStatus::NO_CONTENT: return "No Content";
+            case HttpStatus::NOT_MODIFIED: return "Not Modified";
             case HttpStatus::BAD_REQUEST: return "Bad Request";
             case HttpStatus::NOT_FOUND: return "Not Found";
             case HttpStatus::METHOD_NOT_ALLOWED: return "Method Not Allowed";
+            case HttpStatus::PAYLOAD_TOO_LARGE: return "Payload Too Large";
             case HttpStatus::INTERNAL_SERVER_ERROR: return "Internal Server Error";
             case HttpStatus::NOT_IMPLEMENTED: return "Not Implemented";
             case HttpStatus::SERVICE_UNAVAILABLE: return "Service Unavailable";
@@ -263,16 +407,26 @@ struct HttpResponse {
         }
     }
 
-    /**
-     * @brief Convert HTTP version to string representation
-     */
-    static std::string version_to_string(HttpVersion version) {
+    static std::string_view version_to_string(HttpVersion version) {
         switch (version) {
             case HttpVersion::HTTP_1_0: return "HTTP/1.0";
             case HttpVersion::HTTP_1_1: return "HTTP/1.1";
             default: return "HTTP/1.1";
         }
     }
+
+private:
+    void set_content_length() {
+        if (stream || push) {
+            // A complete body replaces an earlier stream
+            stream = nullptr;
+            push = nullptr;
+            headers.erase(header_name(HeaderId::TRANSFER_ENCODING));
+        }
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), body.size()).ptr;
+        headers.set(HeaderId::CONTENT_LENGTH, std::string_view(digits, static_cast<size_t>(end - digits)));
+    }
 };
 
 /**
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+namespace dfs {
+namespace network {
+
+/**
+ * Binary RPC wire format
+ *
+ * Sync traffic over HTTP pays for a request line, a dozen headers, a JSON
+ * body (hex for file data) and several parses per call. An RPC connection
+ * pays a 10-byte frame header and copies the payload once.
+ *
+ * A connection starts with kRpcPreamble (client → server, once) and then
+ * carries frames in both directions, all integers big-endian:
+ *
+ *   [type: 1][flags: 1][request_id: 4][length: 4][payload: length bytes]
+ *
+ * - type: the operation; a reply carries the type of its request
+ * - flags: kRpcReply on replies; kRpcError marks a payload that is an
+ *   error message, kRpcBusy one the client should retry later
+ * - request_id: chosen by the client and echoed on the reply. Requests
+ *   are multiplexed: many may be outstanding, and replies come back in
+ *   completion order, not request order.
+ *
+ * Payloads are opaque here; the sync operations encode theirs with the
+ * metadata Serializer (see dfs/sync/rpc.hpp).
+ */
+inline constexpr std::string_view kRpcPreamble{"\0DFSRPC1", 8};   // '\0' never starts HTTP
+inline constexpr size_t kRpcHeaderSize = 10;
+inline constexpr uint32_t kRpcMaxPayload = 64u * 1024 * 1024;
+
+inline constexpr uint8_t kRpcReply = 0x01;
+inline constexpr uint8_t kRpcError = 0x02;
+inline constexpr uint8_t kRpcBusy = 0x04;
+
+struct RpcFrameHeader {
+    uint8_t type = 0;
+    uint8_t flags = 0;
+    uint32_t request_id = 0;
+    uint32_t length = 0;
+
+    void encode(uint8_t* out) const {
+        out[0] = type;
+        out[1] = flags;
+        put32(out + 2, request_id);
+        put32(out + 6, length);
+    }
+
+    static RpcFrameHeader decode(const uint8_t* in) {
+        return {in[0], in[1], get32(in + 2), get32(in + 6)};
+    }
+
+    // Header and payload appended to out
+    void append_to(std::vector<uint8_t>& out, const uint8_t* payload) const {
+        size_t start = out.size();
+        out.resize(start + kRpcHeaderSize + length);
+        encode(out.data() + start);
+        if (length > 0) {
+            std::copy(payload, payload + length, out.data() + start + kRpcHeaderSize);
+        }
+    }
+
+private:
+    static void put32(uint8_t* out, uint32_t value) {
+        out[0] = static_cast<uint8_t>(value >> 24);
+        out[1] = static_cast<uint8_t>(value >> 16);
+        out[2] = static_cast<uint8_t>(value >> 8);
+        out[3] = static_cast<uint8_t>(value);
+    }
+
+    static uint32_t get32(const uint8_t* in) {
+        return (uint32_t{in[0]} << 24) | (uint32_t{in[1]} << 16) | (uint32_t{in[2]} << 8) | uint32_t{in[3]};
+    }
+};
+
+/**
+ * @brief One request frame, payload copied out of the receive buffer
+ */
+struct RpcRequest {
+    uint8_t type = 0;
+    uint32_t request_id = 0;
+    std::vector<uint8_t> payload;
+};
+
+namespace detail {
+
+// Where replies go: the event loop that owns the connection
+class RpcReplySink {
+public:
+    virtual ~RpcReplySink() = default;
+    virtual void deliver(int fd, uint64_t connection_id, RpcFrameHeader header,
+                         std::vector<uint8_t> payload) = 0;
+};
+
+} // namespace detail
+
+/**
+ * @brief Answers one RpcRequest, from any thread, exactly once
+ *
+ * A handler may reply before returning (cheap operations) or move the
+ * reply to another thread and answer later; the connection keeps
+ * serving other requests meanwhile. A reply destroyed without an answer
+ * sends an error, so the client is never left waiting. Replies for a
+ * connection (or server) that is gone are dropped.
+ */
+class RpcReply {
+public:
+    RpcReply() = default;
+    RpcReply(std::shared_ptr<detail::RpcReplySink> sink, int fd, uint64_t connection_id,
+             uint8_t type, uint32_t request_id)
+        : sink_(std::move(sink)), fd_(fd), connection_id_(connection_id)
+        , type_(type), request_id_(request_id) {}
+
+    RpcReply(RpcReply&& other) noexcept { *this = std::move(other); }
+    RpcReply& operator=(RpcReply&& other) noexcept;
+    RpcReply(const RpcReply&) = delete;
+    RpcReply& operator=(const RpcReply&) = delete;
+
+    ~RpcReply();
+
+    // A payload over kRpcMaxPayload cannot be framed; it is answered with
+    // an error instead, which keeps the connection usable
+    void send(std::vector<uint8_t> payload = {});
+
+    // busy: the request was not run and may be sent again later
+    void fail(std::string_view message, bool busy = false);
+
+    bool pending() const { return sink_ != nullptr; }
+    uint32_t request_id() const { return request_id_; }
+
+private:
+    void deliver(uint8_t flags, std::vector<uint8_t> payload);
+
+    std::shared_ptr<detail::RpcReplySink> sink_;
+    int fd_ = -1;
+    uint64_t connection_id_ = 0;
+    uint8_t type_ = 0;
+    uint32_t request_id_ = 0;
+};
+
+using RpcHandler = std::function<void(RpcRequest request, RpcReply reply)>;
+
+} // namespace network
+} // namespace dfs
@@ -43,15 +43,30 @@ public:
     Result<void> connect(const std::string& address, uint16_t port);
     
     Result<size_t> send(const std::vector<uint8_t>& data);
+    Result<size_t> send(const uint8_t* data, size_t size);
     Result<std::vector<uint8_t>> receive(size_t max_size);
+
+    // Receive into a caller-owned buffer (e.g. a BufferPool lease); no allocation
+    Result<size_t> receive_into(uint8_t* buffer, size_t max_size);
+
+    // Look at pending bytes without consuming them (MSG_PEEK)
+    Result<size_t> peek(uint8_t* buffer, size_t max_size);
     
     Result<void> set_non_blocking(bool enable);
     Result<void> set_reuse_address(bool enable);
     
+    // Wakes a thread blocked in accept()/recv() on this socket; close() does not
+    void shutdown();
     void close();
     bool is_valid() const { return socket_ != INVALID_SOCKET_VALUE; }
     
     socket_t native_handle() const { return socket_; }
+
+    // Port the socket is bound to (the kernel's pick after bind(..., 0))
+    Result<uint16_t> local_port() const;
+
+    // IPv4 address of the peer in host byte order (accepted sockets only, else 0)
+    uint32_t peer_address() const { return peer_address_; }
     
     static std::unique_ptr<Socket> create_from_native(socket_t socket) {
         return std::unique_ptr<Socket>(new Socket(socket));
@@ -63,6 +78,7 @@ private:
     socket_t socket_;
     SocketType type_;
     bool is_connected_;
+    uint32_t peer_address_;
     
     static bool platform_initialized_;
     static Result<void> initialize_platform();
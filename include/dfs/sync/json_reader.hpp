@@ -0,0 +1,36 @@
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/sync/rpc.hpp"
+#include "dfs/sync/types.hpp"
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace dfs::sync {
+
+// Decodes the JSON the sync API receives straight into its structs; the
+// reading side of JsonWriter.
+//
+// /api/sync/diff used to json::parse the client's snapshot into a DOM and
+// then copy every field out of it. The reader makes two passes instead:
+// index_structurals() classifies 64 bytes per step (SSE2 on x86-64, a
+// scalar loop elsewhere) and records where the structure is, then the
+// decoder walks that index and reads fields into FileMetadata directly.
+// Per entry, only the entry's own strings are allocated.
+//
+// The input is validated as JSON and unknown keys are skipped. Missing
+// fields keep their defaults, as value(key, default) did on the DOM.
+// Numbers read into integer fields must be integers.
+
+// Offsets of {}[]:, outside strings and of every unescaped quote, in order
+Result<std::vector<std::uint32_t>> index_structurals(std::string_view json);
+
+// An array of FileMetadata objects, as write_metadata_array() writes it
+Result<std::vector<FileMetadata>> parse_metadata_array(std::string_view json);
+
+// The /api/sync/diff body: {"session_id": "...", "snapshot": [...]}
+Result<rpc::DiffArgs> parse_diff_request(std::string_view body);
+
+} // namespace dfs::sync
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "dfs/sync/types.hpp"
+
+#include <charconv>
+#include <concepts>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs::sync {
+
+// Appends compact JSON to a string the caller owns: a response body, a
+// chunk of a streamed body, or a cached snapshot.
+//
+// The JSON API's listings used to go through nlohmann::json: a DOM
+// object per file, a DOM array of them, then a dump into a fresh string
+// copied into the body. A 1M-entry snapshot meant millions of small
+// allocations before the first byte was written. The writer appends
+// straight to the destination; the only allocations are its growth.
+//
+// Commas are placed by the writer; the caller only has to balance
+// begin_*/end_* and put a key() before each value inside an object.
+// Strings are escaped as JSON requires; bytes >= 0x80 pass through, so
+// UTF-8 paths stay UTF-8.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) : out_(out) {}
+
+    JsonWriter& begin_object() { return open('{'); }
+    JsonWriter& end_object() { return close('}'); }
+    JsonWriter& begin_array() { return open('['); }
+    JsonWriter& end_array() { return close(']'); }
+
+    JsonWriter& key(std::string_view name);
+
+    JsonWriter& value(std::string_view text);
+    JsonWriter& value(const char* text) { return value(std::string_view(text)); }
+    JsonWriter& value(bool flag);
+
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    JsonWriter& value(T number) {
+        separate();
+        char digits[24];
+        auto end = std::to_chars(digits, digits + sizeof(digits), number).ptr;
+        out_.append(digits, end);
+        need_comma_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(const std::vector<std::string>& strings);
+
+    // key(name).value(v)
+    template <typename T>
+    JsonWriter& field(std::string_view name, const T& v) {
+        return key(name).value(v);
+    }
+
+    std::string& output() { return out_; }
+
+private:
+    JsonWriter& open(char bracket);
+    JsonWriter& close(char bracket);
+
+    void separate() {
+        if (need_comma_) {
+            out_ += ',';
+        }
+    }
+
+    std::string& out_;
+    bool need_comma_ = false;   // A value was written in the current container
+};
+
+// Same fields as the JSON API has always sent
+void write_json(JsonWriter& out, const FileMetadata& metadata);
+void write_json(JsonWriter& out, const SyncSessionInfo& info);
+void write_json(JsonWriter& out, const DiffResponse& diff);
+
+// JSON array of `files`; fits SnapshotCache::Serializer
+void write_metadata_array(const std::vector<FileMetadata>& files, std::string& out);
+
+template <typename T>
+std::string to_json(const T& item) {
+    std::string out;
+    JsonWriter writer(out);
+    write_json(writer, item);
+    return out;
+}
+
+} // namespace dfs::sync
@@ -0,0 +1,72 @@
+#pragma once
+
+#include "dfs/core/result.hpp"
+#include "dfs/sync/types.hpp"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs::sync::rpc {
+
+// Payloads of the sync operations on the binary RPC protocol (framing in
+// dfs/network/rpc.hpp). Fields use the metadata Serializer's encoding:
+// big-endian integers, u32-length-prefixed strings and bytes, and
+// FileMetadata records as Serializer::serialize_into() writes them.
+//
+// File data travels as raw bytes; the JSON API sends it hex-encoded,
+// twice the size and a parse on each side.
+enum class Op : std::uint8_t {
+    Register = 1,        // [preferred_id]                -> [client_id]
+    StartSession = 2,    // [client_id]                   -> [session_id]
+    Diff = 3,            // DiffArgs                      -> DiffResponse
+    UploadChunk = 4,     // ChunkEnvelope                 -> (empty)
+    UploadComplete = 5,  // CompleteArgs                  -> FileMetadata
+    Download = 6,        // [file_path]                   -> FileData
+};
+
+// Download error for a file too big for one reply frame; the client
+// fetches such files over HTTP instead
+inline constexpr std::string_view kFileTooLarge = "file too large for RPC";
+
+struct DiffArgs {
+    std::string session_id;
+    std::vector<FileMetadata> snapshot;
+};
+
+struct CompleteArgs {
+    std::string session_id;
+    std::string file_path;
+    std::string expected_hash;
+};
+
+struct FileData {
+    std::string hash;
+    std::vector<std::uint8_t> data;
+};
+
+// A payload that is a single string
+std::vector<std::uint8_t> encode_text(std::string_view text);
+dfs::Result<std::string> decode_text(const std::vector<std::uint8_t>& payload);
+
+std::vector<std::uint8_t> encode_diff_args(const std::string& session_id, const std::vector<FileMetadata>& snapshot);
+dfs::Result<DiffArgs> decode_diff_args(const std::vector<std::uint8_t>& payload);
+
+std::vector<std::uint8_t> encode_diff_response(const DiffResponse& diff);
+dfs::Result<DiffResponse> decode_diff_response(const std::vector<std::uint8_t>& payload);
+
+// [session_id][file_path][chunk_index][total_chunks][chunk_size][chunk_hash][data]
+std::vector<std::uint8_t> encode_chunk(const ChunkEnvelope& chunk);
+dfs::Result<ChunkEnvelope> decode_chunk(const std::vector<std::uint8_t>& payload);
+
+std::vector<std::uint8_t> encode_complete_args(const CompleteArgs& args);
+dfs::Result<CompleteArgs> decode_complete_args(const std::vector<std::uint8_t>& payload);
+
+std::vector<std::uint8_t> encode_metadata(const FileMetadata& metadata);
+dfs::Result<FileMetadata> decode_metadata(const std::vector<std::uint8_t>& payload);
+
+std::vector<std::uint8_t> encode_file_data(const std::string& hash, const std::vector<std::uint8_t>& data);
+dfs::Result<FileData> decode_file_data(const std::vector<std::uint8_t>& payload);
+
+} // namespace dfs::sync::rpc
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "dfs/core/work_stealing_pool.hpp"
+#include "dfs/network/rpc.hpp"
+#include "dfs/sync/service.hpp"
+
+namespace dfs::sync {
+
+// SyncService over the binary RPC protocol (payloads in dfs/sync/rpc.hpp).
+//
+// Register and StartSession only touch in-memory state and are answered
+// on the event loop. Diff, uploads and downloads touch the disk, so they
+// run on the pool: the loop keeps reading the connection's next frames,
+// and their replies leave in completion order.
+//
+// Files over max_download_size() are refused with rpc::kFileTooLarge
+// before they are read: their reply would not fit in one frame.
+//
+// Thread safety: handle() may be called from any number of loops. The
+// service and pool must outlive every request handed to the pool
+// (shut the pool down after stopping the server).
+class SyncRpcService {
+public:
+    // kRpcMaxPayload less room for the hash and length prefixes
+    static constexpr std::uint64_t kDefaultMaxDownloadSize = network::kRpcMaxPayload - 64;
+
+    SyncRpcService(SyncService& service, WorkStealingPool& pool);
+
+    // Call before the service handles requests
+    void set_max_download_size(std::uint64_t bytes) { max_download_size_ = bytes; }
+    [[nodiscard]] std::uint64_t max_download_size() const noexcept { return max_download_size_; }
+
+    void handle(network::RpcRequest request, network::RpcReply reply);
+
+    // handle() bound to this, for HttpServerEpoll::set_rpc_handler()
+    network::RpcHandler handler();
+
+private:
+    void execute(const network::RpcRequest& request, network::RpcReply& reply);
+
+    SyncService& service_;
+    WorkStealingPool& pool_;
+    std::uint64_t max_download_size_ = kDefaultMaxDownloadSize;
+};
+
+} // namespace dfs::sync
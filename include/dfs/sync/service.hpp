@@ -4,6 +4,7 @@
 #include "dfs/sync/merkle_tree.hpp"
 #include "dfs/sync/session.hpp"
 #include "dfs/sync/transfer.hpp"
+#include "dfs/events/coalescer.hpp"
 #include "dfs/events/event_bus.hpp"
 #include "dfs/events/events.hpp"
 
@@ -21,10 +22,13 @@ namespace dfs::sync {
 
 class SyncService {
 public:
+    // progress_window: minimum spacing between FileChunkReceivedEvents
+    // for one file (0 = one event per chunk)
     SyncService(std::filesystem::path data_root,
                 std::filesystem::path staging_root,
                 events::EventBus& bus,
-                metadata::MetadataStore& store);
+                metadata::MetadataStore& store,
+                std::chrono::milliseconds progress_window = std::chrono::milliseconds(100));
 
     std::string register_client(const std::string& preferred_id = {});
 
@@ -39,10 +43,18 @@ public:
                                                         const std::string& file_path,
                                                         const std::string& expected_hash);
 
+    dfs::Result<std::vector<std::uint8_t>> read_file(const std::string& file_path) const;
+
+    // Where a synced file lives on disk, for callers that stream it
+    std::filesystem::path stored_path(const std::string& file_path) const;
+
     dfs::Result<std::string> read_file_hex(const std::string& file_path) const;
 
     dfs::Result<SyncSessionInfo> session_info(const std::string& session_id) const;
 
+    // Sessions not yet Complete or Failed
+    std::size_t active_sessions() const;
+
     metadata::MetadataStore& store() noexcept { return store_; }
 
 private:
@@ -57,6 +69,7 @@ private:
 
     metadata::MetadataStore& store_;
     events::EventBus& event_bus_;
+    events::ChunkProgressCoalescer progress_;
     FileTransferService transfer_service_;
 
     std::filesystem::path data_root_;
@@ -64,6 +77,9 @@ private:
 
     std::atomic<uint64_t> client_counter_{0};
     std::atomic<uint64_t> session_counter_{0};
+    // Sessions not yet Complete or Failed, kept in step with transitions
+    // so the metrics scrape does not walk sessions_ under mutex_
+    std::atomic<std::size_t> active_sessions_{0};
 
     mutable std::mutex mutex_;
     std::unordered_map<std::string, std::string> clients_;
@@ -72,6 +88,10 @@ private:
     metadata::FileMetadata build_metadata_from_disk(const std::string& client_id,
                                                     const std::string& file_path) const;
 
+    // Caller holds mutex_; if this change ended the session, decrements
+    // active_sessions_ and flushes the session's chunk progress
+    void note_session_end(SessionState before, const SessionData& session_data);
+
     dfs::Result<SessionData*> find_session(const std::string& session_id);
     dfs::Result<const SessionData*> find_session(const std::string& session_id) const;
 
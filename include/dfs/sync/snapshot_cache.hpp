@@ -0,0 +1,67 @@
+#pragma once
+
+#include "dfs/metadata/store.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace dfs::sync {
+
+// Last serialized snapshot of the metadata store, rebuilt on the first
+// read after a write.
+//
+// Clients poll for changes far more often than the store changes. Without
+// a cache every poll copies and serializes the whole store; with it a
+// poll costs one version load and, if the client already has this state,
+// an ETag comparison.
+//
+// The ETag is derived from the contents, not the store's version counter,
+// so an ETag a client kept across a server restart still matches exactly
+// when the files are the same. It is the Merkle root plus a fingerprint of
+// the fields the root leaves out (timestamps, sync state): the body carries
+// those too, and a change to them alone must not be answered with a 304.
+//
+// Thread safety: current() may be called from any thread. Concurrent
+// readers after a write wait for one rebuild instead of each doing it.
+class SnapshotCache {
+public:
+    // Writes the listing for `files` to `out` (e.g. a JSON array)
+    using Serializer = std::function<void(const std::vector<metadata::FileMetadata>& files, std::string& out)>;
+
+    struct Snapshot {
+        std::uint64_t version = 0;      // MetadataStore::version() it was built from
+        std::string root_hash;          // Merkle root of the listing
+        std::string etag;               // Quoted "<root>-<fingerprint>", ready for the ETag header
+        std::string body;               // Serializer output
+        std::size_t file_count = 0;
+    };
+
+    SnapshotCache(const metadata::MetadataStore& store, Serializer serializer);
+
+    // Snapshot of the store's current state; never null
+    [[nodiscard]] std::shared_ptr<const Snapshot> current();
+
+    [[nodiscard]] std::uint64_t builds() const noexcept { return builds_.load(std::memory_order_relaxed); }
+    [[nodiscard]] std::uint64_t hits() const noexcept { return hits_.load(std::memory_order_relaxed); }
+
+private:
+    std::shared_ptr<const Snapshot> build();
+
+    const metadata::MetadataStore& store_;
+    Serializer serializer_;
+
+    std::mutex rebuild_mutex_;                  // One rebuild at a time
+    mutable std::mutex mutex_;                  // Guards snapshot_
+    std::shared_ptr<const Snapshot> snapshot_;
+
+    std::atomic<std::uint64_t> builds_{0};
+    std::atomic<std::uint64_t> hits_{0};
+};
+
+} // namespace dfs::sync
@@ -4,7 +4,10 @@
 #include "dfs/sync/types.hpp"
 
 #include <filesystem>
+#include <cstdint>
 #include <functional>
+#include <string>
+#include <vector>
 
 namespace dfs::sync {
 
@@ -27,6 +30,21 @@ public:
                                     const std::filesystem::path& destination_root,
                                     const std::string& expected_hash) const;
 
+    // FNV-1a as 16 hex digits: the hash chunks and finished files are
+    // checked against, so clients must report file hashes the same way
+    static std::string content_hash(const std::vector<std::uint8_t>& data);
+    static dfs::Result<std::string> file_hash(const std::filesystem::path& path);
+
+    // content_hash() over data fed in pieces, in order
+    class ContentHasher {
+    public:
+        void update(const std::uint8_t* data, std::size_t size);
+        std::string hex() const;
+
+    private:
+        std::uint64_t hash_ = 0xcbf29ce484222325ULL;
+    };
+
 private:
     static std::filesystem::path make_staging_path(const std::filesystem::path& staging_root,
                                                    const std::string& session_id,
@@ -0,0 +1,48 @@
+#include "dfs/client/connection_pool.hpp"
+
+namespace dfs {
+namespace client {
+
+ConnectionPool::ConnectionPool(std::string host, uint16_t port, size_t max_idle,
+                               std::chrono::milliseconds timeout)
+    : host_(std::move(host))
+    , port_(port)
+    , authority_(host_ + ":" + std::to_string(port))
+    , max_idle_(max_idle)
+    , timeout_(timeout) {}
+
+Result<ConnectionPool::Lease> ConnectionPool::acquire() {
+    {
+        std::lock_guard lock(mutex_);
+        if (!idle_.empty()) {
+            // Most recently used first: least likely to have timed out
+            auto connection = std::move(idle_.back());
+            idle_.pop_back();
+            reused_.fetch_add(1, std::memory_order_relaxed);
+            return Ok(Lease(this, std::move(connection), true));
+        }
+    }
+    return acquire_fresh();
+}
+
+Result<ConnectionPool::Lease> ConnectionPool::acquire_fresh() {
+    auto connection = HttpConnection::open(host_, port_, timeout_);
+    if (connection.is_error()) {
+        return Err<Lease>(connection.error());
+    }
+    opened_.fetch_add(1, std::memory_order_relaxed);
+    return Ok(Lease(this, std::move(connection.value()), false));
+}
+
+void ConnectionPool::release(std::unique_ptr<HttpConnection> connection) {
+    if (!connection->reusable()) {
+        return;
+    }
+    std::lock_guard lock(mutex_);
+    if (idle_.size() < max_idle_) {
+        idle_.push_back(std::move(connection));
+    }
+}
+
+} // namespace client
+} // namespace dfs
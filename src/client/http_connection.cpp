@@ -0,0 +1,268 @@
+#include "dfs/client/http_connection.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+
+namespace dfs {
+namespace client {
+
+namespace {
+
+constexpr size_t kReadSize = 16 * 1024;
+constexpr size_t kMaxLine = 16 * 1024;
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+} // namespace
+
+// ────────────────────────────────────────────────────────────
+// Connection setup
+// ────────────────────────────────────────────────────────────
+
+Result<std::unique_ptr<HttpConnection>> HttpConnection::open(const std::string& host, uint16_t port,
+                                                             std::chrono::milliseconds timeout) {
+    std::unique_ptr<HttpConnection> connection(new HttpConnection());
+    auto created = connection->socket_.create(network::SocketType::TCP);
+    if (created.is_error()) {
+        return Err<std::unique_ptr<HttpConnection>>(created.error());
+    }
+
+    int fd = connection->socket_.native_handle();
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(timeout.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((timeout.count() % 1000) * 1000);
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    auto connected = connection->socket_.connect(host, port);
+    if (connected.is_error()) {
+        return Err<std::unique_ptr<HttpConnection>>(connected.error());
+    }
+    return Ok(std::move(connection));
+}
+
+void HttpConnection::write_request(std::string& out, std::string_view method, std::string_view target,
+                                   std::string_view host, std::string_view body,
+                                   std::string_view extra_headers) {
+    out += method;
+    out += ' ';
+    out += target;
+    out += " HTTP/1.1\r\nHost: ";
+    out += host;
+    out += "\r\n";
+    if (!body.empty()) {
+        out += "Content-Type: application/json\r\nContent-Length: ";
+        out += std::to_string(body.size());
+        out += "\r\n";
+    }
+    out += extra_headers;
+    out += "\r\n";
+    out += body;
+}
+
+// ────────────────────────────────────────────────────────────
+// I/O
+// ────────────────────────────────────────────────────────────
+
+Result<void> HttpConnection::send(std::string_view wire) {
+    int fd = socket_.native_handle();
+    while (!wire.empty()) {
+        // MSG_NOSIGNAL: a server that closed the connection is an error
+        // here, not a SIGPIPE
+        ssize_t n = ::send(fd, wire.data(), wire.size(), MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            reusable_ = false;
+            return Err<void>(std::string("Send failed: ") + std::strerror(errno));
+        }
+        wire.remove_prefix(static_cast<size_t>(n));
+    }
+    return Ok();
+}
+
+Result<size_t> HttpConnection::fill() {
+    size_t old_size = buffer_.size();
+    buffer_.resize(old_size + kReadSize);
+    ssize_t n;
+    do {
+        n = ::recv(socket_.native_handle(), buffer_.data() + old_size, kReadSize, 0);
+    } while (n < 0 && errno == EINTR);
+    buffer_.resize(old_size + static_cast<size_t>(std::max<ssize_t>(n, 0)));
+    if (n < 0) {
+        reusable_ = false;
+        return Err<size_t>(errno == EAGAIN || errno == EWOULDBLOCK ? std::string("Receive timed out")
+                                                                   : std::string("Receive failed"));
+    }
+    return Ok(static_cast<size_t>(n));
+}
+
+Result<void> HttpConnection::need(size_t count) {
+    while (buffer_.size() - offset_ < count) {
+        auto n = fill();
+        if (n.is_error()) {
+            return Err<void>(n.error());
+        }
+        if (n.value() == 0) {
+            reusable_ = false;
+            return Err<void>(std::string("Connection closed mid-response"));
+        }
+    }
+    return Ok();
+}
+
+Result<std::string_view> HttpConnection::read_line() {
+    size_t scanned = offset_;
+    while (true) {
+        size_t end = buffer_.find("\r\n", scanned);
+        if (end != std::string::npos) {
+            std::string_view line(buffer_.data() + offset_, end - offset_);
+            offset_ = end + 2;
+            return Ok(line);
+        }
+        if (buffer_.size() - offset_ > kMaxLine) {
+            reusable_ = false;
+            return Err<std::string_view>(std::string("Response line too long"));
+        }
+        scanned = buffer_.empty() ? offset_ : std::max(offset_, buffer_.size() - 1);
+        auto n = fill();
+        if (n.is_error()) {
+            return Err<std::string_view>(n.error());
+        }
+        if (n.value() == 0) {
+            reusable_ = false;
+            return Err<std::string_view>(std::string("Connection closed"));
+        }
+    }
+}
+
+// ────────────────────────────────────────────────────────────
+// Response parsing
+// ────────────────────────────────────────────────────────────
+
+Result<ClientResponse> HttpConnection::receive() {
+    // Drop the responses already read; a pipelined one may follow
+    buffer_.erase(0, offset_);
+    offset_ = 0;
+
+    ClientResponse response;
+    auto status_line = read_line();
+    if (status_line.is_error()) {
+        return Err<ClientResponse>(status_line.error());
+    }
+    // "HTTP/1.1 200 OK"
+    std::string_view line = status_line.value();
+    bool http10 = line.rfind("HTTP/1.0", 0) == 0;
+    size_t space = line.find(' ');
+    if (line.rfind("HTTP/", 0) != 0 || space == std::string_view::npos ||
+        std::from_chars(line.data() + space + 1, line.data() + line.size(), response.status).ec != std::errc{}) {
+        reusable_ = false;
+        return Err<ClientResponse>(std::string("Malformed status line"));
+    }
+
+    while (true) {
+        auto header = read_line();
+        if (header.is_error()) {
+            return Err<ClientResponse>(header.error());
+        }
+        if (header.value().empty()) {
+            break;
+        }
+        std::string_view field = header.value();
+        size_t colon = field.find(':');
+        if (colon == std::string_view::npos) {
+            reusable_ = false;
+            return Err<ClientResponse>(std::string("Malformed header line"));
+        }
+        response.headers.add(trim(field.substr(0, colon)), trim(field.substr(colon + 1)));
+    }
+
+    std::string_view connection = response.headers.get(network::HeaderId::CONNECTION);
+    if (network::ascii_iequals(connection, "close") ||
+        (http10 && !network::ascii_iequals(connection, "keep-alive"))) {
+        reusable_ = false;
+    }
+
+    if (network::ascii_iequals(response.headers.get(network::HeaderId::TRANSFER_ENCODING), "chunked")) {
+        while (true) {
+            auto size_line = read_line();
+            if (size_line.is_error()) {
+                return Err<ClientResponse>(size_line.error());
+            }
+            std::string_view text = size_line.value();
+            size_t size = 0;
+            if (std::from_chars(text.data(), text.data() + text.size(), size, 16).ec != std::errc{}) {
+                reusable_ = false;
+                return Err<ClientResponse>(std::string("Malformed chunk size"));
+            }
+            if (size == 0) {
+                // Trailers, up to the empty line
+                while (true) {
+                    auto trailer = read_line();
+                    if (trailer.is_error()) {
+                        return Err<ClientResponse>(trailer.error());
+                    }
+                    if (trailer.value().empty()) {
+                        break;
+                    }
+                }
+                break;
+            }
+            if (auto ready = need(size + 2); ready.is_error()) {
+                return Err<ClientResponse>(ready.error());
+            }
+            response.body.append(buffer_, offset_, size);
+            offset_ += size + 2;
+        }
+    } else if (response.headers.contains(network::HeaderId::CONTENT_LENGTH)) {
+        std::string_view text = response.headers.get(network::HeaderId::CONTENT_LENGTH);
+        size_t length = 0;
+        if (std::from_chars(text.data(), text.data() + text.size(), length).ec != std::errc{}) {
+            reusable_ = false;
+            return Err<ClientResponse>(std::string("Malformed Content-Length"));
+        }
+        if (auto ready = need(length); ready.is_error()) {
+            return Err<ClientResponse>(ready.error());
+        }
+        response.body.assign(buffer_, offset_, length);
+        offset_ += length;
+    } else if (response.status != 204 && response.status != 304 && response.status >= 200) {
+        // No framing: the body runs to EOF
+        reusable_ = false;
+        while (true) {
+            auto n = fill();
+            if (n.is_error()) {
+                return Err<ClientResponse>(n.error());
+            }
+            if (n.value() == 0) {
+                break;
+            }
+        }
+        response.body.assign(buffer_, offset_, std::string::npos);
+        offset_ = buffer_.size();
+    }
+
+    ++responses_;
+    return Ok(std::move(response));
+}
+
+} // namespace client
+} // namespace dfs
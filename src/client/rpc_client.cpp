@@ -0,0 +1,249 @@
+#include "dfs/client/rpc_client.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/uio.h>
+
+namespace dfs {
+namespace client {
+
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The reader wakes this often to look for overdue replies
+constexpr std::chrono::milliseconds kReadPoll{250};
+
+timeval to_timeval(std::chrono::milliseconds time) {
+    timeval tv{};
+    tv.tv_sec = static_cast<time_t>(time.count() / 1000);
+    tv.tv_usec = static_cast<suseconds_t>((time.count() % 1000) * 1000);
+    return tv;
+}
+
+std::future<RpcResult> failed(std::string error, bool broken) {
+    std::promise<RpcResult> promise;
+    RpcResult result;
+    result.error = std::move(error);
+    result.broken = broken;
+    promise.set_value(std::move(result));
+    return promise.get_future();
+}
+
+} // namespace
+
+// ────────────────────────────────────────────────────────────
+// Connection setup
+// ────────────────────────────────────────────────────────────
+
+Result<std::unique_ptr<RpcClient>> RpcClient::connect(const std::string& host, uint16_t port,
+                                                      std::chrono::milliseconds timeout) {
+    std::unique_ptr<RpcClient> client(new RpcClient(timeout));
+    auto created = client->socket_.create(network::SocketType::TCP);
+    if (created.is_error()) {
+        return Err<std::unique_ptr<RpcClient>>(created.error());
+    }
+
+    int fd = client->socket_.native_handle();
+    timeval send_timeout = to_timeval(timeout);
+    timeval receive_timeout = to_timeval(std::min(timeout, kReadPoll));
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout));
+    ::setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &receive_timeout, sizeof(receive_timeout));
+    int one = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+    auto connected = client->socket_.connect(host, port);
+    if (connected.is_error()) {
+        return Err<std::unique_ptr<RpcClient>>(connected.error());
+    }
+    if (::send(fd, network::kRpcPreamble.data(), network::kRpcPreamble.size(), MSG_NOSIGNAL) !=
+        static_cast<ssize_t>(network::kRpcPreamble.size())) {
+        return Err<std::unique_ptr<RpcClient>>(std::string("Failed to send RPC preamble"));
+    }
+
+    client->reader_ = std::thread([raw = client.get()] { raw->read_replies(); });
+    return Ok(std::move(client));
+}
+
+RpcClient::~RpcClient() {
+    // Wakes the reader out of recv(); it fails what is still outstanding
+    ::shutdown(socket_.native_handle(), SHUT_RDWR);
+    if (reader_.joinable()) {
+        reader_.join();
+    }
+}
+
+// ────────────────────────────────────────────────────────────
+// Calls
+// ────────────────────────────────────────────────────────────
+
+std::future<RpcResult> RpcClient::call(uint8_t type, const std::vector<uint8_t>& payload) {
+    if (payload.size() > network::kRpcMaxPayload) {
+        return failed("RPC payload too large: " + std::to_string(payload.size()) + " bytes", false);
+    }
+
+    uint32_t id;
+    std::future<RpcResult> future;
+    {
+        std::lock_guard lock(calls_mutex_);
+        if (broken_.load(std::memory_order_relaxed)) {
+            return failed(broken_reason_, true);
+        }
+        id = ++next_id_;
+        auto& pending = calls_[id];
+        pending.sent = Clock::now();
+        future = pending.promise.get_future();
+    }
+
+    std::array<uint8_t, network::kRpcHeaderSize> header;
+    network::RpcFrameHeader{type, 0, id, static_cast<uint32_t>(payload.size())}.encode(header.data());
+
+    // Header and payload in one write, without copying the payload
+    std::array<iovec, 2> parts{{{header.data(), header.size()},
+                                {const_cast<uint8_t*>(payload.data()), payload.size()}}};
+    size_t remaining = header.size() + payload.size();
+    std::lock_guard lock(send_mutex_);
+    msghdr message{};
+    message.msg_iov = parts.data();
+    message.msg_iovlen = parts.size();
+    while (remaining > 0) {
+        ssize_t n = ::sendmsg(socket_.native_handle(), &message, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            fail_all(std::string("RPC send failed: ") + std::strerror(errno));
+            break;
+        }
+        remaining -= static_cast<size_t>(n);
+        // Skip what was written
+        auto written = static_cast<size_t>(n);
+        while (message.msg_iovlen > 0 && written >= message.msg_iov->iov_len) {
+            written -= message.msg_iov->iov_len;
+            ++message.msg_iov;
+            --message.msg_iovlen;
+        }
+        if (message.msg_iovlen > 0) {
+            message.msg_iov->iov_base = static_cast<uint8_t*>(message.msg_iov->iov_base) + written;
+            message.msg_iov->iov_len -= written;
+        }
+    }
+    return future;
+}
+
+size_t RpcClient::in_flight() const {
+    std::lock_guard lock(calls_mutex_);
+    return calls_.size();
+}
+
+// ────────────────────────────────────────────────────────────
+// Reader
+// ────────────────────────────────────────────────────────────
+
+void RpcClient::read_replies() {
+    int fd = socket_.native_handle();
+    std::string reason;
+
+    // Fill [data, data + size); false once the connection is gone
+    auto read_exact = [&](uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::recv(fd, data, size, 0);
+            if (n > 0) {
+                data += n;
+                size -= static_cast<size_t>(n);
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                // Idle is fine; a call waiting longer than the timeout is not
+                std::lock_guard lock(calls_mutex_);
+                auto overdue = std::any_of(calls_.begin(), calls_.end(), [&](const auto& entry) {
+                    return Clock::now() - entry.second.sent > timeout_;
+                });
+                if (!overdue) {
+                    continue;
+                }
+                reason = "RPC reply timed out";
+                return false;
+            }
+            reason = n == 0 ? std::string("RPC connection closed")
+                            : std::string("RPC receive failed: ") + std::strerror(errno);
+            return false;
+        }
+        return true;
+    };
+
+    std::array<uint8_t, network::kRpcHeaderSize> header_bytes;
+    while (read_exact(header_bytes.data(), header_bytes.size())) {
+        auto header = network::RpcFrameHeader::decode(header_bytes.data());
+        if (!(header.flags & network::kRpcReply) || header.length > network::kRpcMaxPayload) {
+            reason = "Malformed RPC reply";
+            break;
+        }
+
+        RpcResult result;
+        result.payload.resize(header.length);
+        if (!read_exact(result.payload.data(), result.payload.size())) {
+            break;
+        }
+        if (header.flags & network::kRpcError) {
+            result.error.assign(result.payload.begin(), result.payload.end());
+            result.payload.clear();
+            result.busy = (header.flags & network::kRpcBusy) != 0;
+            if (result.error.empty()) {
+                result.error = "RPC failed";
+            }
+        }
+
+        std::promise<RpcResult> promise;
+        {
+            std::lock_guard lock(calls_mutex_);
+            auto it = calls_.find(header.request_id);
+            if (it == calls_.end()) {
+                spdlog::debug("RPC reply for unknown request {}", header.request_id);
+                continue;
+            }
+            promise = std::move(it->second.promise);
+            calls_.erase(it);
+        }
+        promise.set_value(std::move(result));
+    }
+
+    fail_all(reason);
+}
+
+void RpcClient::fail_all(const std::string& error) {
+    std::unordered_map<uint32_t, Pending> calls;
+    {
+        std::lock_guard lock(calls_mutex_);
+        if (!broken_.exchange(true, std::memory_order_acq_rel)) {
+            broken_reason_ = error;
+        }
+        calls.swap(calls_);
+    }
+    if (!calls.empty()) {
+        spdlog::debug("RPC connection failed with {} calls outstanding: {}", calls.size(), error);
+    }
+    for (auto& [id, pending] : calls) {
+        RpcResult result;
+        result.error = error;
+        result.broken = true;
+        pending.promise.set_value(std::move(result));
+    }
+    // Unblocks a sender stuck on a full socket
+    ::shutdown(socket_.native_handle(), SHUT_RDWR);
+}
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,786 @@
+#include "dfs/client/sync_client.hpp"
+#include "dfs/core/hex.hpp"
+#include "dfs/core/trace.hpp"
+#include "dfs/sync/json_writer.hpp"
+
+#include <nlohmann/json.hpp>
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+
+namespace dfs {
+namespace client {
+
+namespace fs = std::filesystem;
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+std::chrono::microseconds since(Clock::time_point start) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start);
+}
+
+std::chrono::milliseconds retry_after_of(const ClientResponse& response) {
+    std::string_view value = response.headers.get("Retry-After");
+    int seconds = 0;
+    if (std::from_chars(value.data(), value.data() + value.size(), seconds).ec != std::errc{}) {
+        return {};
+    }
+    return std::chrono::seconds(seconds);
+}
+
+// "HTTP 400: <the server's error message>"
+std::string error_of(const ClientResponse& response) {
+    auto body = json::parse(response.body, nullptr, false);
+    std::string detail = body.is_object() && body.contains("error") && body["error"].is_string()
+                             ? body["error"].get<std::string>()
+                             : response.body.substr(0, 200);
+    return "HTTP " + std::to_string(response.status) + ": " + detail;
+}
+
+const char* op_name(sync::rpc::Op op) {
+    switch (op) {
+    case sync::rpc::Op::Register: return "register";
+    case sync::rpc::Op::StartSession: return "start session";
+    case sync::rpc::Op::Diff: return "diff";
+    case sync::rpc::Op::UploadChunk: return "upload chunk";
+    case sync::rpc::Op::UploadComplete: return "upload complete";
+    case sync::rpc::Op::Download: return "download";
+    }
+    return "unknown";
+}
+
+// A server path as a path under root; empty if it would leave root
+fs::path local_path(const fs::path& root, const std::string& path) {
+    fs::path relative = fs::path(path).relative_path().lexically_normal();
+    if (relative.empty() || *relative.begin() == "..") {
+        return {};
+    }
+    return root / relative;
+}
+
+} // namespace
+
+// ────────────────────────────────────────────────────────────
+// RetryPolicy
+// ────────────────────────────────────────────────────────────
+
+std::chrono::milliseconds RetryPolicy::backoff(int attempt, std::chrono::milliseconds retry_after) const {
+    double delay = static_cast<double>(initial_backoff.count()) * std::pow(multiplier, std::max(0, attempt - 2));
+    delay = std::min(delay, static_cast<double>(max_backoff.count()));
+
+    thread_local std::mt19937 rng{std::random_device{}()};
+    std::uniform_real_distribution<double> jitter(0.5, 1.0);
+    auto jittered = std::chrono::milliseconds(static_cast<int64_t>(delay * jitter(rng)));
+    return std::min(std::max(jittered, retry_after), max_backoff);
+}
+
+// ────────────────────────────────────────────────────────────
+// Upload pipeline
+// ────────────────────────────────────────────────────────────
+
+/**
+ * Requests written ahead of their responses on one connection. pending_
+ * holds every request sent on the current connection and not yet
+ * answered, in wire order, so after a failure it is exactly what has to
+ * be sent again.
+ */
+class SyncClient::UploadPipeline {
+public:
+    explicit UploadPipeline(SyncClient& client)
+        : client_(client), window_(std::max<size_t>(1, client.config_.upload_window)) {}
+
+    ~UploadPipeline() {
+        if (lease_ && !pending_.empty()) {
+            (*lease_).discard();   // Unread responses: not reusable
+        }
+    }
+
+    Result<void> submit(std::string wire) {
+        while (pending_.size() >= window_) {
+            if (auto done = complete_one(); done.is_error()) {
+                return done;
+            }
+        }
+        pending_.push_back({std::move(wire), 1});
+        if (!lease_) {
+            return reconnect(false);
+        }
+        if (auto sent = (*lease_)->send(pending_.back().wire); sent.is_error()) {
+            return recover(sent.error());
+        }
+        return Ok();
+    }
+
+    Result<void> drain() {
+        while (!pending_.empty()) {
+            if (auto done = complete_one(); done.is_error()) {
+                return done;
+            }
+        }
+        return Ok();
+    }
+
+private:
+    struct Pending {
+        std::string wire;
+        int attempts;
+    };
+
+    const RetryPolicy& policy() const { return client_.config_.retry; }
+
+    Result<void> complete_one() {
+        auto response = (*lease_)->receive();
+        if (response.is_error()) {
+            return recover(response.error());
+        }
+        client_.requests_.fetch_add(1, std::memory_order_relaxed);
+        Pending done = std::move(pending_.front());
+        pending_.pop_front();
+
+        bool closed = !(*lease_)->reusable();
+        if (closed && window_ > 1) {
+            // Requests behind the answered one would be sent again after
+            // every response; stop-and-wait is cheaper
+            spdlog::debug("Server closes connections after each response; upload window set to 1");
+            window_ = 1;
+        }
+
+        const ClientResponse& answer = response.value();
+        if (RetryPolicy::retryable(answer.status)) {
+            if (done.attempts >= policy().max_attempts) {
+                return Err<void>(error_of(answer));
+            }
+            ++done.attempts;
+            client_.retries_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(policy().backoff(done.attempts, retry_after_of(answer)));
+            pending_.push_back(std::move(done));
+            if (!closed) {
+                if (auto sent = (*lease_)->send(pending_.back().wire); sent.is_error()) {
+                    return recover(sent.error());
+                }
+            }
+        } else if (!answer.ok()) {
+            return Err<void>(error_of(answer));
+        }
+
+        if (closed) {
+            return reconnect(true);
+        }
+        return Ok();
+    }
+
+    // The connection failed with requests outstanding
+    Result<void> recover(const std::string& error) {
+        // A connection that answered before (a pooled one the server timed
+        // out, or one closed after a response) is not the request's fault
+        bool made_progress = (*lease_)->responses() > 0;
+        (*lease_).discard();
+        lease_.reset();
+        if (!made_progress) {
+            Pending& front = pending_.front();
+            if (front.attempts >= policy().max_attempts) {
+                return Err<void>(std::string("Upload failed: ") + error);
+            }
+            ++front.attempts;
+            std::this_thread::sleep_for(policy().backoff(front.attempts));
+        }
+        return reconnect(true);
+    }
+
+    // Open a connection and send everything pending on it
+    Result<void> reconnect(bool resend) {
+        lease_.reset();
+        if (pending_.empty()) {
+            return Ok();   // The next submit() connects
+        }
+        while (true) {
+            auto lease = client_.pool_.acquire();
+            if (lease.is_ok()) {
+                lease_.emplace(std::move(lease.value()));
+                break;
+            }
+            Pending& front = pending_.front();
+            if (front.attempts >= policy().max_attempts) {
+                return Err<void>(std::string("Upload failed: ") + lease.error());
+            }
+            ++front.attempts;
+            std::this_thread::sleep_for(policy().backoff(front.attempts));
+        }
+        if (resend) {
+            client_.retries_.fetch_add(pending_.size(), std::memory_order_relaxed);
+        }
+        for (const auto& request : pending_) {
+            if (auto sent = (*lease_)->send(request.wire); sent.is_error()) {
+                return recover(sent.error());
+            }
+        }
+        return Ok();
+    }
+
+    SyncClient& client_;
+    size_t window_;
+    std::optional<ConnectionPool::Lease> lease_;
+    std::deque<Pending> pending_;
+};
+
+// ────────────────────────────────────────────────────────────
+// RPC window
+// ────────────────────────────────────────────────────────────
+
+/**
+ * Calls in flight on the RPC connection, settled oldest first (their
+ * replies may have arrived in any order). A call that failed retryably
+ * is sent again on its own with rpc_call(), so the calls behind it keep
+ * their place. A call that failed for good ends the window, unless its
+ * on_error recovers.
+ */
+class SyncClient::RpcWindow {
+public:
+    using OnReply = std::function<Result<void>(std::vector<uint8_t> payload)>;
+    using OnError = std::function<Result<void>(const std::string& error)>;
+
+    RpcWindow(SyncClient& client, size_t limit) : client_(client), limit_(std::max<size_t>(1, limit)) {}
+
+    Result<void> submit(sync::rpc::Op op, std::vector<uint8_t> payload, OnReply on_reply = {},
+                        OnError on_error = {}) {
+        while (calls_.size() >= limit_) {
+            if (auto settled = settle_one(); settled.is_error()) {
+                return settled;
+            }
+        }
+        auto connection = client_.rpc_connection();
+        if (connection.is_error()) {
+            return Err<void>(connection.error());
+        }
+        auto reply = connection.value()->call(static_cast<uint8_t>(op), payload);
+        calls_.push_back({op, std::move(payload), std::move(reply), std::move(on_reply), std::move(on_error)});
+        return Ok();
+    }
+
+    Result<void> drain() {
+        while (!calls_.empty()) {
+            if (auto settled = settle_one(); settled.is_error()) {
+                return settled;
+            }
+        }
+        return Ok();
+    }
+
+private:
+    struct Call {
+        sync::rpc::Op op;
+        std::vector<uint8_t> payload;   // Kept to send again
+        std::future<RpcResult> reply;
+        OnReply on_reply;
+        OnError on_error;
+    };
+
+    Result<void> settle_one() {
+        Call call = std::move(calls_.front());
+        calls_.pop_front();
+
+        RpcResult result = call.reply.get();
+        if (!result.broken) {
+            client_.requests_.fetch_add(1, std::memory_order_relaxed);
+        }
+        std::vector<uint8_t> payload;
+        if (result.ok()) {
+            payload = std::move(result.payload);
+        } else if (result.retryable()) {
+            client_.retries_.fetch_add(1, std::memory_order_relaxed);
+            auto retried = client_.rpc_call(call.op, call.payload, 2);
+            if (retried.is_error()) {
+                return Err<void>(retried.error());
+            }
+            payload = std::move(retried.value());
+        } else if (call.on_error) {
+            return call.on_error(result.error);
+        } else {
+            return Err<void>(std::string(op_name(call.op)) + " failed: " + result.error);
+        }
+        return call.on_reply ? call.on_reply(std::move(payload)) : Ok();
+    }
+
+    SyncClient& client_;
+    size_t limit_;
+    std::deque<Call> calls_;
+};
+
+// ────────────────────────────────────────────────────────────
+// SyncClient
+// ────────────────────────────────────────────────────────────
+
+SyncClient::SyncClient(fs::path root, SyncClientConfig config)
+    : root_(std::move(root))
+    , config_(std::move(config))
+    , pool_(config_.host, config_.port, config_.max_idle_connections, config_.timeout) {}
+
+Result<ClientResponse> SyncClient::call(std::string_view method, std::string_view target, std::string_view body,
+                                        std::string_view extra_headers) {
+    std::string wire;
+    HttpConnection::write_request(wire, method, target, pool_.authority(), body, extra_headers);
+
+    std::string last_error;
+    std::chrono::milliseconds retry_after{0};
+    bool stale_retried = false;
+    int attempt = 1;
+    while (attempt <= config_.retry.max_attempts) {
+        auto lease = pool_.acquire();
+        if (lease.is_error()) {
+            last_error = lease.error();
+        } else {
+            bool reused = lease.value().reused();
+            auto sent = lease.value()->send(wire);
+            auto response = sent.is_ok() ? lease.value()->receive() : Err<ClientResponse>(sent.error());
+            if (response.is_error()) {
+                last_error = response.error();
+                lease.value().discard();
+                if (reused && !stale_retried) {
+                    // Closed by the server while idle in the pool; try a
+                    // new connection at once, without using up an attempt
+                    stale_retried = true;
+                    retries_.fetch_add(1, std::memory_order_relaxed);
+                    continue;
+                }
+            } else {
+                requests_.fetch_add(1, std::memory_order_relaxed);
+                if (!RetryPolicy::retryable(response.value().status)) {
+                    if (!response.value().ok()) {
+                        return Err<ClientResponse>(error_of(response.value()));
+                    }
+                    return response;
+                }
+                last_error = error_of(response.value());
+                retry_after = retry_after_of(response.value());
+            }
+        }
+
+        if (++attempt <= config_.retry.max_attempts) {
+            retries_.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::sleep_for(config_.retry.backoff(attempt, retry_after));
+        }
+    }
+    return Err<ClientResponse>(std::string(method) + " " + std::string(target) + " failed after " +
+                               std::to_string(config_.retry.max_attempts) + " attempts: " + last_error);
+}
+
+Result<std::vector<uint8_t>> SyncClient::rpc_call(sync::rpc::Op op, const std::vector<uint8_t>& payload,
+                                                   int first_attempt) {
+    std::string last_error;
+    for (int attempt = first_attempt; attempt <= config_.retry.max_attempts; ++attempt) {
+        if (attempt > 1) {
+            std::this_thread::sleep_for(config_.retry.backoff(attempt));
+        }
+        if (attempt > first_attempt) {
+            retries_.fetch_add(1, std::memory_order_relaxed);
+        }
+        auto connection = rpc_connection();
+        if (connection.is_error()) {
+            return Err<std::vector<uint8_t>>(connection.error());
+        }
+        RpcResult result = connection.value()->request(static_cast<uint8_t>(op), payload);
+        if (!result.broken) {
+            requests_.fetch_add(1, std::memory_order_relaxed);
+        }
+        if (result.ok()) {
+            return Ok(std::move(result.payload));
+        }
+        if (!result.retryable()) {
+            return Err<std::vector<uint8_t>>(std::string(op_name(op)) + " failed: " + result.error);
+        }
+        last_error = result.error;
+    }
+    return Err<std::vector<uint8_t>>(std::string(op_name(op)) + " failed after " +
+                                     std::to_string(config_.retry.max_attempts) + " attempts: " + last_error);
+}
+
+Result<RpcClient*> SyncClient::rpc_connection() {
+    if (rpc_ && rpc_->usable()) {
+        return Ok(rpc_.get());
+    }
+    rpc_.reset();
+    std::string last_error;
+    for (int attempt = 1; attempt <= config_.retry.max_attempts; ++attempt) {
+        if (attempt > 1) {
+            std::this_thread::sleep_for(config_.retry.backoff(attempt));
+        }
+        auto connected = RpcClient::connect(config_.host, config_.port, config_.timeout);
+        if (connected.is_ok()) {
+            rpc_ = std::move(connected.value());
+            ++rpc_opened_;
+            return Ok(rpc_.get());
+        }
+        last_error = connected.error();
+    }
+    return Err<RpcClient*>("RPC connect failed: " + last_error);
+}
+
+Result<std::string> SyncClient::register_client() {
+    if (config_.transport == SyncTransport::Rpc) {
+        auto reply = rpc_call(sync::rpc::Op::Register, sync::rpc::encode_text(config_.client_id));
+        if (reply.is_error()) {
+            return Err<std::string>(reply.error());
+        }
+        auto client_id = sync::rpc::decode_text(reply.value());
+        if (client_id.is_error() || client_id.value().empty()) {
+            return Err<std::string>(std::string("Malformed register response"));
+        }
+        client_id_ = std::move(client_id.value());
+    } else {
+        auto response = call("POST", "/api/register", json{{"preferred_id", config_.client_id}}.dump());
+        if (response.is_error()) {
+            return Err<std::string>(response.error());
+        }
+        auto body = json::parse(response.value().body, nullptr, false);
+        if (!body.is_object() || !body.value("client_id", std::string{}).size()) {
+            return Err<std::string>(std::string("Malformed register response"));
+        }
+        client_id_ = body["client_id"].get<std::string>();
+    }
+    detector_.emplace(client_id_);
+    return Ok(client_id_);
+}
+
+Result<std::string> SyncClient::start_session() {
+    if (config_.transport == SyncTransport::Rpc) {
+        auto reply = rpc_call(sync::rpc::Op::StartSession, sync::rpc::encode_text(client_id_));
+        if (reply.is_error()) {
+            return Err<std::string>(reply.error());
+        }
+        return sync::rpc::decode_text(reply.value());
+    }
+
+    // The snapshot in the reply is not needed (the diff says what to do),
+    // so an unchanged one is not sent again
+    std::string start_headers;
+    if (!snapshot_etag_.empty()) {
+        start_headers = "If-None-Match: " + snapshot_etag_ + "\r\n";
+    }
+    auto start = call("POST", "/api/sync/start", json{{"client_id", client_id_}}.dump(), start_headers);
+    if (start.is_error()) {
+        return Err<std::string>(start.error());
+    }
+    auto start_body = json::parse(start.value().body, nullptr, false);
+    if (!start_body.is_object() || !start_body.contains("session") || !start_body["session"].is_object()) {
+        return Err<std::string>(std::string("Malformed sync/start response"));
+    }
+    snapshot_etag_ = std::string(start.value().headers.get("ETag"));
+    return Ok(start_body["session"].value("session_id", std::string{}));
+}
+
+Result<sync::DiffResponse> SyncClient::request_diff(const std::string& session_id,
+                                                    const std::vector<metadata::FileMetadata>& snapshot) {
+    if (config_.transport == SyncTransport::Rpc) {
+        auto reply = rpc_call(sync::rpc::Op::Diff, sync::rpc::encode_diff_args(session_id, snapshot));
+        if (reply.is_error()) {
+            return Err<sync::DiffResponse>(reply.error());
+        }
+        return sync::rpc::decode_diff_response(reply.value());
+    }
+
+    // The local snapshot can be large: written straight into the body
+    std::string body;
+    sync::JsonWriter writer(body);
+    writer.begin_object().field("session_id", session_id).key("snapshot").begin_array();
+    for (const auto& metadata : snapshot) {
+        sync::write_json(writer, metadata);
+    }
+    writer.end_array().end_object();
+    auto diff = call("POST", "/api/sync/diff", body);
+    if (diff.is_error()) {
+        return Err<sync::DiffResponse>(diff.error());
+    }
+    auto diff_body = json::parse(diff.value().body, nullptr, false);
+    if (!diff_body.is_object()) {
+        return Err<sync::DiffResponse>(std::string("Malformed sync/diff response"));
+    }
+    sync::DiffResponse response;
+    response.files_to_upload = diff_body.value("files_to_upload", std::vector<std::string>{});
+    response.files_to_download = diff_body.value("files_to_download", std::vector<std::string>{});
+    return Ok(std::move(response));
+}
+
+Result<SyncReport> SyncClient::sync() {
+    trace::Span span("client.sync");
+    const auto started = Clock::now();
+    const size_t requests_before = requests_.load();
+    const size_t retries_before = retries_.load();
+    const size_t opened_before = pool_.opened() + rpc_opened_;
+    SyncReport report;
+
+    if (client_id_.empty()) {
+        if (auto registered = register_client(); registered.is_error()) {
+            return Err<SyncReport>(registered.error());
+        }
+    }
+
+    auto phase_started = Clock::now();
+    sync::ChangeSet changes = detector_->scan_directory(root_);
+    report.scan_time = since(phase_started);
+
+    auto session = start_session();
+    if (session.is_error()) {
+        return Err<SyncReport>(session.error());
+    }
+    const std::string session_id = session.value();
+
+    auto diff = request_diff(session_id, changes.snapshot);
+    if (diff.is_error()) {
+        return Err<SyncReport>(diff.error());
+    }
+    const auto& to_upload = diff.value().files_to_upload;
+    const auto& to_download = diff.value().files_to_download;
+
+    phase_started = Clock::now();
+    if (auto uploaded = upload(session_id, to_upload, changes.snapshot, report); uploaded.is_error()) {
+        return Err<SyncReport>(uploaded.error());
+    }
+    report.upload_time = since(phase_started);
+
+    phase_started = Clock::now();
+    if (auto downloaded = download(to_download, report); downloaded.is_error()) {
+        return Err<SyncReport>(downloaded.error());
+    }
+    report.download_time = since(phase_started);
+
+    report.requests = requests_.load() - requests_before;
+    report.retries = retries_.load() - retries_before;
+    report.connections_opened = pool_.opened() + rpc_opened_ - opened_before;
+    report.total_time = since(started);
+    spdlog::info("Sync {}: {} up ({:.1f} MiB/s), {} down ({:.1f} MiB/s), {} requests, {} retries",
+                 session_id, report.files_uploaded, report.upload_mib_per_s(), report.files_downloaded,
+                 report.download_mib_per_s(), report.requests, report.retries);
+    return Ok(report);
+}
+
+Result<void> SyncClient::upload(const std::string& session_id, const std::vector<std::string>& paths,
+                                const std::vector<metadata::FileMetadata>& snapshot, SyncReport& report) {
+    trace::Span span("client.upload", session_id);
+    std::unordered_map<std::string_view, const metadata::FileMetadata*> local;
+    for (const auto& metadata : snapshot) {
+        local.emplace(metadata.file_path, &metadata);
+    }
+
+    // Both transports pipeline the same requests; one is used
+    const bool rpc = config_.transport == SyncTransport::Rpc;
+    UploadPipeline pipeline(*this);
+    RpcWindow window(*this, config_.upload_window);
+    auto submit = [&](std::string_view target, const json& payload) {
+        std::string wire;
+        HttpConnection::write_request(wire, "POST", target, pool_.authority(), payload.dump());
+        return pipeline.submit(std::move(wire));
+    };
+    auto drain = [&] { return rpc ? window.drain() : pipeline.drain(); };
+    auto send_chunk = [&](sync::ChunkEnvelope&& chunk) {
+        ++report.chunks_uploaded;
+        if (rpc) {
+            return window.submit(sync::rpc::Op::UploadChunk, sync::rpc::encode_chunk(chunk));
+        }
+        std::string data;
+        hex::encode_to(data, chunk.data);
+        return submit("/api/file/upload_chunk", json{{"session_id", chunk.session_id},
+                                                     {"file_path", chunk.file_path},
+                                                     {"chunk_index", chunk.chunk_index},
+                                                     {"total_chunks", chunk.total_chunks},
+                                                     {"chunk_size", chunk.chunk_size},
+                                                     {"data", std::move(data)},
+                                                     {"chunk_hash", chunk.chunk_hash}});
+    };
+
+    for (const auto& path : paths) {
+        auto it = local.find(path);
+        fs::path source = local_path(root_, path);
+        if (it == local.end() || source.empty()) {
+            spdlog::warn("Server asked for {}, which is not in the sync root", path);
+            continue;
+        }
+        const metadata::FileMetadata& metadata = *it->second;
+
+        Result<void> sent = Ok();
+        if (metadata.size == 0) {
+            // No chunks would be produced, and the server finalizes from
+            // the staged file, so stage an empty one
+            sync::ChunkEnvelope empty;
+            empty.session_id = session_id;
+            empty.file_path = path;
+            empty.total_chunks = 1;
+            empty.chunk_size = static_cast<std::uint32_t>(config_.chunk_size);
+            empty.chunk_hash = sync::FileTransferService::content_hash(empty.data);
+            sent = send_chunk(std::move(empty));
+        } else {
+            sent = transfer_.upload_file(source, session_id, path, send_chunk, config_.chunk_size);
+        }
+        if (sent.is_error()) {
+            return sent;
+        }
+
+        // Finalizing hashes the staged file: every chunk must be in first.
+        // The completion itself is pipelined ahead of the next file.
+        if (auto drained = drain(); drained.is_error()) {
+            return drained;
+        }
+        auto completed = rpc ? window.submit(sync::rpc::Op::UploadComplete,
+                                             sync::rpc::encode_complete_args({session_id, path, metadata.hash}))
+                             : submit("/api/file/upload_complete", json{{"session_id", session_id},
+                                                                        {"file_path", path},
+                                                                        {"expected_hash", metadata.hash}});
+        if (completed.is_error()) {
+            return completed;
+        }
+        ++report.files_uploaded;
+        report.bytes_uploaded += metadata.size;
+    }
+    return drain();
+}
+
+Result<void> SyncClient::download(const std::vector<std::string>& paths, SyncReport& report) {
+    if (config_.transport == SyncTransport::Rpc) {
+        return download_rpc(paths, report);
+    }
+    trace::Span span("client.download");
+    std::atomic<size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<size_t> files{0};
+    std::mutex error_mutex;
+    std::string first_error;
+
+    auto worker = [&] {
+        while (!failed.load(std::memory_order_relaxed)) {
+            size_t index = next.fetch_add(1, std::memory_order_relaxed);
+            if (index >= paths.size()) {
+                return;
+            }
+            auto downloaded = download_file(paths[index]);
+            if (downloaded.is_error()) {
+                std::lock_guard lock(error_mutex);
+                if (!failed.exchange(true)) {
+                    first_error = downloaded.error();
+                }
+                return;
+            }
+            bytes.fetch_add(downloaded.value(), std::memory_order_relaxed);
+            files.fetch_add(1, std::memory_order_relaxed);
+        }
+    };
+
+    size_t workers = std::min(std::max<size_t>(1, config_.download_parallelism), paths.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < workers; ++i) {
+        threads.emplace_back(worker);
+    }
+    if (workers > 0) {
+        worker();
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    report.files_downloaded = files.load();
+    report.bytes_downloaded = bytes.load();
+    if (failed.load()) {
+        return Err<void>(first_error);
+    }
+    return Ok();
+}
+
+Result<void> SyncClient::download_rpc(const std::vector<std::string>& paths, SyncReport& report) {
+    trace::Span span("client.download");
+    RpcWindow window(*this, config_.download_parallelism);
+    for (const auto& path : paths) {
+        auto store = [this, &report, &path](std::vector<uint8_t> payload) -> Result<void> {
+            auto file = sync::rpc::decode_file_data(payload);
+            if (file.is_error()) {
+                return Err<void>("Malformed download response for " + path + ": " + file.error());
+            }
+            if (auto stored = store_download(path, file.value().data, file.value().hash); stored.is_error()) {
+                return stored;
+            }
+            ++report.files_downloaded;
+            report.bytes_downloaded += file.value().data.size();
+            return Ok();
+        };
+        // A file too big for one reply frame is fetched over HTTP instead
+        auto fallback = [this, &report, &path](const std::string& error) -> Result<void> {
+            if (error != sync::rpc::kFileTooLarge) {
+                return Err<void>("download failed: " + error);
+            }
+            auto downloaded = download_file(path);
+            if (downloaded.is_error()) {
+                return Err<void>(downloaded.error());
+            }
+            ++report.files_downloaded;
+            report.bytes_downloaded += downloaded.value();
+            return Ok();
+        };
+        if (auto sent = window.submit(sync::rpc::Op::Download, sync::rpc::encode_text(path), store, fallback);
+            sent.is_error()) {
+            return sent;
+        }
+    }
+    return window.drain();
+}
+
+Result<uint64_t> SyncClient::download_file(const std::string& path) {
+    auto response = call("POST", "/api/file/download", json{{"file_path", path}}.dump());
+    if (response.is_error()) {
+        return Err<uint64_t>(response.error());
+    }
+    auto body = json::parse(response.value().body, nullptr, false);
+    if (!body.is_object() || !body.contains("data") || !body["data"].is_string()) {
+        return Err<uint64_t>("Malformed download response for " + path);
+    }
+    std::vector<std::uint8_t> data;
+    if (auto decoded = hex::decode_to(body["data"].get_ref<const std::string&>(), data); decoded.is_error()) {
+        return Err<uint64_t>("Invalid file data for " + path + ": " + decoded.error());
+    }
+    if (auto stored = store_download(path, data, body.value("hash", std::string{})); stored.is_error()) {
+        return Err<uint64_t>(stored.error());
+    }
+    return Ok(static_cast<uint64_t>(data.size()));
+}
+
+Result<void> SyncClient::store_download(const std::string& path, const std::vector<std::uint8_t>& data,
+                                        const std::string& hash) {
+    fs::path target = local_path(root_, path);
+    if (target.empty()) {
+        return Err<void>("Refusing to write outside the sync root: " + path);
+    }
+    if (sync::FileTransferService::content_hash(data) != hash) {
+        return Err<void>("Hash mismatch downloading " + path);
+    }
+
+    // Written next to the target and renamed, so a reader (or a crash)
+    // never sees a partial file under the real name
+    std::error_code ec;
+    fs::create_directories(target.parent_path(), ec);
+    fs::path partial = target;
+    partial += ".dfs-partial";
+    {
+        std::ofstream out(partial, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!out) {
+            return Err<void>("Failed to write " + partial.string());
+        }
+    }
+    fs::rename(partial, target, ec);
+    if (ec) {
+        fs::remove(partial, ec);
+        return Err<void>("Failed to move " + path + " into place");
+    }
+    return Ok();
+}
+
+} // namespace client
+} // namespace dfs
@@ -0,0 +1,838 @@
+#include "dfs/events/journal.hpp"
+#include "dfs/core/trace.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#ifndef _WIN32
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace dfs::events {
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr std::array<char, 8> kSegmentMagic{'D', 'F', 'S', 'J', 'R', 'N', 'L', '1'};
+constexpr std::size_t kSegmentHeaderBytes = 16;  // magic + base offset
+constexpr std::size_t kRecordHeaderBytes = 8;    // length + crc32
+
+// ════════════════════════════════════════════════════════
+// Byte helpers
+// ════════════════════════════════════════════════════════
+
+std::uint32_t crc32(const std::uint8_t* data, std::size_t size) {
+    static const auto table = []() {
+        std::array<std::uint32_t, 256> t{};
+        for (std::uint32_t i = 0; i < 256; ++i) {
+            std::uint32_t c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    std::uint32_t crc = 0xFFFFFFFFu;
+    for (std::size_t i = 0; i < size; ++i) {
+        crc = table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void store_u32(std::uint8_t* out, std::uint32_t value) {
+    for (int i = 0; i < 4; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+void store_u64(std::uint8_t* out, std::uint64_t value) {
+    for (int i = 0; i < 8; ++i) {
+        out[i] = static_cast<std::uint8_t>(value >> (8 * i));
+    }
+}
+
+std::uint32_t load_u32(const std::uint8_t* in) {
+    std::uint32_t value = 0;
+    for (int i = 0; i < 4; ++i) {
+        value |= static_cast<std::uint32_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+std::uint64_t load_u64(const std::uint8_t* in) {
+    std::uint64_t value = 0;
+    for (int i = 0; i < 8; ++i) {
+        value |= static_cast<std::uint64_t>(in[i]) << (8 * i);
+    }
+    return value;
+}
+
+fs::path segment_path(const fs::path& directory, std::uint64_t base_offset) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%020llu.log", static_cast<unsigned long long>(base_offset));
+    return directory / name;
+}
+
+// ════════════════════════════════════════════════════════
+// Payload encoding
+// ════════════════════════════════════════════════════════
+
+class Writer {
+public:
+    explicit Writer(std::vector<std::uint8_t>& out) : out_(out) {}
+
+    void u8(std::uint8_t value) {
+        out_.push_back(value);
+    }
+
+    void varint(std::uint64_t value) {
+        while (value >= 0x80) {
+            out_.push_back(static_cast<std::uint8_t>(value | 0x80));
+            value >>= 7;
+        }
+        out_.push_back(static_cast<std::uint8_t>(value));
+    }
+
+    void svarint(std::int64_t value) {
+        varint((static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63));
+    }
+
+    void string(const std::string& value) {
+        varint(value.size());
+        out_.insert(out_.end(), value.begin(), value.end());
+    }
+
+    void timestamp(std::chrono::system_clock::time_point tp) {
+        svarint(std::chrono::duration_cast<std::chrono::nanoseconds>(tp.time_since_epoch()).count());
+    }
+
+    void metadata(const metadata::FileMetadata& m) {
+        string(m.file_path);
+        string(m.hash);
+        varint(m.size);
+        svarint(static_cast<std::int64_t>(m.modified_time));
+        svarint(static_cast<std::int64_t>(m.created_time));
+        u8(static_cast<std::uint8_t>(m.sync_state));
+        varint(m.replicas.size());
+        for (const auto& replica : m.replicas) {
+            string(replica.replica_id);
+            varint(replica.version);
+            svarint(static_cast<std::int64_t>(replica.modified_time));
+        }
+    }
+
+private:
+    std::vector<std::uint8_t>& out_;
+};
+
+/**
+ * @brief Bounds-checked reader; any overrun latches failed()
+ */
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t size) : data_(data), size_(size) {}
+
+    bool failed() const { return failed_; }
+    bool at_end() const { return pos_ == size_; }
+
+    std::uint8_t u8() {
+        if (pos_ >= size_) {
+            failed_ = true;
+            return 0;
+        }
+        return data_[pos_++];
+    }
+
+    std::uint64_t varint() {
+        std::uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            std::uint8_t byte = u8();
+            if (failed_) {
+                return 0;
+            }
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) {
+                return value;
+            }
+        }
+        failed_ = true;  // More than 10 bytes
+        return 0;
+    }
+
+    std::int64_t svarint() {
+        std::uint64_t raw = varint();
+        return static_cast<std::int64_t>((raw >> 1) ^ (~(raw & 1) + 1));
+    }
+
+    std::string string() {
+        std::uint64_t length = varint();
+        if (failed_ || length > size_ - pos_) {
+            failed_ = true;
+            return {};
+        }
+        std::string value(reinterpret_cast<const char*>(data_ + pos_), static_cast<std::size_t>(length));
+        pos_ += static_cast<std::size_t>(length);
+        return value;
+    }
+
+    std::chrono::system_clock::time_point timestamp() {
+        auto ns = std::chrono::nanoseconds(svarint());
+        return std::chrono::system_clock::time_point(
+            std::chrono::duration_cast<std::chrono::system_clock::duration>(ns));
+    }
+
+    metadata::FileMetadata metadata() {
+        metadata::FileMetadata m;
+        m.file_path = string();
+        m.hash = string();
+        m.size = varint();
+        m.modified_time = static_cast<time_t>(svarint());
+        m.created_time = static_cast<time_t>(svarint());
+        m.sync_state = static_cast<metadata::SyncState>(u8());
+        std::uint64_t replicas = varint();
+        for (std::uint64_t i = 0; i < replicas && !failed_; ++i) {
+            metadata::ReplicaInfo replica;
+            replica.replica_id = string();
+            replica.version = static_cast<std::uint32_t>(varint());
+            replica.modified_time = static_cast<time_t>(svarint());
+            m.replicas.push_back(std::move(replica));
+        }
+        return m;
+    }
+
+private:
+    const std::uint8_t* data_;
+    std::size_t size_;
+    std::size_t pos_ = 0;
+    bool failed_ = false;
+};
+
+void encode_fields(Writer& w, const FileAddedEvent& e) {
+    w.metadata(e.metadata);
+    w.string(e.source);
+}
+
+void encode_fields(Writer& w, const FileModifiedEvent& e) {
+    w.string(e.file_path);
+    w.string(e.old_hash);
+    w.string(e.new_hash);
+    w.varint(e.old_size);
+    w.varint(e.new_size);
+    w.string(e.source);
+}
+
+void encode_fields(Writer& w, const FileDeletedEvent& e) {
+    w.string(e.file_path);
+    w.metadata(e.last_metadata);
+    w.string(e.source);
+}
+
+void encode_fields(Writer& w, const ServerStartedEvent& e) {
+    w.varint(e.port);
+}
+
+void encode_fields(Writer& w, const ServerShuttingDownEvent& e) {
+    w.string(e.reason);
+}
+
+void encode_fields(Writer& w, const SyncStartedEvent& e) {
+    w.string(e.node_id);
+    w.varint(e.file_count);
+}
+
+void encode_fields(Writer& w, const SyncCompletedEvent& e) {
+    w.string(e.node_id);
+    w.varint(e.files_synced);
+    w.svarint(e.duration.count());
+}
+
+void encode_fields(Writer& w, const SyncFailedEvent& e) {
+    w.string(e.node_id);
+    w.string(e.error_message);
+}
+
+void encode_fields(Writer& w, const FileUploadStartedEvent& e) {
+    w.string(e.session_id);
+    w.string(e.file_path);
+    w.varint(e.total_bytes);
+}
+
+void encode_fields(Writer& w, const FileChunkReceivedEvent& e) {
+    w.string(e.session_id);
+    w.string(e.file_path);
+    w.varint(e.chunk_index);
+    w.varint(e.total_chunks);
+    w.varint(e.bytes_received);
+    w.varint(e.chunks_merged);
+}
+
+void encode_fields(Writer& w, const FileUploadCompletedEvent& e) {
+    w.string(e.session_id);
+    w.string(e.file_path);
+    w.string(e.hash);
+    w.varint(e.total_bytes);
+    w.svarint(e.duration.count());
+}
+
+void encode_fields(Writer& w, const FileDownloadCompletedEvent& e) {
+    w.string(e.session_id);
+    w.string(e.file_path);
+    w.varint(e.total_bytes);
+}
+
+void encode_fields(Writer& w, const FileConflictDetectedEvent& e) {
+    w.metadata(e.local);
+    w.metadata(e.remote);
+    w.string(e.session_id);
+}
+
+void encode_fields(Writer& w, const FileConflictResolvedEvent& e) {
+    w.metadata(e.resolved);
+    w.metadata(e.other);
+    w.u8(static_cast<std::uint8_t>(e.strategy));
+    w.string(e.session_id);
+}
+
+// Decoders read fields in the same order as encode_fields()
+JournalEvent decode_fields(Reader& r, std::size_t index) {
+    switch (index) {
+        case 0: {
+            auto metadata = r.metadata();
+            return FileAddedEvent(std::move(metadata), r.string());
+        }
+        case 1: {
+            auto path = r.string();
+            auto old_hash = r.string();
+            auto new_hash = r.string();
+            auto old_size = r.varint();
+            auto new_size = r.varint();
+            return FileModifiedEvent(std::move(path), std::move(old_hash), std::move(new_hash),
+                                     old_size, new_size, r.string());
+        }
+        case 2: {
+            auto path = r.string();
+            auto metadata = r.metadata();
+            return FileDeletedEvent(std::move(path), std::move(metadata), r.string());
+        }
+        case 3:
+            return ServerStartedEvent(static_cast<std::uint16_t>(r.varint()));
+        case 4:
+            return ServerShuttingDownEvent(r.string());
+        case 5: {
+            auto node = r.string();
+            return SyncStartedEvent(std::move(node), r.varint());
+        }
+        case 6: {
+            auto node = r.string();
+            auto files = r.varint();
+            return SyncCompletedEvent(std::move(node), files, std::chrono::milliseconds(r.svarint()));
+        }
+        case 7: {
+            auto node = r.string();
+            return SyncFailedEvent(std::move(node), r.string());
+        }
+        case 8: {
+            FileUploadStartedEvent e;
+            e.session_id = r.string();
+            e.file_path = r.string();
+            e.total_bytes = r.varint();
+            return e;
+        }
+        case 9: {
+            FileChunkReceivedEvent e;
+            e.session_id = r.string();
+            e.file_path = r.string();
+            e.chunk_index = static_cast<std::uint32_t>(r.varint());
+            e.total_chunks = static_cast<std::uint32_t>(r.varint());
+            e.bytes_received = r.varint();
+            e.chunks_merged = static_cast<std::uint32_t>(r.varint());
+            return e;
+        }
+        case 10: {
+            FileUploadCompletedEvent e;
+            e.session_id = r.string();
+            e.file_path = r.string();
+            e.hash = r.string();
+            e.total_bytes = r.varint();
+            e.duration = std::chrono::milliseconds(r.svarint());
+            return e;
+        }
+        case 11: {
+            FileDownloadCompletedEvent e;
+            e.session_id = r.string();
+            e.file_path = r.string();
+            e.total_bytes = r.varint();
+            return e;
+        }
+        case 12: {
+            FileConflictDetectedEvent e;
+            e.local = r.metadata();
+            e.remote = r.metadata();
+            e.session_id = r.string();
+            return e;
+        }
+        default: {
+            FileConflictResolvedEvent e;
+            e.resolved = r.metadata();
+            e.other = r.metadata();
+            e.strategy = static_cast<ConflictResolutionStrategy>(r.u8());
+            e.session_id = r.string();
+            return e;
+        }
+    }
+}
+
+static_assert(std::variant_size_v<JournalEvent> == 14,
+              "Add an encode_fields/decode_fields case for the new event type");
+
+template<typename F, std::size_t... I>
+void for_each_event_type(F&& f, std::index_sequence<I...>) {
+    (f.template operator()<std::variant_alternative_t<I, JournalEvent>>(), ...);
+}
+
+// ════════════════════════════════════════════════════════
+// Segment scanning
+// ════════════════════════════════════════════════════════
+
+struct ScanResult {
+    std::size_t end = kSegmentHeaderBytes;  // Byte position after the last valid record
+    std::uint64_t records = 0;
+};
+
+/**
+ * @brief Walk valid records in a mapped segment
+ *
+ * Stops at limit, a zero length (preallocated tail) or a bad checksum
+ * (torn write). visit(index, payload, length) may return false to stop.
+ */
+template<typename Visit>
+ScanResult scan_records(const std::uint8_t* data, std::size_t limit, Visit&& visit) {
+    ScanResult result;
+    std::size_t pos = kSegmentHeaderBytes;
+    while (pos + kRecordHeaderBytes <= limit) {
+        const std::uint32_t length = load_u32(data + pos);
+        if (length == 0 || length > limit - pos - kRecordHeaderBytes) {
+            break;
+        }
+        const std::uint8_t* payload = data + pos + kRecordHeaderBytes;
+        if (crc32(payload, length) != load_u32(data + pos + 4)) {
+            break;
+        }
+        if (!visit(result.records, payload, static_cast<std::size_t>(length))) {
+            break;
+        }
+        pos += kRecordHeaderBytes + length;
+        result.end = pos;
+        result.records++;
+    }
+    return result;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════
+// EventCodec
+// ════════════════════════════════════════════════════════
+
+void EventCodec::encode(const JournalEvent& event, std::vector<std::uint8_t>& out) {
+    Writer writer(out);
+    writer.u8(static_cast<std::uint8_t>(event.index() + 1));
+    std::visit([&writer](const auto& e) {
+        encode_fields(writer, e);
+        writer.timestamp(e.timestamp);
+    }, event);
+}
+
+Result<JournalEvent> EventCodec::decode(const std::uint8_t* data, std::size_t size) {
+    Reader reader(data, size);
+    const std::uint8_t type = reader.u8();
+    if (reader.failed() || type == 0 || type > std::variant_size_v<JournalEvent>) {
+        return Err<JournalEvent>(std::string("Unknown journal event type: ") + std::to_string(type));
+    }
+
+    JournalEvent event = decode_fields(reader, type - 1u);
+    auto timestamp = reader.timestamp();
+    std::visit([timestamp](auto& e) { e.timestamp = timestamp; }, event);
+
+    if (reader.failed()) {
+        return Err<JournalEvent>(std::string("Truncated journal record"));
+    }
+    if (!reader.at_end()) {
+        return Err<JournalEvent>(std::string("Trailing bytes in journal record"));
+    }
+    return Ok(std::move(event));
+}
+
+// ════════════════════════════════════════════════════════
+// EventJournal
+// ════════════════════════════════════════════════════════
+
+struct EventJournal::Segment {
+    std::uint64_t base_offset = 0;
+    fs::path path;
+    int fd = -1;
+    std::uint8_t* data = nullptr;
+    std::size_t capacity = 0;
+    std::size_t write_pos = kSegmentHeaderBytes;
+    std::size_t synced_pos = kSegmentHeaderBytes;
+};
+
+EventJournal::EventJournal(JournalOptions options)
+    : options_(std::move(options)),
+      last_sync_(std::chrono::steady_clock::now()) {
+    options_.segment_bytes = std::max<std::size_t>(options_.segment_bytes, 4096);
+    options_.fsync_every_records = std::max<std::size_t>(options_.fsync_every_records, 1);
+}
+
+#ifdef _WIN32
+
+Result<std::unique_ptr<EventJournal>> EventJournal::open(JournalOptions) {
+    return Err<std::unique_ptr<EventJournal>>(std::string("EventJournal requires POSIX mmap"));
+}
+
+EventJournal::~EventJournal() = default;
+Result<std::uint64_t> EventJournal::append(const JournalEvent&) {
+    return Err<std::uint64_t>(std::string("EventJournal requires POSIX mmap"));
+}
+Result<void> EventJournal::sync() { return Ok(); }
+Result<void> EventJournal::recover() { return Ok(); }
+Result<void> EventJournal::open_active(std::uint64_t, std::size_t) { return Ok(); }
+Result<void> EventJournal::close_active() { return Ok(); }
+Result<void> EventJournal::sync_locked() { return Ok(); }
+Result<std::uint64_t> EventJournal::replay(std::uint64_t,
+                                           const std::function<void(const JournalRecord&)>&) const {
+    return Ok<std::uint64_t>(0);
+}
+
+#else
+
+namespace {
+
+std::string errno_message(const std::string& what, const fs::path& path) {
+    return what + " " + path.string() + ": " + std::strerror(errno);
+}
+
+} // namespace
+
+Result<std::unique_ptr<EventJournal>> EventJournal::open(JournalOptions options) {
+    std::error_code ec;
+    fs::create_directories(options.directory, ec);
+    if (ec) {
+        return Err<std::unique_ptr<EventJournal>>(
+            "Cannot create journal directory " + options.directory.string() + ": " + ec.message());
+    }
+
+    std::unique_ptr<EventJournal> journal(new EventJournal(std::move(options)));
+    auto recovered = journal->recover();
+    if (recovered.is_error()) {
+        return Err<std::unique_ptr<EventJournal>>(recovered.error());
+    }
+    return Ok(std::move(journal));
+}
+
+EventJournal::~EventJournal() {
+    detach();
+    std::lock_guard lock(mutex_);
+    if (active_) {
+        auto closed = close_active();
+        if (closed.is_error()) {
+            spdlog::error("[EventJournal] {}", closed.error());
+        }
+    }
+}
+
+Result<void> EventJournal::recover() {
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(options_.directory, ec)) {
+        const auto& path = entry.path();
+        const std::string stem = path.stem().string();
+        if (path.extension() != ".log" || stem.empty() ||
+            !std::all_of(stem.begin(), stem.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        segment_bases_.push_back(std::stoull(stem));
+    }
+    if (ec) {
+        return Err<void>("Cannot list journal directory " + options_.directory.string() + ": " + ec.message());
+    }
+    std::sort(segment_bases_.begin(), segment_bases_.end());
+
+    const std::uint64_t active_base = segment_bases_.empty() ? 0 : segment_bases_.back();
+    auto opened = open_active(active_base, 0);
+    if (opened.is_error()) {
+        return opened;
+    }
+
+    // Find the end of the tail segment
+    auto scan = scan_records(active_->data, active_->capacity,
+                             [](std::uint64_t, const std::uint8_t*, std::size_t) { return true; });
+    active_->write_pos = scan.end;
+    active_->synced_pos = scan.end;
+    next_offset_ = active_->base_offset + scan.records;
+
+    // Wipe a torn record at the tail so it can't resurface behind a
+    // shorter record written over its start
+    if (scan.end + kRecordHeaderBytes <= active_->capacity) {
+        const std::size_t torn = std::min<std::size_t>(
+            kRecordHeaderBytes + load_u32(active_->data + scan.end), active_->capacity - scan.end);
+        std::memset(active_->data + scan.end, 0, torn);
+    }
+    return Ok();
+}
+
+Result<void> EventJournal::open_active(std::uint64_t base_offset, std::size_t min_capacity) {
+    auto segment = std::make_unique<Segment>();
+    segment->base_offset = base_offset;
+    segment->path = segment_path(options_.directory, base_offset);
+
+    segment->fd = ::open(segment->path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (segment->fd < 0) {
+        return Err<void>(errno_message("Cannot open journal segment", segment->path));
+    }
+
+    struct stat st{};
+    if (::fstat(segment->fd, &st) != 0) {
+        ::close(segment->fd);
+        return Err<void>(errno_message("Cannot stat journal segment", segment->path));
+    }
+    const bool fresh = static_cast<std::size_t>(st.st_size) < kSegmentHeaderBytes;
+
+    segment->capacity = std::max({options_.segment_bytes, min_capacity,
+                                  static_cast<std::size_t>(st.st_size)});
+    if (::ftruncate(segment->fd, static_cast<off_t>(segment->capacity)) != 0) {
+        ::close(segment->fd);
+        return Err<void>(errno_message("Cannot size journal segment", segment->path));
+    }
+
+    void* mapped = ::mmap(nullptr, segment->capacity, PROT_READ | PROT_WRITE, MAP_SHARED, segment->fd, 0);
+    if (mapped == MAP_FAILED) {
+        ::close(segment->fd);
+        return Err<void>(errno_message("Cannot map journal segment", segment->path));
+    }
+    segment->data = static_cast<std::uint8_t*>(mapped);
+
+    if (fresh) {
+        std::memcpy(segment->data, kSegmentMagic.data(), kSegmentMagic.size());
+        store_u64(segment->data + 8, base_offset);
+    } else if (std::memcmp(segment->data, kSegmentMagic.data(), kSegmentMagic.size()) != 0 ||
+               load_u64(segment->data + 8) != base_offset) {
+        ::munmap(segment->data, segment->capacity);
+        ::close(segment->fd);
+        return Err<void>("Corrupt journal segment header: " + segment->path.string());
+    }
+
+    if (segment_bases_.empty() || segment_bases_.back() != base_offset) {
+        segment_bases_.push_back(base_offset);
+    }
+    active_ = std::move(segment);
+    return Ok();
+}
+
+Result<void> EventJournal::close_active() {
+    auto synced = sync_locked();
+
+    Segment& segment = *active_;
+    ::munmap(segment.data, segment.capacity);
+    // Trim the preallocated tail; reopening extends it again
+    int rc = ::ftruncate(segment.fd, static_cast<off_t>(segment.write_pos));
+    if (rc == 0) {
+        rc = ::fsync(segment.fd);
+    }
+    const std::string error = rc != 0 ? errno_message("Cannot finalize journal segment", segment.path) : "";
+    ::close(segment.fd);
+    active_.reset();
+
+    if (synced.is_error()) {
+        return synced;
+    }
+    if (!error.empty()) {
+        return Err<void>(error);
+    }
+    return Ok();
+}
+
+Result<void> EventJournal::sync_locked() {
+    unsynced_records_ = 0;
+    last_sync_ = std::chrono::steady_clock::now();
+
+    Segment& segment = *active_;
+    if (segment.synced_pos >= segment.write_pos) {
+        return Ok();
+    }
+
+    trace::Span fsync_span("journal.fsync");
+    const std::size_t page = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+    const std::size_t begin = segment.synced_pos / page * page;
+    if (::msync(segment.data + begin, segment.write_pos - begin, MS_SYNC) != 0) {
+        return Err<void>(errno_message("msync failed for", segment.path));
+    }
+    segment.synced_pos = segment.write_pos;
+    return Ok();
+}
+
+Result<void> EventJournal::sync() {
+    std::lock_guard lock(mutex_);
+    return sync_locked();
+}
+
+Result<std::uint64_t> EventJournal::append(const JournalEvent& event) {
+    std::lock_guard lock(mutex_);
+
+    scratch_.clear();
+    EventCodec::encode(event, scratch_);
+    const std::size_t record_bytes = kRecordHeaderBytes + scratch_.size();
+
+    if (active_->write_pos + record_bytes > active_->capacity) {
+        auto closed = close_active();
+        if (closed.is_error()) {
+            return Err<std::uint64_t>(closed.error());
+        }
+        auto opened = open_active(next_offset_, kSegmentHeaderBytes + record_bytes);
+        if (opened.is_error()) {
+            return Err<std::uint64_t>(opened.error());
+        }
+    }
+
+    std::uint8_t* out = active_->data + active_->write_pos;
+    std::memcpy(out + kRecordHeaderBytes, scratch_.data(), scratch_.size());
+    store_u32(out + 4, crc32(scratch_.data(), scratch_.size()));
+    store_u32(out, static_cast<std::uint32_t>(scratch_.size()));  // Length last: marks record valid
+    active_->write_pos += record_bytes;
+
+    const std::uint64_t offset = next_offset_++;
+
+    if (++unsynced_records_ >= options_.fsync_every_records ||
+        std::chrono::steady_clock::now() - last_sync_ >= options_.fsync_interval) {
+        auto synced = sync_locked();
+        if (synced.is_error()) {
+            return Err<std::uint64_t>(synced.error());
+        }
+    }
+    return Ok(offset);
+}
+
+Result<std::uint64_t> EventJournal::replay(std::uint64_t from_offset,
+                                           const std::function<void(const JournalRecord&)>& visitor) const {
+    // Snapshot what's durable-in-memory now; appends after this point
+    // land past active_end and are not visited.
+    std::vector<std::uint64_t> bases;
+    std::uint64_t active_base = 0;
+    std::size_t active_end = 0;
+    {
+        std::lock_guard lock(mutex_);
+        bases = segment_bases_;
+        active_base = active_->base_offset;
+        active_end = active_->write_pos;
+    }
+
+    std::uint64_t visited = 0;
+    for (std::size_t i = 0; i < bases.size(); ++i) {
+        const std::uint64_t base = bases[i];
+        if (i + 1 < bases.size() && bases[i + 1] <= from_offset) {
+            continue;  // Whole segment is before from_offset
+        }
+
+        const fs::path path = segment_path(options_.directory, base);
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            return Err<std::uint64_t>(errno_message("Cannot open journal segment", path));
+        }
+        struct stat st{};
+        ::fstat(fd, &st);
+        std::size_t limit = static_cast<std::size_t>(st.st_size);
+        if (base == active_base) {
+            limit = std::min(limit, active_end);
+        }
+        if (limit < kSegmentHeaderBytes) {
+            ::close(fd);
+            continue;
+        }
+
+        void* mapped = ::mmap(nullptr, limit, PROT_READ, MAP_SHARED, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            return Err<std::uint64_t>(errno_message("Cannot map journal segment", path));
+        }
+        const auto* data = static_cast<const std::uint8_t*>(mapped);
+
+        std::string error;
+        scan_records(data, limit, [&](std::uint64_t index, const std::uint8_t* payload, std::size_t length) {
+            const std::uint64_t offset = base + index;
+            if (offset < from_offset) {
+                return true;
+            }
+            auto decoded = EventCodec::decode(payload, length);
+            if (decoded.is_error()) {
+                error = "Offset " + std::to_string(offset) + ": " + decoded.error();
+                return false;
+            }
+            visitor(JournalRecord{offset, std::move(decoded.value())});
+            visited++;
+            return true;
+        });
+        ::munmap(mapped, limit);
+
+        if (!error.empty()) {
+            return Err<std::uint64_t>(error);
+        }
+    }
+    return Ok(visited);
+}
+
+#endif  // _WIN32
+
+Result<std::uint64_t> EventJournal::replay_into(EventBus& bus, std::uint64_t from_offset) const {
+    return replay(from_offset, [&bus](const JournalRecord& record) {
+        std::visit([&bus](const auto& e) { bus.emit(e); }, record.event);
+    });
+}
+
+void EventJournal::attach(EventBus& bus) {
+    detach();
+    for_each_event_type([this, &bus]<typename Event>() {
+        const size_t id = bus.subscribe<Event>([this](const Event& e) {
+            auto appended = append(JournalEvent(e));
+            if (appended.is_error()) {
+                spdlog::error("[EventJournal] append failed: {}", appended.error());
+            }
+        });
+        unsubscribers_.push_back([&bus, id]() { bus.unsubscribe<Event>(id); });
+    }, std::make_index_sequence<std::variant_size_v<JournalEvent>>{});
+}
+
+void EventJournal::detach() {
+    for (auto& unsubscribe : unsubscribers_) {
+        unsubscribe();
+    }
+    unsubscribers_.clear();
+}
+
+std::uint64_t EventJournal::next_offset() const {
+    std::lock_guard lock(mutex_);
+    return next_offset_;
+}
+
+std::uint64_t EventJournal::first_offset() const {
+    std::lock_guard lock(mutex_);
+    return segment_bases_.empty() ? 0 : segment_bases_.front();
+}
+
+std::size_t EventJournal::segment_count() const {
+    std::lock_guard lock(mutex_);
+    return segment_bases_.size();
+}
+
+} // namespace dfs::events
@@ -0,0 +1,218 @@
+#include "dfs/network/change_feed.hpp"
+
+#include <algorithm>
+
+namespace dfs {
+namespace network {
+
+// ────────────────────────────────────────────────────────────
+// Subscriber bodies
+// ────────────────────────────────────────────────────────────
+
+/**
+ * Shared part of both subscription kinds: the cursor and the watcher
+ * registration. Bodies are driven by one server thread at a time.
+ */
+class FeedBody : public PushBody {
+public:
+    FeedBody(std::shared_ptr<ChangeFeed> feed, uint64_t cursor)
+        : feed_(std::move(feed)), cursor_(cursor) {}
+
+    ~FeedBody() override { unwatch(); }
+
+    void watch(std::function<void()> wake) override {
+        unwatch();
+        watcher_ = feed_->add_watcher(std::move(wake));
+    }
+
+    void unwatch() override {
+        if (watcher_ != 0) {
+            feed_->remove_watcher(watcher_);
+            watcher_ = 0;
+        }
+    }
+
+protected:
+    // Records after the cursor; false on a gap (the cursor then skips to
+    // the newest record, since the client resyncs from a snapshot anyway)
+    bool next_batch() {
+        batch_.clear();
+        if (!feed_->read_since(cursor_, feed_->config().max_batch, batch_)) {
+            cursor_ = feed_->last_sequence();
+            return false;
+        }
+        if (!batch_.empty()) {
+            cursor_ = batch_.back().sequence;
+        }
+        return true;
+    }
+
+    std::shared_ptr<ChangeFeed> feed_;
+    uint64_t cursor_;
+    std::vector<ChangeFeed::Record> batch_;
+
+private:
+    size_t watcher_ = 0;
+};
+
+namespace {
+
+class LongPollBody : public FeedBody {
+public:
+    LongPollBody(std::shared_ptr<ChangeFeed> feed, uint64_t cursor)
+        : FeedBody(std::move(feed), cursor)
+        , deadline_(Clock::now() + feed_->config().long_poll_timeout) {}
+
+    bool pull(std::string& out, Clock::time_point now) override {
+        bool in_history = next_batch();
+        if (in_history && batch_.empty() && now < deadline_) {
+            return true;   // Nothing yet: stay parked
+        }
+
+        out += "{\"cursor\":";
+        out += std::to_string(cursor_);
+        if (!in_history) {
+            out += ",\"resync\":true";
+        }
+        out += ",\"changes\":[";
+        for (size_t i = 0; i < batch_.size(); ++i) {
+            if (i > 0) {
+                out += ',';
+            }
+            out += batch_[i].data;
+        }
+        out += "]}";
+        return false;
+    }
+
+    Clock::time_point deadline() const override { return deadline_; }
+
+private:
+    Clock::time_point deadline_;
+};
+
+class EventStreamBody : public FeedBody {
+public:
+    EventStreamBody(std::shared_ptr<ChangeFeed> feed, uint64_t cursor)
+        : FeedBody(std::move(feed), cursor)
+        , heartbeat_at_(Clock::now() + feed_->config().heartbeat) {}
+
+    bool pull(std::string& out, Clock::time_point now) override {
+        if (!started_) {
+            // Reconnect delay for EventSource, and a first byte so the
+            // client sees the stream is open
+            out += "retry: 3000\n: subscribed\n\n";
+            started_ = true;
+        }
+
+        if (!next_batch()) {
+            out += "event: resync\ndata: {\"cursor\":";
+            out += std::to_string(cursor_);
+            out += "}\n\n";
+        }
+        for (const auto& record : batch_) {
+            out += "id: ";
+            out += std::to_string(record.sequence);
+            out += "\nevent: change\ndata: ";
+            out += record.data;   // One line: records must not contain '\n'
+            out += "\n\n";
+        }
+
+        if (!out.empty()) {
+            heartbeat_at_ = now + feed_->config().heartbeat;
+        } else if (now >= heartbeat_at_) {
+            out += ": ping\n\n";
+            heartbeat_at_ = now + feed_->config().heartbeat;
+        }
+        return true;   // Open until the client leaves
+    }
+
+    Clock::time_point deadline() const override { return heartbeat_at_; }
+
+private:
+    Clock::time_point heartbeat_at_;
+    bool started_ = false;
+};
+
+} // namespace
+
+// ────────────────────────────────────────────────────────────
+// ChangeFeed
+// ────────────────────────────────────────────────────────────
+
+ChangeFeed::ChangeFeed(ChangeFeedConfig config)
+    : config_(std::move(config)) {
+    config_.history = std::max<size_t>(1, config_.history);
+    config_.max_batch = std::max<size_t>(1, config_.max_batch);
+}
+
+uint64_t ChangeFeed::publish(std::string data) {
+    uint64_t sequence;
+    {
+        std::lock_guard lock(history_mutex_);
+        sequence = ++last_sequence_;
+        history_.push_back({sequence, std::move(data)});
+        if (history_.size() > config_.history) {
+            history_.pop_front();
+        }
+    }
+
+    std::lock_guard lock(watchers_mutex_);
+    for (const auto& [id, wake] : watchers_) {
+        wake();
+    }
+    return sequence;
+}
+
+uint64_t ChangeFeed::last_sequence() const {
+    std::lock_guard lock(history_mutex_);
+    return last_sequence_;
+}
+
+bool ChangeFeed::read_since(uint64_t cursor, size_t max, std::vector<Record>& out) const {
+    std::lock_guard lock(history_mutex_);
+    if (cursor == last_sequence_) {
+        return true;
+    }
+    if (cursor > last_sequence_) {
+        return false;   // From before a restart: the client must resync
+    }
+    uint64_t oldest = history_.empty() ? last_sequence_ + 1 : history_.front().sequence;
+    if (cursor + 1 < oldest) {
+        return false;
+    }
+    // Sequences are contiguous, so the first record to send is found by offset
+    auto it = history_.begin() + static_cast<std::ptrdiff_t>(cursor + 1 - oldest);
+    for (; it != history_.end() && out.size() < max; ++it) {
+        out.push_back(*it);
+    }
+    return true;
+}
+
+std::shared_ptr<PushBody> ChangeFeed::long_poll(uint64_t cursor) {
+    return std::make_shared<LongPollBody>(shared_from_this(), cursor);
+}
+
+std::shared_ptr<PushBody> ChangeFeed::event_stream(uint64_t cursor) {
+    return std::make_shared<EventStreamBody>(shared_from_this(), cursor);
+}
+
+size_t ChangeFeed::subscribers() const {
+    std::lock_guard lock(watchers_mutex_);
+    return watchers_.size();
+}
+
+size_t ChangeFeed::add_watcher(std::function<void()> wake) {
+    std::lock_guard lock(watchers_mutex_);
+    size_t id = next_watcher_++;
+    watchers_.emplace(id, std::move(wake));
+    return id;
+}
+
+void ChangeFeed::remove_watcher(size_t id) {
+    std::lock_guard lock(watchers_mutex_);
+    watchers_.erase(id);
+}
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,383 @@
+#include "dfs/network/compression.hpp"
+
+#include <spdlog/spdlog.h>
+
+#ifdef DFS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#ifdef DFS_HAS_ZSTD
+#include <zstd.h>
+#endif
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <cstring>
+
+namespace dfs {
+namespace network {
+
+// ────────────────────────────────────────────────────────────
+// Per-thread compression contexts
+// ────────────────────────────────────────────────────────────
+
+namespace {
+
+#ifdef DFS_HAS_ZLIB
+/**
+ * deflate state with a gzip wrapper, set up once per thread. deflateReset()
+ * between responses keeps the allocated window and hash tables.
+ */
+class GzipContext {
+public:
+    GzipContext() {
+        std::memset(&stream_, 0, sizeof(stream_));
+        ready_ = deflateInit2(&stream_, level_, Z_DEFLATED, 15 + 16 /* gzip header */, 8,
+                              Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+
+    ~GzipContext() {
+        if (ready_) {
+            deflateEnd(&stream_);
+        }
+    }
+
+    GzipContext(const GzipContext&) = delete;
+    GzipContext& operator=(const GzipContext&) = delete;
+
+    Result<void> compress(std::string_view input, int level, std::string& out) {
+        if (!ready_) {
+            return Err<void>(std::string("gzip: deflateInit2 failed"));
+        }
+        if (input.size() > UINT_MAX) {
+            return Err<void>(std::string("gzip: input too large"));
+        }
+
+        deflateReset(&stream_);
+        if (level != level_) {
+            // On a freshly reset stream this only switches parameters
+            if (deflateParams(&stream_, level, Z_DEFAULT_STRATEGY) != Z_OK) {
+                return Err<void>(std::string("gzip: invalid level"));
+            }
+            level_ = level;
+        }
+
+        out.resize(deflateBound(&stream_, static_cast<uLong>(input.size())));
+        stream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+        stream_.avail_in = static_cast<uInt>(input.size());
+        stream_.next_out = reinterpret_cast<Bytef*>(out.data());
+        stream_.avail_out = static_cast<uInt>(out.size());
+
+        // deflateBound() guarantees one call finishes the stream
+        if (deflate(&stream_, Z_FINISH) != Z_STREAM_END) {
+            return Err<void>(std::string("gzip: deflate did not finish"));
+        }
+        out.resize(stream_.total_out);
+        return Ok();
+    }
+
+private:
+    z_stream stream_;
+    int level_ = 6;
+    bool ready_ = false;
+};
+#endif
+
+#ifdef DFS_HAS_ZSTD
+class ZstdContext {
+public:
+    ZstdContext() : ctx_(ZSTD_createCCtx()) {}
+    ~ZstdContext() { ZSTD_freeCCtx(ctx_); }
+
+    ZstdContext(const ZstdContext&) = delete;
+    ZstdContext& operator=(const ZstdContext&) = delete;
+
+    Result<void> compress(std::string_view input, int level, std::string& out) {
+        if (ctx_ == nullptr) {
+            return Err<void>(std::string("zstd: ZSTD_createCCtx failed"));
+        }
+        out.resize(ZSTD_compressBound(input.size()));
+        size_t written = ZSTD_compressCCtx(ctx_, out.data(), out.size(), input.data(), input.size(), level);
+        if (ZSTD_isError(written)) {
+            return Err<void>(std::string("zstd: ") + ZSTD_getErrorName(written));
+        }
+        out.resize(written);
+        return Ok();
+    }
+
+private:
+    ZSTD_CCtx* ctx_;
+};
+#endif
+
+bool starts_with_ci(std::string_view text, std::string_view prefix) {
+    return text.size() >= prefix.size() && ascii_iequals(text.substr(0, prefix.size()), prefix);
+}
+
+std::string_view trim(std::string_view text) {
+    while (!text.empty() && (text.front() == ' ' || text.front() == '\t')) {
+        text.remove_prefix(1);
+    }
+    while (!text.empty() && (text.back() == ' ' || text.back() == '\t')) {
+        text.remove_suffix(1);
+    }
+    return text;
+}
+
+// q-value of one Accept-Encoding element's parameters (";q=0.5"); 1 if absent
+double parse_qvalue(std::string_view params) {
+    while (!params.empty()) {
+        size_t next = params.find(';');
+        std::string_view param = trim(params.substr(0, next));
+        params = next == std::string_view::npos ? std::string_view{} : params.substr(next + 1);
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') && param[1] == '=') {
+            double q = 0.0;
+            auto [end, ec] = std::from_chars(param.data() + 2, param.data() + param.size(), q);
+            return ec == std::errc() ? std::clamp(q, 0.0, 1.0) : 0.0;
+        }
+    }
+    return 1.0;
+}
+
+} // namespace
+
+// ────────────────────────────────────────────────────────────
+// Codings
+// ────────────────────────────────────────────────────────────
+
+std::string_view encoding_name(ContentEncoding encoding) {
+    switch (encoding) {
+        case ContentEncoding::GZIP: return "gzip";
+        case ContentEncoding::ZSTD: return "zstd";
+        default: return "identity";
+    }
+}
+
+bool encoding_available(ContentEncoding encoding) {
+    switch (encoding) {
+#ifdef DFS_HAS_ZLIB
+        case ContentEncoding::GZIP: return true;
+#endif
+#ifdef DFS_HAS_ZSTD
+        case ContentEncoding::ZSTD: return true;
+#endif
+        default: return false;
+    }
+}
+
+ContentEncoding negotiate_encoding(std::string_view accept_encoding) {
+    // Weight per coding: -1 = not mentioned
+    double gzip_q = -1.0;
+    double zstd_q = -1.0;
+    double any_q = -1.0;
+
+    while (!accept_encoding.empty()) {
+        size_t next = accept_encoding.find(',');
+        std::string_view element = accept_encoding.substr(0, next);
+        accept_encoding = next == std::string_view::npos ? std::string_view{} : accept_encoding.substr(next + 1);
+
+        size_t params_at = element.find(';');
+        std::string_view coding = trim(element.substr(0, params_at));
+        double q = params_at == std::string_view::npos ? 1.0 : parse_qvalue(element.substr(params_at + 1));
+
+        if (ascii_iequals(coding, "gzip") || ascii_iequals(coding, "x-gzip")) {
+            gzip_q = q;
+        } else if (ascii_iequals(coding, "zstd")) {
+            zstd_q = q;
+        } else if (coding == "*") {
+            any_q = q;
+        }
+    }
+
+    // "*" covers codings not listed by name
+    if (gzip_q < 0) gzip_q = any_q;
+    if (zstd_q < 0) zstd_q = any_q;
+    if (!encoding_available(ContentEncoding::GZIP)) gzip_q = 0.0;
+    if (!encoding_available(ContentEncoding::ZSTD)) zstd_q = 0.0;
+
+    if (zstd_q > 0 && zstd_q >= gzip_q) {
+        return ContentEncoding::ZSTD;
+    }
+    if (gzip_q > 0) {
+        return ContentEncoding::GZIP;
+    }
+    return ContentEncoding::IDENTITY;
+}
+
+bool is_compressible_type(std::string_view content_type) {
+    std::string_view type = trim(content_type.substr(0, content_type.find(';')));
+    if (starts_with_ci(type, "text/")) {
+        return true;
+    }
+    if (ascii_iequals(type, "application/json") || ascii_iequals(type, "application/javascript") ||
+        ascii_iequals(type, "application/xml") || ascii_iequals(type, "image/svg+xml")) {
+        return true;
+    }
+    // Structured syntax suffixes: application/problem+json, application/atom+xml
+    return type.size() > 5 && (ascii_iequals(type.substr(type.size() - 5), "+json") ||
+                               ascii_iequals(type.substr(type.size() - 4), "+xml"));
+}
+
+// Parameters go unused in a build with neither zlib nor zstd
+Result<void> compress(ContentEncoding encoding, [[maybe_unused]] std::string_view input, [[maybe_unused]] int level,
+                      [[maybe_unused]] std::string& out) {
+    switch (encoding) {
+#ifdef DFS_HAS_ZLIB
+        case ContentEncoding::GZIP: {
+            thread_local GzipContext gzip;
+            return gzip.compress(input, level, out);
+        }
+#endif
+#ifdef DFS_HAS_ZSTD
+        case ContentEncoding::ZSTD: {
+            thread_local ZstdContext zstd;
+            return zstd.compress(input, level, out);
+        }
+#endif
+        default:
+            return Err<void>("compress: coding not available: " + std::string(encoding_name(encoding)));
+    }
+}
+
+// ────────────────────────────────────────────────────────────
+// ResponseCompressor
+// ────────────────────────────────────────────────────────────
+
+ResponseCompressor::ResponseCompressor(CompressionOptions options)
+    : options_(std::move(options)) {
+    cache_.reserve(options_.cache_entries);
+}
+
+ResponseFilter ResponseCompressor::filter() {
+    return [this](const HttpContext& ctx, HttpResponse& response) { apply(ctx, response); };
+}
+
+void ResponseCompressor::apply(const HttpContext& ctx, HttpResponse& response) {
+    if (response.status_code != 200 || response.is_streaming() ||
+        response.body.size() < options_.min_size ||
+        response.headers.contains("Content-Encoding") ||
+        !is_compressible_type(response.headers.get(HeaderId::CONTENT_TYPE))) {
+        return;
+    }
+
+    // From here on the coding depends on Accept-Encoding, compressed or not
+    std::string_view vary = response.headers.get("Vary");
+    if (vary.empty()) {
+        response.headers.set("Vary", "Accept-Encoding");
+    } else if (vary != "*" && vary.find("Accept-Encoding") == std::string_view::npos) {
+        response.headers.set("Vary", std::string(vary) + ", Accept-Encoding");
+    }
+
+    ContentEncoding encoding = negotiate_encoding(ctx.request.headers.get("Accept-Encoding"));
+    if (encoding == ContentEncoding::IDENTITY) {
+        return;
+    }
+
+    // Weak validators ("W/...") may cover different bytes; only strong ones key the cache
+    std::string etag(response.headers.get("ETag"));
+    std::string_view url(ctx.request.url);
+    bool cacheable = options_.cache_entries > 0 && ctx.request.method == HttpMethod::GET &&
+                     !etag.empty() && etag.rfind("W/", 0) != 0;
+
+    std::string_view original(reinterpret_cast<const char*>(response.body.data()), response.body.size());
+
+    if (cacheable) {
+        std::shared_ptr<const std::string> cached;
+        if (cache_lookup(url, encoding, etag, cached)) {
+            cache_hits_.fetch_add(1, std::memory_order_relaxed);
+            if (cached) {
+                bytes_in_.fetch_add(original.size(), std::memory_order_relaxed);
+                bytes_out_.fetch_add(cached->size(), std::memory_order_relaxed);
+                set_encoded(response, encoding, *cached);
+            }
+            return;
+        }
+    }
+
+    thread_local std::string scratch;   // Keeps its capacity across responses
+    int level = encoding == ContentEncoding::ZSTD ? options_.zstd_level : options_.gzip_level;
+    auto result = compress(encoding, original, level, scratch);
+    if (result.is_error()) {
+        spdlog::warn("Response compression failed, sending identity: {}", result.error());
+        return;
+    }
+
+    if (static_cast<double>(scratch.size()) > static_cast<double>(original.size()) * options_.max_ratio) {
+        incompressible_.fetch_add(1, std::memory_order_relaxed);
+        if (cacheable) {
+            cache_store(url, encoding, etag, nullptr);
+        }
+        return;
+    }
+
+    compressed_.fetch_add(1, std::memory_order_relaxed);
+    bytes_in_.fetch_add(original.size(), std::memory_order_relaxed);
+    bytes_out_.fetch_add(scratch.size(), std::memory_order_relaxed);
+    if (cacheable) {
+        cache_store(url, encoding, etag, std::make_shared<const std::string>(scratch));
+    }
+    set_encoded(response, encoding, scratch);
+}
+
+void ResponseCompressor::set_encoded(HttpResponse& response, ContentEncoding encoding, std::string_view body) {
+    std::string_view name = encoding_name(encoding);
+    response.set_body(body);
+    response.headers.set("Content-Encoding", name);
+
+    // "abc" -> "abc-gzip": a strong validator must differ per representation
+    std::string_view etag = response.headers.get("ETag");
+    if (etag.size() >= 2 && etag.back() == '"' && etag.rfind("W/", 0) != 0) {
+        std::string coded(etag.substr(0, etag.size() - 1));
+        coded += '-';
+        coded += name;
+        coded += '"';
+        response.headers.set("ETag", coded);
+    }
+}
+
+bool ResponseCompressor::cache_lookup(std::string_view url, ContentEncoding encoding, std::string_view etag,
+                                      std::shared_ptr<const std::string>& body) {
+    std::lock_guard lock(cache_mutex_);
+    for (auto& entry : cache_) {
+        if (entry.encoding == encoding && entry.url == url) {
+            if (entry.etag != etag) {
+                return false;   // Stale: the next store replaces it
+            }
+            entry.last_used = ++tick_;
+            body = entry.body;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ResponseCompressor::cache_store(std::string_view url, ContentEncoding encoding, std::string_view etag,
+                                     std::shared_ptr<const std::string> body) {
+    std::lock_guard lock(cache_mutex_);
+    CacheEntry* slot = nullptr;
+    for (auto& entry : cache_) {
+        if (entry.encoding == encoding && entry.url == url) {
+            slot = &entry;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        if (cache_.size() < options_.cache_entries) {
+            slot = &cache_.emplace_back();
+        } else {
+            slot = &*std::min_element(cache_.begin(), cache_.end(),
+                                      [](const CacheEntry& a, const CacheEntry& b) {
+                                          return a.last_used < b.last_used;
+                                      });
+        }
+        slot->url.assign(url);
+        slot->encoding = encoding;
+    }
+    slot->etag.assign(etag);
+    slot->body = std::move(body);
+    slot->last_used = ++tick_;
+}
+
+} // namespace network
+} // namespace dfs
@@ -1,4 +1,5 @@
 #include "dfs/network/http_router.hpp"
+#include "dfs/core/trace.hpp"
 #include <spdlog/spdlog.h>
 #include <sstream>
 
@@ -70,21 +71,21 @@ Route::Route(HttpMethod m, const std::string& pat, RouteHandler h)
     }
 }
 
-bool Route::matches(HttpMethod req_method, const std::string& url) const {
+bool Route::matches(HttpMethod req_method, std::string_view url) const {
     // Method must match
     if (method != req_method) {
         return false;
     }
 
     // URL must match regex
-    return std::regex_match(url, regex);
+    return std::regex_match(url.begin(), url.end(), regex);
 }
 
-std::unordered_map<std::string, std::string> Route::extract_params(const std::string& url) const {
+std::unordered_map<std::string, std::string> Route::extract_params(std::string_view url) const {
     std::unordered_map<std::string, std::string> params;
-    std::smatch match;
+    std::match_results<std::string_view::const_iterator> match;
 
-    if (std::regex_match(url, match, regex)) {
+    if (std::regex_match(url.begin(), url.end(), match, regex)) {
         // match[0] is the full string, match[1+] are capture groups
         for (size_t i = 0; i < param_names.size() && i + 1 < match.size(); ++i) {
             params[param_names[i]] = match[i + 1].str();
@@ -148,6 +149,10 @@ void HttpRouter::use(Middleware middleware) {
     middlewares_.push_back(std::move(middleware));
 }
 
+void HttpRouter::use_after(ResponseFilter filter) {
+    filters_.push_back(std::move(filter));
+}
+
 void HttpRouter::set_not_found_handler(RouteHandler handler) {
     not_found_handler_ = std::move(handler);
 }
@@ -155,6 +160,18 @@ void HttpRouter::set_not_found_handler(RouteHandler handler) {
 HttpResponse HttpRouter::handle_request(const HttpRequest& request) {
     // Create context
     HttpContext ctx(request);
+    HttpResponse response = dispatch(ctx);
+
+    // Filters see every response, including short-circuits and 404s
+    for (const auto& filter : filters_) {
+        filter(ctx, response);
+    }
+
+    return response;
+}
+
+HttpResponse HttpRouter::dispatch(HttpContext& ctx) {
+    const HttpRequest& request = ctx.request;
     HttpResponse response(HttpStatus::OK);
 
     // Run middleware
@@ -166,11 +183,13 @@ HttpResponse HttpRouter::handle_request(const HttpRequest& request) {
     }
 
     // Find matching route
+    trace::Span route_span("http.route");
     const Route* route = find_route(request.method, request.url);
 
     if (route) {
         // Extract URL parameters
         ctx.params = route->extract_params(request.url);
+        route_span.end();
 
         // Call route handler
         try {
@@ -211,7 +230,7 @@ HttpResponse HttpRouter::default_not_found_handler(const HttpContext& ctx) {
          << "<head><title>404 Not Found</title></head>\n"
          << "<body>\n"
          << "<h1>404 - Not Found</h1>\n"
-         << "<p>The requested URL <code>" << ctx.request.url << "</code> was not found on this server.</p>\n"
+         << "<p>The requested URL <code>" << std::string_view(ctx.request.url) << "</code> was not found on this server.</p>\n"
          << "<hr>\n"
          << "<p>DFS HTTP Server</p>\n"
          << "</body>\n"
@@ -223,7 +242,7 @@ HttpResponse HttpRouter::default_not_found_handler(const HttpContext& ctx) {
     return response;
 }
 
-const Route* HttpRouter::find_route(HttpMethod method, const std::string& url) const {
+const Route* HttpRouter::find_route(HttpMethod method, std::string_view url) const {
     for (const auto& route : routes_) {
         if (route.matches(method, url)) {
             return &route;
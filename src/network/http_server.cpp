@@ -1,6 +1,11 @@
 #include "dfs/network/http_server.hpp"
+#include "dfs/network/buffer_pool.hpp"
+#include "dfs/network/connection_arena.hpp"
+#include "dfs/core/trace.hpp"
 #include <spdlog/spdlog.h>
 #include <algorithm>
+#include <condition_variable>
+#include <mutex>
 
 namespace dfs {
 namespace network {
@@ -14,6 +19,7 @@ HttpServer::HttpServer(size_t thread_pool_size, size_t max_queue_size)
     , max_queue_size_(max_queue_size)
     , running_(false)
     , active_connections_(0)
+    , queue_depth_(0)
     , total_processed_(0) {
 
     spdlog::info("HttpServer created with {} worker threads, max queue size: {}",
@@ -28,6 +34,10 @@ void HttpServer::set_handler(HttpRequestHandler handler) {
     handler_ = std::move(handler);
 }
 
+void HttpServer::set_admission_config(AdmissionConfig config) {
+    admission_.configure(std::move(config));
+}
+
 Result<void> HttpServer::listen(uint16_t port, const std::string& address) {
     // Create TCP socket
     auto create_result = listener_.create(SocketType::TCP);
@@ -55,8 +65,10 @@ Result<void> HttpServer::listen(uint16_t port, const std::string& address) {
         return Err<void, std::string>("Failed to listen: " + listen_result.error());
     }
 
-    port_ = port;
-    spdlog::info("HTTP server (thread pool) listening on {}:{}", address, port);
+    // Port 0 asks the kernel for a free port; report the one it chose
+    auto bound_port = listener_.local_port();
+    port_ = bound_port.is_ok() ? bound_port.value() : port;
+    spdlog::info("HTTP server (thread pool) listening on {}:{}", address, port_);
 
     return Ok();
 }
@@ -71,9 +83,7 @@ Result<void> HttpServer::serve_forever() {
     }
 
     // Spawn worker threads
-    for (size_t i = 0; i < thread_pool_size_; ++i) {
-        worker_threads_.emplace_back([this] { worker_thread(); });
-    }
+    pool_ = std::make_unique<WorkStealingPool>(thread_pool_size_);
 
     running_.store(true, std::memory_order_release);
     spdlog::info("Server started with {} worker threads. Waiting for connections...",
@@ -95,31 +105,34 @@ Result<void> HttpServer::serve_forever() {
         auto client = std::move(accept_result.value());
         spdlog::debug("Accepted new connection");
 
-        // Enqueue with overflow protection
-        {
-            std::lock_guard<std::mutex> lock(queue_mutex_);
-            if (task_queue_.size() >= max_queue_size_) {
-                spdlog::warn("Queue full ({} tasks), rejecting connection", max_queue_size_);
-
-                // Send 503 Service Unavailable
-                auto overload_response = create_error_response(
-                    HttpStatus::SERVICE_UNAVAILABLE,
-                    "Server overloaded, please try again later"
-                );
-                overload_response.set_header("Retry-After", "5");
-                send_response(*client, overload_response);
-                client->close();
-                continue;
-            }
-
-            task_queue_.push(std::move(client));
+        // Admission: queue limit and per-client limit, answered with the
+        // pre-serialized 503 before anything is parsed
+        if (queue_depth_.load(std::memory_order_relaxed) >= max_queue_size_) {
+            spdlog::warn("Queue full ({} tasks), rejecting connection", max_queue_size_);
+            admission_.record_queue_shed();
+            reject(*client);
+            continue;
+        }
+        uint32_t peer = client->peer_address();
+        if (!admission_.try_enter(peer)) {
+            spdlog::debug("Client over its connection limit, rejecting");
+            reject(*client);
+            continue;
         }
 
-        // Wake one worker thread
-        queue_cv_.notify_one();
+        queue_depth_.fetch_add(1, std::memory_order_relaxed);
+        auto accepted_at = std::chrono::steady_clock::now();
+        pool_->submit([this, client = std::move(client), accepted_at]() mutable {
+            process_connection(std::move(client), accepted_at);
+        });
     }
 
-    spdlog::info("Server stopped");
+    // Finish the queued connections and join the workers
+    pool_->shutdown();
+    pool_.reset();
+
+    spdlog::info("Server stopped. Processed {} total requests",
+                 total_processed_.load());
     return Ok();
 }
 
@@ -130,95 +143,119 @@ void HttpServer::stop() {
         // Signal shutdown
         running_.store(false, std::memory_order_release);
 
-        // Wake all workers so they see running_ = false
-        queue_cv_.notify_all();
-
-        // Close listener to unblock accept()
+        // Shut the listener down to unblock accept(); serve_forever() drains the pool
+        listener_.shutdown();
         listener_.close();
-
-        // Join all worker threads
-        for (auto& thread : worker_threads_) {
-            if (thread.joinable()) {
-                thread.join();
-            }
-        }
-
-        worker_threads_.clear();
-
-        spdlog::info("Server stopped. Processed {} total requests",
-                     total_processed_.load());
     }
 }
 
-void HttpServer::worker_thread() {
-    spdlog::debug("Worker thread started");
-
-    while (true) {
-        std::unique_ptr<Socket> client;
-
-        {
-            std::unique_lock<std::mutex> lock(queue_mutex_);
+void HttpServer::process_connection(std::unique_ptr<Socket> client,
+                                    std::chrono::steady_clock::time_point accepted_at) {
+    queue_depth_.fetch_sub(1, std::memory_order_relaxed);
+    uint32_t peer = client->peer_address();
+
+    // CoDel: under a standing queue, connections that waited too long are
+    // answered with 503 - unless they are for a cheap route
+    auto now = std::chrono::steady_clock::now();
+    if (admission_.should_shed(now, now - accepted_at)) {
+        if (is_priority_request(*client)) {
+            admission_.record_priority_admit();
+        } else {
+            admission_.record_delay_shed();
+            reject(*client);
+            admission_.leave(peer);
+            return;
+        }
+    }
 
-            // Wait for task or shutdown signal
-            queue_cv_.wait(lock, [this] {
-                return !task_queue_.empty() || !running_.load(std::memory_order_acquire);
-            });
+    active_connections_.fetch_add(1, std::memory_order_relaxed);
 
-            // Check shutdown
-            if (!running_.load(std::memory_order_acquire) && task_queue_.empty()) {
-                break;  // Exit thread
-            }
+    auto result = handle_connection(std::move(client));
+    if (result.is_error()) {
+        spdlog::error("Error handling connection: {}", result.error());
+    }
 
-            // Get task
-            if (!task_queue_.empty()) {
-                client = std::move(task_queue_.front());
-                task_queue_.pop();
-            }
-        }  // Release lock here - critical!
+    active_connections_.fetch_sub(1, std::memory_order_relaxed);
+    total_processed_.fetch_add(1, std::memory_order_relaxed);
+    admission_.leave(peer);
+}
 
-        // Process connection WITHOUT holding lock
-        if (client) {
-            active_connections_.fetch_add(1, std::memory_order_relaxed);
+bool HttpServer::is_priority_request(Socket& client) {
+    // Enough for "METHOD /path" of any route we prioritize
+    uint8_t head[256];
+    auto peeked = client.peek(head, sizeof(head));
+    if (peeked.is_error()) {
+        return false;
+    }
+    return admission_.is_priority(
+        std::string_view(reinterpret_cast<const char*>(head), peeked.value()));
+}
 
-            auto result = handle_connection(std::move(client));
-            if (result.is_error()) {
-                spdlog::error("Error handling connection: {}", result.error());
+void HttpServer::reject(Socket& client) {
+    std::string_view response = admission_.overload_response();
+    client.send(reinterpret_cast<const uint8_t*>(response.data()), response.size());
+
+    // Discard whatever request bytes already arrived: closing with unread
+    // data makes the kernel send RST, which can destroy the 503 in flight
+    if (client.set_non_blocking(true).is_ok()) {
+        uint8_t scratch[4096];
+        for (int i = 0; i < 16; ++i) {
+            auto received = client.receive_into(scratch, sizeof(scratch));
+            if (received.is_error() || received.value() == 0) {
+                break;
             }
-
-            active_connections_.fetch_sub(1, std::memory_order_relaxed);
-            total_processed_.fetch_add(1, std::memory_order_relaxed);
         }
     }
-
-    spdlog::debug("Worker thread exiting");
+    client.close();
 }
 
 Result<void> HttpServer::handle_connection(std::unique_ptr<Socket> client) {
-    // Create parser for this connection
-    HttpParser parser;
+    // A worker serves one connection at a time, so the parser, the arena
+    // and the arena's overflow pool live per worker thread and are reused
+    // for every connection it handles.
+    thread_local std::pmr::unsynchronized_pool_resource overflow_pool;
+    thread_local ConnectionArena arena(&overflow_pool);
+    thread_local HttpParser parser;
+
+    Result<void> result = Ok();
+    {
+        ArenaScope scope(arena);
+        parser.reset();   // Request now allocates from the arena
+        result = serve_request(*client, parser);
+    }
+    parser.reset();   // Drop arena-backed state before rewinding the arena
+    arena.reset();
 
+    // Close connection (for now, we don't support keep-alive in thread pool version)
+    client->close();
+
+    return result;
+}
+
+Result<void> HttpServer::serve_request(Socket& client, HttpParser& parser) {
     // Read and parse the request
-    auto request_result = read_request(*client, parser);
-    if (request_result.is_error()) {
+    auto read_result = read_request(client, parser);
+    if (read_result.is_error()) {
         // Send error response
         auto error_response = create_error_response(
-            HttpStatus::BAD_REQUEST,
-            "Failed to parse request: " + request_result.error()
+            parser.error_status(),
+            "Failed to parse request: " + read_result.error()
         );
-        send_response(*client, error_response);
-        return Err<void, std::string>(request_result.error());
+        send_response(client, error_response);
+        return Err<void, std::string>(read_result.error());
     }
 
-    HttpRequest request = request_result.value();
+    const HttpRequest& request = parser.request();
 
     // Log the request
     spdlog::info("{} {} HTTP/{}",
                 HttpMethodUtils::to_string(request.method),
-                request.url,
+                std::string_view(request.url),
                 request.version == HttpVersion::HTTP_1_1 ? "1.1" : "1.0");
 
     // Call user handler
     HttpResponse response;
+    trace::Span handler_span("http.handler");
     try {
         response = handler_(request);
     } catch (const std::exception& e) {
@@ -235,44 +272,48 @@ Result<void> HttpServer::handle_connection(std::unique_ptr<Socket> client) {
         );
     }
 
+    handler_span.end();
+
     // Send response
-    auto send_result = send_response(*client, response);
+    trace::Span send_span("http.send");
+    auto send_result = send_response(client, response);
     if (send_result.is_error()) {
         return Err<void, std::string>("Failed to send response: " + send_result.error());
     }
 
-    // Close connection (for now, we don't support keep-alive in thread pool version)
-    client->close();
-
     return Ok();
 }
 
-Result<HttpRequest> HttpServer::read_request(Socket& socket, HttpParser& parser) {
-    // Buffer for reading data
-    constexpr size_t BUFFER_SIZE = 4096;
+Result<void> HttpServer::read_request(Socket& socket, HttpParser& parser) {
+    // Pooled receive buffer: no allocation per read
+    BufferPool::Lease buffer = BufferPool::shared().acquire();
 
     // Read data in chunks until request is complete
     while (!parser.is_complete()) {
         // Read data from socket
-        auto recv_result = socket.receive(BUFFER_SIZE);
+        trace::Span read_span("http.read");
+        auto recv_result = socket.receive_into(buffer.data(), buffer.size());
+        read_span.end();
         if (recv_result.is_error()) {
-            return Err<HttpRequest, std::string>("Failed to read from socket: " + recv_result.error());
+            return Err<void, std::string>("Failed to read from socket: " + recv_result.error());
         }
 
-        const auto& data = recv_result.value();
-        if (data.empty()) {
+        size_t received = recv_result.value();
+        if (received == 0) {
             // Client closed connection
-            return Err<HttpRequest, std::string>("Client closed connection before sending complete request");
+            return Err<void, std::string>("Client closed connection before sending complete request");
         }
 
         // Feed data to parser
+        trace::Span parse_span("http.parse");
         auto parse_result = parser.parse(
-            reinterpret_cast<const char*>(data.data()),
-            data.size()
+            reinterpret_cast<const char*>(buffer.data()),
+            received
         );
+        parse_span.end();
 
         if (parse_result.is_error()) {
-            return Err<HttpRequest, std::string>(parse_result.error());
+            return Err<void, std::string>(parse_result.error());
         }
 
         if (parse_result.value()) {
@@ -283,35 +324,109 @@ Result<HttpRequest> HttpServer::read_request(Socket& socket, HttpParser& parser)
         // Need more data, continue loop
     }
 
-    return Ok(parser.get_request());
+    return Ok();
 }
 
-Result<void> HttpServer::send_response(Socket& socket, const HttpResponse& response) {
-    // Serialize response to bytes
-    std::vector<uint8_t> data = response.serialize();
+namespace {
 
-    // Send all data
+Result<void> send_all(Socket& socket, const std::pmr::vector<uint8_t>& data) {
     // Note: We might need multiple send() calls if the buffer is large
     size_t total_sent = 0;
     while (total_sent < data.size()) {
-        // Create a view of remaining data
-        std::vector<uint8_t> remaining(
-            data.begin() + total_sent,
-            data.end()
-        );
-
-        auto send_result = socket.send(remaining);
+        auto send_result = socket.send(data.data() + total_sent, data.size() - total_sent);
         if (send_result.is_error()) {
             return Err<void, std::string>("Failed to send response: " + send_result.error());
         }
-
         total_sent += send_result.value();
     }
+    return Ok();
+}
 
-    spdlog::debug("Sent {} bytes", total_sent);
+} // namespace
+
+Result<void> HttpServer::send_response(Socket& socket, const HttpResponse& response) {
+
+    // Serialize response to bytes (from the arena when one is bound)
+    std::pmr::vector<uint8_t> data(request_resource());
+    if (response.is_push()) {
+        return send_push(socket, response);
+    }
+    if (!response.is_streaming()) {
+        response.serialize_into(data);
+        spdlog::debug("Sending {} bytes", data.size());
+        return send_all(socket, data);
+    }
+
+    // Streamed body: send the head, then each chunk as the producer
+    // makes it, so only one piece is ever held in memory
+    response.serialize_head_into(data);
+    thread_local std::string scratch;
+    bool more = true;
+    while (more) {
+        more = response.write_next_chunk(data, scratch);
+        auto sent = send_all(socket, data);
+        if (sent.is_error()) {
+            return sent;
+        }
+        data.clear();
+    }
     return Ok();
 }
 
+Result<void> HttpServer::send_push(Socket& socket, const HttpResponse& response) {
+    // No event loop here: the worker waits for the body's wakes. Correct,
+    // but a worker per subscriber; HttpServerEpoll parks them instead.
+    struct Wakeup {
+        std::mutex mutex;
+        std::condition_variable cv;
+        bool woken = false;
+    };
+    auto wakeup = std::make_shared<Wakeup>();
+    response.push->watch([wakeup] {
+        std::lock_guard lock(wakeup->mutex);
+        wakeup->woken = true;
+        wakeup->cv.notify_one();
+    });
+    struct Unwatch {
+        PushBody& body;
+        ~Unwatch() { body.unwatch(); }
+    } unwatch{*response.push};
+
+    std::pmr::vector<uint8_t> data(request_resource());
+    response.serialize_head_into(data);
+    std::string scratch;
+    while (true) {
+        scratch.clear();
+        bool more = response.push->pull(scratch, PushBody::Clock::now());
+        HttpResponse::write_chunk(data, scratch);
+        if (!more) {
+            HttpResponse::write_last_chunk(data);
+        }
+        if (!data.empty()) {
+            auto sent = send_all(socket, data);
+            if (sent.is_error()) {
+                return sent;
+            }
+            data.clear();
+        }
+        if (!more) {
+            return Ok();
+        }
+        if (!running_.load(std::memory_order_acquire)) {
+            return Err<void, std::string>("Server stopping");
+        }
+        if (!scratch.empty()) {
+            continue;   // Maybe more ready; only wait once drained
+        }
+
+        // Re-check running_ at least once a second so stop() is not held up
+        std::unique_lock lock(wakeup->mutex);
+        auto until = std::min(response.push->deadline(), PushBody::Clock::now() + std::chrono::seconds(1));
+        wakeup->cv.wait_until(lock, until, [&wakeup] { return wakeup->woken; });
+        wakeup->woken = false;
+    }
+}
+
 HttpResponse HttpServer::create_error_response(HttpStatus status, const std::string& message) {
     HttpResponse response(status);
 
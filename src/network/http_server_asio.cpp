@@ -36,7 +36,7 @@ void HttpConnection::do_read() {
                 );
 
                 if (parse_result.is_error()) {
-                    handle_error("Parse error: " + parse_result.error());
+                    handle_error(parser_.error_status(), "Parse error: " + parse_result.error());
                     return;
                 }
 
@@ -114,7 +114,7 @@ void HttpConnection::do_write(const HttpResponse& response) {
     );
 }
 
-void HttpConnection::handle_error(const std::string& message) {
+void HttpConnection::handle_error(HttpStatus status, const std::string& message) {
     // ────────────────────────────────────────
     // REUSED: Same error handling logic from legacy server
     // (http_server_legacy.cpp lines 114-119)
@@ -122,7 +122,7 @@ void HttpConnection::handle_error(const std::string& message) {
     spdlog::warn("Connection error: {}", message);
 
     auto error_response = create_error_response(
-        HttpStatus::BAD_REQUEST,
+        status,
         message
     );
 
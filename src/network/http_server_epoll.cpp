@@ -0,0 +1,980 @@
+#include "dfs/network/http_server_epoll.hpp"
+#include "dfs/network/connection_arena.hpp"
+#include "dfs/core/trace.hpp"
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <memory_resource>
+#include <mutex>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace dfs {
+namespace network {
+
+using dfs::Ok;
+using dfs::Err;
+
+namespace {
+
+constexpr size_t kReadChunk = 16 * 1024;
+constexpr int kMaxEvents = 256;
+
+// Timer wheel: 512 slots of 100 ms cover ~51 s per revolution; longer
+// deadlines simply stay in the wheel for extra revolutions.
+constexpr size_t kWheelSlots = 512;
+constexpr std::chrono::milliseconds kTick{100};
+
+// Output queued for one connection before it stops reading. A client
+// that pipelines requests but never reads its responses costs at most
+// this much (plus one read's worth of responses) until it drains.
+constexpr size_t kMaxPendingOutput = 1024 * 1024;
+
+// Requests one RPC connection may have in flight, counted until their
+// reply is written to the socket; more are answered busy at once
+// instead of queueing without bound. No further frame is dispatched
+// while more than kMaxPendingOutput of replies is unsent.
+constexpr size_t kRpcMaxInFlight = 4096;
+
+// Room reserved ahead for a partial RPC frame. A header alone can claim
+// kRpcMaxPayload; past this the buffer grows as the bytes arrive.
+constexpr size_t kRpcReserveAhead = 64 * 1024;
+
+// The reply queue whose loop is running an RPC handler on this thread;
+// replies sent from inside the handler skip the queue
+thread_local const void* t_dispatching_replies = nullptr;
+
+bool wants_keep_alive(const HttpRequest& request) {
+    std::string_view connection = request.headers.get(HeaderId::CONNECTION);
+    if (request.version == HttpVersion::HTTP_1_0) {
+        return ascii_iequals(connection, "keep-alive");
+    }
+    return !ascii_iequals(connection, "close");
+}
+
+} // namespace
+
+// ──────────────────────────────────────────────────────────
+// EventLoop - one epoll instance and its connections
+// ──────────────────────────────────────────────────────────
+
+class HttpServerEpoll::EventLoop {
+public:
+    EventLoop(HttpServerEpoll& server, size_t index)
+        : server_(server), index_(index) {}
+
+    ~EventLoop() {
+        close_all();
+        if (replies_) {
+            replies_->detach();   // Late replies are dropped from now on
+        }
+        if (wake_fd_ >= 0) {
+            ::close(wake_fd_);
+        }
+        if (epoll_fd_ >= 0) {
+            ::close(epoll_fd_);
+        }
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    Result<void> init(int listen_fd) {
+        listen_fd_ = listen_fd;
+
+        epoll_fd_ = ::epoll_create1(EPOLL_CLOEXEC);
+        if (epoll_fd_ < 0) {
+            return Err<void, std::string>(std::string("epoll_create1 failed: ") + std::strerror(errno));
+        }
+
+        wake_fd_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            return Err<void, std::string>(std::string("eventfd failed: ") + std::strerror(errno));
+        }
+        replies_ = std::make_shared<ReplyQueue>(*this);
+
+        epoll_event wake_event{};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = wake_fd_;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) != 0) {
+            return Err<void, std::string>(std::string("epoll_ctl(eventfd) failed: ") + std::strerror(errno));
+        }
+
+        // Level-triggered + exclusive: one loop is woken per connection
+        // burst and keeps accepting until the backlog is empty.
+        epoll_event listen_event{};
+        listen_event.events = EPOLLIN | EPOLLEXCLUSIVE;
+        listen_event.data.fd = listen_fd_;
+        if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, listen_fd_, &listen_event) != 0) {
+            return Err<void, std::string>(std::string("epoll_ctl(listener) failed: ") + std::strerror(errno));
+        }
+
+        started_at_ = std::chrono::steady_clock::now();
+        return Ok();
+    }
+
+    void run() {
+        spdlog::debug("Epoll loop {} started", index_);
+        std::array<epoll_event, kMaxEvents> events;
+
+        while (server_.running_.load(std::memory_order_acquire)) {
+            int timeout = live_connections_ > 0 ? static_cast<int>(kTick.count()) : -1;
+            int n = ::epoll_wait(epoll_fd_, events.data(), kMaxEvents, timeout);
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                spdlog::error("epoll_wait failed: {}", std::strerror(errno));
+                break;
+            }
+
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                uint32_t flags = events[i].events;
+
+                if (fd == wake_fd_) {
+                    uint64_t drained;
+                    [[maybe_unused]] auto r = ::read(wake_fd_, &drained, sizeof(drained));
+                    pump_woken();
+                    pump_replies();
+                } else if (fd == listen_fd_) {
+                    accept_all();
+                } else {
+                    on_event(fd, flags);
+                }
+            }
+
+            expire_timers();
+        }
+
+        close_all();
+        spdlog::debug("Epoll loop {} exiting", index_);
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        [[maybe_unused]] auto r = ::write(wake_fd_, &one, sizeof(one));
+    }
+
+    // Called by a PushBody from any thread: queue the connection for a
+    // pull() and wake the loop. A burst of pushes costs one eventfd write.
+    void notify(int fd, uint64_t id) {
+        bool was_empty;
+        {
+            std::lock_guard lock(woken_mutex_);
+            was_empty = woken_.empty();
+            woken_.push_back({fd, id, 0});
+        }
+        if (was_empty) {
+            wake();
+        }
+    }
+
+private:
+    struct OutgoingReply {
+        int fd;
+        uint64_t id;
+        RpcFrameHeader header;
+        std::vector<uint8_t> payload;
+    };
+
+    // RPC replies sent from handler threads, handed to the loop. Every
+    // RpcReply shares it, so one that outlives the loop is dropped safely.
+    class ReplyQueue final : public detail::RpcReplySink {
+    public:
+        explicit ReplyQueue(EventLoop& loop) : loop_(&loop) {}
+
+        void deliver(int fd, uint64_t connection_id, RpcFrameHeader header,
+                     std::vector<uint8_t> payload) override {
+            if (t_dispatching_replies == this) {
+                // Answered inside the handler, on the loop thread: straight
+                // into the connection's output, sent after the read
+                loop_->append_reply(fd, connection_id, header, payload);
+                return;
+            }
+            std::lock_guard lock(mutex_);
+            if (loop_ == nullptr) {
+                return;
+            }
+            bool was_empty = entries_.empty();
+            entries_.push_back({fd, connection_id, header, std::move(payload)});
+            if (was_empty) {
+                loop_->wake();
+            }
+        }
+
+        void take(std::vector<OutgoingReply>& into) {
+            std::lock_guard lock(mutex_);
+            into.swap(entries_);
+        }
+
+        void detach() {
+            std::lock_guard lock(mutex_);
+            loop_ = nullptr;
+        }
+
+    private:
+        std::mutex mutex_;
+        EventLoop* loop_;
+        std::vector<OutgoingReply> entries_;
+    };
+
+    struct Connection {
+        explicit Connection(std::pmr::memory_resource* upstream) : arena(upstream) {
+            start_request();
+        }
+
+        ~Connection() {
+            if (push) {
+                push->unwatch();   // No wakes for a closed connection
+            }
+        }
+
+        Connection(const Connection&) = delete;
+        Connection& operator=(const Connection&) = delete;
+
+        std::unique_ptr<Socket> socket;
+        uint64_t id = 0;                    // Distinguishes reused fds in the wheel
+        ConnectionArena arena;              // Request and response memory
+        HttpParser parser;
+        std::vector<uint8_t> out;           // Serialized responses not yet sent
+        size_t out_offset = 0;
+        HttpResponse::BodyProducer stream;  // Chunks still to pull into out
+        std::shared_ptr<PushBody> push;     // Parked until it wakes or its deadline
+        std::string stream_scratch;
+        std::vector<char> unparsed;         // Input held back while reading is paused
+        bool read_paused = false;           // Output over kMaxPendingOutput
+        bool close_after_write = false;
+        bool first_read = true;             // Nothing received yet: sniff for RPC
+        bool rpc = false;                   // Speaks binary RPC instead of HTTP
+        bool rpc_greeted = false;           // Preamble received
+        std::vector<uint8_t> rpc_in;        // Start of a frame still arriving
+        size_t rpc_in_flight = 0;           // Requests whose reply is not yet written
+        std::deque<size_t> rpc_reply_ends;  // End offset in out of each unwritten reply
+        uint64_t deadline_tick = 0;
+        uint64_t filed_tick = 0;            // Tick of its live wheel entry
+        bool in_wheel = false;
+
+        // Rewind the arena and start parsing the next request in it. The
+        // finished request goes first: it lives in the arena.
+        void start_request() {
+            parser.reset();
+            arena.reset();
+            ArenaScope scope(arena);
+            parser.reset();
+        }
+    };
+
+    struct WheelEntry {
+        int fd;
+        uint64_t id;
+        uint64_t filed_tick;   // Superseded if the connection was re-filed earlier
+    };
+
+    // ════════════════════════════════════════════════════════
+    // Accept
+    // ════════════════════════════════════════════════════════
+
+    void accept_all() {
+        while (true) {
+            int fd = ::accept4(listen_fd_, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN && errno != EWOULDBLOCK) {
+                    spdlog::warn("accept4 failed: {}", std::strerror(errno));
+                }
+                return;
+            }
+
+            int one = 1;
+            ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+            auto conn = std::make_unique<Connection>(&arena_upstream_);
+            conn->socket = Socket::create_from_native(fd);
+            conn->id = ++next_id_;
+
+            epoll_event event{};
+            event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+            event.data.fd = fd;
+            if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+                spdlog::warn("epoll_ctl(add) failed: {}", std::strerror(errno));
+                continue;   // Socket destructor closes fd
+            }
+
+            if (static_cast<size_t>(fd) >= connections_.size()) {
+                connections_.resize(static_cast<size_t>(fd) + 1);
+            }
+            touch(*conn);
+            connections_[static_cast<size_t>(fd)] = std::move(conn);
+            ++live_connections_;
+            server_.active_connections_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Connection I/O
+    // ════════════════════════════════════════════════════════
+
+    Connection* find(int fd) {
+        auto index = static_cast<size_t>(fd);
+        return index < connections_.size() ? connections_[index].get() : nullptr;
+    }
+
+    void on_event(int fd, uint32_t flags) {
+        Connection* conn = find(fd);
+        if (conn == nullptr) {
+            return;
+        }
+        if (flags & EPOLLERR) {
+            close_connection(fd);
+            return;
+        }
+        if (conn->push && (flags & (EPOLLRDHUP | EPOLLHUP))) {
+            close_connection(fd);   // Subscriber went away while parked
+            return;
+        }
+        if (flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+            if (!on_readable(fd, *conn)) {
+                return;   // Closed
+            }
+        }
+        if ((flags & EPOLLOUT) && (conn->out_offset < conn->out.size() || conn->read_paused)) {
+            flush_and_resume(fd, *conn);
+        }
+    }
+
+    static size_t pending_output(const Connection& conn) {
+        return conn.out.size() - conn.out_offset;
+    }
+
+    // Returns false if the connection was closed
+    bool on_readable(int fd, Connection& conn) {
+        while (true) {
+            if (!read_input(fd, conn) || !flush(fd, conn)) {
+                return false;
+            }
+            if (!conn.read_paused || pending_output(conn) > 0) {
+                return true;   // EPOLLOUT resumes reading once out drains
+            }
+            conn.read_paused = false;   // Drained at once: keep reading
+        }
+    }
+
+    // Flush, and once a paused connection's output has drained, read
+    // again. The socket is edge-triggered: input that arrived while
+    // paused raises no new event, so it has to be read explicitly.
+    bool flush_and_resume(int fd, Connection& conn) {
+        if (!flush(fd, conn)) {
+            return false;
+        }
+        if (conn.read_paused && pending_output(conn) == 0) {
+            conn.read_paused = false;
+            return on_readable(fd, conn);
+        }
+        return true;
+    }
+
+    // Consume held-back input, then read until the socket is empty, the
+    // connection pauses or it must close. Returns false if closed.
+    bool read_input(int fd, Connection& conn) {
+        if (!conn.unparsed.empty() && !conn.read_paused) {
+            std::vector<char> held;
+            held.swap(conn.unparsed);
+            consume(conn, held.data(), held.size());
+        }
+
+        bool peer_closed = false;
+        while (!conn.close_after_write && !conn.read_paused) {
+            trace::Span read_span("http.read");
+            ssize_t n = ::recv(fd, read_buffer_.data(), read_buffer_.size(), 0);
+            read_span.end();
+
+            if (n > 0) {
+                touch(conn);
+                if (!consume(conn, read_buffer_.data(), static_cast<size_t>(n))) {
+                    break;
+                }
+                continue;
+            }
+            if (n == 0) {
+                peer_closed = true;
+                break;
+            }
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                break;
+            }
+            close_connection(fd);
+            return false;
+        }
+
+        if (peer_closed) {
+            conn.close_after_write = true;
+        }
+        return true;
+    }
+
+    // Feed bytes to the parser, dispatching every complete request.
+    // Returns false once the connection must stop reading; bytes left
+    // when output passes kMaxPendingOutput wait in unparsed.
+    bool consume(Connection& conn, const char* data, size_t len) {
+        if (conn.first_read) {
+            conn.first_read = false;
+            conn.rpc = data[0] == kRpcPreamble[0] && server_.rpc_handler_;
+        }
+        if (conn.rpc) {
+            return consume_rpc(conn, reinterpret_cast<const uint8_t*>(data), len);
+        }
+
+        while (len > 0) {
+            trace::Span parse_span("http.parse");
+            auto parsed = conn.parser.parse(data, len);
+            parse_span.end();
+
+            if (parsed.is_error()) {
+                queue_response(conn, create_error_response(conn.parser.error_status(),
+                                                           "Failed to parse request: " + parsed.error()));
+                conn.close_after_write = true;
+                return false;
+            }
+            if (!parsed.value()) {
+                return true;   // Need more bytes
+            }
+
+            size_t used = conn.parser.consumed();
+            data += used;
+            len -= used;
+
+            {
+                // The request was parsed into the arena; the handler's
+                // response is built there too.
+                ArenaScope scope(conn.arena);
+                const HttpRequest& request = conn.parser.request();
+                bool keep_alive = wants_keep_alive(request);
+                HttpResponse response = server_.handle_request(request);
+                // A streamed body is pulled while out drains; requests
+                // behind it would have to wait, so it ends the connection
+                if (!keep_alive || response.is_streaming() || response.is_push() ||
+                    ascii_iequals(response.headers.get(HeaderId::CONNECTION), "close")) {
+                    response.set_header("Connection", "close");
+                    conn.close_after_write = true;
+                } else {
+                    response.set_header("Connection", "keep-alive");
+                }
+                queue_response(conn, response);
+            }
+            conn.start_request();
+            server_.total_processed_.fetch_add(1, std::memory_order_relaxed);
+
+            if (conn.close_after_write) {
+                return false;
+            }
+            if (pending_output(conn) > kMaxPendingOutput) {
+                conn.unparsed.assign(data, data + len);
+                conn.read_paused = true;
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void queue_response(Connection& conn, const HttpResponse& response) {
+        if (conn.out_offset == conn.out.size()) {
+            conn.out.clear();   // Keeps capacity for the next response
+            conn.out_offset = 0;
+        }
+        if (response.is_streaming()) {
+            response.serialize_head_into(conn.out);
+            conn.stream = response.stream;   // flush() pulls the chunks
+            return;
+        }
+        if (response.is_push()) {
+            response.serialize_head_into(conn.out);
+            conn.push = response.push;       // flush() pulls what is ready
+            int fd = conn.socket->native_handle();
+            uint64_t id = conn.id;
+            conn.push->watch([this, fd, id] { notify(fd, id); });
+            touch(conn);                     // Deadline now comes from the body
+            return;
+        }
+        response.serialize_into(conn.out);
+    }
+
+    // Write as much as the socket takes. Returns false if closed.
+    bool flush(int fd, Connection& conn) {
+        trace::Span send_span("http.send");
+        while (conn.out_offset < conn.out.size() || refill(conn)) {
+            ssize_t n = ::send(fd, conn.out.data() + conn.out_offset,
+                               conn.out.size() - conn.out_offset, MSG_NOSIGNAL);
+            if (n > 0) {
+                conn.out_offset += static_cast<size_t>(n);
+                while (!conn.rpc_reply_ends.empty() && conn.rpc_reply_ends.front() <= conn.out_offset) {
+                    conn.rpc_reply_ends.pop_front();
+                    --conn.rpc_in_flight;   // Written: no longer in flight
+                }
+                continue;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                touch(conn);
+                return true;   // Resume on the next EPOLLOUT edge
+            }
+            close_connection(fd);
+            return false;
+        }
+
+        conn.out.clear();
+        conn.out_offset = 0;
+        if (conn.close_after_write && !conn.push) {
+            close_connection(fd);
+            return false;
+        }
+        return true;
+    }
+
+    // Pull the next chunk of a streamed or pushed body once out has
+    // drained, so only one chunk is buffered at a time. False if nothing
+    // was added (a pushed body with nothing ready stays parked).
+    bool refill(Connection& conn) {
+        if (conn.push) {
+            conn.stream_scratch.clear();
+            bool more = conn.push->pull(conn.stream_scratch, PushBody::Clock::now());
+            if (more && conn.stream_scratch.empty()) {
+                return false;
+            }
+            conn.out.clear();
+            conn.out_offset = 0;
+            HttpResponse::write_chunk(conn.out, conn.stream_scratch);
+            if (!more) {
+                HttpResponse::write_last_chunk(conn.out);
+                conn.push->unwatch();
+                conn.push = nullptr;
+            }
+            return true;
+        }
+        if (!conn.stream) {
+            return false;
+        }
+        conn.out.clear();
+        conn.out_offset = 0;
+        if (!HttpResponse::pull_chunk(conn.stream, conn.out, conn.stream_scratch)) {
+            conn.stream = nullptr;
+        }
+        return true;
+    }
+
+    // Pull from every pushed body that woke the loop. A connection still
+    // writing an earlier chunk is skipped; flush() pulls again once it drains.
+    void pump_woken() {
+        {
+            std::lock_guard lock(woken_mutex_);
+            pumping_.swap(woken_);
+        }
+        for (const auto& entry : pumping_) {
+            Connection* conn = find(entry.fd);
+            if (conn != nullptr && conn->id == entry.id && conn->push &&
+                conn->out_offset == conn->out.size()) {
+                flush(entry.fd, *conn);
+            }
+        }
+        pumping_.clear();
+    }
+
+    void close_connection(int fd) {
+        auto index = static_cast<size_t>(fd);
+        if (index >= connections_.size() || !connections_[index]) {
+            return;
+        }
+        // Closing the fd removes it from the epoll set
+        connections_[index].reset();
+        --live_connections_;
+        server_.active_connections_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void close_all() {
+        for (size_t fd = 0; fd < connections_.size(); ++fd) {
+            if (connections_[fd]) {
+                close_connection(static_cast<int>(fd));
+            }
+        }
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Binary RPC
+    // ════════════════════════════════════════════════════════
+
+    // Split bytes into frames and dispatch each complete one; the start of
+    // an incomplete frame waits in rpc_in. Frames behind more than
+    // kMaxPendingOutput of unsent replies wait in unparsed. Returns false
+    // on a protocol error or once reading pauses.
+    bool consume_rpc(Connection& conn, const uint8_t* data, size_t len) {
+        if (!conn.rpc_in.empty()) {
+            conn.rpc_in.insert(conn.rpc_in.end(), data, data + len);
+            data = conn.rpc_in.data();
+            len = conn.rpc_in.size();
+        }
+
+        size_t offset = 0;
+        if (!conn.rpc_greeted && len >= kRpcPreamble.size()) {
+            if (std::memcmp(data, kRpcPreamble.data(), kRpcPreamble.size()) != 0) {
+                spdlog::debug("Closing connection with a bad RPC preamble");
+                conn.close_after_write = true;
+                return false;
+            }
+            conn.rpc_greeted = true;
+            offset = kRpcPreamble.size();
+        }
+
+        size_t frame_size = 0;
+        while (conn.rpc_greeted && len - offset >= kRpcHeaderSize) {
+            auto header = RpcFrameHeader::decode(data + offset);
+            if (header.length > kRpcMaxPayload || (header.flags & kRpcReply)) {
+                spdlog::debug("Closing RPC connection: bad frame (type {}, {} bytes)", header.type, header.length);
+                conn.close_after_write = true;
+                return false;
+            }
+            frame_size = kRpcHeaderSize + header.length;
+            if (len - offset < frame_size) {
+                break;
+            }
+            if (pending_output(conn) > kMaxPendingOutput) {
+                conn.unparsed.assign(data + offset, data + len);
+                conn.rpc_in.clear();
+                conn.read_paused = true;
+                return false;
+            }
+            // The one copy of the payload: the handler owns it from here
+            const uint8_t* payload = data + offset + kRpcHeaderSize;
+            RpcRequest request{header.type, header.request_id,
+                               std::vector<uint8_t>(payload, payload + header.length)};
+            offset += frame_size;
+            frame_size = 0;
+            dispatch_rpc(conn, std::move(request));
+        }
+
+        if (data == conn.rpc_in.data()) {
+            conn.rpc_in.erase(conn.rpc_in.begin(), conn.rpc_in.begin() + static_cast<std::ptrdiff_t>(offset));
+        } else {
+            conn.rpc_in.assign(data + offset, data + len);
+        }
+        conn.rpc_in.reserve(std::min(frame_size, kRpcReserveAhead));   // A small frame grows once
+        return true;
+    }
+
+    void dispatch_rpc(Connection& conn, RpcRequest request) {
+        RpcReply reply(replies_, conn.socket->native_handle(), conn.id, request.type, request.request_id);
+        server_.total_processed_.fetch_add(1, std::memory_order_relaxed);
+        ++conn.rpc_in_flight;
+
+        t_dispatching_replies = replies_.get();
+        if (conn.rpc_in_flight > kRpcMaxInFlight) {
+            reply.fail("Too many requests in flight", true);
+        } else {
+            server_.handle_rpc(std::move(request), std::move(reply));
+        }
+        t_dispatching_replies = nullptr;
+    }
+
+    void append_reply(int fd, uint64_t id, const RpcFrameHeader& header, const std::vector<uint8_t>& payload) {
+        Connection* conn = find(fd);
+        if (conn == nullptr || conn->id != id) {
+            return;   // Closed while the handler ran
+        }
+        if (conn->out_offset == conn->out.size()) {
+            conn->out.clear();
+            conn->out_offset = 0;
+        }
+        header.append_to(conn->out, payload.data());
+        conn->rpc_reply_ends.push_back(conn->out.size());   // In flight until flush() writes it
+        touch(*conn);
+    }
+
+    // Append every queued reply, then flush each connection once
+    void pump_replies() {
+        replies_->take(replying_);
+        for (const auto& reply : replying_) {
+            append_reply(reply.fd, reply.id, reply.header, reply.payload);
+        }
+        for (const auto& reply : replying_) {
+            Connection* conn = find(reply.fd);
+            if (conn != nullptr && conn->id == reply.id && conn->out_offset < conn->out.size()) {
+                flush_and_resume(reply.fd, *conn);
+            }
+        }
+        replying_.clear();
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Timer wheel
+    // ════════════════════════════════════════════════════════
+
+    uint64_t now_tick() const {
+        return static_cast<uint64_t>((std::chrono::steady_clock::now() - started_at_) / kTick);
+    }
+
+    // Push the idle deadline out. O(1): an entry already in the wheel is
+    // left where it is and re-filed when its slot comes up. A parked push
+    // body is not idle: its own deadline (timeout, heartbeat) applies.
+    void touch(Connection& conn) {
+        if (conn.push) {
+            auto until = conn.push->deadline() - started_at_;
+            conn.deadline_tick = static_cast<uint64_t>(std::max<int64_t>(0, until / kTick)) + 1;
+        } else {
+            auto timeout_ticks = static_cast<uint64_t>(
+                std::max<int64_t>(1, server_.idle_timeout_ / kTick));
+            conn.deadline_tick = now_tick() + timeout_ticks;
+        }
+        // A deadline earlier than the live entry (a push body's heartbeat
+        // after an idle timeout) needs an entry of its own
+        if (!conn.in_wheel || conn.deadline_tick < conn.filed_tick) {
+            file(conn);
+        }
+    }
+
+    void file(Connection& conn) {
+        conn.filed_tick = std::max(conn.deadline_tick, current_tick_ + 1);
+        wheel_[conn.filed_tick % kWheelSlots].push_back({conn.socket->native_handle(), conn.id, conn.filed_tick});
+        conn.in_wheel = true;
+    }
+
+    void expire_timers() {
+        uint64_t now = now_tick();
+        if (now - current_tick_ > kWheelSlots) {
+            current_tick_ = now - kWheelSlots;   // Long stall: one full sweep suffices
+        }
+
+        while (current_tick_ < now) {
+            ++current_tick_;
+            auto& slot = wheel_[current_tick_ % kWheelSlots];
+            if (slot.empty()) {
+                continue;
+            }
+
+            expiring_.swap(slot);
+            for (const auto& entry : expiring_) {
+                Connection* conn = find(entry.fd);
+                if (conn == nullptr || conn->id != entry.id) {
+                    continue;   // Closed (fd maybe reused since)
+                }
+                if (conn->filed_tick != entry.filed_tick) {
+                    continue;   // Superseded by an earlier entry
+                }
+                conn->in_wheel = false;
+                if (conn->deadline_tick <= current_tick_ && conn->push) {
+                    // Due for a timeout or heartbeat pull
+                    if (conn->out_offset == conn->out.size() && !flush(entry.fd, *conn)) {
+                        continue;   // Closed
+                    }
+                    touch(*conn);
+                } else if (conn->deadline_tick <= current_tick_ &&
+                           conn->rpc_in_flight > conn->rpc_reply_ends.size()) {
+                    touch(*conn);   // Waiting on its handlers, not idle
+                } else if (conn->deadline_tick <= current_tick_) {
+                    spdlog::debug("Closing idle connection (fd {})", entry.fd);
+                    close_connection(entry.fd);
+                } else {
+                    file(*conn);
+                }
+            }
+            expiring_.clear();
+        }
+    }
+
+    HttpServerEpoll& server_;
+    size_t index_;
+    int epoll_fd_ = -1;
+    int wake_fd_ = -1;
+    int listen_fd_ = -1;
+
+    std::pmr::unsynchronized_pool_resource arena_upstream_;   // Recycles arena blocks
+    std::vector<std::unique_ptr<Connection>> connections_;   // Indexed by fd
+    size_t live_connections_ = 0;
+    uint64_t next_id_ = 0;
+    std::array<char, kReadChunk> read_buffer_{};
+
+    std::chrono::steady_clock::time_point started_at_;
+    uint64_t current_tick_ = 0;
+    std::array<std::vector<WheelEntry>, kWheelSlots> wheel_;
+    std::vector<WheelEntry> expiring_;
+
+    std::mutex woken_mutex_;                // notify() runs on publisher threads
+    std::vector<WheelEntry> woken_;         // Pushed connections to pull from
+    std::vector<WheelEntry> pumping_;       // Loop-owned copy being processed
+
+    std::shared_ptr<ReplyQueue> replies_;   // RPC replies from other threads
+    std::vector<OutgoingReply> replying_;   // Loop-owned copy being processed
+};
+
+// ──────────────────────────────────────────────────────────
+// HttpServerEpoll Implementation
+// ──────────────────────────────────────────────────────────
+
+HttpServerEpoll::HttpServerEpoll(size_t loop_count, std::chrono::milliseconds idle_timeout)
+    : loop_count_(std::max<size_t>(1, loop_count))
+    , idle_timeout_(idle_timeout) {
+
+    spdlog::info("HttpServerEpoll created with {} event loops, idle timeout {} ms",
+                 loop_count_, idle_timeout_.count());
+}
+
+HttpServerEpoll::~HttpServerEpoll() {
+    stop();
+}
+
+void HttpServerEpoll::set_handler(HttpRequestHandler handler) {
+    handler_ = std::move(handler);
+}
+
+void HttpServerEpoll::set_rpc_handler(RpcHandler handler) {
+    rpc_handler_ = std::move(handler);
+}
+
+Result<void> HttpServerEpoll::listen(uint16_t port, const std::string& address) {
+    auto create_result = listener_.create(SocketType::TCP);
+    if (create_result.is_error()) {
+        return Err<void, std::string>("Failed to create listener socket: " + create_result.error());
+    }
+
+    auto reuse_result = listener_.set_reuse_address(true);
+    if (reuse_result.is_error()) {
+        return Err<void, std::string>("Failed to set SO_REUSEADDR: " + reuse_result.error());
+    }
+
+    auto bind_result = listener_.bind(address, port);
+    if (bind_result.is_error()) {
+        return Err<void, std::string>("Failed to bind: " + bind_result.error());
+    }
+
+    auto listen_result = listener_.listen(SOMAXCONN);
+    if (listen_result.is_error()) {
+        return Err<void, std::string>("Failed to listen: " + listen_result.error());
+    }
+
+    auto nb_result = listener_.set_non_blocking(true);
+    if (nb_result.is_error()) {
+        return Err<void, std::string>("Failed to make listener non-blocking: " + nb_result.error());
+    }
+
+    sockaddr_in bound{};
+    socklen_t len = sizeof(bound);
+    if (::getsockname(listener_.native_handle(), reinterpret_cast<sockaddr*>(&bound), &len) == 0) {
+        port_ = ntohs(bound.sin_port);
+    } else {
+        port_ = port;
+    }
+
+    loops_.clear();
+    for (size_t i = 0; i < loop_count_; ++i) {
+        auto loop = std::make_unique<EventLoop>(*this, i);
+        auto init_result = loop->init(listener_.native_handle());
+        if (init_result.is_error()) {
+            loops_.clear();
+            return init_result;
+        }
+        loops_.push_back(std::move(loop));
+    }
+
+    spdlog::info("HTTP server (epoll) listening on {}:{}", address, port_);
+    return Ok();
+}
+
+Result<void> HttpServerEpoll::serve_forever() {
+    if (loops_.empty()) {
+        return Err<void, std::string>("Server not listening. Call listen() first.");
+    }
+    if (!handler_) {
+        return Err<void, std::string>("No request handler set. Call set_handler() first.");
+    }
+
+    running_.store(true, std::memory_order_release);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < loops_.size(); ++i) {
+        threads.emplace_back([loop = loops_[i].get()] { loop->run(); });
+    }
+    loops_[0]->run();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    spdlog::info("Server stopped. Processed {} total requests", total_processed_.load());
+    return Ok();
+}
+
+void HttpServerEpoll::stop() {
+    if (running_.exchange(false, std::memory_order_acq_rel)) {
+        spdlog::info("Stopping epoll server...");
+        for (auto& loop : loops_) {
+            loop->wake();
+        }
+    }
+}
+
+HttpResponse HttpServerEpoll::handle_request(const HttpRequest& request) {
+    spdlog::debug("{} {} HTTP/{}",
+                  HttpMethodUtils::to_string(request.method),
+                  request.url,
+                  request.version == HttpVersion::HTTP_1_1 ? "1.1" : "1.0");
+
+    trace::Span handler_span("http.handler");
+    try {
+        return handler_(request);
+    } catch (const std::exception& e) {
+        spdlog::error("Handler threw exception: {}", e.what());
+    } catch (...) {
+        spdlog::error("Handler threw unknown exception");
+    }
+    return create_error_response(HttpStatus::INTERNAL_SERVER_ERROR, "Internal server error");
+}
+
+void HttpServerEpoll::handle_rpc(RpcRequest request, RpcReply reply) {
+    trace::Span handler_span("rpc.handler");
+    try {
+        rpc_handler_(std::move(request), std::move(reply));
+    } catch (const std::exception& e) {
+        // An unanswered reply sends its own error when unwound
+        spdlog::error("RPC handler threw exception: {}", e.what());
+    } catch (...) {
+        spdlog::error("RPC handler threw unknown exception");
+    }
+}
+
+HttpResponse HttpServerEpoll::create_error_response(HttpStatus status, const std::string& message) {
+    HttpResponse response(status);
+
+    std::string html =
+        "<!DOCTYPE html>\n"
+        "<html>\n"
+        "<head><title>Error " + std::to_string(static_cast<int>(status)) + "</title></head>\n"
+        "<body>\n"
+        "<h1>Error " + std::to_string(static_cast<int>(status)) + "</h1>\n"
+        "<p>" + message + "</p>\n"
+        "</body>\n"
+        "</html>\n";
+
+    response.set_body(html);
+    response.set_header("Content-Type", "text/html");
+    response.set_header("Connection", "close");
+
+    return response;
+}
+
+} // namespace network
+} // namespace dfs
@@ -112,7 +112,7 @@ Result<void> HttpServerLegacy::handle_connection(std::unique_ptr<Socket> client)
     if (request_result.is_error()) {
         // Send error response
         auto error_response = create_error_response(
-            HttpStatus::BAD_REQUEST,
+            parser.error_status(),
             "Failed to parse request: " + request_result.error()
         );
         send_response(*client, error_response);
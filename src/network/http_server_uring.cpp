@@ -0,0 +1,909 @@
+#include "dfs/network/http_server_uring.hpp"
+#include "dfs/network/connection_arena.hpp"
+#include "dfs/core/trace.hpp"
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <memory_resource>
+#include <unordered_map>
+
+#include <arpa/inet.h>
+#include <linux/io_uring.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace dfs {
+namespace network {
+
+using dfs::Ok;
+using dfs::Err;
+
+namespace {
+
+constexpr unsigned kSqEntries = 256;
+constexpr unsigned kCqEntries = 4 * kSqEntries;    // Multishot ops post many CQEs per SQE
+
+// Provided receive buffers, shared by all connections of a loop
+constexpr unsigned kBufferCount = 256;             // Power of two (ring size)
+constexpr size_t kBufferSize = 8 * 1024;
+constexpr uint16_t kBufferGroup = 0;
+
+// Output queued for one connection before its receive is cancelled; it
+// is re-armed once the peer has read everything (see HttpServerEpoll)
+constexpr size_t kMaxPendingOutput = 1024 * 1024;
+
+// user_data layout: operation in the top byte, connection id below
+enum class Op : uint8_t { Accept = 1, Recv, Send, Shutdown, Close, Wake, Cancel };
+
+constexpr uint64_t kIdMask = (uint64_t{1} << 56) - 1;
+
+uint64_t pack(Op op, uint64_t id) {
+    return (static_cast<uint64_t>(op) << 56) | (id & kIdMask);
+}
+
+Op op_of(uint64_t user_data) {
+    return static_cast<Op>(user_data >> 56);
+}
+
+uint64_t id_of(uint64_t user_data) {
+    return user_data & kIdMask;
+}
+
+bool wants_keep_alive(const HttpRequest& request) {
+    std::string_view connection = request.headers.get(HeaderId::CONNECTION);
+    if (request.version == HttpVersion::HTTP_1_0) {
+        return ascii_iequals(connection, "keep-alive");
+    }
+    return !ascii_iequals(connection, "close");
+}
+
+std::string errno_message(const char* what, int err) {
+    return std::string(what) + " failed: " + std::strerror(err);
+}
+
+// ──────────────────────────────────────────────────────────
+// Ring - minimal io_uring wrapper over the raw syscalls
+// ──────────────────────────────────────────────────────────
+
+class Ring {
+public:
+    Ring() = default;
+
+    ~Ring() {
+        if (sqes_ != nullptr) {
+            ::munmap(sqes_, sqes_size_);
+        }
+        if (cq_ptr_ != nullptr && cq_ptr_ != sq_ptr_) {
+            ::munmap(cq_ptr_, cq_size_);
+        }
+        if (sq_ptr_ != nullptr) {
+            ::munmap(sq_ptr_, sq_size_);
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    Ring(const Ring&) = delete;
+    Ring& operator=(const Ring&) = delete;
+
+    Result<void> init() {
+        io_uring_params params{};
+        params.flags = IORING_SETUP_CQSIZE;
+        params.cq_entries = kCqEntries;
+
+        fd_ = static_cast<int>(::syscall(__NR_io_uring_setup, kSqEntries, &params));
+        if (fd_ < 0) {
+            return Err<void, std::string>(errno_message("io_uring_setup", errno));
+        }
+        if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_NODROP)) {
+            return Err<void, std::string>("io_uring: kernel too old (needs SINGLE_MMAP and NODROP)");
+        }
+
+        sq_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cq_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+        sq_size_ = cq_size_ = std::max(sq_size_, cq_size_);   // One mapping serves both
+
+        sq_ptr_ = ::mmap(nullptr, sq_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                         fd_, IORING_OFF_SQ_RING);
+        if (sq_ptr_ == MAP_FAILED) {
+            sq_ptr_ = nullptr;
+            return Err<void, std::string>(errno_message("mmap(sq ring)", errno));
+        }
+        cq_ptr_ = sq_ptr_;
+
+        sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = ::mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                            fd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return Err<void, std::string>(errno_message("mmap(sqes)", errno));
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<char*>(sq_ptr_);
+        sq_head_ = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+        sq_tail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sq_mask_ = *reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sq_array_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        sq_entries_ = params.sq_entries;
+        local_tail_ = *sq_tail_;
+
+        auto* cq = static_cast<char*>(cq_ptr_);
+        cq_head_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cq_tail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cq_mask_ = *reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+        return Ok();
+    }
+
+    int fd() const { return fd_; }
+
+    // Next free SQE, zeroed. Flushes the queue to the kernel when full.
+    io_uring_sqe* get_sqe() {
+        while (local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE) >= sq_entries_) {
+            enter(0);
+        }
+        unsigned index = local_tail_ & sq_mask_;
+        io_uring_sqe* sqe = &sqes_[index];
+        std::memset(sqe, 0, sizeof(*sqe));
+        sq_array_[index] = index;
+        ++local_tail_;
+        return sqe;
+    }
+
+    // Submit everything queued and wait for at least wait_nr completions
+    void enter(unsigned wait_nr) {
+        __atomic_store_n(sq_tail_, local_tail_, __ATOMIC_RELEASE);
+        unsigned to_submit = local_tail_ - __atomic_load_n(sq_head_, __ATOMIC_ACQUIRE);
+        unsigned flags = wait_nr > 0 ? IORING_ENTER_GETEVENTS : 0;
+
+        int ret = static_cast<int>(::syscall(__NR_io_uring_enter, fd_, to_submit, wait_nr, flags,
+                                             nullptr, 0));
+        ++enter_calls_;
+        if (ret > 0) {
+            submitted_ += static_cast<unsigned>(ret);
+        }
+        // EINTR: retried by the caller's loop. EBUSY/EAGAIN: CQ backlog,
+        // reaping completions makes room.
+        if (ret < 0 && errno != EINTR && errno != EBUSY && errno != EAGAIN) {
+            spdlog::error("io_uring_enter failed: {}", std::strerror(errno));
+        }
+    }
+
+    // Invoke fn(cqe) for every available completion. Returns the count.
+    template <typename Fn>
+    unsigned for_each_cqe(Fn&& fn) {
+        unsigned head = *cq_head_;
+        unsigned tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+        unsigned count = 0;
+        while (head != tail) {
+            // Copy first: fn may queue work that lets the kernel reuse the slot
+            io_uring_cqe cqe = cqes_[head & cq_mask_];
+            ++head;
+            ++count;
+            __atomic_store_n(cq_head_, head, __ATOMIC_RELEASE);
+            fn(cqe);
+            if (head == tail) {
+                tail = __atomic_load_n(cq_tail_, __ATOMIC_ACQUIRE);
+            }
+        }
+        return count;
+    }
+
+    // Counters since the last call
+    void take_stats(size_t& enter_calls, size_t& submitted) {
+        enter_calls = enter_calls_;
+        submitted = submitted_;
+        enter_calls_ = 0;
+        submitted_ = 0;
+    }
+
+private:
+    int fd_ = -1;
+
+    void* sq_ptr_ = nullptr;
+    void* cq_ptr_ = nullptr;
+    size_t sq_size_ = 0;
+    size_t cq_size_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqes_size_ = 0;
+
+    unsigned* sq_head_ = nullptr;
+    unsigned* sq_tail_ = nullptr;
+    unsigned* sq_array_ = nullptr;
+    unsigned sq_mask_ = 0;
+    unsigned sq_entries_ = 0;
+    unsigned local_tail_ = 0;   // SQEs prepared but not yet published
+
+    unsigned* cq_head_ = nullptr;
+    unsigned* cq_tail_ = nullptr;
+    unsigned cq_mask_ = 0;
+    io_uring_cqe* cqes_ = nullptr;
+
+    size_t enter_calls_ = 0;
+    size_t submitted_ = 0;
+};
+
+// ──────────────────────────────────────────────────────────
+// BufferRing - provided receive buffers (IORING_REGISTER_PBUF_RING)
+// ──────────────────────────────────────────────────────────
+
+class BufferRing {
+public:
+    BufferRing() = default;
+
+    ~BufferRing() {
+        if (ring_ != nullptr) {
+            ::munmap(ring_, ring_size_);
+        }
+    }
+
+    BufferRing(const BufferRing&) = delete;
+    BufferRing& operator=(const BufferRing&) = delete;
+
+    Result<void> init(int ring_fd) {
+        ring_size_ = kBufferCount * sizeof(io_uring_buf);
+        void* mem = ::mmap(nullptr, ring_size_, PROT_READ | PROT_WRITE,
+                           MAP_ANONYMOUS | MAP_PRIVATE, -1, 0);
+        if (mem == MAP_FAILED) {
+            return Err<void, std::string>(errno_message("mmap(buffer ring)", errno));
+        }
+        ring_ = static_cast<io_uring_buf_ring*>(mem);
+
+        io_uring_buf_reg reg{};
+        reg.ring_addr = reinterpret_cast<uint64_t>(ring_);
+        reg.ring_entries = kBufferCount;
+        reg.bgid = kBufferGroup;
+        if (::syscall(__NR_io_uring_register, ring_fd, IORING_REGISTER_PBUF_RING, &reg, 1) != 0) {
+            return Err<void, std::string>(errno_message("io_uring_register(PBUF_RING)", errno));
+        }
+
+        storage_.resize(kBufferCount * kBufferSize);
+        for (unsigned bid = 0; bid < kBufferCount; ++bid) {
+            add(static_cast<uint16_t>(bid));
+        }
+        publish();
+        return Ok();
+    }
+
+    const char* data(uint16_t bid) const {
+        return storage_.data() + static_cast<size_t>(bid) * kBufferSize;
+    }
+
+    // Hand a buffer back to the kernel (visible after publish())
+    void add(uint16_t bid) {
+        // Index from the ring base, not ring_->bufs: the uapi header's
+        // flexible-array wrapper adds a padding member when compiled as C++.
+        io_uring_buf& buf = reinterpret_cast<io_uring_buf*>(ring_)[tail_ & (kBufferCount - 1)];
+        buf.addr = reinterpret_cast<uint64_t>(data(bid));
+        buf.len = static_cast<uint32_t>(kBufferSize);
+        buf.bid = bid;
+        ++tail_;
+    }
+
+    void publish() {
+        __atomic_store_n(&ring_->tail, tail_, __ATOMIC_RELEASE);
+    }
+
+private:
+    io_uring_buf_ring* ring_ = nullptr;
+    size_t ring_size_ = 0;
+    uint16_t tail_ = 0;
+    std::vector<char> storage_;
+};
+
+} // namespace
+
+// ──────────────────────────────────────────────────────────
+// EventLoop - one ring and its connections
+// ──────────────────────────────────────────────────────────
+
+class HttpServerUring::EventLoop {
+public:
+    EventLoop(HttpServerUring& server, size_t index)
+        : server_(server), index_(index) {}
+
+    ~EventLoop() {
+        // run() drains every connection before returning; this only
+        // covers loops that were set up but never run.
+        for (auto& [id, conn] : connections_) {
+            ::close(conn->fd);
+        }
+        if (wake_fd_ >= 0) {
+            ::close(wake_fd_);
+        }
+    }
+
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+
+    Result<void> init(int listen_fd) {
+        listen_fd_ = listen_fd;
+
+        auto ring_result = ring_.init();
+        if (ring_result.is_error()) {
+            return ring_result;
+        }
+
+        auto buffers_result = buffers_.init(ring_.fd());
+        if (buffers_result.is_error()) {
+            return buffers_result;
+        }
+
+        wake_fd_ = ::eventfd(0, EFD_CLOEXEC);
+        if (wake_fd_ < 0) {
+            return Err<void, std::string>(errno_message("eventfd", errno));
+        }
+        return Ok();
+    }
+
+    void run() {
+        spdlog::debug("io_uring loop {} started", index_);
+        arm_accept();
+        arm_wake();
+
+        while (server_.running_.load(std::memory_order_acquire)) {
+            ring_.enter(1);
+            reap();
+            publish_stats();
+        }
+
+        drain();
+        publish_stats();
+        spdlog::debug("io_uring loop {} exiting", index_);
+    }
+
+    void wake() {
+        uint64_t one = 1;
+        [[maybe_unused]] auto r = ::write(wake_fd_, &one, sizeof(one));
+    }
+
+private:
+    struct Connection {
+        explicit Connection(std::pmr::memory_resource* upstream) : arena(upstream) {
+            start_request();
+        }
+
+        int fd = -1;
+        uint64_t id = 0;
+        ConnectionArena arena;              // Request and response memory
+        HttpParser parser;
+        std::vector<uint8_t> out;           // Bytes owned by the in-flight send
+        size_t out_offset = 0;
+        std::vector<uint8_t> pending;       // Responses queued behind it
+        std::vector<char> unparsed;         // Input held back while reading is paused
+        bool recv_armed = false;
+        bool read_paused = false;           // Output over kMaxPendingOutput
+        bool sending = false;
+        bool close_after_write = false;
+        bool closing = false;               // Shutdown/close submitted
+        bool closed = false;                // Close completed (fd released)
+
+        // Rewind the arena and start parsing the next request in it. The
+        // finished request goes first: it lives in the arena.
+        void start_request() {
+            parser.reset();
+            arena.reset();
+            ArenaScope scope(arena);
+            parser.reset();
+        }
+    };
+
+    // ════════════════════════════════════════════════════════
+    // Submissions
+    // ════════════════════════════════════════════════════════
+
+    void arm_accept() {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_ACCEPT;
+        sqe->fd = listen_fd_;
+        sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+        sqe->accept_flags = SOCK_CLOEXEC;
+        sqe->user_data = pack(Op::Accept, 0);
+    }
+
+    void arm_wake() {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_READ;
+        sqe->fd = wake_fd_;
+        sqe->addr = reinterpret_cast<uint64_t>(&wake_value_);
+        sqe->len = sizeof(wake_value_);
+        sqe->off = static_cast<uint64_t>(-1);
+        sqe->user_data = pack(Op::Wake, 0);
+    }
+
+    void arm_recv(Connection& conn) {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_RECV;
+        sqe->fd = conn.fd;
+        sqe->ioprio = IORING_RECV_MULTISHOT;
+        sqe->flags = IOSQE_BUFFER_SELECT;
+        sqe->buf_group = kBufferGroup;
+        sqe->user_data = pack(Op::Recv, conn.id);
+        conn.recv_armed = true;
+    }
+
+    // Stop the multishot recv; it completes with -ECANCELED. Data that
+    // completes before the cancel lands is held in unparsed.
+    void cancel_recv(Connection& conn) {
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_ASYNC_CANCEL;
+        sqe->addr = pack(Op::Recv, conn.id);
+        sqe->user_data = pack(Op::Cancel, conn.id);
+    }
+
+    // Shutdown ends a pending multishot recv (it completes with 0), close
+    // then releases the fd. With link set, the chain continues a send.
+    void submit_teardown(Connection& conn) {
+        io_uring_sqe* shut = ring_.get_sqe();
+        shut->opcode = IORING_OP_SHUTDOWN;
+        shut->fd = conn.fd;
+        shut->len = SHUT_RDWR;
+        shut->flags = IOSQE_IO_LINK;
+        shut->user_data = pack(Op::Shutdown, conn.id);
+
+        io_uring_sqe* close = ring_.get_sqe();
+        close->opcode = IORING_OP_CLOSE;
+        close->fd = conn.fd;
+        close->user_data = pack(Op::Close, conn.id);
+
+        conn.closing = true;
+    }
+
+    void begin_close(Connection& conn) {
+        if (!conn.closing) {
+            submit_teardown(conn);
+        }
+    }
+
+    // Start sending queued responses unless a send is already in flight
+    void flush(Connection& conn) {
+        if (conn.sending || conn.closing) {
+            return;
+        }
+        if (conn.pending.empty()) {
+            if (conn.close_after_write) {
+                begin_close(conn);
+            }
+            return;
+        }
+
+        conn.out.swap(conn.pending);
+        conn.pending.clear();
+        conn.out_offset = 0;
+        submit_send(conn);
+    }
+
+    void submit_send(Connection& conn) {
+        trace::Span send_span("http.send");
+        io_uring_sqe* sqe = ring_.get_sqe();
+        sqe->opcode = IORING_OP_SEND;
+        sqe->fd = conn.fd;
+        sqe->addr = reinterpret_cast<uint64_t>(conn.out.data() + conn.out_offset);
+        sqe->len = static_cast<uint32_t>(conn.out.size() - conn.out_offset);
+        sqe->user_data = pack(Op::Send, conn.id);
+        conn.sending = true;
+
+        if (conn.close_after_write) {
+            // Last response: WAITALL makes a short send fail the link, so
+            // the teardown only runs once every byte is out.
+            sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+            sqe->flags = IOSQE_IO_LINK;
+            submit_teardown(conn);
+        } else {
+            sqe->msg_flags = MSG_NOSIGNAL;
+        }
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Completions
+    // ════════════════════════════════════════════════════════
+
+    void reap() {
+        bool returned_buffers = false;
+        ring_.for_each_cqe([&](const io_uring_cqe& cqe) {
+            switch (op_of(cqe.user_data)) {
+                case Op::Accept:   on_accept(cqe); break;
+                case Op::Recv:     returned_buffers |= on_recv(cqe); break;
+                case Op::Send:     on_send(cqe); break;
+                case Op::Close:    on_close(cqe); break;
+                case Op::Wake:     wake_fired_ = true; break;
+                case Op::Shutdown:
+                case Op::Cancel:   break;
+            }
+        });
+        if (returned_buffers) {
+            buffers_.publish();
+        }
+    }
+
+    Connection* find(uint64_t id) {
+        auto it = connections_.find(id);
+        return it != connections_.end() ? it->second.get() : nullptr;
+    }
+
+    void on_accept(const io_uring_cqe& cqe) {
+        if (!(cqe.flags & IORING_CQE_F_MORE) && server_.running_.load(std::memory_order_acquire)) {
+            arm_accept();   // Multishot ended (e.g. error); start another
+        }
+        if (cqe.res < 0) {
+            if (cqe.res != -ECANCELED) {
+                spdlog::warn("io_uring accept failed: {}", std::strerror(-cqe.res));
+            }
+            return;
+        }
+
+        int fd = cqe.res;
+        int one = 1;
+        ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        auto conn = std::make_unique<Connection>(&arena_upstream_);
+        conn->fd = fd;
+        conn->id = ++next_id_;
+        arm_recv(*conn);
+        connections_.emplace(conn->id, std::move(conn));
+        server_.active_connections_.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Returns true if a buffer went back to the ring
+    bool on_recv(const io_uring_cqe& cqe) {
+        bool has_buffer = (cqe.flags & IORING_CQE_F_BUFFER) != 0;
+        auto bid = static_cast<uint16_t>(cqe.flags >> IORING_CQE_BUFFER_SHIFT);
+
+        Connection* conn = find(id_of(cqe.user_data));
+        if (conn != nullptr && !(cqe.flags & IORING_CQE_F_MORE)) {
+            conn->recv_armed = false;
+        }
+
+        if (conn != nullptr && !conn->closing) {
+            if (cqe.res > 0 && has_buffer) {
+                consume(*conn, buffers_.data(bid), static_cast<size_t>(cqe.res));
+            } else if (cqe.res == 0) {
+                conn->close_after_write = true;   // Peer closed
+            } else if (cqe.res == -ENOBUFS) {
+                // Pool ran dry; buffers returned in this batch refill it
+            } else if (cqe.res == -ECANCELED) {
+                // cancel_recv() landed; re-armed below if already resumed
+            } else if (cqe.res < 0) {
+                conn->pending.clear();
+                conn->close_after_write = true;
+            }
+
+            if (!conn->recv_armed && !conn->close_after_write && !conn->read_paused) {
+                arm_recv(*conn);
+            }
+            flush(*conn);
+        }
+
+        if (has_buffer) {
+            buffers_.add(bid);
+        }
+        if (conn != nullptr) {
+            release_if_done(*conn);
+        }
+        return has_buffer;
+    }
+
+    void on_send(const io_uring_cqe& cqe) {
+        Connection* conn = find(id_of(cqe.user_data));
+        if (conn == nullptr) {
+            return;
+        }
+        conn->sending = false;
+
+        if (conn->closing) {
+            // Linked teardown follows (or was cancelled if the send failed)
+            release_if_done(*conn);
+            return;
+        }
+        if (cqe.res < 0) {
+            conn->pending.clear();
+            conn->close_after_write = true;
+            flush(*conn);
+            return;
+        }
+
+        conn->out_offset += static_cast<size_t>(cqe.res);
+        if (conn->out_offset < conn->out.size()) {
+            submit_send(*conn);   // Short write: send the rest
+            return;
+        }
+        conn->out.clear();
+        conn->out_offset = 0;
+        if (conn->read_paused && conn->pending.empty()) {
+            resume_reading(*conn);
+        }
+        flush(*conn);
+    }
+
+    // Everything queued was sent: parse the input held back while paused
+    // and re-arm the receive unless that input paused it again
+    void resume_reading(Connection& conn) {
+        conn.read_paused = false;
+        std::vector<char> held;
+        held.swap(conn.unparsed);
+        consume(conn, held.data(), held.size());
+        if (!conn.read_paused && !conn.recv_armed && !conn.close_after_write) {
+            arm_recv(conn);
+        }
+    }
+
+    void on_close(const io_uring_cqe& cqe) {
+        Connection* conn = find(id_of(cqe.user_data));
+        if (conn == nullptr) {
+            return;
+        }
+        if (cqe.res < 0) {
+            // Chain broken by a failed send (-ECANCELED): the fd is
+            // still ours, tear it down directly.
+            ::shutdown(conn->fd, SHUT_RDWR);
+            ::close(conn->fd);
+        }
+        conn->closed = true;
+        release_if_done(*conn);
+    }
+
+    // Free the connection once nothing in flight references it
+    void release_if_done(Connection& conn) {
+        if (!conn.closed || conn.recv_armed || conn.sending) {
+            return;
+        }
+        connections_.erase(conn.id);
+        server_.active_connections_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Request handling
+    // ════════════════════════════════════════════════════════
+
+    static size_t pending_output(const Connection& conn) {
+        return conn.out.size() - conn.out_offset + conn.pending.size();
+    }
+
+    void consume(Connection& conn, const char* data, size_t len) {
+        if (conn.read_paused) {
+            conn.unparsed.insert(conn.unparsed.end(), data, data + len);
+            return;
+        }
+        while (len > 0 && !conn.close_after_write) {
+            trace::Span parse_span("http.parse");
+            auto parsed = conn.parser.parse(data, len);
+            parse_span.end();
+
+            if (parsed.is_error()) {
+                queue_response(conn, create_error_response(conn.parser.error_status(),
+                                                           "Failed to parse request: " + parsed.error()));
+                conn.close_after_write = true;
+                return;
+            }
+            if (!parsed.value()) {
+                return;   // Need more bytes
+            }
+
+            size_t used = conn.parser.consumed();
+            data += used;
+            len -= used;
+
+            {
+                // The request was parsed into the arena; the handler's
+                // response is built there too.
+                ArenaScope scope(conn.arena);
+                const HttpRequest& request = conn.parser.request();
+                bool keep_alive = wants_keep_alive(request);
+                HttpResponse response = server_.handle_request(request);
+                if (!keep_alive || ascii_iequals(response.headers.get(HeaderId::CONNECTION), "close")) {
+                    response.set_header("Connection", "close");
+                    conn.close_after_write = true;
+                } else {
+                    response.set_header("Connection", "keep-alive");
+                }
+                queue_response(conn, response);
+            }
+            conn.start_request();
+            server_.total_processed_.fetch_add(1, std::memory_order_relaxed);
+
+            if (pending_output(conn) > kMaxPendingOutput && !conn.close_after_write) {
+                conn.unparsed.assign(data, data + len);
+                conn.read_paused = true;
+                if (conn.recv_armed) {
+                    cancel_recv(conn);
+                }
+                return;
+            }
+        }
+    }
+
+    void queue_response(Connection& conn, const HttpResponse& response) {
+        // A streamed body is drained into pending in full: chunked on the
+        // wire, but not yet memory-bounded on this backend
+        response.serialize_into(conn.pending);
+    }
+
+    // ════════════════════════════════════════════════════════
+    // Shutdown
+    // ════════════════════════════════════════════════════════
+
+    // Cancel everything in flight (accept, receives, sends blocked on slow
+    // peers), close every connection and wait until all completions for
+    // memory we own have arrived.
+    void drain() {
+        io_uring_sqe* cancel = ring_.get_sqe();
+        cancel->opcode = IORING_OP_ASYNC_CANCEL;
+        cancel->cancel_flags = IORING_ASYNC_CANCEL_ANY;
+        cancel->user_data = pack(Op::Cancel, 0);
+
+        for (auto& [id, conn] : connections_) {
+            begin_close(*conn);
+        }
+
+        while (!connections_.empty() || !wake_fired_) {
+            ring_.enter(1);
+            reap();
+        }
+    }
+
+    void publish_stats() {
+        size_t enter_calls = 0;
+        size_t submitted = 0;
+        ring_.take_stats(enter_calls, submitted);
+        server_.enter_calls_.fetch_add(enter_calls, std::memory_order_relaxed);
+        server_.submitted_ops_.fetch_add(submitted, std::memory_order_relaxed);
+    }
+
+    HttpServerUring& server_;
+    size_t index_;
+    int listen_fd_ = -1;
+    int wake_fd_ = -1;
+    uint64_t wake_value_ = 0;
+    bool wake_fired_ = false;
+
+    Ring ring_;
+    BufferRing buffers_;
+
+    std::pmr::unsynchronized_pool_resource arena_upstream_;   // Recycles arena blocks
+    std::unordered_map<uint64_t, std::unique_ptr<Connection>> connections_;
+    uint64_t next_id_ = 0;
+};
+
+// ──────────────────────────────────────────────────────────
+// HttpServerUring Implementation
+// ──────────────────────────────────────────────────────────
+
+HttpServerUring::HttpServerUring(size_t loop_count)
+    : loop_count_(std::max<size_t>(1, loop_count)) {
+
+    spdlog::info("HttpServerUring created with {} rings", loop_count_);
+}
+
+HttpServerUring::~HttpServerUring() {
+    stop();
+}
+
+void HttpServerUring::set_handler(HttpRequestHandler handler) {
+    handler_ = std::move(handler);
+}
+
+Result<void> HttpServerUring::listen(uint16_t port, const std::string& address) {
+    auto create_result = listener_.create(SocketType::TCP);
+    if (create_result.is_error()) {
+        return Err<void, std::string>("Failed to create listener socket: " + create_result.error());
+    }
+
+    auto reuse_result = listener_.set_reuse_address(true);
+    if (reuse_result.is_error()) {
+        return Err<void, std::string>("Failed to set SO_REUSEADDR: " + reuse_result.error());
+    }
+
+    auto bind_result = listener_.bind(address, port);
+    if (bind_result.is_error()) {
+        return Err<void, std::string>("Failed to bind: " + bind_result.error());
+    }
+
+    auto listen_result = listener_.listen(SOMAXCONN);
+    if (listen_result.is_error()) {
+        return Err<void, std::string>("Failed to listen: " + listen_result.error());
+    }
+
+    sockaddr_in bound{};
+    socklen_t len = sizeof(bound);
+    if (::getsockname(listener_.native_handle(), reinterpret_cast<sockaddr*>(&bound), &len) == 0) {
+        port_ = ntohs(bound.sin_port);
+    } else {
+        port_ = port;
+    }
+
+    loops_.clear();
+    for (size_t i = 0; i < loop_count_; ++i) {
+        auto loop = std::make_unique<EventLoop>(*this, i);
+        auto init_result = loop->init(listener_.native_handle());
+        if (init_result.is_error()) {
+            loops_.clear();
+            return init_result;
+        }
+        loops_.push_back(std::move(loop));
+    }
+
+    spdlog::info("HTTP server (io_uring) listening on {}:{}", address, port_);
+    return Ok();
+}
+
+Result<void> HttpServerUring::serve_forever() {
+    if (loops_.empty()) {
+        return Err<void, std::string>("Server not listening. Call listen() first.");
+    }
+    if (!handler_) {
+        return Err<void, std::string>("No request handler set. Call set_handler() first.");
+    }
+
+    running_.store(true, std::memory_order_release);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < loops_.size(); ++i) {
+        threads.emplace_back([loop = loops_[i].get()] { loop->run(); });
+    }
+    loops_[0]->run();
+
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    spdlog::info("Server stopped. Processed {} total requests with {} io_uring_enter calls",
+                 total_processed_.load(), enter_calls_.load());
+    return Ok();
+}
+
+void HttpServerUring::stop() {
+    if (running_.exchange(false, std::memory_order_acq_rel)) {
+        spdlog::info("Stopping io_uring server...");
+        for (auto& loop : loops_) {
+            loop->wake();
+        }
+    }
+}
+
+HttpResponse HttpServerUring::handle_request(const HttpRequest& request) {
+    spdlog::debug("{} {} HTTP/{}",
+                  HttpMethodUtils::to_string(request.method),
+                  request.url,
+                  request.version == HttpVersion::HTTP_1_1 ? "1.1" : "1.0");
+
+    trace::Span handler_span("http.handler");
+    try {
+        return handler_(request);
+    } catch (const std::exception& e) {
+        spdlog::error("Handler threw exception: {}", e.what());
+    } catch (...) {
+        spdlog::error("Handler threw unknown exception");
+    }
+    return create_error_response(HttpStatus::INTERNAL_SERVER_ERROR, "Internal server error");
+}
+
+HttpResponse HttpServerUring::create_error_response(HttpStatus status, const std::string& message) {
+    HttpResponse response(status);
+
+    std::string html =
+        "<!DOCTYPE html>\n"
+        "<html>\n"
+        "<head><title>Error " + std::to_string(static_cast<int>(status)) + "</title></head>\n"
+        "<body>\n"
+        "<h1>Error " + std::to_string(static_cast<int>(status)) + "</h1>\n"
+        "<p>" + message + "</p>\n"
+        "</body>\n"
+        "</html>\n";
+
+    response.set_body(html);
+    response.set_header("Content-Type", "text/html");
+    response.set_header("Connection", "close");
+
+    return response;
+}
+
+} // namespace network
+} // namespace dfs
@@ -0,0 +1,50 @@
+#include "dfs/network/rpc.hpp"
+
+namespace dfs {
+namespace network {
+
+RpcReply& RpcReply::operator=(RpcReply&& other) noexcept {
+    if (this != &other) {
+        if (pending()) {
+            fail("Request dropped");
+        }
+        sink_ = std::move(other.sink_);
+        fd_ = other.fd_;
+        connection_id_ = other.connection_id_;
+        type_ = other.type_;
+        request_id_ = other.request_id_;
+    }
+    return *this;
+}
+
+RpcReply::~RpcReply() {
+    if (pending()) {
+        fail("Request dropped by the server");
+    }
+}
+
+void RpcReply::send(std::vector<uint8_t> payload) {
+    deliver(kRpcReply, std::move(payload));
+}
+
+void RpcReply::fail(std::string_view message, bool busy) {
+    deliver(kRpcReply | kRpcError | (busy ? kRpcBusy : 0), std::vector<uint8_t>(message.begin(), message.end()));
+}
+
+void RpcReply::deliver(uint8_t flags, std::vector<uint8_t> payload) {
+    if (!sink_) {
+        return;   // Already answered
+    }
+    auto sink = std::move(sink_);
+    if (payload.size() > kRpcMaxPayload) {
+        // The peer drops a connection that sends such a frame
+        const std::string message = "Reply of " + std::to_string(payload.size()) + " bytes exceeds the RPC limit";
+        flags = kRpcReply | kRpcError;
+        payload.assign(message.begin(), message.end());
+    }
+    RpcFrameHeader header{type_, flags, request_id_, static_cast<uint32_t>(payload.size())};
+    sink->deliver(fd_, connection_id_, header, std::move(payload));
+}
+
+} // namespace network
+} // namespace dfs
@@ -33,14 +33,16 @@ Result<void> Socket::initialize_platform() {
 Socket::Socket() 
     : socket_(INVALID_SOCKET_VALUE)
     , type_(SocketType::TCP)
-    , is_connected_(false) {
+    , is_connected_(false)
+    , peer_address_(0) {
     initialize_platform();
 }
 
 Socket::Socket(socket_t socket)
     : socket_(socket)
     , type_(SocketType::TCP)
-    , is_connected_(true) {
+    , is_connected_(true)
+    , peer_address_(0) {
 }
 
 Socket::~Socket() {
@@ -50,7 +52,8 @@ Socket::~Socket() {
 Socket::Socket(Socket&& other) noexcept
     : socket_(other.socket_)
     , type_(other.type_)
-    , is_connected_(other.is_connected_) {
+    , is_connected_(other.is_connected_)
+    , peer_address_(other.peer_address_) {
     other.socket_ = INVALID_SOCKET_VALUE;
     other.is_connected_ = false;
 }
@@ -61,6 +64,7 @@ Socket& Socket::operator=(Socket&& other) noexcept {
         socket_ = other.socket_;
         type_ = other.type_;
         is_connected_ = other.is_connected_;
+        peer_address_ = other.peer_address_;
         other.socket_ = INVALID_SOCKET_VALUE;
         other.is_connected_ = false;
     }
@@ -148,7 +152,9 @@ Result<std::unique_ptr<Socket>> Socket::accept() {
     inet_ntop(AF_INET, &client_addr.sin_addr, addr_str, INET_ADDRSTRLEN);
     spdlog::info("Accepted connection from {}:{}", addr_str, ntohs(client_addr.sin_port));
     
-    return Ok(Socket::create_from_native(client_socket));
+    auto client = Socket::create_from_native(client_socket);
+    client->peer_address_ = ntohl(client_addr.sin_addr.s_addr);
+    return Ok(std::move(client));
 }
 
 Result<void> Socket::connect(const std::string& address, uint16_t port) {
@@ -174,13 +180,17 @@ Result<void> Socket::connect(const std::string& address, uint16_t port) {
 }
 
 Result<size_t> Socket::send(const std::vector<uint8_t>& data) {
+    return send(data.data(), data.size());
+}
+
+Result<size_t> Socket::send(const uint8_t* data, size_t size) {
     if (socket_ == INVALID_SOCKET_VALUE) {
         return Err<size_t>(std::string("Socket not created"));
     }
     
     auto sent = ::send(socket_, 
-                         reinterpret_cast<const char*>(data.data()), 
-                         data.size(), 0);
+                         reinterpret_cast<const char*>(data), 
+                         size, 0);
     
     if (sent < 0) {
         return Err<size_t>(std::string("Failed to send data"));
@@ -207,6 +217,52 @@ Result<std::vector<uint8_t>> Socket::receive(size_t max_size) {
     return Ok(std::move(buffer));
 }
 
+Result<size_t> Socket::receive_into(uint8_t* buffer, size_t max_size) {
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        return Err<size_t>(std::string("Socket not created"));
+    }
+
+    auto received = ::recv(socket_,
+                           reinterpret_cast<char*>(buffer),
+                           max_size, 0);
+
+    if (received < 0) {
+        return Err<size_t>(std::string("Failed to receive data"));
+    }
+
+    return Ok(static_cast<size_t>(received));
+}
+
+Result<uint16_t> Socket::local_port() const {
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        return Err<uint16_t>(std::string("Socket not created"));
+    }
+
+    sockaddr_in addr{};
+    socklen_t addr_len = sizeof(addr);
+    if (::getsockname(socket_, reinterpret_cast<sockaddr*>(&addr), &addr_len) < 0) {
+        return Err<uint16_t>(std::string("Failed to get socket name"));
+    }
+
+    return Ok(static_cast<uint16_t>(ntohs(addr.sin_port)));
+}
+
+Result<size_t> Socket::peek(uint8_t* buffer, size_t max_size) {
+    if (socket_ == INVALID_SOCKET_VALUE) {
+        return Err<size_t>(std::string("Socket not created"));
+    }
+
+    auto received = ::recv(socket_,
+                           reinterpret_cast<char*>(buffer),
+                           max_size, MSG_PEEK);
+
+    if (received < 0) {
+        return Err<size_t>(std::string("Failed to peek data"));
+    }
+
+    return Ok(static_cast<size_t>(received));
+}
+
 Result<void> Socket::set_non_blocking(bool enable) {
     if (socket_ == INVALID_SOCKET_VALUE) {
         return Err<void>(std::string("Socket not created"));
@@ -251,6 +307,16 @@ Result<void> Socket::set_reuse_address(bool enable) {
     return Ok();
 }
 
+void Socket::shutdown() {
+    if (socket_ != INVALID_SOCKET_VALUE) {
+#ifdef DFS_PLATFORM_WINDOWS
+        ::shutdown(socket_, SD_BOTH);
+#else
+        ::shutdown(socket_, SHUT_RDWR);
+#endif
+    }
+}
+
 void Socket::close() {
     if (socket_ != INVALID_SOCKET_VALUE) {
         close_socket(socket_);
@@ -0,0 +1,107 @@
+#include "dfs/sync/rpc_service.hpp"
+#include "dfs/core/trace.hpp"
+#include "dfs/sync/rpc.hpp"
+
+#include <spdlog/spdlog.h>
+
+#include <filesystem>
+
+namespace dfs::sync {
+
+SyncRpcService::SyncRpcService(SyncService& service, WorkStealingPool& pool)
+    : service_(service), pool_(pool) {}
+
+network::RpcHandler SyncRpcService::handler() {
+    return [this](network::RpcRequest request, network::RpcReply reply) {
+        handle(std::move(request), std::move(reply));
+    };
+}
+
+void SyncRpcService::handle(network::RpcRequest request, network::RpcReply reply) {
+    auto op = static_cast<rpc::Op>(request.type);
+    if (op == rpc::Op::Register || op == rpc::Op::StartSession) {
+        execute(request, reply);
+        return;
+    }
+    pool_.submit([this, request = std::move(request), reply = std::move(reply)]() mutable {
+        execute(request, reply);
+    });
+}
+
+void SyncRpcService::execute(const network::RpcRequest& request, network::RpcReply& reply) {
+    trace::Span span("sync.rpc");
+    switch (static_cast<rpc::Op>(request.type)) {
+    case rpc::Op::Register: {
+        auto preferred = rpc::decode_text(request.payload);
+        if (preferred.is_error()) {
+            return reply.fail(preferred.error());
+        }
+        return reply.send(rpc::encode_text(service_.register_client(preferred.value())));
+    }
+    case rpc::Op::StartSession: {
+        auto client_id = rpc::decode_text(request.payload);
+        if (client_id.is_error()) {
+            return reply.fail(client_id.error());
+        }
+        auto session = service_.start_session(client_id.value());
+        if (session.is_error()) {
+            return reply.fail(session.error());
+        }
+        return reply.send(rpc::encode_text(session.value().session_id));
+    }
+    case rpc::Op::Diff: {
+        auto args = rpc::decode_diff_args(request.payload);
+        if (args.is_error()) {
+            return reply.fail(args.error());
+        }
+        auto diff = service_.compute_diff(args.value().session_id, args.value().snapshot);
+        if (diff.is_error()) {
+            return reply.fail(diff.error());
+        }
+        return reply.send(rpc::encode_diff_response(diff.value()));
+    }
+    case rpc::Op::UploadChunk: {
+        auto chunk = rpc::decode_chunk(request.payload);
+        if (chunk.is_error()) {
+            return reply.fail(chunk.error());
+        }
+        auto ingested = service_.ingest_chunk(chunk.value());
+        if (ingested.is_error()) {
+            return reply.fail(ingested.error());
+        }
+        return reply.send();
+    }
+    case rpc::Op::UploadComplete: {
+        auto args = rpc::decode_complete_args(request.payload);
+        if (args.is_error()) {
+            return reply.fail(args.error());
+        }
+        const auto& [session_id, file_path, expected_hash] = args.value();
+        auto metadata = service_.finalize_upload(session_id, file_path, expected_hash);
+        if (metadata.is_error()) {
+            return reply.fail(metadata.error());
+        }
+        return reply.send(rpc::encode_metadata(metadata.value()));
+    }
+    case rpc::Op::Download: {
+        auto path = rpc::decode_text(request.payload);
+        if (path.is_error()) {
+            return reply.fail(path.error());
+        }
+        std::error_code ec;
+        const auto size = std::filesystem::file_size(service_.stored_path(path.value()), ec);
+        if (!ec && size > max_download_size_) {
+            return reply.fail(rpc::kFileTooLarge);
+        }
+        auto data = service_.read_file(path.value());
+        if (data.is_error()) {
+            return reply.fail(data.error());
+        }
+        return reply.send(rpc::encode_file_data(FileTransferService::content_hash(data.value()), data.value()));
+    }
+    }
+    spdlog::debug("Unknown sync RPC operation {}", request.type);
+    reply.fail("Unknown operation " + std::to_string(request.type));
+}
+
+} // namespace dfs::sync
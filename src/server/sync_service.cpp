@@ -1,9 +1,10 @@
 #include "dfs/sync/service.hpp"
+#include "dfs/core/hex.hpp"
+#include "dfs/core/trace.hpp"
 
 #include <chrono>
 #include <cstdint>
 #include <fstream>
-#include <iomanip>
 #include <random>
 #include <sstream>
 #include <optional>
@@ -22,28 +23,6 @@ std::string generate_id(const std::string& base, uint64_t counter) {
     return oss.str();
 }
 
-std::string hex_encode(const std::vector<std::uint8_t>& data) {
-    std::ostringstream oss;
-    for (auto byte : data) {
-        oss << std::hex << std::setw(2) << std::setfill('0') << static_cast<int>(byte);
-    }
-    return oss.str();
-}
-
-std::vector<std::uint8_t> hex_decode(const std::string& hex) {
-    std::vector<std::uint8_t> bytes;
-    if (hex.size() % 2 != 0) {
-        return bytes;
-    }
-    bytes.reserve(hex.size() / 2);
-    for (std::size_t i = 0; i < hex.size(); i += 2) {
-        auto part = hex.substr(i, 2);
-        std::uint8_t value = static_cast<std::uint8_t>(std::stoi(part, nullptr, 16));
-        bytes.push_back(value);
-    }
-    return bytes;
-}
-
 std::string compute_file_hash(const fs::path& path) {
     std::ifstream input(path, std::ios::binary);
     if (!input) {
@@ -60,9 +39,7 @@ std::string compute_file_hash(const fs::path& path) {
             hash *= prime;
         }
     }
-    std::ostringstream hex;
-    hex << std::hex << std::setw(sizeof(hash) * 2) << std::setfill('0') << hash;
-    return hex.str();
+    return hex::encode_u64(hash);
 }
 
 std::optional<metadata::ReplicaInfo> find_replica(const metadata::FileMetadata& metadata,
@@ -75,14 +52,20 @@ std::optional<metadata::ReplicaInfo> find_replica(const metadata::FileMetadata&
     return std::nullopt;
 }
 
+bool is_open(SessionState state) {
+    return state != SessionState::Complete && state != SessionState::Failed;
+}
+
 } // namespace
 
 SyncService::SyncService(fs::path data_root,
                          fs::path staging_root,
                          events::EventBus& bus,
-                         metadata::MetadataStore& store)
+                         metadata::MetadataStore& store,
+                         std::chrono::milliseconds progress_window)
     : store_(store),
       event_bus_(bus),
+      progress_(bus, progress_window),
       data_root_(std::move(data_root)),
       staging_root_(std::move(staging_root)) {
 
@@ -110,13 +93,14 @@ dfs::Result<SyncSessionInfo> SyncService::start_session(const std::string& clien
         return dfs::Err<SyncSessionInfo>(std::string("Unknown client: ") + client_id);
     }
     const auto session_id = "session-" + std::to_string(++session_counter_);
-    SessionData session_data{SyncSession(session_id, client_id)};
+    SessionData session_data{SyncSession(session_id, client_id), {}, {}};
     auto result = session_data.session.start(0, 0);
     if (result.is_error()) {
         return dfs::Err<SyncSessionInfo>(result.error());
     }
     session_data.started_at = std::chrono::steady_clock::now();
     sessions_.emplace(session_id, std::move(session_data));
+    active_sessions_.fetch_add(1, std::memory_order_relaxed);
 
     event_bus_.emit(events::SyncStartedEvent{client_id, store_.size()});
     return dfs::Ok(sessions_.at(session_id).session.info());
@@ -131,7 +115,7 @@ dfs::Result<DiffResponse> SyncService::compute_diff(const std::string& session_i
     }
     auto* session_data = session_result.value();
 
-    if (session_data->session.state() == SessionState::Idle) {
+    if (session_data->session.state() == SessionState::ComputingDiff) {
         auto transition = session_data->session.transition_to(SessionState::RequestingMetadata);
         if (transition.is_error()) {
             return dfs::Err<DiffResponse>(transition.error());
@@ -164,8 +148,10 @@ dfs::Result<DiffResponse> SyncService::compute_diff(const std::string& session_i
     }
 
     // Handle server-only files not present in client's diff list
+    const std::unordered_set<std::string> listed(response.files_to_download.begin(),
+                                                 response.files_to_download.end());
     for (const auto& [path, metadata] : server_map) {
-        if (client_map.find(path) == client_map.end()) {
+        if (client_map.find(path) == client_map.end() && listed.find(path) == listed.end()) {
             response.files_to_download.push_back(path);
         }
     }
@@ -182,7 +168,9 @@ dfs::Result<DiffResponse> SyncService::compute_diff(const std::string& session_i
 }
 
 dfs::Result<void> SyncService::ingest_chunk(const ChunkEnvelope& chunk) {
+    trace::Span wait_span("sync.lock_wait", chunk.session_id);
     std::lock_guard lock(mutex_);
+    wait_span.end();
     auto session_result = find_session(chunk.session_id);
     if (session_result.is_error()) {
         return dfs::Err<void>(session_result.error());
@@ -199,39 +187,54 @@ dfs::Result<void> SyncService::ingest_chunk(const ChunkEnvelope& chunk) {
         event_bus_.emit(started);
     }
 
+    trace::Span apply_span("sync.apply_chunk", chunk.session_id);
     auto result = transfer_service_.apply_chunk(chunk, staging_root_);
+    apply_span.end();
     if (result.is_error()) {
+        progress_.flush(chunk.session_id, chunk.file_path);
+        const auto before = session_data->session.state();
         session_data->session.mark_failed(result.error());
+        note_session_end(before, *session_data);
         event_bus_.emit(events::SyncFailedEvent{session_data->session.client_id(), result.error()});
         return result;
     }
 
-    events::FileChunkReceivedEvent evt{chunk.session_id, chunk.file_path, chunk.chunk_index,
-                                       chunk.total_chunks, chunk.data.size()};
-    event_bus_.emit(evt);
+    progress_.add(events::FileChunkReceivedEvent{chunk.session_id, chunk.file_path, chunk.chunk_index,
+                                                 chunk.total_chunks, chunk.data.size()});
     return dfs::Ok();
 }
 
 dfs::Result<metadata::FileMetadata> SyncService::finalize_upload(const std::string& session_id,
                                                                   const std::string& file_path,
                                                                   const std::string& expected_hash) {
+    trace::Span wait_span("sync.lock_wait", session_id);
     std::lock_guard lock(mutex_);
+    wait_span.end();
     auto session_result = find_session(session_id);
     if (session_result.is_error()) {
         return dfs::Err<metadata::FileMetadata>(session_result.error());
     }
     auto* session_data = session_result.value();
 
+    // Progress must reach subscribers before completion or failure
+    progress_.flush(session_id, file_path);
+
+    trace::Span finalize_span("sync.finalize_file", session_id);
     auto finalize_result = transfer_service_.finalize_file(session_id, file_path, staging_root_, data_root_, expected_hash);
+    finalize_span.end();
     if (finalize_result.is_error()) {
+        const auto before = session_data->session.state();
         session_data->session.mark_failed(finalize_result.error());
+        note_session_end(before, *session_data);
         event_bus_.emit(events::SyncFailedEvent{session_data->session.client_id(), finalize_result.error()});
         return dfs::Err<metadata::FileMetadata>(finalize_result.error());
     }
 
     auto new_metadata = build_metadata_from_disk(session_data->session.client_id(), file_path);
     if (new_metadata.hash != expected_hash) {
+        const auto before = session_data->session.state();
         session_data->session.mark_failed("Hash mismatch after finalize");
+        note_session_end(before, *session_data);
         event_bus_.emit(events::SyncFailedEvent{session_data->session.client_id(), "Hash mismatch after finalize"});
         return dfs::Err<metadata::FileMetadata>(std::string("Hash mismatch after finalize for ") + file_path);
     }
@@ -272,8 +275,10 @@ dfs::Result<metadata::FileMetadata> SyncService::finalize_upload(const std::stri
                                          session_data->total_upload_bytes - session_data->uploaded_bytes);
 
     if (session_data->pending_uploads.empty()) {
+        const auto before = session_data->session.state();
         session_data->session.transition_to(SessionState::ApplyingChanges);
         session_data->session.transition_to(SessionState::Complete);
+        note_session_end(before, *session_data);
         const auto sync_duration = std::chrono::duration_cast<std::chrono::milliseconds>(
             std::chrono::steady_clock::now() - session_data->started_at);
         events::SyncCompletedEvent done{session_data->session.client_id(), store_.size(), sync_duration};
@@ -283,22 +288,35 @@ dfs::Result<metadata::FileMetadata> SyncService::finalize_upload(const std::stri
     return dfs::Ok(new_metadata);
 }
 
-dfs::Result<std::string> SyncService::read_file_hex(const std::string& file_path) const {
-    fs::path absolute = data_root_ / fs::path(file_path).relative_path();
-    if (!fs::exists(absolute)) {
-        return dfs::Err<std::string>(std::string("File not found: ") + file_path);
+dfs::Result<std::vector<std::uint8_t>> SyncService::read_file(const std::string& file_path) const {
+    fs::path absolute = stored_path(file_path);
+    std::error_code ec;
+    const auto size = fs::file_size(absolute, ec);
+    if (ec) {
+        return dfs::Err<std::vector<std::uint8_t>>(std::string("File not found: ") + file_path);
     }
 
     std::ifstream input(absolute, std::ios::binary);
     if (!input) {
-        return dfs::Err<std::string>(std::string("Failed to open file: ") + file_path);
+        return dfs::Err<std::vector<std::uint8_t>>(std::string("Failed to open file: ") + file_path);
     }
 
-    std::ostringstream buffer;
-    buffer << input.rdbuf();
-    const std::string data = buffer.str();
-    std::vector<std::uint8_t> bytes(data.begin(), data.end());
-    return dfs::Ok(hex_encode(bytes));
+    std::vector<std::uint8_t> bytes(static_cast<std::size_t>(size));
+    input.read(reinterpret_cast<char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    bytes.resize(static_cast<std::size_t>(input.gcount()));
+    return dfs::Ok(std::move(bytes));
+}
+
+fs::path SyncService::stored_path(const std::string& file_path) const {
+    return data_root_ / fs::path(file_path).relative_path();
+}
+
+dfs::Result<std::string> SyncService::read_file_hex(const std::string& file_path) const {
+    auto bytes = read_file(file_path);
+    if (bytes.is_error()) {
+        return dfs::Err<std::string>(bytes.error());
+    }
+    return dfs::Ok(hex::encode(bytes.value()));
 }
 
 dfs::Result<SyncSessionInfo> SyncService::session_info(const std::string& session_id) const {
@@ -310,13 +328,28 @@ dfs::Result<SyncSessionInfo> SyncService::session_info(const std::string& sessio
     return dfs::Ok(session_result.value()->session.info());
 }
 
-metadata::FileMetadata SyncService::build_metadata_from_disk(const std::string& client_id,
+std::size_t SyncService::active_sessions() const {
+    return active_sessions_.load(std::memory_order_relaxed);
+}
+
+void SyncService::note_session_end(SessionState before, const SessionData& session_data) {
+    if (is_open(before) && !is_open(session_data.session.state())) {
+        active_sessions_.fetch_sub(1, std::memory_order_relaxed);
+        // Files of the session that never finished would otherwise stay tracked
+        progress_.flush_session(session_data.session.session_id());
+    }
+}
+
+metadata::FileMetadata SyncService::build_metadata_from_disk(const std::string& /*client_id*/,
                                                              const std::string& file_path) const {
-    fs::path absolute = data_root_ / fs::path(file_path).relative_path();
+    fs::path absolute = stored_path(file_path);
     metadata::FileMetadata metadata;
     metadata.file_path = file_path;
     metadata.size = fs::exists(absolute) ? fs::file_size(absolute) : 0;
-    metadata.hash = compute_file_hash(absolute);
+    {
+        trace::Span hash_span("sync.hash");
+        metadata.hash = compute_file_hash(absolute);
+    }
     const auto now = std::time(nullptr);
     metadata.modified_time = now;
     metadata.created_time = now;
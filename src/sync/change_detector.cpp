@@ -1,10 +1,8 @@
 #include "dfs/sync/change_detector.hpp"
+#include "dfs/sync/transfer.hpp"
 
 #include <chrono>
 #include <filesystem>
-#include <fstream>
-#include <iomanip>
-#include <sstream>
 #include <system_error>
 
 using dfs::metadata::FileMetadata;
@@ -23,12 +21,6 @@ std::time_t to_time_t(fs::file_time_type time) {
     return system_clock::to_time_t(system_time);
 }
 
-std::string hash_to_hex(std::size_t value) {
-    std::ostringstream oss;
-    oss << std::hex << std::setw(sizeof(value) * 2) << std::setfill('0') << value;
-    return oss.str();
-}
-
 } // namespace
 
 ChangeDetector::ChangeDetector(std::string replica_id, bool recursive)
@@ -199,18 +191,10 @@ std::optional<ReplicaInfo> ChangeDetector::find_replica(const FileMetadata& meta
     return std::nullopt;
 }
 
+// Same hash the server computes, so an unchanged file diffs as equal
 std::string ChangeDetector::compute_file_hash(const fs::path& absolute_path) const {
-    std::ifstream input(absolute_path, std::ios::binary);
-    if (!input) {
-        return {};
-    }
-
-    std::ostringstream buffer;
-    buffer << input.rdbuf();
-    const std::string data = buffer.str();
-
-    const std::size_t hash_value = std::hash<std::string>{}(data);
-    return hash_to_hex(hash_value);
+    auto hash = FileTransferService::file_hash(absolute_path);
+    return hash.is_ok() ? hash.value() : std::string{};
 }
 
 } // namespace dfs::sync
@@ -0,0 +1,529 @@
+#include "dfs/sync/json_reader.hpp"
+
+#include <bit>
+#include <charconv>
+#include <cstring>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace dfs::sync {
+
+namespace {
+
+// ────────────────────────────────────────────────────────────
+// Pass 1: structural index
+// ────────────────────────────────────────────────────────────
+
+constexpr std::size_t kBlock = 64;
+
+// One bit per byte of a 64-byte block
+struct BlockMasks {
+    std::uint64_t quote = 0;
+    std::uint64_t backslash = 0;
+    std::uint64_t structural = 0;   // {}[]:,
+    std::uint64_t control = 0;      // Below 0x20: invalid inside strings
+};
+
+#if defined(__SSE2__)
+BlockMasks classify(const char* block) {
+    // '[' and ']' differ from '{' and '}' only in bit 0x20
+    const __m128i case_bit = _mm_set1_epi8(0x20);
+    const __m128i open = _mm_set1_epi8('{');
+    const __m128i close = _mm_set1_epi8('}');
+    const __m128i colon = _mm_set1_epi8(':');
+    const __m128i comma = _mm_set1_epi8(',');
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control_max = _mm_set1_epi8(0x1f);
+
+    BlockMasks masks;
+    for (int lane = 0; lane < 4; ++lane) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block + lane * 16));
+        __m128i folded = _mm_or_si128(bytes, case_bit);
+        __m128i structural = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(folded, open), _mm_cmpeq_epi8(folded, close)),
+                                          _mm_or_si128(_mm_cmpeq_epi8(bytes, colon), _mm_cmpeq_epi8(bytes, comma)));
+        __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(bytes, control_max), control_max);
+
+        auto bits = [lane](__m128i matches) {
+            return static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(matches))) << (lane * 16);
+        };
+        masks.quote |= bits(_mm_cmpeq_epi8(bytes, quote));
+        masks.backslash |= bits(_mm_cmpeq_epi8(bytes, backslash));
+        masks.structural |= bits(structural);
+        masks.control |= bits(control);
+    }
+    return masks;
+}
+#else
+BlockMasks classify(const char* block) {
+    BlockMasks masks;
+    for (std::size_t i = 0; i < kBlock; ++i) {
+        auto c = static_cast<unsigned char>(block[i]);
+        std::uint64_t bit = std::uint64_t{1} << i;
+        if (c == '"') {
+            masks.quote |= bit;
+        } else if (c == '\\') {
+            masks.backslash |= bit;
+        } else if (c == '{' || c == '}' || c == '[' || c == ']' || c == ':' || c == ',') {
+            masks.structural |= bit;
+        } else if (c < 0x20) {
+            masks.control |= bit;
+        }
+    }
+    return masks;
+}
+#endif
+
+// Bit i = XOR of bits 0..i: 1 from an opening quote up to its closing one
+std::uint64_t prefix_xor(std::uint64_t bits) {
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+    return bits;
+}
+
+// ────────────────────────────────────────────────────────────
+// Pass 2: decoding
+// ────────────────────────────────────────────────────────────
+
+constexpr int kMaxDepth = 512;
+
+bool is_space(char c) {
+    return c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void append_utf8(std::string& out, std::uint32_t code) {
+    if (code < 0x80) {
+        out += static_cast<char>(code);
+    } else if (code < 0x800) {
+        out += static_cast<char>(0xc0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    } else if (code < 0x10000) {
+        out += static_cast<char>(0xe0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    } else {
+        out += static_cast<char>(0xf0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3f));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3f));
+        out += static_cast<char>(0x80 | (code & 0x3f));
+    }
+}
+
+bool read_hex4(std::string_view text, std::size_t at, std::uint32_t& out) {
+    if (at + 4 > text.size()) {
+        return false;
+    }
+    auto result = std::from_chars(text.data() + at, text.data() + at + 4, out, 16);
+    return result.ec == std::errc{} && result.ptr == text.data() + at + 4;
+}
+
+// RFC 8259 number: -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+// from_chars alone also takes "nan", "inf", "01", ".5" and "5."
+bool is_json_number(std::string_view token) {
+    std::size_t i = 0;
+    auto digits = [&] {
+        std::size_t start = i;
+        while (i < token.size() && token[i] >= '0' && token[i] <= '9') {
+            ++i;
+        }
+        return i > start;
+    };
+    if (i < token.size() && token[i] == '-') {
+        ++i;
+    }
+    if (i < token.size() && token[i] == '0') {
+        ++i;
+    } else if (!digits()) {
+        return false;
+    }
+    if (i < token.size() && token[i] == '.') {
+        ++i;
+        if (!digits()) {
+            return false;
+        }
+    }
+    if (i < token.size() && (token[i] == 'e' || token[i] == 'E')) {
+        ++i;
+        if (i < token.size() && (token[i] == '+' || token[i] == '-')) {
+            ++i;
+        }
+        if (!digits()) {
+            return false;
+        }
+    }
+    return i == token.size();
+}
+
+// Walks the structural index. Each read checks that only whitespace lies
+// between the previous token and the next one, so text the index skipped
+// cannot hide garbage.
+class Decoder {
+public:
+    Decoder(std::string_view text, const std::vector<std::uint32_t>& index) : text_(text), index_(index) {}
+
+    // Next non-space character, 0 at the end
+    char peek() {
+        while (pos_ < text_.size() && is_space(text_[pos_])) {
+            ++pos_;
+        }
+        return pos_ < text_.size() ? text_[pos_] : '\0';
+    }
+
+    bool expect(char c) {
+        if (peek() != c || next_ >= index_.size() || index_[next_] != pos_) {
+            return fail(std::string("expected '") + c + "'");
+        }
+        ++next_;
+        ++pos_;
+        return true;
+    }
+
+    // Contents of the next string; points into the input unless escaped
+    bool string(std::string_view& out) {
+        if (!expect('"')) {
+            return false;
+        }
+        // Pass 1 guarantees the closing quote is the next index entry
+        std::uint32_t close = index_[next_++];
+        std::string_view raw = text_.substr(pos_, close - pos_);
+        pos_ = close + 1;
+        if (std::memchr(raw.data(), '\\', raw.size()) == nullptr) {
+            out = raw;
+            return true;
+        }
+        if (!unescape(raw, scratch_)) {
+            return false;
+        }
+        out = scratch_;
+        return true;
+    }
+
+    bool string(std::string& out) {
+        std::string_view view;
+        if (!string(view)) {
+            return false;
+        }
+        out.assign(view);
+        return true;
+    }
+
+    template <typename T>
+    bool integer(T& out) {
+        std::string_view token;
+        if (!scalar(token, "expected an integer")) {
+            return false;
+        }
+        auto result = std::from_chars(token.data(), token.data() + token.size(), out);
+        if (result.ec != std::errc{} || result.ptr != token.data() + token.size() || !is_json_number(token)) {
+            pos_ -= token.size();
+            return fail("expected an integer");
+        }
+        return true;
+    }
+
+    // {"key": value, ...}; on_key reads the value after the colon
+    template <typename OnKey>
+    bool object(OnKey&& on_key) {
+        if (!expect('{')) {
+            return false;
+        }
+        if (peek() == '}') {
+            return expect('}');
+        }
+        while (true) {
+            std::string_view key;
+            if (!string(key)) {
+                return false;
+            }
+            // The key may live in scratch_, which the value can overwrite
+            std::string_view name = key.data() == scratch_.data() ? std::string_view(key_scratch_.assign(key)) : key;
+            if (!expect(':') || !on_key(name)) {
+                return false;
+            }
+            if (peek() != ',') {
+                return expect('}');
+            }
+            expect(',');
+        }
+    }
+
+    // [value, ...]; on_item reads one value
+    template <typename OnItem>
+    bool array(OnItem&& on_item) {
+        if (!expect('[')) {
+            return false;
+        }
+        if (peek() == ']') {
+            return expect(']');
+        }
+        while (true) {
+            if (!on_item()) {
+                return false;
+            }
+            if (peek() != ',') {
+                return expect(']');
+            }
+            expect(',');
+        }
+    }
+
+    bool skip_value(int depth = 0) {
+        if (depth > kMaxDepth) {
+            return fail("nesting too deep");
+        }
+        switch (peek()) {
+        case '{':
+            return object([&](std::string_view) { return skip_value(depth + 1); });
+        case '[':
+            return array([&] { return skip_value(depth + 1); });
+        case '"': {
+            std::string_view ignored;
+            return string(ignored);
+        }
+        default:
+            break;
+        }
+        std::string_view token;
+        if (!scalar(token, "invalid value")) {
+            return false;
+        }
+        if (token == "true" || token == "false" || token == "null") {
+            return true;
+        }
+        if (is_json_number(token)) {
+            return true;
+        }
+        pos_ -= token.size();
+        return fail("invalid value");
+    }
+
+    bool finish() {
+        if (peek() != '\0') {
+            return fail("trailing characters");
+        }
+        return true;
+    }
+
+    const std::string& error() const { return error_; }
+
+private:
+    // A number or literal: everything up to the next structural character
+    bool scalar(std::string_view& out, std::string_view what) {
+        peek();
+        std::size_t end = next_ < index_.size() ? index_[next_] : text_.size();
+        std::size_t start = pos_;
+        while (pos_ < end && !is_space(text_[pos_])) {
+            char c = text_[pos_];
+            if (c == '"' || c == '\\' || static_cast<unsigned char>(c) < 0x20) {
+                return fail(what);
+            }
+            ++pos_;
+        }
+        if (pos_ == start) {
+            return fail(what);
+        }
+        out = text_.substr(start, pos_ - start);
+        return true;
+    }
+
+    bool unescape(std::string_view raw, std::string& out) {
+        out.clear();
+        out.reserve(raw.size());
+        for (std::size_t i = 0; i < raw.size(); ++i) {
+            if (raw[i] != '\\') {
+                out += raw[i];
+                continue;
+            }
+            if (++i == raw.size()) {
+                return fail("bad escape");
+            }
+            switch (raw[i]) {
+            case '"': out += '"'; break;
+            case '\\': out += '\\'; break;
+            case '/': out += '/'; break;
+            case 'b': out += '\b'; break;
+            case 'f': out += '\f'; break;
+            case 'n': out += '\n'; break;
+            case 'r': out += '\r'; break;
+            case 't': out += '\t'; break;
+            case 'u': {
+                std::uint32_t code = 0;
+                if (!read_hex4(raw, i + 1, code)) {
+                    return fail("bad \\u escape");
+                }
+                i += 4;
+                if (code >= 0xdc00 && code <= 0xdfff) {
+                    return fail("unpaired surrogate");
+                }
+                if (code >= 0xd800 && code <= 0xdbff) {
+                    std::uint32_t low = 0;
+                    if (i + 2 >= raw.size() || raw[i + 1] != '\\' || raw[i + 2] != 'u' ||
+                        !read_hex4(raw, i + 3, low) || low < 0xdc00 || low > 0xdfff) {
+                        return fail("unpaired surrogate");
+                    }
+                    i += 6;
+                    code = 0x10000 + ((code - 0xd800) << 10) + (low - 0xdc00);
+                }
+                append_utf8(out, code);
+                break;
+            }
+            default:
+                return fail("bad escape");
+            }
+        }
+        return true;
+    }
+
+    bool fail(std::string_view what) {
+        if (error_.empty()) {
+            error_ = "Malformed JSON at offset " + std::to_string(pos_) + ": " + std::string(what);
+        }
+        return false;
+    }
+
+    std::string_view text_;
+    const std::vector<std::uint32_t>& index_;
+    std::size_t next_ = 0;   // Next index entry to consume
+    std::size_t pos_ = 0;    // Next unread byte
+    std::string scratch_;     // Unescaped string contents
+    std::string key_scratch_;
+    std::string error_;
+};
+
+bool read_metadata(Decoder& in, FileMetadata& metadata) {
+    return in.object([&](std::string_view key) {
+        if (key == "file_path") {
+            return in.string(metadata.file_path);
+        }
+        if (key == "hash") {
+            return in.string(metadata.hash);
+        }
+        if (key == "size") {
+            return in.integer(metadata.size);
+        }
+        if (key == "modified_time") {
+            return in.integer(metadata.modified_time);
+        }
+        if (key == "created_time") {
+            return in.integer(metadata.created_time);
+        }
+        if (key == "sync_state") {
+            int state = 0;
+            if (!in.integer(state)) {
+                return false;
+            }
+            metadata.sync_state = static_cast<metadata::SyncState>(state);
+            return true;
+        }
+        return in.skip_value();
+    });
+}
+
+bool read_metadata_array(Decoder& in, std::vector<FileMetadata>& files) {
+    return in.array([&] { return read_metadata(in, files.emplace_back()); });
+}
+
+} // namespace
+
+Result<std::vector<std::uint32_t>> index_structurals(std::string_view json) {
+    if (json.size() > std::numeric_limits<std::uint32_t>::max()) {
+        return Err<std::vector<std::uint32_t>>(std::string("JSON document too large"));
+    }
+
+    std::vector<std::uint32_t> index;
+    // Snapshot entries have about one structural character per 6 bytes
+    index.reserve(json.size() / 6 + 16);
+
+    std::uint64_t in_string = 0;      // All ones when a block starts inside a string
+    std::uint64_t escape_next = 0;    // Bit 0 set when a block starts escaped
+    char tail[kBlock];
+
+    for (std::size_t offset = 0; offset < json.size(); offset += kBlock) {
+        const char* block = json.data() + offset;
+        if (json.size() - offset < kBlock) {
+            std::memset(tail, ' ', kBlock);
+            std::memcpy(tail, block, json.size() - offset);
+            block = tail;
+        }
+        BlockMasks masks = classify(block);
+
+        // A backslash escapes the next byte unless it is escaped itself.
+        // Backslashes are rare, so walking them one by one is cheap.
+        std::uint64_t escaped = escape_next;
+        escape_next = 0;
+        for (std::uint64_t rest = masks.backslash; rest != 0; rest &= rest - 1) {
+            int bit = std::countr_zero(rest);
+            if (escaped & (std::uint64_t{1} << bit)) {
+                continue;
+            }
+            if (bit == 63) {
+                escape_next = 1;
+            } else {
+                escaped |= std::uint64_t{1} << (bit + 1);
+            }
+        }
+
+        std::uint64_t quotes = masks.quote & ~escaped;
+        std::uint64_t strings = prefix_xor(quotes) ^ in_string;
+        in_string = std::uint64_t{0} - (strings >> 63);
+
+        if (masks.control & strings) {
+            auto at = offset + static_cast<std::size_t>(std::countr_zero(masks.control & strings));
+            return Err<std::vector<std::uint32_t>>("Malformed JSON at offset " + std::to_string(at) +
+                                                   ": control character in string");
+        }
+
+        for (std::uint64_t rest = (masks.structural & ~strings) | quotes; rest != 0; rest &= rest - 1) {
+            index.push_back(static_cast<std::uint32_t>(offset + static_cast<std::size_t>(std::countr_zero(rest))));
+        }
+    }
+
+    if (in_string) {
+        return Err<std::vector<std::uint32_t>>(std::string("Malformed JSON: unterminated string"));
+    }
+    return Ok(std::move(index));
+}
+
+Result<std::vector<FileMetadata>> parse_metadata_array(std::string_view json) {
+    auto index = index_structurals(json);
+    if (index.is_error()) {
+        return Err<std::vector<FileMetadata>>(index.error());
+    }
+    Decoder in(json, index.value());
+    std::vector<FileMetadata> files;
+    if (!read_metadata_array(in, files) || !in.finish()) {
+        return Err<std::vector<FileMetadata>>(in.error());
+    }
+    return Ok(std::move(files));
+}
+
+Result<rpc::DiffArgs> parse_diff_request(std::string_view body) {
+    auto index = index_structurals(body);
+    if (index.is_error()) {
+        return Err<rpc::DiffArgs>(index.error());
+    }
+    Decoder in(body, index.value());
+    rpc::DiffArgs args;
+    bool ok = in.object([&](std::string_view key) {
+        if (key == "session_id") {
+            return in.string(args.session_id);
+        }
+        if (key == "snapshot") {
+            return read_metadata_array(in, args.snapshot);
+        }
+        return in.skip_value();
+    });
+    if (!ok || !in.finish()) {
+        return Err<rpc::DiffArgs>(in.error());
+    }
+    return Ok(std::move(args));
+}
+
+} // namespace dfs::sync
@@ -0,0 +1,137 @@
+#include "dfs/sync/json_writer.hpp"
+
+namespace dfs::sync {
+
+namespace {
+
+// Characters a JSON string cannot hold as themselves
+bool needs_escape(unsigned char c) {
+    return c < 0x20 || c == '"' || c == '\\';
+}
+
+void append_escaped(std::string& out, unsigned char c) {
+    switch (c) {
+    case '"': out += "\\\""; return;
+    case '\\': out += "\\\\"; return;
+    case '\b': out += "\\b"; return;
+    case '\f': out += "\\f"; return;
+    case '\n': out += "\\n"; return;
+    case '\r': out += "\\r"; return;
+    case '\t': out += "\\t"; return;
+    default: break;
+    }
+    static constexpr char kHex[] = "0123456789abcdef";
+    const char escape[] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+    out.append(escape, sizeof(escape));
+}
+
+void append_string(std::string& out, std::string_view text) {
+    out += '"';
+    // Copy clean runs in one append; paths and hashes rarely need escaping
+    std::size_t run = 0;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        auto c = static_cast<unsigned char>(text[i]);
+        if (needs_escape(c)) {
+            out.append(text.data() + run, i - run);
+            append_escaped(out, c);
+            run = i + 1;
+        }
+    }
+    out.append(text.data() + run, text.size() - run);
+    out += '"';
+}
+
+} // namespace
+
+JsonWriter& JsonWriter::open(char bracket) {
+    separate();
+    out_ += bracket;
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::close(char bracket) {
+    out_ += bracket;
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::key(std::string_view name) {
+    separate();
+    append_string(out_, name);
+    out_ += ':';
+    need_comma_ = false;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(std::string_view text) {
+    separate();
+    append_string(out_, text);
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(bool flag) {
+    separate();
+    out_ += flag ? "true" : "false";
+    need_comma_ = true;
+    return *this;
+}
+
+JsonWriter& JsonWriter::value(const std::vector<std::string>& strings) {
+    begin_array();
+    for (const auto& text : strings) {
+        value(text);
+    }
+    return end_array();
+}
+
+void write_json(JsonWriter& out, const FileMetadata& metadata) {
+    out.begin_object()
+        .field("file_path", metadata.file_path)
+        .field("hash", metadata.hash)
+        .field("size", metadata.size)
+        .field("modified_time", metadata.modified_time)
+        .field("created_time", metadata.created_time)
+        .field("sync_state", static_cast<int>(metadata.sync_state))
+        .end_object();
+}
+
+void write_json(JsonWriter& out, const SyncSessionInfo& info) {
+    out.begin_object()
+        .field("session_id", info.session_id)
+        .field("client_id", info.client_id)
+        .field("files_pending", info.files_pending)
+        .field("bytes_pending", info.bytes_pending)
+        .field("state", static_cast<int>(info.state))
+        .field("last_error", info.last_error)
+        .end_object();
+}
+
+void write_json(JsonWriter& out, const DiffResponse& diff) {
+    out.begin_object()
+        .field("files_to_upload", diff.files_to_upload)
+        .field("files_to_download", diff.files_to_download)
+        .field("files_to_delete_remote", diff.files_to_delete_remote)
+        .end_object();
+}
+
+void write_metadata_array(const std::vector<FileMetadata>& files, std::string& out) {
+    // One allocation for the typical listing: the fixed text of an entry
+    // (keys, numbers, punctuation) is about 120 bytes
+    std::size_t estimate = 2;
+    for (const auto& metadata : files) {
+        estimate += 120 + metadata.file_path.size() + metadata.hash.size();
+    }
+    out.clear();
+    out.reserve(estimate);
+
+    JsonWriter writer(out);
+    writer.begin_array();
+    for (const auto& metadata : files) {
+        write_json(writer, metadata);
+    }
+    writer.end_array();
+}
+
+} // namespace dfs::sync
@@ -1,6 +1,6 @@
 #include "dfs/sync/merkle_tree.hpp"
+#include "dfs/core/hex.hpp"
 
-#include <iomanip>
 #include <iterator>
 #include <set>
 #include <sstream>
@@ -18,11 +18,7 @@ std::string combine_hashes(const std::map<std::string, std::string>& leaves) {
         aggregate << path << ':' << hash << ';';
     }
     const auto combined = aggregate.str();
-    const std::size_t raw_hash = std::hash<std::string>{}(combined);
-
-    std::ostringstream oss;
-    oss << std::hex << std::setw(sizeof(raw_hash) * 2) << std::setfill('0') << raw_hash;
-    return oss.str();
+    return hex::encode_u64(std::hash<std::string>{}(combined));
 }
 
 } // namespace
@@ -71,9 +67,7 @@ std::string MerkleTree::hash_leaf(const metadata::FileMetadata& metadata) {
 }
 
 std::string MerkleTree::hash_to_hex(std::size_t value) {
-    std::ostringstream oss;
-    oss << std::hex << std::setw(sizeof(value) * 2) << std::setfill('0') << value;
-    return oss.str();
+    return hex::encode_u64(value);
 }
 
 void MerkleTree::recompute_root() {
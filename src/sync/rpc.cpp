@@ -0,0 +1,195 @@
+#include "dfs/sync/rpc.hpp"
+#include "dfs/metadata/serializer.hpp"
+
+namespace dfs::sync::rpc {
+
+using metadata::Serializer;
+
+namespace {
+
+// Reads fields in order; the first failure sticks and is reported by finish()
+class Reader {
+public:
+    explicit Reader(const std::vector<std::uint8_t>& payload) : payload_(payload) {}
+
+    Reader& string(std::string& out) { return take(Serializer::read_string(payload_, cursor_), out); }
+    Reader& u32(std::uint32_t& out) { return take(Serializer::read_uint32(payload_, cursor_), out); }
+    Reader& bytes(std::vector<std::uint8_t>& out) { return take(Serializer::read_bytes(payload_, cursor_), out); }
+    Reader& metadata(FileMetadata& out) { return take(Serializer::deserialize(payload_, cursor_), out); }
+
+    Reader& strings(std::vector<std::string>& out) {
+        std::uint32_t count = 0;
+        u32(count);
+        // Every string takes at least its length prefix: a count the
+        // payload cannot hold is corrupt, not a reason to allocate
+        if (error_.empty() && count > (payload_.size() - cursor_) / 4) {
+            error_ = "Bad string count";
+        }
+        for (std::uint32_t i = 0; error_.empty() && i < count; ++i) {
+            string(out.emplace_back());
+        }
+        return *this;
+    }
+
+    template <typename T>
+    dfs::Result<T> finish(T value, std::string_view what) {
+        if (error_.empty() && cursor_ != payload_.size()) {
+            error_ = "Trailing bytes";
+        }
+        if (!error_.empty()) {
+            return dfs::Err<T>("Malformed " + std::string(what) + ": " + error_);
+        }
+        return dfs::Ok(std::move(value));
+    }
+
+    bool ok() const { return error_.empty(); }
+    std::size_t remaining() const { return payload_.size() - cursor_; }
+
+private:
+    template <typename R, typename T>
+    Reader& take(R&& result, T& out) {
+        if (!error_.empty()) {
+            return *this;
+        }
+        if (result.is_error()) {
+            error_ = result.error();
+        } else {
+            out = std::move(result.value());
+        }
+        return *this;
+    }
+
+    const std::vector<std::uint8_t>& payload_;
+    std::size_t cursor_ = 0;
+    std::string error_;
+};
+
+void write_strings(std::vector<std::uint8_t>& out, const std::vector<std::string>& strings) {
+    Serializer::write_uint32(out, static_cast<std::uint32_t>(strings.size()));
+    for (const auto& text : strings) {
+        Serializer::write_string(out, text);
+    }
+}
+
+} // namespace
+
+std::vector<std::uint8_t> encode_text(std::string_view text) {
+    std::vector<std::uint8_t> out;
+    out.reserve(4 + text.size());
+    Serializer::write_uint32(out, static_cast<std::uint32_t>(text.size()));
+    out.insert(out.end(), text.begin(), text.end());
+    return out;
+}
+
+dfs::Result<std::string> decode_text(const std::vector<std::uint8_t>& payload) {
+    std::string text;
+    return Reader(payload).string(text).finish(std::move(text), "text payload");
+}
+
+std::vector<std::uint8_t> encode_diff_args(const std::string& session_id, const std::vector<FileMetadata>& snapshot) {
+    std::vector<std::uint8_t> out;
+    Serializer::write_string(out, session_id);
+    Serializer::write_uint32(out, static_cast<std::uint32_t>(snapshot.size()));
+    for (const auto& metadata : snapshot) {
+        Serializer::serialize_into(out, metadata);
+    }
+    return out;
+}
+
+dfs::Result<DiffArgs> decode_diff_args(const std::vector<std::uint8_t>& payload) {
+    DiffArgs args;
+    std::uint32_t count = 0;
+    Reader reader(payload);
+    reader.string(args.session_id).u32(count);
+    if (reader.ok() && count <= reader.remaining()) {
+        args.snapshot.reserve(count);
+    }
+    for (std::uint32_t i = 0; reader.ok() && i < count; ++i) {
+        reader.metadata(args.snapshot.emplace_back());
+    }
+    return reader.finish(std::move(args), "diff request");
+}
+
+std::vector<std::uint8_t> encode_diff_response(const DiffResponse& diff) {
+    std::vector<std::uint8_t> out;
+    write_strings(out, diff.files_to_upload);
+    write_strings(out, diff.files_to_download);
+    write_strings(out, diff.files_to_delete_remote);
+    return out;
+}
+
+dfs::Result<DiffResponse> decode_diff_response(const std::vector<std::uint8_t>& payload) {
+    DiffResponse diff;
+    return Reader(payload)
+        .strings(diff.files_to_upload)
+        .strings(diff.files_to_download)
+        .strings(diff.files_to_delete_remote)
+        .finish(std::move(diff), "diff response");
+}
+
+std::vector<std::uint8_t> encode_chunk(const ChunkEnvelope& chunk) {
+    std::vector<std::uint8_t> out;
+    out.reserve(32 + chunk.session_id.size() + chunk.file_path.size() + chunk.chunk_hash.size() + chunk.data.size());
+    Serializer::write_string(out, chunk.session_id);
+    Serializer::write_string(out, chunk.file_path);
+    Serializer::write_uint32(out, chunk.chunk_index);
+    Serializer::write_uint32(out, chunk.total_chunks);
+    Serializer::write_uint32(out, chunk.chunk_size);
+    Serializer::write_string(out, chunk.chunk_hash);
+    Serializer::write_bytes(out, chunk.data.data(), chunk.data.size());
+    return out;
+}
+
+dfs::Result<ChunkEnvelope> decode_chunk(const std::vector<std::uint8_t>& payload) {
+    ChunkEnvelope chunk;
+    return Reader(payload)
+        .string(chunk.session_id)
+        .string(chunk.file_path)
+        .u32(chunk.chunk_index)
+        .u32(chunk.total_chunks)
+        .u32(chunk.chunk_size)
+        .string(chunk.chunk_hash)
+        .bytes(chunk.data)
+        .finish(std::move(chunk), "chunk");
+}
+
+std::vector<std::uint8_t> encode_complete_args(const CompleteArgs& args) {
+    std::vector<std::uint8_t> out;
+    Serializer::write_string(out, args.session_id);
+    Serializer::write_string(out, args.file_path);
+    Serializer::write_string(out, args.expected_hash);
+    return out;
+}
+
+dfs::Result<CompleteArgs> decode_complete_args(const std::vector<std::uint8_t>& payload) {
+    CompleteArgs args;
+    return Reader(payload)
+        .string(args.session_id)
+        .string(args.file_path)
+        .string(args.expected_hash)
+        .finish(std::move(args), "upload completion");
+}
+
+std::vector<std::uint8_t> encode_metadata(const FileMetadata& metadata) {
+    return Serializer::serialize(metadata);
+}
+
+dfs::Result<FileMetadata> decode_metadata(const std::vector<std::uint8_t>& payload) {
+    FileMetadata metadata;
+    return Reader(payload).metadata(metadata).finish(std::move(metadata), "metadata");
+}
+
+std::vector<std::uint8_t> encode_file_data(const std::string& hash, const std::vector<std::uint8_t>& data) {
+    std::vector<std::uint8_t> out;
+    out.reserve(8 + hash.size() + data.size());
+    Serializer::write_string(out, hash);
+    Serializer::write_bytes(out, data.data(), data.size());
+    return out;
+}
+
+dfs::Result<FileData> decode_file_data(const std::vector<std::uint8_t>& payload) {
+    FileData file;
+    return Reader(payload).string(file.hash).bytes(file.data).finish(std::move(file), "file data");
+}
+
+} // namespace dfs::sync::rpc
@@ -0,0 +1,91 @@
+#include "dfs/sync/snapshot_cache.hpp"
+#include "dfs/core/trace.hpp"
+#include "dfs/sync/merkle_tree.hpp"
+#include "dfs/sync/transfer.hpp"
+
+#include <algorithm>
+
+namespace dfs::sync {
+namespace {
+
+template <typename T>
+void hash_value(FileTransferService::ContentHasher& hasher, const T& value) {
+    hasher.update(reinterpret_cast<const std::uint8_t*>(&value), sizeof(value));
+}
+
+// Hash of the per-file fields the Merkle leaves do not cover, in path
+// order so it does not depend on the store's iteration order
+std::string metadata_fingerprint(const std::vector<metadata::FileMetadata>& files) {
+    std::vector<const metadata::FileMetadata*> sorted;
+    sorted.reserve(files.size());
+    for (const auto& metadata : files) {
+        sorted.push_back(&metadata);
+    }
+    std::sort(sorted.begin(), sorted.end(),
+              [](const auto* a, const auto* b) { return a->file_path < b->file_path; });
+
+    FileTransferService::ContentHasher hasher;
+    for (const auto* metadata : sorted) {
+        hasher.update(reinterpret_cast<const std::uint8_t*>(metadata->file_path.data()),
+                      metadata->file_path.size() + 1);   // With the terminator, as a separator
+        hash_value(hasher, static_cast<std::int64_t>(metadata->modified_time));
+        hash_value(hasher, static_cast<std::int64_t>(metadata->created_time));
+        hash_value(hasher, static_cast<std::int32_t>(metadata->sync_state));
+    }
+    return hasher.hex();
+}
+
+} // namespace
+
+SnapshotCache::SnapshotCache(const metadata::MetadataStore& store, Serializer serializer)
+    : store_(store), serializer_(std::move(serializer)) {}
+
+std::shared_ptr<const SnapshotCache::Snapshot> SnapshotCache::current() {
+    const std::uint64_t version = store_.version();
+    {
+        std::lock_guard lock(mutex_);
+        if (snapshot_ && snapshot_->version == version) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return snapshot_;
+        }
+    }
+
+    std::lock_guard rebuild_lock(rebuild_mutex_);
+    {
+        // Another reader may have rebuilt it while we waited
+        std::lock_guard lock(mutex_);
+        if (snapshot_ && snapshot_->version >= version) {
+            hits_.fetch_add(1, std::memory_order_relaxed);
+            return snapshot_;
+        }
+    }
+
+    auto fresh = build();
+    std::lock_guard lock(mutex_);
+    snapshot_ = fresh;
+    return fresh;
+}
+
+std::shared_ptr<const SnapshotCache::Snapshot> SnapshotCache::build() {
+    trace::Span span("sync.snapshot_build");
+
+    // Listing and version come from one read of the store, so the
+    // snapshot never pairs old contents with a newer version
+    auto listing = store_.snapshot();
+
+    MerkleTree tree;
+    tree.build(listing.files);
+
+    auto snapshot = std::make_shared<Snapshot>();
+    snapshot->version = listing.version;
+    snapshot->root_hash = tree.root_hash();
+    snapshot->etag = "\"" + (tree.empty() ? std::string("empty")
+                                          : tree.root_hash() + "-" + metadata_fingerprint(listing.files)) + "\"";
+    snapshot->file_count = listing.files.size();
+    serializer_(listing.files, snapshot->body);
+
+    builds_.fetch_add(1, std::memory_order_relaxed);
+    return snapshot;
+}
+
+} // namespace dfs::sync
@@ -1,8 +1,8 @@
 #include "dfs/sync/transfer.hpp"
+#include "dfs/core/hex.hpp"
+#include "dfs/core/trace.hpp"
 
 #include <fstream>
-#include <iomanip>
-#include <sstream>
 
 namespace dfs::sync {
 namespace fs = std::filesystem;
@@ -10,33 +10,18 @@ namespace fs = std::filesystem;
 namespace {
 
 std::string hash_vector(const std::vector<std::uint8_t>& data) {
-    const std::uint64_t offset = 0xcbf29ce484222325ULL;
-    const std::uint64_t prime  = 0x100000001b3ULL;
-    std::uint64_t hash = offset;
-    for (std::uint8_t byte : data) {
-        hash ^= static_cast<std::uint64_t>(byte);
-        hash *= prime;
-    }
-    std::ostringstream oss;
-    oss << std::hex << std::setw(sizeof(hash) * 2) << std::setfill('0') << hash;
-    return oss.str();
+    FileTransferService::ContentHasher hasher;
+    hasher.update(data.data(), data.size());
+    return hasher.hex();
 }
 
 std::string hash_stream(std::ifstream& stream) {
-    const std::uint64_t offset = 0xcbf29ce484222325ULL;
-    const std::uint64_t prime  = 0x100000001b3ULL;
-    std::uint64_t hash = offset;
+    FileTransferService::ContentHasher hasher;
     char buffer[4096];
     while (stream.read(buffer, sizeof(buffer)) || stream.gcount() > 0) {
-        const std::streamsize count = stream.gcount();
-        for (std::streamsize i = 0; i < count; ++i) {
-            hash ^= static_cast<std::uint64_t>(static_cast<unsigned char>(buffer[i]));
-            hash *= prime;
-        }
+        hasher.update(reinterpret_cast<const std::uint8_t*>(buffer), static_cast<std::size_t>(stream.gcount()));
     }
-    std::ostringstream hex;
-    hex << std::hex << std::setw(sizeof(hash) * 2) << std::setfill('0') << hash;
-    return hex.str();
+    return hasher.hex();
 }
 
 } // namespace
@@ -90,6 +75,30 @@ dfs::Result<void> FileTransferService::upload_file(const fs::path& source,
     return dfs::Ok();
 }
 
+std::string FileTransferService::content_hash(const std::vector<std::uint8_t>& data) {
+    return hash_vector(data);
+}
+
+void FileTransferService::ContentHasher::update(const std::uint8_t* data, std::size_t size) {
+    const std::uint64_t prime = 0x100000001b3ULL;
+    for (std::size_t i = 0; i < size; ++i) {
+        hash_ ^= static_cast<std::uint64_t>(data[i]);
+        hash_ *= prime;
+    }
+}
+
+std::string FileTransferService::ContentHasher::hex() const {
+    return hex::encode_u64(hash_);
+}
+
+dfs::Result<std::string> FileTransferService::file_hash(const fs::path& path) {
+    std::ifstream input(path, std::ios::binary);
+    if (!input) {
+        return dfs::Err<std::string>(std::string("Failed to open file: ") + path.string());
+    }
+    return dfs::Ok(hash_stream(input));
+}
+
 dfs::Result<void> FileTransferService::apply_chunk(const ChunkEnvelope& chunk,
                                                     const fs::path& staging_root) const {
     const auto staging_path = make_staging_path(staging_root, chunk.session_id, chunk.file_path);
@@ -97,7 +106,10 @@ dfs::Result<void> FileTransferService::apply_chunk(const ChunkEnvelope& chunk,
         return res;
     }
 
-    if (chunk.chunk_hash != hash_vector(chunk.data)) {
+    trace::Span hash_span("sync.hash", chunk.session_id);
+    bool hash_ok = chunk.chunk_hash == hash_vector(chunk.data);
+    hash_span.end();
+    if (!hash_ok) {
         return dfs::Err<void>(std::string("Chunk hash mismatch for ") + chunk.file_path);
     }
 
@@ -123,6 +135,7 @@ dfs::Result<void> FileTransferService::apply_chunk(const ChunkEnvelope& chunk,
         return dfs::Err<void>(std::string("Failed to write chunk for ") + chunk.file_path);
     }
 
+    trace::Span flush_span("sync.flush", chunk.session_id);
     file.flush();
     return dfs::Ok();
 }
@@ -142,7 +155,10 @@ dfs::Result<void> FileTransferService::finalize_file(const std::string& session_
         return dfs::Err<void>(std::string("Failed to open staging file: ") + staging_path.string());
     }
 
-    if (expected_hash != hash_stream(input)) {
+    trace::Span hash_span("sync.hash", session_id);
+    bool hash_ok = expected_hash == hash_stream(input);
+    hash_span.end();
+    if (!hash_ok) {
         return dfs::Err<void>(std::string("Final hash mismatch for ") + file_path);
     }
 
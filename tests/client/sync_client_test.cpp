@@ -0,0 +1,505 @@
+#include "dfs/client/sync_client.hpp"
+#include "dfs/events/event_bus.hpp"
+#include "dfs/network/http_router.hpp"
+#include "dfs/network/http_server.hpp"
+#include "dfs/network/http_server_epoll.hpp"
+#include "dfs/sync/json_reader.hpp"
+#include "dfs/sync/rpc.hpp"
+#include "dfs/sync/rpc_service.hpp"
+#include "dfs/sync/service.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+
+namespace fs = std::filesystem;
+using namespace dfs::client;
+using dfs::network::HttpContext;
+using dfs::network::HttpResponse;
+using dfs::network::HttpStatus;
+using json = nlohmann::json;
+
+namespace {
+
+fs::path create_temp_dir(const std::string& prefix) {
+    static std::atomic<uint64_t> counter{0};
+    auto dir = fs::temp_directory_path() /
+               (prefix + std::to_string(::getpid()) + "_" + std::to_string(counter.fetch_add(1)));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+void write_file(const fs::path& path, const std::string& content) {
+    fs::create_directories(path.parent_path());
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out << content;
+}
+
+std::string read_file(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    std::ostringstream buffer;
+    buffer << in.rdbuf();
+    return buffer.str();
+}
+
+std::string pattern(size_t size, char seed) {
+    std::string text(size, '\0');
+    for (size_t i = 0; i < size; ++i) {
+        text[i] = static_cast<char>(seed + static_cast<char>(i % 23));
+    }
+    return text;
+}
+
+HttpResponse json_response(HttpStatus status, const json& body) {
+    HttpResponse response(status);
+    response.set_header("Content-Type", "application/json");
+    response.set_body(body.dump());
+    return response;
+}
+
+std::vector<std::uint8_t> from_hex(const std::string& hex) {
+    std::vector<std::uint8_t> out;
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        out.push_back(static_cast<std::uint8_t>(std::stoi(hex.substr(i, 2), nullptr, 16)));
+    }
+    return out;
+}
+
+std::string to_hex(const std::string& data) {
+    static constexpr char kDigits[] = "0123456789abcdef";
+    std::string out;
+    for (unsigned char byte : data) {
+        out += kDigits[byte >> 4];
+        out += kDigits[byte & 0x0f];
+    }
+    return out;
+}
+
+/**
+ * The sync demo server's API over a SyncService, on either server, and
+ * its binary RPC on the epoll server. fail_chunks makes the next N chunk
+ * uploads answer with `fail_status` (over RPC: busy for 503, else an error).
+ */
+class SyncServerFixture : public ::testing::Test {
+protected:
+    void SetUp() override {
+        data_root = create_temp_dir("dfs_client_data_");
+        staging_root = create_temp_dir("dfs_client_stage_");
+        service = std::make_unique<dfs::sync::SyncService>(data_root, staging_root, bus, store,
+                                                           std::chrono::milliseconds(0));
+
+        router.use([this](const HttpContext& ctx, HttpResponse& response) {
+            if (ctx.request.url == "/api/file/upload_chunk" && fail_chunks.load() > 0) {
+                fail_chunks.fetch_sub(1);
+                response = json_response(static_cast<HttpStatus>(fail_status), json{{"error", "injected"}});
+                return false;
+            }
+            return true;
+        });
+        router.post("/api/register", [this](const HttpContext& ctx) {
+            auto payload = json::parse(ctx.request.body_as_string());
+            return json_response(HttpStatus::OK,
+                                 json{{"client_id", service->register_client(payload.value("preferred_id", ""))}});
+        });
+        router.post("/api/sync/start", [this](const HttpContext& ctx) {
+            auto payload = json::parse(ctx.request.body_as_string());
+            auto info = service->start_session(payload.value("client_id", ""));
+            if (info.is_error()) {
+                return json_response(HttpStatus::BAD_REQUEST, json{{"error", info.error()}});
+            }
+            // Streamed, like the demo server: exercises chunked decoding
+            auto body = std::make_shared<std::string>(
+                json{{"session", {{"session_id", info.value().session_id}}}, {"server_snapshot", json::array()}}
+                    .dump());
+            HttpResponse response(HttpStatus::OK);
+            response.set_header("Content-Type", "application/json");
+            response.set_header("ETag", "\"v1\"");
+            response.set_body_stream([body](std::string& chunk) {
+                chunk = *body;
+                return false;
+            });
+            return response;
+        });
+        router.post("/api/sync/diff", [this](const HttpContext& ctx) {
+            auto request = dfs::sync::parse_diff_request(ctx.request.body_as_string());
+            if (request.is_error()) {
+                return json_response(HttpStatus::BAD_REQUEST, json{{"error", request.error()}});
+            }
+            auto diff = service->compute_diff(request.value().session_id, request.value().snapshot);
+            if (diff.is_error()) {
+                return json_response(HttpStatus::BAD_REQUEST, json{{"error", diff.error()}});
+            }
+            return json_response(HttpStatus::OK, json{{"files_to_upload", diff.value().files_to_upload},
+                                                      {"files_to_download", diff.value().files_to_download}});
+        });
+        router.post("/api/file/upload_chunk", [this](const HttpContext& ctx) {
+            auto payload = json::parse(ctx.request.body_as_string());
+            dfs::sync::ChunkEnvelope chunk;
+            chunk.session_id = payload.value("session_id", "");
+            chunk.file_path = payload.value("file_path", "");
+            chunk.chunk_index = payload.value("chunk_index", 0);
+            chunk.total_chunks = payload.value("total_chunks", 0);
+            chunk.chunk_size = payload.value("chunk_size", 0);
+            chunk.data = from_hex(payload.value("data", ""));
+            chunk.chunk_hash = payload.value("chunk_hash", "");
+            ++chunks_received;
+            auto result = service->ingest_chunk(chunk);
+            if (result.is_error()) {
+                return json_response(HttpStatus::BAD_REQUEST, json{{"error", result.error()}});
+            }
+            return json_response(HttpStatus::OK, json{{"status", "chunk_received"}});
+        });
+        router.post("/api/file/upload_complete", [this](const HttpContext& ctx) {
+            auto payload = json::parse(ctx.request.body_as_string());
+            auto result = service->finalize_upload(payload.value("session_id", ""), payload.value("file_path", ""),
+                                                   payload.value("expected_hash", ""));
+            if (result.is_error()) {
+                return json_response(HttpStatus::BAD_REQUEST, json{{"error", result.error()}});
+            }
+            return json_response(HttpStatus::OK, json{{"file_path", result.value().file_path}});
+        });
+        router.post("/api/file/download", [this](const HttpContext& ctx) {
+            auto payload = json::parse(ctx.request.body_as_string());
+            ++http_downloads;
+            std::string content = read_file(data_root / payload.value("file_path", ""));
+            std::vector<std::uint8_t> bytes(content.begin(), content.end());
+            return json_response(HttpStatus::OK, json{{"data", to_hex(content)},
+                                                      {"hash", dfs::sync::FileTransferService::content_hash(bytes)}});
+        });
+    }
+
+    void TearDown() override {
+        if (epoll_server) {
+            epoll_server->stop();
+        }
+        if (pool_server) {
+            pool_server->stop();
+        }
+        if (server_thread.joinable()) {
+            server_thread.join();
+        }
+        rpc_pool.shutdown();   // Requests still running use the service
+        fs::remove_all(data_root);
+        fs::remove_all(staging_root);
+        for (const auto& dir : client_dirs) {
+            fs::remove_all(dir);
+        }
+    }
+
+    template <typename Server>
+    uint16_t start(Server& server) {
+        server.set_handler([this](const dfs::network::HttpRequest& request) { return router.handle_request(request); });
+        EXPECT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+        server_thread = std::thread([&server] { server.serve_forever(); });
+        while (!server.is_running()) {
+            std::this_thread::yield();
+        }
+        return server.get_port();
+    }
+
+    uint16_t start_epoll() {
+        epoll_server = std::make_unique<dfs::network::HttpServerEpoll>(2);
+        return start(*epoll_server);
+    }
+
+    uint16_t start_epoll_rpc() {
+        epoll_server = std::make_unique<dfs::network::HttpServerEpoll>(2);
+        rpc_service = std::make_unique<dfs::sync::SyncRpcService>(*service, rpc_pool);
+        epoll_server->set_rpc_handler([this](dfs::network::RpcRequest request, dfs::network::RpcReply reply) {
+            if (request.type == static_cast<uint8_t>(dfs::sync::rpc::Op::UploadChunk)) {
+                if (fail_chunks.load() > 0) {
+                    fail_chunks.fetch_sub(1);
+                    return reply.fail("injected", fail_status == 503);
+                }
+                ++chunks_received;
+            }
+            rpc_service->handle(std::move(request), std::move(reply));
+        });
+        return start(*epoll_server);
+    }
+
+    uint16_t start_thread_pool() {
+        pool_server = std::make_unique<dfs::network::HttpServer>(4);
+        return start(*pool_server);
+    }
+
+    SyncClientConfig config(uint16_t port) {
+        SyncClientConfig cfg;
+        cfg.port = port;
+        cfg.chunk_size = 4096;
+        cfg.retry.initial_backoff = std::chrono::milliseconds(1);
+        cfg.retry.max_backoff = std::chrono::milliseconds(5);
+        cfg.timeout = std::chrono::seconds(5);
+        return cfg;
+    }
+
+    fs::path client_dir() {
+        client_dirs.push_back(create_temp_dir("dfs_client_root_"));
+        return client_dirs.back();
+    }
+
+    dfs::events::EventBus bus;
+    dfs::metadata::MetadataStore store;
+    fs::path data_root;
+    fs::path staging_root;
+    std::unique_ptr<dfs::sync::SyncService> service;
+    dfs::network::HttpRouter router;
+
+    std::unique_ptr<dfs::network::HttpServerEpoll> epoll_server;
+    std::unique_ptr<dfs::network::HttpServer> pool_server;
+    dfs::WorkStealingPool rpc_pool{2};
+    std::unique_ptr<dfs::sync::SyncRpcService> rpc_service;
+    std::thread server_thread;
+    std::vector<fs::path> client_dirs;
+
+    std::atomic<int> fail_chunks{0};
+    int fail_status = 503;
+    std::atomic<int> chunks_received{0};
+    std::atomic<int> http_downloads{0};
+};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// Retry policy
+// ════════════════════════════════════════════════════════════
+
+TEST(RetryPolicyTest, BackoffGrowsWithJitterAndCap) {
+    RetryPolicy policy;
+    policy.initial_backoff = std::chrono::milliseconds(100);
+    policy.max_backoff = std::chrono::milliseconds(1000);
+    for (int i = 0; i < 50; ++i) {
+        auto first = policy.backoff(2);
+        EXPECT_GE(first.count(), 50);
+        EXPECT_LE(first.count(), 100);
+        auto third = policy.backoff(4);
+        EXPECT_GE(third.count(), 200);
+        EXPECT_LE(third.count(), 400);
+        EXPECT_LE(policy.backoff(20).count(), 1000);
+    }
+    // Retry-After raises the delay, but not past the cap
+    EXPECT_EQ(policy.backoff(2, std::chrono::milliseconds(700)).count(), 700);
+    EXPECT_EQ(policy.backoff(2, std::chrono::seconds(5)).count(), 1000);
+
+    EXPECT_TRUE(RetryPolicy::retryable(503));
+    EXPECT_TRUE(RetryPolicy::retryable(429));
+    EXPECT_FALSE(RetryPolicy::retryable(400));
+    EXPECT_FALSE(RetryPolicy::retryable(200));
+}
+
+// ════════════════════════════════════════════════════════════
+// Sync against a server
+// ════════════════════════════════════════════════════════════
+
+TEST_F(SyncServerFixture, UploadsChangesOnceOverPipelinedConnection) {
+    SyncClientConfig cfg = config(start_epoll());
+    cfg.upload_window = 8;
+    fs::path root = client_dir();
+    write_file(root / "docs/big.bin", pattern(100 * 1024 + 17, 'a'));   // 26 chunks
+    write_file(root / "notes.txt", "hello");
+    write_file(root / "empty.txt", "");
+
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_EQ(report.value().files_uploaded, 3u);
+    EXPECT_EQ(report.value().chunks_uploaded, 28u);
+    EXPECT_EQ(report.value().bytes_uploaded, 100u * 1024 + 17 + 5);
+    EXPECT_EQ(report.value().retries, 0u);
+    // Keep-alive: register, start, diff and the upload pipeline share it
+    EXPECT_LE(report.value().connections_opened, 2u);
+
+    EXPECT_EQ(read_file(data_root / "docs/big.bin"), pattern(100 * 1024 + 17, 'a'));
+    EXPECT_EQ(read_file(data_root / "notes.txt"), "hello");
+    EXPECT_TRUE(fs::exists(data_root / "empty.txt"));
+
+    // Unchanged files hash the same on both sides: nothing to do
+    auto again = client.sync();
+    ASSERT_TRUE(again.is_ok()) << again.error();
+    EXPECT_EQ(again.value().files_uploaded, 0u);
+    EXPECT_EQ(again.value().files_downloaded, 0u);
+
+    write_file(root / "notes.txt", "hello again");
+    auto changed = client.sync();
+    ASSERT_TRUE(changed.is_ok()) << changed.error();
+    EXPECT_EQ(changed.value().files_uploaded, 1u);
+    EXPECT_EQ(read_file(data_root / "notes.txt"), "hello again");
+}
+
+TEST_F(SyncServerFixture, DownloadsServerFilesInParallel) {
+    SyncClientConfig cfg = config(start_epoll());
+    fs::path source = client_dir();
+    for (int i = 0; i < 12; ++i) {
+        write_file(source / ("dir" + std::to_string(i % 3)) / ("file" + std::to_string(i)),
+                   pattern(3000 + i * 500, static_cast<char>('A' + i)));
+    }
+    SyncClient uploader(source, cfg);
+    ASSERT_TRUE(uploader.sync().is_ok());
+
+    cfg.download_parallelism = 4;
+    fs::path target = client_dir();
+    SyncClient downloader(target, cfg);
+    auto report = downloader.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_EQ(report.value().files_downloaded, 12u);
+    for (int i = 0; i < 12; ++i) {
+        fs::path relative = fs::path("dir" + std::to_string(i % 3)) / ("file" + std::to_string(i));
+        EXPECT_EQ(read_file(target / relative), read_file(source / relative)) << relative;
+    }
+    EXPECT_FALSE(fs::exists(target / "dir0/file0.dfs-partial"));
+}
+
+TEST_F(SyncServerFixture, RetriesShedChunksWithBackoff) {
+    SyncClientConfig cfg = config(start_epoll());
+    fs::path root = client_dir();
+    write_file(root / "data.bin", pattern(40 * 1024, 'x'));   // 10 chunks
+
+    fail_chunks = 3;
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_GE(report.value().retries, 3u);
+    EXPECT_EQ(chunks_received.load(), 10);
+    EXPECT_EQ(read_file(data_root / "data.bin"), pattern(40 * 1024, 'x'));
+}
+
+TEST_F(SyncServerFixture, GivesUpAfterMaxAttempts) {
+    SyncClientConfig cfg = config(start_epoll());
+    cfg.retry.max_attempts = 3;
+    fs::path root = client_dir();
+    write_file(root / "data.bin", "payload");
+
+    fail_status = 500;
+    fail_chunks = 1000;
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_error());
+    EXPECT_NE(report.error().find("HTTP 500"), std::string::npos) << report.error();
+}
+
+TEST_F(SyncServerFixture, ClientErrorsAreNotRetried) {
+    SyncClientConfig cfg = config(start_epoll());
+    fs::path root = client_dir();
+    write_file(root / "data.bin", "payload");
+
+    fail_status = 400;
+    fail_chunks = 1;
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_error());
+    EXPECT_NE(report.error().find("HTTP 400: injected"), std::string::npos) << report.error();
+    EXPECT_EQ(fail_chunks.load(), 0);
+}
+
+TEST_F(SyncServerFixture, WorksWithServerThatClosesEachConnection) {
+    SyncClientConfig cfg = config(start_thread_pool());
+    cfg.upload_window = 8;
+    fs::path root = client_dir();
+    write_file(root / "big.bin", pattern(64 * 1024, 'q'));   // 16 chunks
+    write_file(root / "small.txt", "tiny");
+
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_EQ(report.value().files_uploaded, 2u);
+    EXPECT_EQ(read_file(data_root / "big.bin"), pattern(64 * 1024, 'q'));
+    EXPECT_EQ(read_file(data_root / "small.txt"), "tiny");
+}
+
+// ════════════════════════════════════════════════════════════
+// Binary RPC transport
+// ════════════════════════════════════════════════════════════
+
+TEST_F(SyncServerFixture, RpcTransportSyncsOverOneConnection) {
+    SyncClientConfig cfg = config(start_epoll_rpc());
+    cfg.transport = SyncTransport::Rpc;
+    cfg.upload_window = 8;
+    fs::path source = client_dir();
+    write_file(source / "docs/big.bin", pattern(100 * 1024 + 17, 'a'));   // 26 chunks
+    write_file(source / "notes.txt", "hello");
+    write_file(source / "empty.txt", "");
+
+    SyncClient uploader(source, cfg);
+    auto report = uploader.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_EQ(report.value().files_uploaded, 3u);
+    EXPECT_EQ(report.value().chunks_uploaded, 28u);
+    EXPECT_EQ(report.value().retries, 0u);
+    EXPECT_EQ(report.value().connections_opened, 1u);
+    EXPECT_EQ(chunks_received.load(), 28);
+    EXPECT_EQ(read_file(data_root / "docs/big.bin"), pattern(100 * 1024 + 17, 'a'));
+    EXPECT_TRUE(fs::exists(data_root / "empty.txt"));
+
+    auto again = uploader.sync();
+    ASSERT_TRUE(again.is_ok()) << again.error();
+    EXPECT_EQ(again.value().files_uploaded, 0u);
+    EXPECT_EQ(again.value().connections_opened, 0u);   // Still the same connection
+
+    cfg.download_parallelism = 4;
+    fs::path target = client_dir();
+    SyncClient downloader(target, cfg);
+    auto downloaded = downloader.sync();
+    ASSERT_TRUE(downloaded.is_ok()) << downloaded.error();
+    EXPECT_EQ(downloaded.value().files_downloaded, 3u);
+    EXPECT_EQ(read_file(target / "docs/big.bin"), pattern(100 * 1024 + 17, 'a'));
+    EXPECT_EQ(read_file(target / "notes.txt"), "hello");
+    EXPECT_TRUE(fs::exists(target / "empty.txt"));
+}
+
+TEST_F(SyncServerFixture, RpcTransportDownloadsOversizedFilesOverHttp) {
+    SyncClientConfig cfg = config(start_epoll_rpc());
+    cfg.transport = SyncTransport::Rpc;
+    rpc_service->set_max_download_size(8 * 1024);
+    fs::path source = client_dir();
+    write_file(source / "big.bin", pattern(20 * 1024, 'b'));
+    write_file(source / "small.txt", "small");
+    ASSERT_TRUE(SyncClient(source, cfg).sync().is_ok());
+
+    fs::path target = client_dir();
+    SyncClient downloader(target, cfg);
+    auto report = downloader.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_EQ(report.value().files_downloaded, 2u);
+    EXPECT_EQ(report.value().bytes_downloaded, 20u * 1024 + 5);
+    EXPECT_EQ(http_downloads.load(), 1);   // Only the file over the limit
+    EXPECT_EQ(read_file(target / "big.bin"), pattern(20 * 1024, 'b'));
+    EXPECT_EQ(read_file(target / "small.txt"), "small");
+}
+
+TEST_F(SyncServerFixture, RpcTransportRetriesBusyReplies) {
+    SyncClientConfig cfg = config(start_epoll_rpc());
+    cfg.transport = SyncTransport::Rpc;
+    fs::path root = client_dir();
+    write_file(root / "data.bin", pattern(40 * 1024, 'x'));   // 10 chunks
+
+    fail_chunks = 3;
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_ok()) << report.error();
+    EXPECT_GE(report.value().retries, 3u);
+    EXPECT_EQ(chunks_received.load(), 10);
+    EXPECT_EQ(read_file(data_root / "data.bin"), pattern(40 * 1024, 'x'));
+}
+
+TEST_F(SyncServerFixture, RpcTransportErrorRepliesAreFinal) {
+    SyncClientConfig cfg = config(start_epoll_rpc());
+    cfg.transport = SyncTransport::Rpc;
+    fs::path root = client_dir();
+    write_file(root / "data.bin", "payload");
+
+    fail_status = 400;
+    fail_chunks = 1;
+    SyncClient client(root, cfg);
+    auto report = client.sync();
+    ASSERT_TRUE(report.is_error());
+    EXPECT_NE(report.error().find("upload chunk failed: injected"), std::string::npos) << report.error();
+    EXPECT_EQ(fail_chunks.load(), 0);
+}
@@ -0,0 +1,102 @@
+#include "dfs/core/hex.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <random>
+
+using dfs::hex::Kernel;
+
+namespace {
+
+constexpr Kernel kKernels[] = {Kernel::Scalar, Kernel::Ssse3, Kernel::Avx2};
+
+std::vector<std::uint8_t> random_bytes(std::size_t size, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::vector<std::uint8_t> out(size);
+    for (auto& byte : out) {
+        byte = static_cast<std::uint8_t>(rng());
+    }
+    return out;
+}
+
+// The formatting the codec replaced
+std::string reference_hex(const std::vector<std::uint8_t>& data) {
+    std::string out;
+    char digits[3];
+    for (auto byte : data) {
+        std::snprintf(digits, sizeof(digits), "%02x", byte);
+        out += digits;
+    }
+    return out;
+}
+
+} // namespace
+
+TEST(HexTest, EveryKernelRoundTripsEveryLength) {
+    for (Kernel kernel : kKernels) {
+        if (!dfs::hex::supported(kernel)) {
+            continue;
+        }
+        // Lengths around the 16- and 32-byte blocks exercise every tail
+        for (std::size_t size = 0; size < 200; ++size) {
+            auto data = random_bytes(size, static_cast<unsigned>(size));
+            std::string text = dfs::hex::encode(data, kernel);
+            ASSERT_EQ(text, reference_hex(data)) << "kernel " << static_cast<int>(kernel) << " size " << size;
+
+            auto back = dfs::hex::decode(text, kernel);
+            ASSERT_TRUE(back.is_ok()) << back.error();
+            EXPECT_EQ(back.value(), data) << "kernel " << static_cast<int>(kernel) << " size " << size;
+        }
+    }
+}
+
+TEST(HexTest, EncodeAppendsAndDecodeAcceptsUpperCase) {
+    std::string out = "data=";
+    dfs::hex::encode_to(out, std::vector<std::uint8_t>{0x00, 0xab, 0xff});
+    EXPECT_EQ(out, "data=00abff");
+
+    for (Kernel kernel : kKernels) {
+        if (!dfs::hex::supported(kernel)) {
+            continue;
+        }
+        std::string upper(100, 'A');
+        upper += "0F9e";
+        auto decoded = dfs::hex::decode(upper, kernel);
+        ASSERT_TRUE(decoded.is_ok()) << decoded.error();
+        EXPECT_EQ(decoded.value().front(), 0xaa);
+        EXPECT_EQ(decoded.value()[50], 0x0f);
+        EXPECT_EQ(decoded.value().back(), 0x9e);
+    }
+}
+
+TEST(HexTest, DecodeReportsTheFirstBadDigit) {
+    const char bad_chars[] = {'g', 'G', '/', ':', '@', '`', ' ', '\0', '\x80', '\xff'};
+    for (Kernel kernel : kKernels) {
+        if (!dfs::hex::supported(kernel)) {
+            continue;
+        }
+        for (std::size_t at : {0u, 1u, 15u, 31u, 32u, 63u, 64u, 100u, 127u}) {
+            for (char c : bad_chars) {
+                std::string text(130, '7');
+                text[at] = c;
+                text[at + 1] = 'z';   // A later bad digit is not the one reported
+                std::vector<std::uint8_t> out;
+                auto decoded = dfs::hex::decode_to(text, out, kernel);
+                ASSERT_TRUE(decoded.is_error());
+                EXPECT_EQ(decoded.error(), "Invalid hex digit at offset " + std::to_string(at))
+                    << "kernel " << static_cast<int>(kernel) << " char " << static_cast<int>(c);
+            }
+        }
+    }
+
+    auto odd = dfs::hex::decode("abc");
+    ASSERT_TRUE(odd.is_error());
+    EXPECT_NE(odd.error().find("Odd-length"), std::string::npos);
+}
+
+TEST(HexTest, EncodesU64AsSixteenDigits) {
+    EXPECT_EQ(dfs::hex::encode_u64(0), "0000000000000000");
+    EXPECT_EQ(dfs::hex::encode_u64(0xcbf29ce484222325ULL), "cbf29ce484222325");
+    EXPECT_EQ(dfs::hex::encode_u64(0x1f), "000000000000001f");
+}
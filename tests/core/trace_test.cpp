@@ -0,0 +1,116 @@
+#include "dfs/core/trace.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+using dfs::trace::Span;
+using dfs::trace::SpanRecord;
+using dfs::trace::Tracer;
+
+namespace {
+
+// The tracer is process-wide; every test starts from an empty, enabled one
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::instance().clear();
+        Tracer::instance().enable();
+    }
+
+    void TearDown() override {
+        Tracer::instance().disable();
+        Tracer::instance().clear();
+    }
+};
+
+} // namespace
+
+TEST_F(TraceTest, DisabledSpansRecordNothing) {
+    Tracer::instance().disable();
+    {
+        Span span("ignored");
+    }
+    EXPECT_TRUE(Tracer::instance().collect().empty());
+}
+
+TEST_F(TraceTest, RecordsNestedSpansWithSessionTag) {
+    std::string session = "session-42";
+    {
+        Span outer("sync.finalize", session);
+        Span inner("sync.hash");
+    }
+
+    auto spans = Tracer::instance().collect();
+    ASSERT_EQ(spans.size(), 2u);
+    EXPECT_STREQ(spans[0].name, "sync.finalize");
+    EXPECT_EQ(spans[0].session, "session-42");
+    EXPECT_STREQ(spans[1].name, "sync.hash");
+    EXPECT_TRUE(spans[1].session.empty());
+    EXPECT_GE(spans[1].start_ns, spans[0].start_ns);
+    EXPECT_LE(spans[1].start_ns + spans[1].duration_ns, spans[0].start_ns + spans[0].duration_ns);
+}
+
+TEST_F(TraceTest, LongSessionTagIsTruncated) {
+    std::string session(100, 'x');
+    {
+        Span span("truncate", session);
+    }
+    auto spans = Tracer::instance().collect();
+    ASSERT_EQ(spans.size(), 1u);
+    EXPECT_EQ(spans[0].session, std::string(dfs::trace::kSessionTagSize, 'x'));
+}
+
+TEST_F(TraceTest, RingKeepsMostRecentSpans) {
+    for (std::size_t i = 0; i < dfs::trace::kRingCapacity + 100; ++i) {
+        Span span("wrap");
+    }
+    EXPECT_EQ(Tracer::instance().collect().size(), dfs::trace::kRingCapacity);
+}
+
+TEST_F(TraceTest, CollectRunsAlongsideWriters) {
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (int t = 0; t < 4; ++t) {
+        writers.emplace_back([&stop] {
+            do {
+                Span span("busy", "session-w");
+            } while (!stop.load(std::memory_order_relaxed));
+        });
+    }
+
+    for (int i = 0; i < 20; ++i) {
+        for (const auto& span : Tracer::instance().collect()) {
+            ASSERT_STREQ(span.name, "busy");
+            ASSERT_EQ(span.session, "session-w");
+        }
+    }
+    stop = true;
+    for (auto& w : writers) {
+        w.join();
+    }
+
+    auto spans = Tracer::instance().collect();
+    EXPECT_FALSE(spans.empty());
+}
+
+TEST_F(TraceTest, ChromeTraceIsValidJson) {
+    {
+        Span span("http.parse", "quote\"and\\slash");
+    }
+    std::string out;
+    Tracer::instance().write_chrome_trace(out);
+
+    auto doc = nlohmann::json::parse(out);
+    ASSERT_EQ(doc["traceEvents"].size(), 1u);
+    const auto& event = doc["traceEvents"][0];
+    EXPECT_EQ(event["name"], "http.parse");
+    EXPECT_EQ(event["ph"], "X");
+    EXPECT_EQ(event["ts"], 0.0);
+    EXPECT_GE(event["dur"].get<double>(), 0.0);
+    EXPECT_EQ(event["args"]["session"], "quote\"and\\slash");
+}
@@ -0,0 +1,134 @@
+#include "dfs/core/work_stealing_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using dfs::WorkStealingPool;
+
+namespace {
+
+// Spawns two children per level until depth 0; counts leaves
+void fork_tree(WorkStealingPool& pool, int depth, std::atomic<int>& leaves) {
+    if (depth == 0) {
+        leaves.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pool.submit([&pool, depth, &leaves] { fork_tree(pool, depth - 1, leaves); });
+    pool.submit([&pool, depth, &leaves] { fork_tree(pool, depth - 1, leaves); });
+}
+
+} // namespace
+
+TEST(WorkStealingPoolTest, RunsEverySubmittedTask) {
+    WorkStealingPool pool(4);
+    std::atomic<int> count{0};
+    for (int i = 0; i < 10000; ++i) {
+        pool.submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+    }
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 10000);
+    EXPECT_EQ(pool.pending(), 0u);
+}
+
+TEST(WorkStealingPoolTest, TasksSpawnedFromWorkersAreAwaited) {
+    WorkStealingPool pool(3);
+    std::atomic<int> leaves{0};
+    pool.submit([&pool, &leaves] { fork_tree(pool, 12, leaves); });
+    pool.wait_idle();
+    EXPECT_EQ(leaves.load(), 1 << 12);
+}
+
+TEST(WorkStealingPoolTest, DequeGrowsPastInitialCapacity) {
+    WorkStealingPool pool(1);
+    std::atomic<int> count{0};
+    pool.submit([&pool, &count] {
+        for (int i = 0; i < 5000; ++i) {   // All pushed to this worker's own deque
+            pool.submit([&count] { count.fetch_add(1, std::memory_order_relaxed); });
+        }
+    });
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 5000);
+}
+
+TEST(WorkStealingPoolTest, AsyncReturnsValuesAndExceptions) {
+    WorkStealingPool pool(2);
+    auto answer = pool.async([] { return 42; });
+    auto failure = pool.async([]() -> int { throw std::runtime_error("boom"); });
+    EXPECT_EQ(answer.get(), 42);
+    EXPECT_THROW(failure.get(), std::runtime_error);
+}
+
+TEST(WorkStealingPoolTest, AcceptsMoveOnlyTasks) {
+    WorkStealingPool pool(2);
+    auto value = std::make_unique<int>(7);
+    auto result = pool.async([v = std::move(value)] { return *v * 6; });
+    EXPECT_EQ(result.get(), 42);
+}
+
+TEST(WorkStealingPoolTest, ThrowingTaskDoesNotKillWorker) {
+    WorkStealingPool pool(1);
+    std::atomic<int> count{0};
+    pool.submit([] { throw std::runtime_error("ignored"); });
+    pool.submit([&count] { count.fetch_add(1); });
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 1);
+}
+
+TEST(WorkStealingPoolTest, ShutdownFinishesQueuedTasks) {
+    std::atomic<int> count{0};
+    {
+        WorkStealingPool pool(2);
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&count] {
+                std::this_thread::sleep_for(std::chrono::microseconds(50));
+                count.fetch_add(1);
+            });
+        }
+    }   // Destructor shuts down
+    EXPECT_EQ(count.load(), 100);
+}
+
+TEST(WorkStealingPoolTest, IdleWorkersStealFromBusyOnes) {
+    WorkStealingPool pool(4);
+    std::atomic<int> count{0};
+    // Everything lands in worker 0's own deque; the others can only get
+    // work by stealing it.
+    pool.submit([&pool, &count] {
+        for (int i = 0; i < 200; ++i) {
+            pool.submit([&count] {
+                std::this_thread::sleep_for(std::chrono::microseconds(100));
+                count.fetch_add(1);
+            });
+        }
+    });
+    pool.wait_idle();
+    EXPECT_EQ(count.load(), 200);
+    EXPECT_GT(pool.steal_count(), 0u);
+}
+
+TEST(WorkStealingPoolTest, ParkedWorkersWakeForNewWork) {
+    WorkStealingPool pool(2);
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));   // Let workers park
+    std::atomic<int> count{0};
+    for (int round = 0; round < 50; ++round) {
+        pool.submit([&count] { count.fetch_add(1); });
+        pool.wait_idle();
+    }
+    EXPECT_EQ(count.load(), 50);
+}
+
+TEST(WorkStealingPoolTest, CurrentWorkerIdentifiesPoolThreads) {
+    WorkStealingPool pool(2);
+    EXPECT_EQ(pool.current_worker(), -1);
+    auto index = pool.async([&pool] { return pool.current_worker(); });
+    int worker = index.get();
+    EXPECT_GE(worker, 0);
+    EXPECT_LT(worker, 2);
+}
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include "dfs/events/coalescer.hpp"
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace dfs::events;
+
+namespace {
+
+FileChunkReceivedEvent chunk(const std::string& session, const std::string& path,
+                             std::uint32_t index, std::uint32_t total, std::size_t bytes = 100) {
+    return FileChunkReceivedEvent{session, path, index, total, bytes};
+}
+
+} // namespace
+
+TEST(ChunkProgressCoalescer, ZeroWindowPassesEveryChunk) {
+    EventBus bus;
+    std::vector<FileChunkReceivedEvent> seen;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { seen.push_back(e); });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::milliseconds(0));
+    for (std::uint32_t i = 0; i < 5; ++i) {
+        progress.add(chunk("s1", "a.bin", i, 5));
+    }
+
+    EXPECT_EQ(seen.size(), 5u);
+    EXPECT_EQ(progress.coalesced_events(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, MergesChunksWithinWindow) {
+    EventBus bus;
+    std::vector<FileChunkReceivedEvent> seen;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { seen.push_back(e); });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        progress.add(chunk("s1", "a.bin", i, 10));
+    }
+
+    // First chunk goes out immediately, the last one carries the rest
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0].chunk_index, 0u);
+    EXPECT_EQ(seen[0].chunks_merged, 1u);
+    EXPECT_EQ(seen[1].chunk_index, 9u);
+    EXPECT_EQ(seen[1].chunks_merged, 9u);
+    EXPECT_EQ(seen[1].bytes_received, 900u);
+    EXPECT_EQ(progress.coalesced_events(), 8u);
+    EXPECT_EQ(progress.pending(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, CompletesByCountWhenChunksArriveOutOfOrder) {
+    EventBus bus;
+    std::vector<FileChunkReceivedEvent> seen;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { seen.push_back(e); });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    // The highest index arrives early; it must not end the file
+    for (std::uint32_t index : {0u, 4u, 2u, 1u, 3u}) {
+        progress.add(chunk("s1", "a.bin", index, 5));
+    }
+
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[0].chunks_merged, 1u);
+    EXPECT_EQ(seen[1].chunks_merged, 4u);
+    EXPECT_EQ(seen[1].bytes_received, 400u);
+    EXPECT_EQ(progress.pending(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, EmitsAgainAfterWindowElapses) {
+    EventBus bus;
+    int events = 0;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent&) { events++; });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::milliseconds(20));
+    progress.add(chunk("s1", "a.bin", 0, 100));
+    progress.add(chunk("s1", "a.bin", 1, 100));
+    EXPECT_EQ(events, 1);
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(30));
+    progress.add(chunk("s1", "a.bin", 2, 100));
+    EXPECT_EQ(events, 2);
+}
+
+TEST(ChunkProgressCoalescer, KeysBySessionAndFile) {
+    EventBus bus;
+    std::vector<std::string> seen;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) {
+        seen.push_back(e.session_id + ":" + e.file_path);
+    });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    progress.add(chunk("s1", "a.bin", 0, 10));
+    progress.add(chunk("s1", "b.bin", 0, 10));
+    progress.add(chunk("s2", "a.bin", 0, 10));
+    progress.add(chunk("s1", "a.bin", 1, 10));
+
+    EXPECT_EQ(seen, (std::vector<std::string>{"s1:a.bin", "s1:b.bin", "s2:a.bin"}));
+    EXPECT_EQ(progress.pending(), 1u);
+}
+
+TEST(ChunkProgressCoalescer, FlushEmitsPendingBeforeCompletion) {
+    EventBus bus;
+    std::vector<std::string> order;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) {
+        order.push_back("chunk" + std::to_string(e.chunks_merged));
+    });
+    bus.subscribe<FileUploadCompletedEvent>([&](const FileUploadCompletedEvent&) {
+        order.push_back("completed");
+    });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    progress.add(chunk("s1", "a.bin", 0, 10));
+    progress.add(chunk("s1", "a.bin", 1, 10));
+    progress.add(chunk("s1", "a.bin", 2, 10));
+
+    progress.flush("s1", "a.bin");
+    bus.emit(FileUploadCompletedEvent{"s1", "a.bin", "hash", 300});
+
+    EXPECT_EQ(order, (std::vector<std::string>{"chunk1", "chunk2", "completed"}));
+    EXPECT_EQ(progress.pending(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, FlushAllDrainsEveryFile) {
+    EventBus bus;
+    std::size_t bytes = 0;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { bytes += e.bytes_received; });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        progress.add(chunk("s1", "a.bin", i, 10));
+        progress.add(chunk("s1", "b.bin", i, 10));
+    }
+    progress.flush_all();
+
+    EXPECT_EQ(bytes, 800u);  // Nothing lost
+    EXPECT_EQ(progress.pending(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, ResentChunksDoNotCompleteTheFileEarly) {
+    EventBus bus;
+    std::vector<FileChunkReceivedEvent> seen;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { seen.push_back(e); });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    // Chunk 1 is re-sent after a transport error; 4 deliveries, 3 chunks
+    for (std::uint32_t index : {0u, 1u, 1u, 2u}) {
+        progress.add(chunk("s1", "a.bin", index, 4));
+    }
+    EXPECT_EQ(seen.size(), 1u);
+    EXPECT_EQ(progress.duplicate_chunks(), 1u);
+    EXPECT_EQ(progress.tracked_files(), 1u);
+
+    progress.add(chunk("s1", "a.bin", 3, 4));
+    ASSERT_EQ(seen.size(), 2u);
+    EXPECT_EQ(seen[1].chunks_merged, 3u);
+    EXPECT_EQ(seen[0].bytes_received + seen[1].bytes_received, 400u);
+    EXPECT_EQ(progress.tracked_files(), 0u);
+}
+
+TEST(ChunkProgressCoalescer, FlushSessionForgetsItsFilesOnly) {
+    EventBus bus;
+    std::size_t bytes = 0;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { bytes += e.bytes_received; });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1));
+    for (std::uint32_t i = 0; i < 3; ++i) {
+        progress.add(chunk("s1", "a.bin", i, 10));
+        progress.add(chunk("s1", "b.bin", i, 10));
+        progress.add(chunk("s10", "a.bin", i, 10));
+    }
+    progress.flush_session("s1");
+
+    EXPECT_EQ(bytes, 700u);   // s1 in full, the first chunk of s10
+    EXPECT_EQ(progress.tracked_files(), 1u);
+    EXPECT_EQ(progress.pending(), 1u);
+}
+
+TEST(ChunkProgressCoalescer, AbandonedFilesAreSweptAfterIdleTimeout) {
+    EventBus bus;
+    std::size_t bytes = 0;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) { bytes += e.bytes_received; });
+
+    ChunkProgressCoalescer progress(bus, std::chrono::hours(1), std::chrono::milliseconds(20));
+    progress.add(chunk("s1", "abandoned.bin", 0, 10));
+    progress.add(chunk("s1", "abandoned.bin", 1, 10));
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+
+    progress.add(chunk("s2", "b.bin", 0, 10));
+    EXPECT_EQ(progress.tracked_files(), 1u);
+    EXPECT_EQ(bytes, 300u);   // The abandoned file's pending progress went out
+}
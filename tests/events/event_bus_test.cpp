@@ -1,11 +1,33 @@
 #include <gtest/gtest.h>
 #include "dfs/events/event_bus.hpp"
 #include <atomic>
+#include <cstdlib>
+#include <future>
+#include <new>
 #include <thread>
 #include <vector>
 
 using namespace dfs::events;
 
+// Counts heap allocations made by the current thread while enabled
+namespace {
+thread_local bool g_count_allocations = false;
+thread_local size_t g_allocation_count = 0;
+}
+
+void* operator new(std::size_t size) {
+    if (g_count_allocations) {
+        ++g_allocation_count;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
 // Test event types
 struct TestEvent {
     int value;
@@ -38,9 +60,9 @@ TEST(EventBus, MultipleSubscribers) {
 
     int count = 0;
 
-    bus.subscribe<TestEvent>([&](const TestEvent& e) { count++; });
-    bus.subscribe<TestEvent>([&](const TestEvent& e) { count++; });
-    bus.subscribe<TestEvent>([&](const TestEvent& e) { count++; });
+    bus.subscribe<TestEvent>([&](const TestEvent&) { count++; });
+    bus.subscribe<TestEvent>([&](const TestEvent&) { count++; });
+    bus.subscribe<TestEvent>([&](const TestEvent&) { count++; });
 
     bus.emit(TestEvent{1, "test"});
 
@@ -53,8 +75,8 @@ TEST(EventBus, DifferentEventTypes) {
     int test_count = 0;
     int another_count = 0;
 
-    bus.subscribe<TestEvent>([&](const TestEvent& e) { test_count++; });
-    bus.subscribe<AnotherEvent>([&](const AnotherEvent& e) { another_count++; });
+    bus.subscribe<TestEvent>([&](const TestEvent&) { test_count++; });
+    bus.subscribe<AnotherEvent>([&](const AnotherEvent&) { another_count++; });
 
     bus.emit(TestEvent{1, "test"});
     bus.emit(AnotherEvent{3.14});
@@ -68,7 +90,7 @@ TEST(EventBus, Unsubscribe) {
     EventBus bus;
 
     int count = 0;
-    auto id = bus.subscribe<TestEvent>([&](const TestEvent& e) { count++; });
+    auto id = bus.subscribe<TestEvent>([&](const TestEvent&) { count++; });
 
     bus.emit(TestEvent{1, "test"});
     EXPECT_EQ(count, 1);
@@ -94,7 +116,7 @@ TEST(EventBus, ThreadSafety) {
     std::vector<std::thread> threads;
     for (int i = 0; i < 10; ++i) {
         threads.emplace_back([&bus, &count]() {
-            bus.subscribe<TestEvent>([&count](const TestEvent& e) {
+            bus.subscribe<TestEvent>([&count](const TestEvent&) {
                 count++;
             });
         });
@@ -121,7 +143,7 @@ TEST(EventBus, ConcurrentEmit) {
     // Emit from multiple threads
     std::vector<std::thread> threads;
     for (int i = 0; i < 100; ++i) {
-        threads.emplace_back([&bus, i]() {
+        threads.emplace_back([&bus]() {
             bus.emit(TestEvent{1, "test"});
         });
     }
@@ -138,10 +160,10 @@ TEST(EventBus, SubscriberCount) {
 
     EXPECT_EQ(bus.subscriber_count<TestEvent>(), 0);
 
-    auto id1 = bus.subscribe<TestEvent>([](const TestEvent& e) {});
+    auto id1 = bus.subscribe<TestEvent>([](const TestEvent&) {});
     EXPECT_EQ(bus.subscriber_count<TestEvent>(), 1);
 
-    auto id2 = bus.subscribe<TestEvent>([](const TestEvent& e) {});
+    bus.subscribe<TestEvent>([](const TestEvent&) {});
     EXPECT_EQ(bus.subscriber_count<TestEvent>(), 2);
 
     bus.unsubscribe<TestEvent>(id1);
@@ -151,8 +173,8 @@ TEST(EventBus, SubscriberCount) {
 TEST(EventBus, Clear) {
     EventBus bus;
 
-    bus.subscribe<TestEvent>([](const TestEvent& e) {});
-    bus.subscribe<AnotherEvent>([](const AnotherEvent& e) {});
+    bus.subscribe<TestEvent>([](const TestEvent&) {});
+    bus.subscribe<AnotherEvent>([](const AnotherEvent&) {});
 
     EXPECT_EQ(bus.subscriber_count<TestEvent>(), 1);
     EXPECT_EQ(bus.subscriber_count<AnotherEvent>(), 1);
@@ -162,3 +184,230 @@ TEST(EventBus, Clear) {
     EXPECT_EQ(bus.subscriber_count<TestEvent>(), 0);
     EXPECT_EQ(bus.subscriber_count<AnotherEvent>(), 0);
 }
+
+TEST(EventBus, AsyncDispatchRunsOnDispatcherThread) {
+    EventBus bus(AsyncDispatchOptions{2, 64, BackpressurePolicy::Block});
+    EXPECT_TRUE(bus.is_async());
+
+    std::atomic<int> count{0};
+    std::atomic<bool> ran_on_emitter{false};
+    const auto emitter = std::this_thread::get_id();
+
+    bus.subscribe<TestEvent>([&](const TestEvent&) {
+        if (std::this_thread::get_id() == emitter) {
+            ran_on_emitter = true;
+        }
+        count++;
+    });
+
+    for (int i = 0; i < 100; ++i) {
+        bus.emit(TestEvent{i, "async"});
+    }
+    bus.flush();
+
+    EXPECT_EQ(count, 100);
+    EXPECT_FALSE(ran_on_emitter);
+}
+
+TEST(EventBus, AsyncPreservesPerSubscriberOrder) {
+    EventBus bus(AsyncDispatchOptions{3, 16, BackpressurePolicy::Block});
+
+    std::vector<std::vector<int>> received(4);
+    for (auto& list : received) {
+        bus.subscribe<TestEvent>([&list](const TestEvent& e) {
+            list.push_back(e.value);
+        });
+    }
+
+    for (int i = 0; i < 500; ++i) {
+        bus.emit(TestEvent{i, "ordered"});
+    }
+    bus.flush();
+
+    for (const auto& list : received) {
+        ASSERT_EQ(list.size(), 500u);
+        for (int i = 0; i < 500; ++i) {
+            EXPECT_EQ(list[i], i);
+        }
+    }
+}
+
+TEST(EventBus, AsyncDropPolicyDiscardsWhenFull) {
+    EventBus bus(AsyncDispatchOptions{1, 1, BackpressurePolicy::Drop});
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    std::vector<int> received;
+
+    bus.subscribe<TestEvent>([&](const TestEvent& e) {
+        if (e.value == 1) {
+            entered.set_value();
+            release_future.wait();
+        }
+        received.push_back(e.value);
+    });
+
+    bus.emit(TestEvent{1, "blocks dispatcher"});
+    entered.get_future().wait();
+    bus.emit(TestEvent{2, "queued"});
+    bus.emit(TestEvent{3, "dropped"});
+    release.set_value();
+    bus.flush();
+
+    EXPECT_EQ(received, (std::vector<int>{1, 2}));
+    EXPECT_EQ(bus.dropped_events(), 1u);
+}
+
+TEST(EventBus, AsyncCoalescePolicyKeepsLatest) {
+    EventBus bus(AsyncDispatchOptions{1, 1, BackpressurePolicy::Coalesce});
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    std::vector<int> received;
+
+    bus.subscribe<TestEvent>([&](const TestEvent& e) {
+        if (e.value == 1) {
+            entered.set_value();
+            release_future.wait();
+        }
+        received.push_back(e.value);
+    });
+
+    bus.emit(TestEvent{1, "blocks dispatcher"});
+    entered.get_future().wait();
+    bus.emit(TestEvent{2, "replaced"});
+    bus.emit(TestEvent{3, "latest"});
+    release.set_value();
+    bus.flush();
+
+    EXPECT_EQ(received, (std::vector<int>{1, 3}));
+    EXPECT_EQ(bus.coalesced_events(), 1u);
+}
+
+TEST(EventBus, ShutdownFallsBackToSynchronousDelivery) {
+    EventBus bus(AsyncDispatchOptions{});
+
+    int count = 0;
+    bus.subscribe<TestEvent>([&](const TestEvent&) { count++; });
+
+    bus.emit(TestEvent{1, "queued"});
+    bus.shutdown();
+    EXPECT_EQ(count, 1);  // Pending deliveries are drained
+    EXPECT_FALSE(bus.is_async());
+
+    bus.emit(TestEvent{2, "inline"});
+    EXPECT_EQ(count, 2);
+}
+
+TEST(EventBus, AsyncSkipsDeliveriesQueuedBeforeUnsubscribe) {
+    EventBus bus(AsyncDispatchOptions{});
+
+    std::promise<void> entered;
+    std::promise<void> release;
+    auto release_future = release.get_future().share();
+    bus.subscribe<AnotherEvent>([&](const AnotherEvent&) {
+        entered.set_value();
+        release_future.wait();
+    });
+    int late_calls = 0;
+    size_t late = bus.subscribe<TestEvent>([&](const TestEvent&) { late_calls++; });
+
+    bus.emit(AnotherEvent{1.0});
+    entered.get_future().wait();
+    bus.emit(TestEvent{1, "queued behind the blocked handler"});
+    bus.unsubscribe<TestEvent>(late);
+    release.set_value();
+    bus.flush();
+
+    EXPECT_EQ(late_calls, 0);
+}
+
+TEST(EventBus, SyncEmitDoesNotAllocate) {
+    EventBus bus;
+
+    int sum = 0;
+    bus.subscribe<AnotherEvent>([&](const AnotherEvent& e) { sum += static_cast<int>(e.data); });
+    bus.subscribe<AnotherEvent>([&](const AnotherEvent&) { sum += 1; });
+    bus.emit(AnotherEvent{0.0});  // Warm up (first use of the type slot)
+
+    g_allocation_count = 0;
+    g_count_allocations = true;
+    for (int i = 0; i < 10000; ++i) {
+        bus.emit(AnotherEvent{1.0});
+    }
+    g_count_allocations = false;
+
+    EXPECT_EQ(g_allocation_count, 0u);
+    EXPECT_EQ(sum, 20001);  // Warm-up contributed one
+}
+
+TEST(EventBus, SubscribeDuringEmitSeesStableSnapshot) {
+    EventBus bus;
+
+    int outer_calls = 0;
+    int inner_calls = 0;
+    bus.subscribe<TestEvent>([&](const TestEvent&) {
+        outer_calls++;
+        // Adding a handler mid-emit must not affect the current delivery
+        bus.subscribe<TestEvent>([&](const TestEvent&) { inner_calls++; });
+    });
+
+    bus.emit(TestEvent{1, "first"});
+    EXPECT_EQ(outer_calls, 1);
+    EXPECT_EQ(inner_calls, 0);
+
+    bus.emit(TestEvent{2, "second"});
+    EXPECT_EQ(outer_calls, 2);
+    EXPECT_EQ(inner_calls, 1);
+    EXPECT_EQ(bus.subscriber_count<TestEvent>(), 3u);
+}
+
+TEST(EventBus, RetiredListsStayBoundedUnderChurn) {
+    EventBus bus;
+    bus.subscribe<TestEvent>([](const TestEvent&) {});
+
+    for (int i = 0; i < 10000; ++i) {
+        size_t id = bus.subscribe<TestEvent>([](const TestEvent&) {});
+        bus.unsubscribe<TestEvent>(id);
+    }
+    EXPECT_LE(bus.retired_lists(), 2u);
+
+    bus.flush();
+    EXPECT_EQ(bus.retired_lists(), 0u);
+}
+
+TEST(EventBus, ChurnWhileEmittingReclaimsSafely) {
+    EventBus bus;
+    std::atomic<int> calls{0};
+    bus.subscribe<TestEvent>([&](const TestEvent&) { calls++; });
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < 3; ++t) {
+        emitters.emplace_back([&]() {
+            while (!done.load()) {
+                bus.emit(TestEvent{1, "churn"});
+            }
+        });
+    }
+
+    for (int i = 0; i < 5000; ++i) {
+        size_t id = bus.subscribe<TestEvent>([](const TestEvent&) {});
+        bus.unsubscribe<TestEvent>(id);
+    }
+    done = true;
+    for (auto& emitter : emitters) {
+        emitter.join();
+    }
+
+    // Whatever was retired while emits were running is freed by the
+    // next writes once they are gone
+    size_t id = bus.subscribe<TestEvent>([](const TestEvent&) {});
+    bus.unsubscribe<TestEvent>(id);
+    EXPECT_LE(bus.retired_lists(), 2u);
+    bus.flush();
+    EXPECT_EQ(bus.retired_lists(), 0u);
+    EXPECT_GT(calls.load(), 0);
+}
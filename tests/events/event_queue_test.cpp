@@ -1,7 +1,10 @@
 #include <gtest/gtest.h>
 #include "dfs/events/event_queue.hpp"
-#include <thread>
+#include <atomic>
 #include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
 
 using namespace dfs::events;
 
@@ -100,3 +103,224 @@ TEST(ThreadSafeQueue, ProducerConsumer) {
 
     EXPECT_EQ(sum, 4950);  // Sum of 0..99
 }
+
+TEST(ThreadSafeQueue, CapacityRoundsUpToPowerOfTwo) {
+    ThreadSafeQueue<int> queue(100);
+    EXPECT_EQ(queue.capacity(), 128u);
+}
+
+TEST(ThreadSafeQueue, TryPushFailsWhenFull) {
+    ThreadSafeQueue<int> queue(4);
+
+    for (int i = 0; i < 4; ++i) {
+        int item = i;
+        EXPECT_TRUE(queue.try_push(item));
+    }
+    int extra = 99;
+    EXPECT_FALSE(queue.try_push(extra));
+    EXPECT_EQ(queue.size(), 4u);
+
+    EXPECT_EQ(queue.pop().value(), 0);
+    EXPECT_TRUE(queue.try_push(extra));
+}
+
+TEST(ThreadSafeQueue, PushBlocksUntilSpaceFreed) {
+    ThreadSafeQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+
+    std::atomic<bool> pushed{false};
+    std::thread producer([&]() {
+        queue.push(3);  // Full: must wait for the consumer
+        pushed = true;
+    });
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(pushed.load());
+
+    EXPECT_EQ(queue.pop().value(), 1);
+    producer.join();
+    EXPECT_TRUE(pushed.load());
+    EXPECT_EQ(queue.pop().value(), 2);
+    EXPECT_EQ(queue.pop().value(), 3);
+}
+
+TEST(ThreadSafeQueue, ShutdownUnblocksFullPush) {
+    ThreadSafeQueue<int> queue(2);
+    queue.push(1);
+    queue.push(2);
+
+    std::thread producer([&]() {
+        EXPECT_FALSE(queue.push(3));
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    queue.shutdown();
+    producer.join();
+
+    // Items queued before shutdown are still delivered
+    EXPECT_EQ(queue.pop().value(), 1);
+    EXPECT_EQ(queue.pop().value(), 2);
+    EXPECT_FALSE(queue.pop().has_value());
+}
+
+TEST(ThreadSafeQueue, PopForWakesOnPush) {
+    ThreadSafeQueue<int> queue;
+
+    std::thread producer([&]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        queue.push(7);
+    });
+
+    auto val = queue.pop_for(std::chrono::seconds(5));
+    producer.join();
+    ASSERT_TRUE(val.has_value());
+    EXPECT_EQ(val.value(), 7);
+}
+
+TEST(ThreadSafeQueue, MultiProducerMultiConsumer) {
+    ThreadSafeQueue<std::unique_ptr<int>> queue(64);
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 4;
+    constexpr int kPerProducer = 20000;
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&]() {
+            while (auto item = queue.pop()) {
+                sum += **item;
+                received++;
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&]() {
+            for (int i = 1; i <= kPerProducer; ++i) {
+                queue.push(std::make_unique<int>(i));
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    queue.shutdown();
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    EXPECT_EQ(received.load(), kProducers * kPerProducer);
+    EXPECT_EQ(sum.load(), static_cast<long long>(kProducers) * kPerProducer * (kPerProducer + 1) / 2);
+}
+
+TEST(ThreadSafeQueue, PushBulkAndPopBulkPreserveOrder) {
+    ThreadSafeQueue<int> queue(16);
+
+    std::vector<int> batch{1, 2, 3, 4, 5};
+    EXPECT_EQ(queue.push_bulk(batch.begin(), batch.end()), 5u);
+    EXPECT_EQ(queue.size(), 5u);
+
+    auto first = queue.pop_bulk(3, std::chrono::milliseconds(10));
+    EXPECT_EQ(first, (std::vector<int>{1, 2, 3}));
+
+    auto rest = queue.pop_bulk(10, std::chrono::milliseconds(10));
+    EXPECT_EQ(rest, (std::vector<int>{4, 5}));
+}
+
+TEST(ThreadSafeQueue, PopBulkTimesOutWhenEmpty) {
+    ThreadSafeQueue<int> queue;
+
+    auto start = std::chrono::steady_clock::now();
+    auto items = queue.pop_bulk(8, std::chrono::milliseconds(50));
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(items.empty());
+    EXPECT_GE(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 45);
+}
+
+TEST(ThreadSafeQueue, PopBulkAppendsToReusedBuffer) {
+    ThreadSafeQueue<int> queue;
+    for (int i = 0; i < 4; ++i) {
+        queue.push(i);
+    }
+
+    std::vector<int> buffer{-1};
+    EXPECT_EQ(queue.pop_bulk(buffer, 16, std::chrono::milliseconds(10)), 4u);
+    EXPECT_EQ(buffer, (std::vector<int>{-1, 0, 1, 2, 3}));
+}
+
+TEST(ThreadSafeQueue, PushBulkLargerThanCapacityWaitsForConsumer) {
+    ThreadSafeQueue<int> queue(8);
+
+    std::vector<int> batch(100);
+    for (int i = 0; i < 100; ++i) {
+        batch[i] = i;
+    }
+
+    std::vector<int> received;
+    std::thread consumer([&]() {
+        while (received.size() < 100) {
+            queue.pop_bulk(received, 16, std::chrono::seconds(5));
+        }
+    });
+
+    EXPECT_EQ(queue.push_bulk(batch.begin(), batch.end()), 100u);
+    consumer.join();
+    EXPECT_EQ(received, batch);
+}
+
+TEST(ThreadSafeQueue, BulkMultiProducerMultiConsumer) {
+    ThreadSafeQueue<std::unique_ptr<int>> queue(128);
+    constexpr int kProducers = 4;
+    constexpr int kConsumers = 3;
+    constexpr int kBatches = 500;
+    constexpr int kBatchSize = 37;
+
+    std::atomic<long long> sum{0};
+    std::atomic<int> received{0};
+
+    std::vector<std::thread> consumers;
+    for (int c = 0; c < kConsumers; ++c) {
+        consumers.emplace_back([&]() {
+            std::vector<std::unique_ptr<int>> batch;
+            for (;;) {
+                batch.clear();
+                if (queue.pop_bulk(batch, 64, std::chrono::milliseconds(100)) == 0) {
+                    if (received.load() == kProducers * kBatches * kBatchSize) {
+                        return;
+                    }
+                    continue;
+                }
+                for (auto& item : batch) {
+                    sum += *item;
+                }
+                received += static_cast<int>(batch.size());
+            }
+        });
+    }
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&]() {
+            for (int b = 0; b < kBatches; ++b) {
+                std::vector<std::unique_ptr<int>> batch;
+                for (int i = 1; i <= kBatchSize; ++i) {
+                    batch.push_back(std::make_unique<int>(i));
+                }
+                queue.push_bulk(batch.begin(), batch.end());
+            }
+        });
+    }
+    for (auto& t : producers) {
+        t.join();
+    }
+    for (auto& t : consumers) {
+        t.join();
+    }
+
+    EXPECT_EQ(received.load(), kProducers * kBatches * kBatchSize);
+    EXPECT_EQ(sum.load(), static_cast<long long>(kProducers) * kBatches * kBatchSize * (kBatchSize + 1) / 2);
+}
@@ -0,0 +1,215 @@
+#include <gtest/gtest.h>
+#include "dfs/events/journal.hpp"
+#include "dfs/events/components.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+namespace fs = std::filesystem;
+using namespace dfs::events;
+
+namespace {
+
+fs::path create_temp_dir(const std::string& prefix) {
+    static std::atomic<uint64_t> counter{0};
+    auto dir = fs::temp_directory_path() /
+               fs::path(prefix + std::to_string(::getpid()) + "_" + std::to_string(counter.fetch_add(1)));
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+    return dir;
+}
+
+dfs::metadata::FileMetadata make_metadata(const std::string& path) {
+    dfs::metadata::FileMetadata m;
+    m.file_path = path;
+    m.hash = "0123456789abcdef";
+    m.size = 4096;
+    m.modified_time = 1704096000;
+    m.created_time = -5;
+    m.sync_state = dfs::metadata::SyncState::MODIFIED;
+    m.replicas.emplace_back("laptop_1", 7, 1704096000);
+    return m;
+}
+
+std::unique_ptr<EventJournal> open_journal(JournalOptions options) {
+    auto opened = EventJournal::open(std::move(options));
+    EXPECT_TRUE(opened.is_ok()) << (opened.is_error() ? opened.error() : "");
+    return opened.is_ok() ? std::move(opened.value()) : nullptr;
+}
+
+std::vector<JournalRecord> read_all(const EventJournal& journal, std::uint64_t from = 0) {
+    std::vector<JournalRecord> records;
+    auto result = journal.replay(from, [&](const JournalRecord& r) { records.push_back(r); });
+    EXPECT_TRUE(result.is_ok()) << (result.is_error() ? result.error() : "");
+    return records;
+}
+
+} // namespace
+
+TEST(EventCodec, RoundTripsEveryEventType) {
+    std::vector<JournalEvent> events{
+        FileAddedEvent(make_metadata("/a.txt"), "http"),
+        FileModifiedEvent("/a.txt", "old", "new", 10, 20, "sync"),
+        FileDeletedEvent("/a.txt", make_metadata("/a.txt"), "watcher"),
+        ServerStartedEvent(8080),
+        ServerShuttingDownEvent("signal"),
+        SyncStartedEvent("node", 3),
+        SyncCompletedEvent("node", 3, std::chrono::milliseconds(1500)),
+        SyncFailedEvent("node", "disk full"),
+        FileUploadStartedEvent{"s1", "/a.txt", 1 << 20},
+        FileChunkReceivedEvent{"s1", "/a.txt", 4, 16, 65536, 3},
+        FileUploadCompletedEvent{"s1", "/a.txt", "hash", 1 << 20, std::chrono::milliseconds(42)},
+        FileDownloadCompletedEvent{"s1", "/b.txt", 99},
+        FileConflictDetectedEvent{make_metadata("/c.txt"), make_metadata("/c.txt"), "s2"},
+        FileConflictResolvedEvent{make_metadata("/c.txt"), make_metadata("/c.txt"),
+                                  ConflictResolutionStrategy::Manual, "s2"},
+    };
+
+    for (const auto& event : events) {
+        std::vector<std::uint8_t> bytes;
+        EventCodec::encode(event, bytes);
+
+        auto decoded = EventCodec::decode(bytes.data(), bytes.size());
+        ASSERT_TRUE(decoded.is_ok()) << decoded.error();
+        ASSERT_EQ(decoded.value().index(), event.index());
+
+        // Re-encoding the decoded event must give identical bytes
+        std::vector<std::uint8_t> again;
+        EventCodec::encode(decoded.value(), again);
+        EXPECT_EQ(again, bytes) << "event index " << event.index();
+    }
+
+    std::vector<std::uint8_t> bytes;
+    EventCodec::encode(JournalEvent(FileChunkReceivedEvent{"s1", "/a.txt", 4, 16, 65536, 3}), bytes);
+    auto chunk = std::get<FileChunkReceivedEvent>(EventCodec::decode(bytes.data(), bytes.size()).value());
+    EXPECT_EQ(chunk.session_id, "s1");
+    EXPECT_EQ(chunk.chunk_index, 4u);
+    EXPECT_EQ(chunk.bytes_received, 65536u);
+    EXPECT_EQ(chunk.chunks_merged, 3u);
+}
+
+TEST(EventCodec, RejectsMalformedPayloads) {
+    std::vector<std::uint8_t> bytes;
+    EventCodec::encode(JournalEvent(SyncFailedEvent("node", "error")), bytes);
+
+    EXPECT_TRUE(EventCodec::decode(bytes.data(), bytes.size() - 3).is_error());  // Truncated
+
+    auto extra = bytes;
+    extra.push_back(0);
+    EXPECT_TRUE(EventCodec::decode(extra.data(), extra.size()).is_error());      // Trailing
+
+    std::uint8_t unknown[] = {200, 0};
+    EXPECT_TRUE(EventCodec::decode(unknown, sizeof(unknown)).is_error());
+}
+
+TEST(EventJournal, AppendAndReplayFromOffset) {
+    auto dir = create_temp_dir("dfs_journal_replay");
+    auto journal = open_journal({dir});
+
+    for (int i = 0; i < 10; ++i) {
+        auto offset = journal->append(ServerStartedEvent(static_cast<uint16_t>(8000 + i)));
+        ASSERT_TRUE(offset.is_ok());
+        EXPECT_EQ(offset.value(), static_cast<std::uint64_t>(i));
+    }
+
+    auto records = read_all(*journal, 6);
+    ASSERT_EQ(records.size(), 4u);
+    EXPECT_EQ(records.front().offset, 6u);
+    EXPECT_EQ(std::get<ServerStartedEvent>(records.front().event).port, 8006);
+    EXPECT_EQ(std::get<ServerStartedEvent>(records.back().event).port, 8009);
+}
+
+TEST(EventJournal, ReopenContinuesAfterLastRecord) {
+    auto dir = create_temp_dir("dfs_journal_reopen");
+    {
+        auto journal = open_journal({dir});
+        journal->append(SyncStartedEvent("a", 1));
+        journal->append(SyncStartedEvent("b", 2));
+    }
+
+    auto journal = open_journal({dir});
+    EXPECT_EQ(journal->next_offset(), 2u);
+    EXPECT_EQ(journal->append(SyncStartedEvent("c", 3)).value(), 2u);
+
+    auto records = read_all(*journal);
+    ASSERT_EQ(records.size(), 3u);
+    EXPECT_EQ(std::get<SyncStartedEvent>(records[2].event).node_id, "c");
+}
+
+TEST(EventJournal, RollsSegmentsAndReplaysAcrossThem) {
+    auto dir = create_temp_dir("dfs_journal_segments");
+    JournalOptions options{dir};
+    options.segment_bytes = 4096;
+    auto journal = open_journal(options);
+
+    const std::string reason(200, 'x');
+    for (int i = 0; i < 100; ++i) {
+        ASSERT_TRUE(journal->append(ServerShuttingDownEvent(reason + std::to_string(i))).is_ok());
+    }
+    EXPECT_GT(journal->segment_count(), 3u);
+
+    auto records = read_all(*journal, 37);
+    ASSERT_EQ(records.size(), 63u);
+    for (std::size_t i = 0; i < records.size(); ++i) {
+        EXPECT_EQ(records[i].offset, 37 + i);
+        EXPECT_EQ(std::get<ServerShuttingDownEvent>(records[i].event).reason, reason + std::to_string(37 + i));
+    }
+}
+
+TEST(EventJournal, RecoveryDropsTornTail) {
+    auto dir = create_temp_dir("dfs_journal_torn");
+    {
+        auto journal = open_journal({dir});
+        journal->append(SyncFailedEvent("n", "first"));
+        journal->append(SyncFailedEvent("n", "second"));
+    }
+
+    // Corrupt the last byte of the second record
+    fs::path segment = dir / "00000000000000000000.log";
+    auto size = fs::file_size(segment);
+    {
+        std::fstream file(segment, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(size - 1));
+        file.put('\x7f');
+    }
+
+    auto journal = open_journal({dir});
+    EXPECT_EQ(journal->next_offset(), 1u);
+    journal->append(SyncFailedEvent("n", "third"));
+
+    auto records = read_all(*journal);
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(std::get<SyncFailedEvent>(records[1].event).error_message, "third");
+}
+
+TEST(EventJournal, AttachedJournalRebuildsSyncComponent) {
+    auto dir = create_temp_dir("dfs_journal_attach");
+    {
+        EventBus bus;
+        auto journal = open_journal({dir});
+        journal->attach(bus);
+
+        bus.emit(FileAddedEvent(make_metadata("/docs/a.txt"), "http"));
+        bus.emit(FileModifiedEvent("/docs/b.txt", "h1", "h2", 1, 2, "sync"));
+        bus.emit(ServerShuttingDownEvent("restart"));
+        EXPECT_EQ(journal->next_offset(), 3u);
+    }
+
+    // "Restart": fresh bus and component, state comes from the journal
+    EventBus bus;
+    SyncComponent sync(bus);
+    auto journal = open_journal({dir});
+    auto replayed = journal->replay_into(bus, 0);
+    ASSERT_TRUE(replayed.is_ok());
+    EXPECT_EQ(replayed.value(), 3u);
+
+    EXPECT_EQ(sync.queue_size(), 2u);
+    EXPECT_EQ(sync.next().value(), "/docs/a.txt");
+    EXPECT_EQ(sync.next().value(), "/docs/b.txt");
+}
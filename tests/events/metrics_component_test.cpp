@@ -38,3 +38,42 @@ TEST(MetricsComponentTest, TracksTransferAndConflictCounters) {
     EXPECT_EQ(stats.conflicts_detected.load(), 1u);
     EXPECT_EQ(stats.conflicts_resolved.load(), 1u);
 }
+
+TEST(MetricsComponentTest, RecordsLatencyAndSizeHistograms) {
+    EventBus bus;
+    MetricsComponent metrics(bus);
+
+    bus.emit(FileUploadCompletedEvent{"session-1", "/a.txt", "hash", 10, std::chrono::milliseconds{120}});
+    bus.emit(FileUploadCompletedEvent{"session-1", "/b.txt", "hash", 10, std::chrono::milliseconds{480}});
+    bus.emit(dfs::events::SyncCompletedEvent{"node-1", 2, std::chrono::milliseconds{900}});
+
+    // One coalesced event standing for four 256-byte chunks
+    dfs::events::FileChunkReceivedEvent chunks{"session-1", "/a.txt", 3, 8, 1024};
+    chunks.chunks_merged = 4;
+    bus.emit(chunks);
+
+    metrics.record_request_latency(std::chrono::microseconds{75});
+
+    const auto& h = metrics.get_histograms();
+    EXPECT_EQ(h.upload_duration_ms.count(), 2u);
+    EXPECT_EQ(h.upload_duration_ms.max(), 480u);
+    EXPECT_EQ(h.upload_duration_ms.percentile(50), 120u);
+    EXPECT_EQ(h.sync_duration_ms.count(), 1u);
+    EXPECT_EQ(h.chunk_size_bytes.count(), 4u);
+    EXPECT_EQ(h.chunk_size_bytes.percentile(99), 256u);
+    EXPECT_EQ(h.request_latency_us.snapshot().p50, 75u);
+}
+
+TEST(MetricsComponentTest, UnsubscribesOnDestruction) {
+    EventBus bus(dfs::events::AsyncDispatchOptions{});
+    {
+        MetricsComponent metrics(bus);
+        EXPECT_EQ(bus.subscriber_count<FileUploadCompletedEvent>(), 1u);
+        bus.emit(FileUploadCompletedEvent{"session-1", "/a.txt", "hash", 10, std::chrono::milliseconds{1}});
+    }
+    EXPECT_EQ(bus.subscriber_count<FileUploadCompletedEvent>(), 0u);
+
+    // Nothing left that points into the destroyed component
+    bus.emit(FileUploadCompletedEvent{"session-1", "/b.txt", "hash", 10, std::chrono::milliseconds{1}});
+    bus.flush();
+}
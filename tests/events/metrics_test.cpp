@@ -0,0 +1,108 @@
+#include "dfs/events/metrics.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <thread>
+#include <vector>
+
+using dfs::events::HdrHistogram;
+using dfs::events::ShardedCounter;
+
+TEST(ShardedCounterTest, SumsIncrementsFromAllThreads) {
+    ShardedCounter counter;
+    constexpr int kThreads = 8;
+    constexpr int kPerThread = 10000;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&counter] {
+            for (int i = 0; i < kPerThread; ++i) {
+                counter++;
+            }
+            counter += 5;
+        });
+    }
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(counter.load(), static_cast<std::uint64_t>(kThreads) * (kPerThread + 5));
+    counter.reset();
+    EXPECT_EQ(counter.load(), 0u);
+}
+
+TEST(HdrHistogramTest, BucketBoundariesRoundTrip) {
+    for (std::uint64_t v : std::initializer_list<std::uint64_t>{0, 1, 127, 128, 129, 255, 256,
+                            1000, 123456, HdrHistogram::kMaxValue}) {
+        std::size_t index = HdrHistogram::bucket_index(v);
+        ASSERT_LT(index, HdrHistogram::kBucketCount) << v;
+        std::uint64_t high = HdrHistogram::highest_equivalent(index);
+        EXPECT_GE(high, v);
+        EXPECT_LE(high - v, v / 64) << v;
+    }
+    EXPECT_EQ(HdrHistogram::bucket_index(HdrHistogram::kMaxValue), HdrHistogram::kBucketCount - 1);
+}
+
+TEST(HdrHistogramTest, PercentilesWithinRelativeError) {
+    HdrHistogram h;
+    for (std::uint64_t v = 1; v <= 100000; ++v) {
+        h.record(v);
+    }
+
+    auto snap = h.snapshot();
+    EXPECT_EQ(snap.count, 100000u);
+    EXPECT_EQ(snap.min, 1u);
+    EXPECT_EQ(snap.max, 100000u);
+    EXPECT_NEAR(snap.mean, 50000.5, 0.01);
+    EXPECT_NEAR(static_cast<double>(snap.p50), 50000.0, 50000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(snap.p99), 99000.0, 99000.0 / 64);
+    EXPECT_NEAR(static_cast<double>(snap.p999), 99900.0, 99900.0 / 64);
+    EXPECT_EQ(h.percentile(100), 100000u);
+}
+
+TEST(HdrHistogramTest, EmptyAndClampedValues) {
+    HdrHistogram h;
+    EXPECT_EQ(h.percentile(99), 0u);
+    EXPECT_EQ(h.snapshot().count, 0u);
+
+    h.record(UINT64_MAX);
+    EXPECT_EQ(h.max(), HdrHistogram::kMaxValue);
+    EXPECT_EQ(h.percentile(50), HdrHistogram::kMaxValue);
+}
+
+TEST(HdrHistogramTest, ReadsRunAlongsideWriters) {
+    HdrHistogram h;
+    std::atomic<bool> stop{false};
+    constexpr int kWriters = 4;
+    constexpr std::uint64_t kPerWriter = 50000;
+
+    std::vector<std::thread> writers;
+    for (int t = 0; t < kWriters; ++t) {
+        writers.emplace_back([&h] {
+            for (std::uint64_t i = 0; i < kPerWriter; ++i) {
+                h.record(100 + i % 900);
+            }
+        });
+    }
+
+    std::thread reader([&] {
+        while (!stop.load()) {
+            auto snap = h.snapshot();
+            if (snap.count > 0) {
+                EXPECT_GE(snap.p50, 100u);
+                EXPECT_LE(snap.p999, 1000u + 1000u / 64);
+            }
+        }
+    });
+
+    for (auto& w : writers) {
+        w.join();
+    }
+    stop = true;
+    reader.join();
+
+    EXPECT_EQ(h.count(), kWriters * kPerWriter);
+}
@@ -0,0 +1,101 @@
+#include "dfs/events/prometheus.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using dfs::events::EventBus;
+using dfs::events::HdrHistogram;
+using dfs::events::MetricsComponent;
+using dfs::events::PrometheusExporter;
+using dfs::events::ShardedCounter;
+
+// Counts heap allocations made by the current thread while enabled
+namespace {
+thread_local bool g_count_allocations = false;
+thread_local size_t g_allocation_count = 0;
+}
+
+void* operator new(std::size_t size) {
+    if (g_count_allocations) {
+        ++g_allocation_count;
+    }
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+TEST(PrometheusExporterTest, RendersCountersAndGauges) {
+    ShardedCounter uploads;
+    uploads += 42;
+
+    PrometheusExporter exporter;
+    exporter.add_counter("dfs_uploads_total", "Files uploaded", uploads);
+    exporter.add_gauge("dfs_queue_depth", "Queued connections", [] { return 3.0; });
+    exporter.add_gauge("dfs_load", "Load", [] { return 0.25; });
+
+    std::string page;
+    exporter.render(page);
+
+    EXPECT_EQ(page,
+              "# HELP dfs_uploads_total Files uploaded\n"
+              "# TYPE dfs_uploads_total counter\n"
+              "dfs_uploads_total 42\n"
+              "# HELP dfs_queue_depth Queued connections\n"
+              "# TYPE dfs_queue_depth gauge\n"
+              "dfs_queue_depth 3\n"
+              "# HELP dfs_load Load\n"
+              "# TYPE dfs_load gauge\n"
+              "dfs_load 0.25\n");
+}
+
+TEST(PrometheusExporterTest, RendersCumulativeHistogramBuckets) {
+    HdrHistogram latency;
+    latency.record(5);
+    latency.record(50, 2);
+    latency.record(5000);
+
+    PrometheusExporter exporter;
+    exporter.add_histogram("dfs_latency_us", "Latency", latency, {10, 100, 1000});
+
+    std::string page;
+    exporter.render(page);
+
+    EXPECT_NE(page.find("# TYPE dfs_latency_us histogram\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_bucket{le=\"10\"} 1\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_bucket{le=\"100\"} 3\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_bucket{le=\"1000\"} 3\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_bucket{le=\"+Inf\"} 4\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_sum 5105\n"), std::string::npos);
+    EXPECT_NE(page.find("dfs_latency_us_count 4\n"), std::string::npos);
+}
+
+TEST(PrometheusExporterTest, WarmScrapeDoesNotAllocate) {
+    EventBus bus;
+    MetricsComponent metrics(bus);
+    metrics.record_request_latency(std::chrono::microseconds{120});
+
+    PrometheusExporter exporter;
+    dfs::events::add_metrics_component(exporter, metrics);
+    exporter.add_gauge("dfs_sessions_active", "Active sessions", [] { return 1.0; });
+
+    std::string page;
+    exporter.render(page);   // Grows the buffer once
+    ASSERT_NE(page.find("dfs_request_latency_microseconds_count 1\n"), std::string::npos);
+
+    metrics.record_request_latency(std::chrono::microseconds{80});
+
+    g_allocation_count = 0;
+    g_count_allocations = true;
+    exporter.render(page);
+    g_count_allocations = false;
+
+    EXPECT_EQ(g_allocation_count, 0u);
+    EXPECT_NE(page.find("dfs_request_latency_microseconds_count 2\n"), std::string::npos);
+}
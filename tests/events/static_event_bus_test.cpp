@@ -0,0 +1,217 @@
+#include <gtest/gtest.h>
+#include "dfs/events/static_event_bus.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dfs::events;
+
+struct PingEvent {
+    int value;
+};
+
+struct NoteEvent {
+    std::string text;
+};
+
+using TestBus = StaticEventBus<PingEvent, NoteEvent>;
+
+TEST(StaticEventBus, SubscribeAndEmit) {
+    TestBus bus;
+
+    int received = 0;
+    bus.subscribe<PingEvent>([&](const PingEvent& e) { received = e.value; });
+
+    bus.emit(PingEvent{42});
+    EXPECT_EQ(received, 42);
+}
+
+TEST(StaticEventBus, RoutesByType) {
+    TestBus bus;
+
+    int pings = 0;
+    std::string note;
+    bus.subscribe<PingEvent>([&](const PingEvent&) { pings++; });
+    bus.subscribe<NoteEvent>([&](const NoteEvent& e) { note = e.text; });
+
+    bus.emit(NoteEvent{"hello"});
+    EXPECT_EQ(pings, 0);
+    EXPECT_EQ(note, "hello");
+
+    bus.emit(PingEvent{1});
+    EXPECT_EQ(pings, 1);
+}
+
+TEST(StaticEventBus, UnsubscribeAndClear) {
+    TestBus bus;
+
+    int count = 0;
+    auto first = bus.subscribe<PingEvent>([&](const PingEvent&) { count++; });
+    bus.subscribe<PingEvent>([&](const PingEvent&) { count += 10; });
+    EXPECT_EQ(bus.subscriber_count<PingEvent>(), 2u);
+
+    bus.unsubscribe<PingEvent>(first);
+    bus.emit(PingEvent{0});
+    EXPECT_EQ(count, 10);
+
+    bus.clear();
+    EXPECT_EQ(bus.subscriber_count<PingEvent>(), 0u);
+    bus.emit(PingEvent{0});
+    EXPECT_EQ(count, 10);
+}
+
+TEST(StaticEventBus, ThrowingHandlerDoesNotStopOthers) {
+    TestBus bus;
+
+    bool second_called = false;
+    bus.subscribe<PingEvent>([](const PingEvent&) { throw std::runtime_error("boom"); });
+    bus.subscribe<PingEvent>([&](const PingEvent&) { second_called = true; });
+
+    bus.emit(PingEvent{0});
+    EXPECT_TRUE(second_called);
+}
+
+TEST(StaticEventBus, ConcurrentEmitAndSubscribe) {
+    TestBus bus;
+
+    std::atomic<int> count{0};
+    bus.subscribe<PingEvent>([&](const PingEvent&) { count++; });
+
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < 4; ++t) {
+        emitters.emplace_back([&]() {
+            for (int i = 0; i < 1000; ++i) {
+                bus.emit(PingEvent{i});
+            }
+        });
+    }
+    for (int i = 0; i < 50; ++i) {
+        bus.subscribe<NoteEvent>([](const NoteEvent&) {});
+    }
+    for (auto& t : emitters) {
+        t.join();
+    }
+
+    EXPECT_EQ(count.load(), 4000);
+    EXPECT_EQ(bus.subscriber_count<NoteEvent>(), 50u);
+}
+
+TEST(StaticEventBus, RetiredListsStayBoundedUnderChurn) {
+    TestBus bus;
+    bus.subscribe<PingEvent>([](const PingEvent&) {});
+
+    for (int i = 0; i < 10000; ++i) {
+        size_t id = bus.subscribe<PingEvent>([](const PingEvent&) {});
+        bus.unsubscribe<PingEvent>(id);
+        ASSERT_LE(bus.retired_lists(), 2u);
+    }
+    EXPECT_EQ(bus.retired_lists(), 0u);
+}
+
+TEST(StaticEventBus, ChurnWhileEmittingReclaimsSafely) {
+    TestBus bus;
+    std::atomic<int> calls{0};
+    bus.subscribe<PingEvent>([&](const PingEvent&) { calls++; });
+
+    std::atomic<bool> done{false};
+    std::vector<std::thread> emitters;
+    for (int t = 0; t < 3; ++t) {
+        emitters.emplace_back([&]() {
+            while (!done.load()) {
+                bus.emit(PingEvent{1});
+            }
+        });
+    }
+
+    for (int i = 0; i < 5000; ++i) {
+        size_t id = bus.subscribe<PingEvent>([](const PingEvent&) {});
+        bus.unsubscribe<PingEvent>(id);
+    }
+    done = true;
+    for (auto& emitter : emitters) {
+        emitter.join();
+    }
+
+    // Whatever was retired while emits were running is freed by the
+    // next write once they are gone
+    size_t id = bus.subscribe<PingEvent>([](const PingEvent&) {});
+    bus.unsubscribe<PingEvent>(id);
+    EXPECT_EQ(bus.retired_lists(), 0u);
+    EXPECT_GT(calls.load(), 0);
+}
+
+TEST(StaticEventBus, RunningEmitPinsRetiredListsUntilItReturns) {
+    TestBus bus;
+    std::atomic<bool> entered{false};
+    std::atomic<bool> release{false};
+    bus.subscribe<PingEvent>([&](const PingEvent&) {
+        entered = true;
+        while (!release.load()) {
+            std::this_thread::yield();
+        }
+    });
+
+    std::thread emitter([&]() { bus.emit(PingEvent{1}); });
+    while (!entered.load()) {
+        std::this_thread::yield();
+    }
+
+    for (int i = 0; i < 100; ++i) {
+        size_t id = bus.subscribe<NoteEvent>([](const NoteEvent&) {});
+        bus.unsubscribe<NoteEvent>(id);
+    }
+    EXPECT_EQ(bus.retired_lists(), 199u);  // First subscribe retires nothing
+
+    release = true;
+    emitter.join();
+    size_t id = bus.subscribe<NoteEvent>([](const NoteEvent&) {});
+    bus.unsubscribe<NoteEvent>(id);
+    EXPECT_EQ(bus.retired_lists(), 0u);
+}
+
+TEST(StaticEventBus, FileSyncBusCoversAllEvents) {
+    static_assert(FileSyncEventBus::event_type_count() == 14);
+
+    FileSyncEventBus bus;
+    std::size_t bytes = 0;
+    bus.subscribe<FileChunkReceivedEvent>([&](const FileChunkReceivedEvent& e) {
+        bytes += e.bytes_received;
+    });
+
+    bus.emit(FileChunkReceivedEvent{"s1", "a.txt", 0, 2, 512});
+    EXPECT_EQ(bytes, 512u);
+}
+
+TEST(StaticHandlerBus, CallsOnlyHandlersThatAcceptTheEvent) {
+    int pings = 0;
+    std::string note;
+    int everything = 0;
+    StaticHandlerBus bus(
+        [&](const PingEvent& e) { pings += e.value; },
+        [&](const NoteEvent& e) { note = e.text; },
+        [&](const auto&) { everything++; });
+
+    static_assert(decltype(bus)::subscriber_count<PingEvent>() == 2);
+    static_assert(decltype(bus)::subscriber_count<NoteEvent>() == 2);
+    static_assert(decltype(bus)::subscriber_count<FileAddedEvent>() == 1);
+
+    bus.emit(PingEvent{5});
+    bus.emit(NoteEvent{"hello"});
+    EXPECT_EQ(pings, 5);
+    EXPECT_EQ(note, "hello");
+    EXPECT_EQ(everything, 2);
+}
+
+TEST(StaticHandlerBus, ThrowingHandlerDoesNotStopOthers) {
+    struct Counter {
+        int calls = 0;
+        void operator()(const PingEvent&) { calls++; }
+    };
+    StaticHandlerBus bus([](const PingEvent&) { throw std::runtime_error("boom"); }, Counter{});
+
+    bus.emit(PingEvent{0});
+    bus.emit(PingEvent{1});
+    EXPECT_EQ(bus.handler<1>().calls, 2);
+}
@@ -0,0 +1,170 @@
+#include "dfs/network/admission_controller.hpp"
+#include "dfs/network/http_server.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dfs::network;
+using namespace std::chrono_literals;
+
+namespace {
+
+using Clock = AdmissionController::Clock;
+
+AdmissionConfig codel_config() {
+    AdmissionConfig config;
+    config.target_delay = 5ms;
+    config.interval = 100ms;
+    return config;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// AdmissionController
+// ════════════════════════════════════════════════════════════
+
+TEST(AdmissionControllerTest, PerClientLimitCountsInFlight) {
+    AdmissionConfig config;
+    config.max_in_flight_per_client = 2;
+    AdmissionController admission(config);
+
+    uint32_t client = 0x0A000001;   // 10.0.0.1
+    EXPECT_TRUE(admission.try_enter(client));
+    EXPECT_TRUE(admission.try_enter(client));
+    EXPECT_FALSE(admission.try_enter(client));
+    EXPECT_EQ(admission.shed_client_limit(), 1u);
+
+    admission.leave(client);
+    EXPECT_TRUE(admission.try_enter(client));
+}
+
+TEST(AdmissionControllerTest, ZeroClientLimitMeansUnlimited) {
+    AdmissionConfig config;
+    config.max_in_flight_per_client = 0;
+    AdmissionController admission(config);
+    for (int i = 0; i < 1000; ++i) {
+        EXPECT_TRUE(admission.try_enter(0x7F000001));
+    }
+}
+
+TEST(AdmissionControllerTest, BurstAloneIsNotOverload) {
+    AdmissionController admission(codel_config());
+    auto t = Clock::now();
+
+    // Within one interval some connections waited long, but the fastest
+    // did not: a burst that drains, not a standing queue
+    EXPECT_FALSE(admission.should_shed(t, 50ms));
+    EXPECT_FALSE(admission.should_shed(t + 10ms, 1ms));
+    EXPECT_FALSE(admission.should_shed(t + 20ms, 40ms));
+    EXPECT_FALSE(admission.should_shed(t + 120ms, 30ms));   // Interval closes with min 1ms
+    EXPECT_FALSE(admission.is_overloaded());
+}
+
+TEST(AdmissionControllerTest, StandingQueueShedsLateConnections) {
+    AdmissionController admission(codel_config());
+    auto t = Clock::now();
+
+    admission.should_shed(t, 20ms);              // Opens the first interval
+    admission.should_shed(t + 50ms, 30ms);
+    // Interval ends with every connection above target
+    EXPECT_TRUE(admission.should_shed(t + 150ms, 25ms));
+    EXPECT_TRUE(admission.is_overloaded());
+
+    // While overloaded, only connections over target are shed
+    EXPECT_FALSE(admission.should_shed(t + 160ms, 2ms));
+    EXPECT_TRUE(admission.should_shed(t + 170ms, 8ms));
+
+    // The queue drained: the next interval sees a fast connection
+    EXPECT_FALSE(admission.should_shed(t + 300ms, 1ms));
+    EXPECT_FALSE(admission.is_overloaded());
+}
+
+TEST(AdmissionControllerTest, PriorityPathsMatchOnSegmentBoundary) {
+    AdmissionController admission;
+    EXPECT_TRUE(admission.is_priority("GET /api/sync/status HTTP/1.1\r\n"));
+    EXPECT_TRUE(admission.is_priority("GET /api/sync/status?client=a HTTP/1.1\r\n"));
+    EXPECT_TRUE(admission.is_priority("GET /health/live HTTP/1.1\r\n"));
+    EXPECT_FALSE(admission.is_priority("GET /api/sync/statusx HTTP/1.1\r\n"));
+    EXPECT_FALSE(admission.is_priority("POST /api/sync/start HTTP/1.1\r\n"));
+    EXPECT_FALSE(admission.is_priority("GARBAGE"));
+}
+
+TEST(AdmissionControllerTest, OverloadResponseIsCompleteHttp) {
+    AdmissionConfig config;
+    config.retry_after_seconds = 7;
+    AdmissionController admission(config);
+
+    std::string response(admission.overload_response());
+    EXPECT_EQ(response.rfind("HTTP/1.1 503 Service Unavailable\r\n", 0), 0u);
+    EXPECT_NE(response.find("Retry-After: 7\r\n"), std::string::npos);
+
+    size_t header_end = response.find("\r\n\r\n");
+    ASSERT_NE(header_end, std::string::npos);
+    size_t length_at = response.find("Content-Length: ");
+    size_t length = std::stoul(response.substr(length_at + 16));
+    EXPECT_EQ(response.size() - header_end - 4, length);
+}
+
+// ════════════════════════════════════════════════════════════
+// HttpServer integration
+// ════════════════════════════════════════════════════════════
+
+namespace {
+
+std::string exchange(uint16_t port, const std::string& request) {
+    Socket client;
+    EXPECT_TRUE(client.create(SocketType::TCP).is_ok());
+    EXPECT_TRUE(client.connect("127.0.0.1", port).is_ok());
+    EXPECT_TRUE(client.send(std::vector<uint8_t>(request.begin(), request.end())).is_ok());
+
+    std::string data;
+    while (true) {
+        auto chunk = client.receive(4096);
+        if (chunk.is_error() || chunk.value().empty()) {
+            break;
+        }
+        data.append(chunk.value().begin(), chunk.value().end());
+    }
+    return data;
+}
+
+} // namespace
+
+TEST(AdmissionControllerTest, ServerShedsAllButPriorityRoutesWhenOverloaded) {
+    HttpServer server(2);
+    server.set_handler([](const HttpRequest&) {
+        HttpResponse response(HttpStatus::OK);
+        response.set_body("served");
+        return response;
+    });
+
+    // Zero target and interval: every connection counts as late, so the
+    // controller is overloaded from the first pickup on
+    AdmissionConfig config;
+    config.target_delay = 0us;
+    config.interval = 0us;
+    server.set_admission_config(config);
+
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    while (!server.is_running()) {
+        std::this_thread::yield();
+    }
+
+    std::string shed = exchange(server.get_port(), "POST /api/sync/start HTTP/1.1\r\nHost: x\r\n\r\n");
+    std::string kept = exchange(server.get_port(), "GET /api/sync/status HTTP/1.1\r\nHost: x\r\n\r\n");
+
+    server.stop();
+    thread.join();
+
+    EXPECT_EQ(shed.rfind("HTTP/1.1 503", 0), 0u) << shed;
+    EXPECT_NE(shed.find("Retry-After: 1"), std::string::npos);
+    EXPECT_EQ(kept.rfind("HTTP/1.1 200", 0), 0u) << kept;
+    EXPECT_EQ(server.admission().shed_delay(), 1u);
+    EXPECT_EQ(server.admission().priority_admits(), 1u);
+}
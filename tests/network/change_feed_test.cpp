@@ -0,0 +1,277 @@
+#include "dfs/network/change_feed.hpp"
+#include "dfs/network/http_server.hpp"
+#include "dfs/network/http_server_epoll.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dfs::network;
+using namespace std::chrono_literals;
+
+namespace {
+
+std::shared_ptr<ChangeFeed> make_feed(size_t history = 4096) {
+    ChangeFeedConfig config;
+    config.history = history;
+    config.long_poll_timeout = 5s;
+    config.heartbeat = 1s;
+    return std::make_shared<ChangeFeed>(config);
+}
+
+std::string pull_all(PushBody& body, bool& more, PushBody::Clock::time_point now = PushBody::Clock::now()) {
+    std::string out;
+    more = body.pull(out, now);
+    return out;
+}
+
+// Polls until cond holds or two seconds pass
+template <typename Cond>
+bool eventually(Cond cond) {
+    auto until = std::chrono::steady_clock::now() + 2s;
+    while (!cond()) {
+        if (std::chrono::steady_clock::now() > until) {
+            return false;
+        }
+        std::this_thread::sleep_for(1ms);
+    }
+    return true;
+}
+
+std::unique_ptr<Socket> open_request(uint16_t port, const std::string& request) {
+    auto client = std::make_unique<Socket>();
+    EXPECT_TRUE(client->create(SocketType::TCP).is_ok());
+    EXPECT_TRUE(client->connect("127.0.0.1", port).is_ok());
+    timeval timeout{5, 0};   // A broken wake fails the test instead of hanging it
+    ::setsockopt(client->native_handle(), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    EXPECT_TRUE(client->send(std::vector<uint8_t>(request.begin(), request.end())).is_ok());
+    return client;
+}
+
+// Reads until `needle` shows up, the peer closes or the timeout hits
+std::string read_until(Socket& client, std::string_view needle) {
+    std::string data;
+    while (data.find(needle) == std::string::npos) {
+        auto chunk = client.receive(4096);
+        if (chunk.is_error() || chunk.value().empty()) {
+            break;
+        }
+        data.append(chunk.value().begin(), chunk.value().end());
+    }
+    return data;
+}
+
+HttpRequestHandler feed_handler(std::shared_ptr<ChangeFeed> feed) {
+    return [feed](const HttpRequest& request) {
+        HttpResponse response(HttpStatus::OK);
+        if (request.url == "/events") {
+            response.set_header("Content-Type", ChangeFeed::kEventStreamType);
+            response.set_body_push(feed->event_stream(0));
+        } else {
+            response.set_header("Content-Type", "application/json");
+            response.set_body_push(feed->long_poll(0));
+        }
+        return response;
+    };
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// History
+// ════════════════════════════════════════════════════════════
+
+TEST(ChangeFeedTest, ReadSinceReturnsRecordsAfterCursor) {
+    auto feed = make_feed();
+    EXPECT_EQ(feed->last_sequence(), 0u);
+    EXPECT_EQ(feed->publish("a"), 1u);
+    EXPECT_EQ(feed->publish("b"), 2u);
+    EXPECT_EQ(feed->publish("c"), 3u);
+
+    std::vector<ChangeFeed::Record> records;
+    ASSERT_TRUE(feed->read_since(1, 10, records));
+    ASSERT_EQ(records.size(), 2u);
+    EXPECT_EQ(records[0].sequence, 2u);
+    EXPECT_EQ(records[1].data, "c");
+
+    records.clear();
+    ASSERT_TRUE(feed->read_since(0, 2, records));
+    EXPECT_EQ(records.size(), 2u);   // Capped at max
+
+    records.clear();
+    EXPECT_TRUE(feed->read_since(3, 10, records));
+    EXPECT_TRUE(records.empty());
+}
+
+TEST(ChangeFeedTest, CursorOutsideHistoryNeedsResync) {
+    auto feed = make_feed(3);
+    for (int i = 0; i < 5; ++i) {
+        feed->publish(std::to_string(i));
+    }
+    std::vector<ChangeFeed::Record> records;
+    EXPECT_FALSE(feed->read_since(1, 10, records));    // 2 was dropped
+    EXPECT_TRUE(feed->read_since(2, 10, records));
+    EXPECT_EQ(records.size(), 3u);
+    EXPECT_FALSE(feed->read_since(99, 10, records));   // From before a restart
+}
+
+// ════════════════════════════════════════════════════════════
+// Subscriber bodies
+// ════════════════════════════════════════════════════════════
+
+TEST(ChangeFeedTest, LongPollAnswersAtOnceWhenBehind) {
+    auto feed = make_feed();
+    feed->publish(R"({"op":"added"})");
+    feed->publish(R"({"op":"deleted"})");
+    auto body = feed->long_poll(0);
+    bool more = true;
+    EXPECT_EQ(pull_all(*body, more), R"({"cursor":2,"changes":[{"op":"added"},{"op":"deleted"}]})");
+    EXPECT_FALSE(more);
+}
+
+TEST(ChangeFeedTest, LongPollParksUntilPublish) {
+    auto feed = make_feed();
+    auto body = feed->long_poll(0);
+    int wakes = 0;
+    body->watch([&wakes] { ++wakes; });
+    EXPECT_EQ(feed->subscribers(), 1u);
+
+    bool more = false;
+    EXPECT_EQ(pull_all(*body, more), "");
+    EXPECT_TRUE(more);
+
+    feed->publish("1");
+    EXPECT_EQ(wakes, 1);
+    EXPECT_EQ(pull_all(*body, more), R"({"cursor":1,"changes":[1]})");
+    EXPECT_FALSE(more);
+
+    body.reset();   // Dropping the body unwatches
+    EXPECT_EQ(feed->subscribers(), 0u);
+}
+
+TEST(ChangeFeedTest, LongPollTimesOutEmpty) {
+    auto feed = make_feed();
+    auto body = feed->long_poll(0);
+    bool more = true;
+    EXPECT_EQ(pull_all(*body, more, body->deadline()), R"({"cursor":0,"changes":[]})");
+    EXPECT_FALSE(more);
+}
+
+TEST(ChangeFeedTest, LongPollFromDroppedCursorAsksForResync) {
+    auto feed = make_feed(2);
+    for (int i = 0; i < 4; ++i) {
+        feed->publish("x");
+    }
+    bool more = true;
+    EXPECT_EQ(pull_all(*feed->long_poll(1), more), R"({"cursor":4,"resync":true,"changes":[]})");
+}
+
+TEST(ChangeFeedTest, EventStreamFormatsRecordsAndHeartbeats) {
+    auto feed = make_feed();
+    auto body = feed->event_stream(0);
+    bool more = false;
+    EXPECT_EQ(pull_all(*body, more), "retry: 3000\n: subscribed\n\n");
+    EXPECT_TRUE(more);
+    EXPECT_EQ(pull_all(*body, more), "");
+
+    feed->publish("{\"op\":\"added\"}");
+    EXPECT_EQ(pull_all(*body, more), "id: 1\nevent: change\ndata: {\"op\":\"added\"}\n\n");
+    EXPECT_TRUE(more);
+
+    EXPECT_EQ(pull_all(*body, more, body->deadline()), ": ping\n\n");
+    EXPECT_TRUE(more);
+}
+
+TEST(ChangeFeedTest, EventStreamSignalsResync) {
+    auto feed = make_feed(2);
+    for (int i = 0; i < 4; ++i) {
+        feed->publish("x");
+    }
+    bool more = false;
+    std::string out = pull_all(*feed->event_stream(1), more);
+    EXPECT_NE(out.find("event: resync\ndata: {\"cursor\":4}\n\n"), std::string::npos) << out;
+    EXPECT_EQ(out.find("event: change"), std::string::npos);
+}
+
+// ════════════════════════════════════════════════════════════
+// Servers
+// ════════════════════════════════════════════════════════════
+
+TEST(ChangeFeedServerTest, EpollLongPollIsWokenByPublish) {
+    auto feed = make_feed();
+    HttpServerEpoll server(1);
+    server.set_handler(feed_handler(feed));
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    ASSERT_TRUE(eventually([&server] { return server.is_running(); }));
+
+    auto client = open_request(server.get_port(), "GET /changes HTTP/1.1\r\nHost: x\r\n\r\n");
+    ASSERT_TRUE(eventually([&feed] { return feed->subscribers() == 1; }));
+    feed->publish("\"hello\"");
+
+    std::string wire = read_until(*client, "0\r\n\r\n");
+    EXPECT_NE(wire.find("Transfer-Encoding: chunked"), std::string::npos) << wire;
+    EXPECT_NE(wire.find(R"({"cursor":1,"changes":["hello"]})"), std::string::npos) << wire;
+    EXPECT_TRUE(eventually([&feed] { return feed->subscribers() == 0; }));
+
+    server.stop();
+    thread.join();
+}
+
+TEST(ChangeFeedServerTest, EpollFansOutToManyParkedStreams) {
+    constexpr int kClients = 64;
+    auto feed = make_feed();
+    HttpServerEpoll server(2);
+    server.set_handler(feed_handler(feed));
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    ASSERT_TRUE(eventually([&server] { return server.is_running(); }));
+
+    std::vector<std::unique_ptr<Socket>> clients;
+    for (int i = 0; i < kClients; ++i) {
+        clients.push_back(open_request(server.get_port(), "GET /events HTTP/1.1\r\nHost: x\r\n\r\n"));
+    }
+    ASSERT_TRUE(eventually([&feed] { return feed->subscribers() == kClients; }));
+
+    feed->publish("\"first\"");
+    feed->publish("\"second\"");
+    for (auto& client : clients) {
+        std::string wire = read_until(*client, "data: \"second\"\n\n");
+        EXPECT_NE(wire.find("id: 1\nevent: change\ndata: \"first\"\n\n"), std::string::npos) << wire;
+        EXPECT_NE(wire.find("id: 2\nevent: change\ndata: \"second\"\n\n"), std::string::npos) << wire;
+    }
+
+    // Subscribers that hang up are dropped without a publish
+    clients.clear();
+    EXPECT_TRUE(eventually([&feed] { return feed->subscribers() == 0; }));
+    EXPECT_TRUE(eventually([&server] { return server.get_active_connections() == 0; }));
+
+    server.stop();
+    thread.join();
+}
+
+TEST(ChangeFeedServerTest, ThreadPoolServerServesLongPoll) {
+    auto feed = make_feed();
+    HttpServer server(2);
+    server.set_handler(feed_handler(feed));
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    ASSERT_TRUE(eventually([&server] { return server.is_running(); }));
+
+    auto client = open_request(server.get_port(), "GET /changes HTTP/1.1\r\nHost: x\r\n\r\n");
+    ASSERT_TRUE(eventually([&feed] { return feed->subscribers() == 1; }));
+    feed->publish("7");
+
+    std::string wire = read_until(*client, "0\r\n\r\n");
+    EXPECT_NE(wire.find(R"({"cursor":1,"changes":[7]})"), std::string::npos) << wire;
+
+    server.stop();
+    thread.join();
+}
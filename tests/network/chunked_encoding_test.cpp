@@ -0,0 +1,234 @@
+#include "dfs/network/http_parser.hpp"
+#include "dfs/network/http_server.hpp"
+#include "dfs/network/http_server_epoll.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+using namespace dfs::network;
+
+namespace {
+
+// Producer that emits `pieces` copies of `text`, one per call
+HttpResponse::BodyProducer repeat(std::string text, int pieces) {
+    auto left = std::make_shared<int>(pieces);
+    return [text = std::move(text), left](std::string& chunk) {
+        chunk += text;
+        return --*left > 0;
+    };
+}
+
+// Decodes a chunked body; returns false on malformed input
+bool decode_chunked(std::string_view wire, std::string& body) {
+    while (true) {
+        size_t line_end = wire.find("\r\n");
+        if (line_end == std::string_view::npos) {
+            return false;
+        }
+        size_t size = std::stoul(std::string(wire.substr(0, line_end)), nullptr, 16);
+        wire.remove_prefix(line_end + 2);
+        if (size == 0) {
+            return wire == "\r\n";
+        }
+        if (wire.size() < size + 2 || wire.substr(size, 2) != "\r\n") {
+            return false;
+        }
+        body.append(wire.substr(0, size));
+        wire.remove_prefix(size + 2);
+    }
+}
+
+std::string exchange(uint16_t port, const std::string& request) {
+    Socket client;
+    EXPECT_TRUE(client.create(SocketType::TCP).is_ok());
+    EXPECT_TRUE(client.connect("127.0.0.1", port).is_ok());
+    EXPECT_TRUE(client.send(std::vector<uint8_t>(request.begin(), request.end())).is_ok());
+
+    std::string data;
+    while (true) {
+        auto chunk = client.receive(4096);
+        if (chunk.is_error() || chunk.value().empty()) {
+            break;
+        }
+        data.append(chunk.value().begin(), chunk.value().end());
+    }
+    return data;
+}
+
+HttpResponse streaming_handler(const HttpRequest&) {
+    HttpResponse response(HttpStatus::OK);
+    response.set_header("Content-Type", "text/plain");
+    response.set_body_stream(repeat(std::string(1000, 'x'), 50));
+    return response;
+}
+
+void expect_streamed_body(const std::string& wire) {
+    size_t header_end = wire.find("\r\n\r\n");
+    ASSERT_NE(header_end, std::string::npos) << wire;
+    std::string head = wire.substr(0, header_end);
+    EXPECT_NE(head.find("Transfer-Encoding: chunked"), std::string::npos);
+    EXPECT_EQ(head.find("Content-Length"), std::string::npos);
+
+    std::string body;
+    ASSERT_TRUE(decode_chunked(std::string_view(wire).substr(header_end + 4), body));
+    EXPECT_EQ(body, std::string(50 * 1000, 'x'));
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// Request parsing
+// ════════════════════════════════════════════════════════════
+
+TEST(ChunkedEncodingTest, ParserJoinsChunks) {
+    constexpr std::string_view raw =
+        "POST /upload HTTP/1.1\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "\r\n"
+        "5\r\nhello\r\n"
+        "7;ext=1\r\n, world\r\n"
+        "0\r\n"
+        "X-Checksum: abc\r\n"
+        "\r\n";
+    HttpParser parser;
+    auto parsed = parser.parse(raw.data(), raw.size());
+    ASSERT_TRUE(parsed.is_ok()) << parsed.error();
+    ASSERT_TRUE(parsed.value());
+    EXPECT_EQ(parser.request().body_as_string(), "hello, world");
+    EXPECT_EQ(parser.consumed(), raw.size());
+}
+
+TEST(ChunkedEncodingTest, ParserHandlesByteByByteInput) {
+    constexpr std::string_view raw =
+        "POST /upload HTTP/1.1\r\n"
+        "transfer-encoding: CHUNKED\r\n"
+        "\r\n"
+        "A\r\n0123456789\r\n"
+        "0\r\n\r\n";
+    HttpParser parser;
+    for (size_t i = 0; i < raw.size(); ++i) {
+        auto parsed = parser.parse(raw.data() + i, 1);
+        ASSERT_TRUE(parsed.is_ok());
+        EXPECT_EQ(parsed.value(), i + 1 == raw.size());
+    }
+    EXPECT_EQ(parser.request().body_as_string(), "0123456789");
+}
+
+TEST(ChunkedEncodingTest, ParserStopsAtEndOfChunkedBody) {
+    constexpr std::string_view raw =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n"
+        "3\r\nabc\r\n0\r\n\r\n"
+        "GET /b HTTP/1.1\r\n\r\n";
+    HttpParser parser;
+    auto parsed = parser.parse(raw.data(), raw.size());
+    ASSERT_TRUE(parsed.is_ok() && parsed.value());
+    EXPECT_EQ(std::string_view(raw.data() + parser.consumed()), "GET /b HTTP/1.1\r\n\r\n");
+}
+
+TEST(ChunkedEncodingTest, ParserRejectsMalformedChunks) {
+    constexpr std::string_view bad_size =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n";
+    constexpr std::string_view missing_crlf =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n3\r\nabcX";
+    HttpParser parser;
+    EXPECT_TRUE(parser.parse(bad_size.data(), bad_size.size()).is_error());
+    parser.reset();
+    EXPECT_TRUE(parser.parse(missing_crlf.data(), missing_crlf.size()).is_error());
+}
+
+TEST(ChunkedEncodingTest, ParserEnforcesMaxBodySize) {
+    HttpParser parser;
+    parser.set_max_body_size(8);
+
+    constexpr std::string_view fits =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n3\r\nabc\r\n0\r\n\r\n";
+    auto parsed = parser.parse(fits.data(), fits.size());
+    ASSERT_TRUE(parsed.is_ok() && parsed.value());
+    EXPECT_EQ(parser.request().body_as_string(), "helloabc");
+
+    // The second chunk pushes the joined body past the limit
+    constexpr std::string_view chunked =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n5\r\nhello\r\n4\r\n";
+    parser.reset();
+    parsed = parser.parse(chunked.data(), chunked.size());
+    ASSERT_TRUE(parsed.is_error());
+    EXPECT_EQ(parser.error_status(), HttpStatus::PAYLOAD_TOO_LARGE);
+    EXPECT_EQ(parsed.error(), "Request body exceeds 8 bytes");
+
+    // Refused from the header alone, before any body byte arrives
+    constexpr std::string_view sized = "POST /a HTTP/1.1\r\nContent-Length: 9\r\n\r\n";
+    parser.reset();
+    parsed = parser.parse(sized.data(), sized.size());
+    ASSERT_TRUE(parsed.is_error());
+    EXPECT_EQ(parser.error_status(), HttpStatus::PAYLOAD_TOO_LARGE);
+
+    // Other errors stay 400, and the limit survives reset()
+    constexpr std::string_view bad_size =
+        "POST /a HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\nzz\r\n";
+    parser.reset();
+    EXPECT_TRUE(parser.parse(bad_size.data(), bad_size.size()).is_error());
+    EXPECT_EQ(parser.error_status(), HttpStatus::BAD_REQUEST);
+    EXPECT_EQ(parser.max_body_size(), 8u);
+}
+
+// ════════════════════════════════════════════════════════════
+// Response streaming
+// ════════════════════════════════════════════════════════════
+
+TEST(ChunkedEncodingTest, SerializeEncodesEveryPiece) {
+    HttpResponse response(HttpStatus::OK);
+    response.set_body("replaced");
+    response.set_body_stream(repeat("abc", 3));
+    EXPECT_FALSE(response.headers.contains(HeaderId::CONTENT_LENGTH));
+    EXPECT_EQ(response.headers.get(HeaderId::TRANSFER_ENCODING), "chunked");
+
+    auto bytes = response.serialize();
+    std::string wire(bytes.begin(), bytes.end());
+    EXPECT_NE(wire.find("\r\n\r\n3\r\nabc\r\n3\r\nabc\r\n3\r\nabc\r\n0\r\n\r\n"), std::string::npos);
+}
+
+TEST(ChunkedEncodingTest, SetBodyAfterStreamRestoresContentLength) {
+    HttpResponse response(HttpStatus::OK);
+    response.set_body_stream(repeat("abc", 3));
+    response.set_body("plain");
+    EXPECT_FALSE(response.is_streaming());
+    EXPECT_FALSE(response.headers.contains(HeaderId::TRANSFER_ENCODING));
+    EXPECT_EQ(response.headers.get(HeaderId::CONTENT_LENGTH), "5");
+}
+
+TEST(ChunkedEncodingTest, ThreadPoolServerStreamsChunks) {
+    HttpServer server(2);
+    server.set_handler(streaming_handler);
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    while (!server.is_running()) {
+        std::this_thread::yield();
+    }
+
+    std::string wire = exchange(server.get_port(), "GET /big HTTP/1.1\r\nHost: x\r\n\r\n");
+    server.stop();
+    thread.join();
+    expect_streamed_body(wire);
+}
+
+TEST(ChunkedEncodingTest, EpollServerStreamsChunks) {
+    HttpServerEpoll server(1);
+    server.set_handler(streaming_handler);
+    ASSERT_TRUE(server.listen(0, "127.0.0.1").is_ok());
+    std::thread thread([&server] { server.serve_forever(); });
+    while (!server.is_running()) {
+        std::this_thread::yield();
+    }
+
+    // Keep-alive request: the streamed response still ends the connection
+    std::string wire = exchange(server.get_port(), "GET /big HTTP/1.1\r\nHost: x\r\n\r\n");
+    server.stop();
+    thread.join();
+    EXPECT_NE(wire.find("Connection: close"), std::string::npos);
+    expect_streamed_body(wire);
+}
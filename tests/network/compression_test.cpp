@@ -0,0 +1,283 @@
+#include "dfs/network/compression.hpp"
+#include "dfs/network/http_router.hpp"
+
+#include <gtest/gtest.h>
+
+#ifdef DFS_HAS_ZLIB
+#include <zlib.h>
+#endif
+
+#include <cstring>
+#include <random>
+#include <string>
+#include <string_view>
+
+using namespace dfs::network;
+
+namespace {
+
+#ifdef DFS_HAS_ZLIB
+// Inflates a gzip member; empty string on error
+std::string gunzip(std::string_view data) {
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(stream));
+    if (inflateInit2(&stream, 15 + 16) != Z_OK) {
+        return {};
+    }
+    std::string out;
+    char buffer[16384];
+    stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(data.data()));
+    stream.avail_in = static_cast<uInt>(data.size());
+    int rc = Z_OK;
+    while (rc == Z_OK) {
+        stream.next_out = reinterpret_cast<Bytef*>(buffer);
+        stream.avail_out = sizeof(buffer);
+        rc = inflate(&stream, Z_NO_FLUSH);
+        out.append(buffer, sizeof(buffer) - stream.avail_out);
+    }
+    inflateEnd(&stream);
+    return rc == Z_STREAM_END ? out : std::string{};
+}
+#endif
+
+std::string json_listing(int entries) {
+    std::string body = "[";
+    for (int i = 0; i < entries; ++i) {
+        body += (i ? "," : "");
+        body += R"({"file_path":"/docs/report_)" + std::to_string(i) +
+                R"(.txt","hash":"0123456789abcdef","size":4096,"sync_state":0})";
+    }
+    return body + "]";
+}
+
+std::string body_of(const HttpResponse& response) {
+    return std::string(response.body.begin(), response.body.end());
+}
+
+HttpRequest get_request(std::string_view url, std::string_view accept_encoding) {
+    HttpRequest request;
+    request.method = HttpMethod::GET;
+    request.url = url;
+    if (!accept_encoding.empty()) {
+        request.headers.set("Accept-Encoding", accept_encoding);
+    }
+    return request;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// Negotiation and codecs
+// ════════════════════════════════════════════════════════════
+
+TEST(CompressionTest, NegotiationHonorsQValues) {
+    // What each build answers with when gzip or zstd is the best choice
+    const ContentEncoding gzip =
+        encoding_available(ContentEncoding::GZIP) ? ContentEncoding::GZIP : ContentEncoding::IDENTITY;
+    const ContentEncoding zstd = encoding_available(ContentEncoding::ZSTD) ? ContentEncoding::ZSTD : gzip;
+
+    EXPECT_EQ(negotiate_encoding(""), ContentEncoding::IDENTITY);
+    EXPECT_EQ(negotiate_encoding("gzip, deflate, br"), gzip);
+    EXPECT_EQ(negotiate_encoding("deflate, X-GZIP;q=0.5"), gzip);
+    EXPECT_EQ(negotiate_encoding("gzip;q=0"), ContentEncoding::IDENTITY);
+    EXPECT_EQ(negotiate_encoding("br, identity"), ContentEncoding::IDENTITY);
+
+    EXPECT_EQ(negotiate_encoding("*"), zstd);
+    EXPECT_EQ(negotiate_encoding("zstd, gzip"), zstd);
+    EXPECT_EQ(negotiate_encoding("zstd;q=0.4, gzip;q=0.8"), gzip == ContentEncoding::GZIP ? gzip : zstd);
+    EXPECT_EQ(negotiate_encoding("gzip;q=0, *;q=0.3"),
+              encoding_available(ContentEncoding::ZSTD) ? ContentEncoding::ZSTD : ContentEncoding::IDENTITY);
+}
+
+TEST(CompressionTest, OnlyTextLikeTypesAreCompressible) {
+    EXPECT_TRUE(is_compressible_type("application/json"));
+    EXPECT_TRUE(is_compressible_type("text/html; charset=utf-8"));
+    EXPECT_TRUE(is_compressible_type("application/problem+json"));
+    EXPECT_FALSE(is_compressible_type("application/octet-stream"));
+    EXPECT_FALSE(is_compressible_type("image/png"));
+    EXPECT_FALSE(is_compressible_type(""));
+}
+
+#ifdef DFS_HAS_ZLIB
+TEST(CompressionTest, GzipRoundTripsAcrossContextReuse) {
+    std::string input = json_listing(200);
+    std::string out;
+    for (int level : {6, 1, 9, 6}) {
+        ASSERT_TRUE(compress(ContentEncoding::GZIP, input, level, out).is_ok());
+        EXPECT_LT(out.size(), input.size() / 5);
+        EXPECT_EQ(gunzip(out), input);
+    }
+    // Reset really resets: a small input after a big one
+    ASSERT_TRUE(compress(ContentEncoding::GZIP, "hello", 6, out).is_ok());
+    EXPECT_EQ(gunzip(out), "hello");
+}
+#endif
+
+TEST(CompressionTest, UnavailableCodingIsAnError) {
+    std::string out;
+    EXPECT_TRUE(compress(ContentEncoding::IDENTITY, "abc", 1, out).is_error());
+    for (ContentEncoding encoding : {ContentEncoding::GZIP, ContentEncoding::ZSTD}) {
+        if (!encoding_available(encoding)) {
+            EXPECT_TRUE(compress(encoding, "abc", 1, out).is_error());
+        }
+    }
+}
+
+// ════════════════════════════════════════════════════════════
+// Router filter
+// ════════════════════════════════════════════════════════════
+
+class CompressionFilterTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        router.use_after(compressor.filter());
+        router.get("/snapshot", [this](const HttpContext&) {
+            ++handler_calls;
+            HttpResponse response(HttpStatus::OK);
+            response.set_header("Content-Type", "application/json");
+            response.set_header("ETag", "\"v" + std::to_string(version) + "\"");
+            response.set_body(json_listing(100 + version));
+            return response;
+        });
+        router.get("/small", [](const HttpContext&) {
+            HttpResponse response(HttpStatus::OK);
+            response.set_header("Content-Type", "application/json");
+            response.set_body("{\"ok\":true}");
+            return response;
+        });
+        router.get("/noise", [](const HttpContext&) {
+            std::mt19937 rng(42);
+            std::string noise(8192, '\0');
+            for (auto& c : noise) {
+                c = static_cast<char>(rng());
+            }
+            HttpResponse response(HttpStatus::OK);
+            response.set_header("Content-Type", "text/plain");
+            response.set_body(noise);
+            return response;
+        });
+    }
+
+    CompressionOptions options() {
+        CompressionOptions opts;
+        opts.cache_entries = 4;
+        return opts;
+    }
+
+    ResponseCompressor compressor{options()};
+    HttpRouter router;
+    int version = 1;
+    int handler_calls = 0;
+};
+
+// The filter tests below ask for gzip and inflate what they get
+#ifdef DFS_HAS_ZLIB
+TEST_F(CompressionFilterTest, CompressesLargeJsonForGzipClients) {
+    auto response = router.handle_request(get_request("/snapshot", "gzip"));
+    EXPECT_EQ(response.headers.get("Content-Encoding"), "gzip");
+    EXPECT_EQ(response.headers.get("Vary"), "Accept-Encoding");
+    EXPECT_EQ(response.headers.get("ETag"), "\"v1-gzip\"");
+    EXPECT_EQ(response.headers.get(HeaderId::CONTENT_LENGTH), std::to_string(response.body.size()));
+    EXPECT_EQ(gunzip(body_of(response)), json_listing(101));
+    EXPECT_EQ(compressor.compressed(), 1u);
+    EXPECT_GT(compressor.bytes_in(), 10 * compressor.bytes_out());
+}
+
+TEST_F(CompressionFilterTest, LeavesBodyAloneWhenNotWorthIt) {
+    // Client without Accept-Encoding: identity, but caches must still vary
+    auto plain = router.handle_request(get_request("/snapshot", ""));
+    EXPECT_FALSE(plain.headers.contains("Content-Encoding"));
+    EXPECT_EQ(plain.headers.get("Vary"), "Accept-Encoding");
+    EXPECT_EQ(body_of(plain), json_listing(101));
+
+    auto small = router.handle_request(get_request("/small", "gzip"));
+    EXPECT_FALSE(small.headers.contains("Content-Encoding"));
+    EXPECT_FALSE(small.headers.contains("Vary"));
+
+    auto noise = router.handle_request(get_request("/noise", "gzip"));
+    EXPECT_FALSE(noise.headers.contains("Content-Encoding"));
+    EXPECT_EQ(noise.body.size(), 8192u);
+    EXPECT_EQ(compressor.incompressible(), 1u);
+
+    auto missing = router.handle_request(get_request("/nowhere", "gzip"));
+    EXPECT_FALSE(missing.headers.contains("Content-Encoding"));   // 404 status
+    EXPECT_EQ(compressor.compressed(), 0u);
+}
+
+TEST_F(CompressionFilterTest, StreamedResponsesAreNotCompressed) {
+    router.get("/stream", [](const HttpContext&) {
+        HttpResponse response(HttpStatus::OK);
+        response.set_header("Content-Type", "application/json");
+        response.set_body_stream([](std::string& chunk) {
+            chunk.assign(4096, 'a');
+            return false;
+        });
+        return response;
+    });
+    auto response = router.handle_request(get_request("/stream", "gzip"));
+    EXPECT_TRUE(response.is_streaming());
+    EXPECT_FALSE(response.headers.contains("Content-Encoding"));
+}
+
+TEST_F(CompressionFilterTest, SameStateIsCompressedOnce) {
+    auto first = router.handle_request(get_request("/snapshot", "gzip"));
+    auto second = router.handle_request(get_request("/snapshot", "gzip, br"));
+    EXPECT_EQ(compressor.compressed(), 1u);
+    EXPECT_EQ(compressor.cache_hits(), 1u);
+    EXPECT_EQ(body_of(first), body_of(second));
+    EXPECT_EQ(second.headers.get("ETag"), "\"v1-gzip\"");
+
+    // A write changes the ETag: the stale entry is replaced, not served
+    version = 2;
+    auto third = router.handle_request(get_request("/snapshot", "gzip"));
+    EXPECT_EQ(compressor.compressed(), 2u);
+    EXPECT_EQ(third.headers.get("ETag"), "\"v2-gzip\"");
+    EXPECT_EQ(gunzip(body_of(third)), json_listing(102));
+    EXPECT_EQ(handler_calls, 3);
+}
+
+TEST_F(CompressionFilterTest, IncompressibleVerdictIsCachedToo) {
+    router.get("/blob", [](const HttpContext&) {
+        std::mt19937 rng(7);
+        std::string noise(4096, '\0');
+        for (auto& c : noise) {
+            c = static_cast<char>(rng());
+        }
+        HttpResponse response(HttpStatus::OK);
+        response.set_header("Content-Type", "text/plain");
+        response.set_header("ETag", "\"blob\"");
+        response.set_body(noise);
+        return response;
+    });
+    router.handle_request(get_request("/blob", "gzip"));
+    auto again = router.handle_request(get_request("/blob", "gzip"));
+    EXPECT_EQ(compressor.incompressible(), 1u);
+    EXPECT_EQ(compressor.cache_hits(), 1u);
+    EXPECT_FALSE(again.headers.contains("Content-Encoding"));
+    EXPECT_EQ(again.headers.get("ETag"), "\"blob\"");
+}
+#else
+TEST_F(CompressionFilterTest, GzipClientsGetIdentityWithoutZlib) {
+    auto response = router.handle_request(get_request("/snapshot", "gzip"));
+    EXPECT_FALSE(response.headers.contains("Content-Encoding"));
+    EXPECT_EQ(response.headers.get("Vary"), "Accept-Encoding");
+    EXPECT_EQ(response.headers.get("ETag"), "\"v1\"");
+    EXPECT_EQ(body_of(response), json_listing(101));
+}
+#endif
+
+TEST(CompressionRouterTest, FiltersRunAfterShortCircuitingMiddleware) {
+    HttpRouter router;
+    router.use([](const HttpContext&, HttpResponse& response) {
+        response = HttpResponse(HttpStatus::UNAUTHORIZED);
+        return false;
+    });
+    int filtered = 0;
+    router.use_after([&filtered](const HttpContext&, HttpResponse& response) {
+        ++filtered;
+        response.set_header("X-Filtered", "yes");
+    });
+    auto response = router.handle_request(get_request("/anything", ""));
+    EXPECT_EQ(filtered, 1);
+    EXPECT_EQ(response.headers.get("X-Filtered"), "yes");
+}
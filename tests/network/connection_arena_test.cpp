@@ -0,0 +1,191 @@
+#include "dfs/network/buffer_pool.hpp"
+#include "dfs/network/connection_arena.hpp"
+#include "dfs/network/http_parser.hpp"
+#include "dfs/network/http_types.hpp"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace dfs::network;
+
+// ════════════════════════════════════════════════════════════
+// Global allocation counter (this test binary only)
+// ════════════════════════════════════════════════════════════
+
+namespace {
+std::atomic<size_t> g_heap_allocations{0};
+} // namespace
+
+void* operator new(std::size_t size) {
+    g_heap_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size == 0 ? 1 : size)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+namespace {
+
+constexpr std::string_view kRequest =
+    "POST /api/files/report.txt HTTP/1.1\r\n"
+    "Host: localhost:8080\r\n"
+    "User-Agent: connection-arena-test/1.0\r\n"
+    "Accept: application/json\r\n"
+    "Content-Type: application/octet-stream\r\n"
+    "Content-Length: 32\r\n"
+    "\r\n"
+    "0123456789abcdef0123456789abcdef";
+
+HttpResponse handle(const HttpRequest& request) {
+    HttpResponse response(HttpStatus::OK);
+    response.set_header("Content-Type", "application/json");
+    response.set_header("X-Request-Path", request.url);
+    response.set_body(std::string_view(reinterpret_cast<const char*>(request.body.data()),
+                                       request.body.size()));
+    return response;
+}
+
+// One request through parse, handle and serialize, as the servers do it
+size_t serve_one(ConnectionArena& arena, HttpParser& parser) {
+    size_t bytes = 0;
+    {
+        ArenaScope scope(arena);
+        parser.reset();
+        auto parsed = parser.parse(kRequest.data(), kRequest.size());
+        EXPECT_TRUE(parsed.is_ok() && parsed.value());
+
+        HttpResponse response = handle(parser.request());
+        std::pmr::vector<uint8_t> out(arena.resource());
+        response.serialize_into(out);
+        bytes = out.size();
+    }
+    parser.reset();
+    arena.reset();
+    return bytes;
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// ConnectionArena
+// ════════════════════════════════════════════════════════════
+
+TEST(ConnectionArenaTest, ScopeBindsAndRestoresRequestResource) {
+    ConnectionArena outer;
+    ConnectionArena inner;
+    EXPECT_EQ(request_resource(), std::pmr::get_default_resource());
+    {
+        ArenaScope a(outer);
+        EXPECT_EQ(request_resource(), outer.resource());
+        {
+            ArenaScope b(inner);
+            EXPECT_EQ(request_resource(), inner.resource());
+        }
+        EXPECT_EQ(request_resource(), outer.resource());
+    }
+    EXPECT_EQ(request_resource(), std::pmr::get_default_resource());
+}
+
+TEST(ConnectionArenaTest, ResetReusesInitialBlock) {
+    ConnectionArena arena;
+    void* first = arena.resource()->allocate(64);
+    arena.reset();
+    void* again = arena.resource()->allocate(64);
+    EXPECT_EQ(first, again);
+}
+
+TEST(ConnectionArenaTest, RequestBuiltInScopeUsesArena) {
+    ConnectionArena arena;
+    ArenaScope scope(arena);
+    HttpRequest request;
+    request.url = "/a/path/long/enough/to/leave/the/small/string/buffer";
+    EXPECT_EQ(request.url.get_allocator().resource(), arena.resource());
+    EXPECT_EQ(request.body.get_allocator().resource(), arena.resource());
+}
+
+TEST(ConnectionArenaTest, CopiesEscapeTheArena) {
+    ConnectionArena arena;
+    HttpResponse kept;
+    {
+        ArenaScope scope(arena);
+        HttpResponse response(HttpStatus::OK);
+        response.set_body("cached body");
+        kept = HttpResponse(response);   // Copy: default resource
+    }
+    arena.reset();
+    EXPECT_EQ(kept.body.get_allocator().resource(), std::pmr::get_default_resource());
+    EXPECT_EQ(std::string(kept.body.begin(), kept.body.end()), "cached body");
+}
+
+TEST(ConnectionArenaTest, SteadyStateRequestsDoNotTouchTheHeap) {
+    std::pmr::unsynchronized_pool_resource pool;
+    ConnectionArena arena(&pool);
+    HttpParser parser;
+
+    size_t expected = serve_one(arena, parser);   // Warm-up grows token buffers
+    ASSERT_GT(expected, kRequest.size() / 2);
+
+    size_t before = g_heap_allocations.load();
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(serve_one(arena, parser), expected);
+    }
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+}
+
+// ════════════════════════════════════════════════════════════
+// BufferPool
+// ════════════════════════════════════════════════════════════
+
+TEST(BufferPoolTest, LeasesAreRecycled) {
+    BufferPool pool(1024);
+    uint8_t* first = nullptr;
+    {
+        auto lease = pool.acquire();
+        ASSERT_TRUE(lease);
+        EXPECT_EQ(lease.size(), 1024u);
+        first = lease.data();
+    }
+    auto again = pool.acquire();
+    EXPECT_EQ(again.data(), first);
+    EXPECT_EQ(pool.slab_count(), 1u);
+}
+
+TEST(BufferPoolTest, GrowsBySlabWhenExhausted) {
+    BufferPool pool(256);
+    std::vector<BufferPool::Lease> leases;
+    for (size_t i = 0; i < BufferPool::kSlabBuffers + 1; ++i) {
+        leases.push_back(pool.acquire());
+    }
+    EXPECT_EQ(pool.slab_count(), 2u);
+    EXPECT_EQ(pool.free_count(), BufferPool::kSlabBuffers - 1);
+
+    leases.clear();
+    EXPECT_EQ(pool.free_count(), 2 * BufferPool::kSlabBuffers);
+}
+
+TEST(BufferPoolTest, AcquireAfterWarmUpDoesNotAllocate) {
+    BufferPool pool(512);
+    { auto warm = pool.acquire(); }
+
+    size_t before = g_heap_allocations.load();
+    for (int i = 0; i < 100; ++i) {
+        auto lease = pool.acquire();
+        lease.data()[0] = static_cast<uint8_t>(i);
+    }
+    EXPECT_EQ(g_heap_allocations.load() - before, 0u);
+}
@@ -0,0 +1,135 @@
+#include "dfs/network/http_headers.hpp"
+#include "dfs/network/http_parser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+using namespace dfs::network;
+
+TEST(HttpHeadersTest, LookupIgnoresCase) {
+    HttpHeaders headers;
+    headers.set("X-Request-Id", "abc");
+    EXPECT_EQ(headers.get("x-request-id"), "abc");
+    EXPECT_EQ(headers.get("X-REQUEST-ID"), "abc");
+    EXPECT_TRUE(headers.contains("x-Request-id"));
+    EXPECT_FALSE(headers.contains("X-Request"));
+    EXPECT_EQ(headers.get("missing"), "");
+}
+
+TEST(HttpHeadersTest, WellKnownHeadersGetIds) {
+    EXPECT_EQ(header_id("content-length"), HeaderId::CONTENT_LENGTH);
+    EXPECT_EQ(header_id("CONNECTION"), HeaderId::CONNECTION);
+    EXPECT_EQ(header_id("Content-Type"), HeaderId::CONTENT_TYPE);
+    EXPECT_EQ(header_id("Content-Typf"), HeaderId::OTHER);
+
+    HttpHeaders headers;
+    headers.set("content-type", "text/plain");
+    EXPECT_EQ(headers.get(HeaderId::CONTENT_TYPE), "text/plain");
+    EXPECT_TRUE(headers.contains(HeaderId::CONTENT_TYPE));
+    EXPECT_FALSE(headers.contains(HeaderId::CONTENT_LENGTH));
+    EXPECT_EQ(headers.id_at(0), HeaderId::CONTENT_TYPE);
+}
+
+TEST(HttpHeadersTest, SetReplacesAndAddAppends) {
+    HttpHeaders headers;
+    headers.set("Connection", "keep-alive");
+    headers.set("connection", "close");          // Shorter: overwritten in place
+    EXPECT_EQ(headers.size(), 1u);
+    EXPECT_EQ(headers.get(HeaderId::CONNECTION), "close");
+
+    headers.set(HeaderId::CONNECTION, "keep-alive, Upgrade");   // Longer: appended
+    EXPECT_EQ(headers.size(), 1u);
+    EXPECT_EQ(headers.get("Connection"), "keep-alive, Upgrade");
+
+    headers.add("Via", "a");
+    headers.add("via", "b");
+    EXPECT_EQ(headers.size(), 3u);
+    EXPECT_EQ(headers.get("Via"), "a");
+}
+
+TEST(HttpHeadersTest, EraseRemovesEveryMatchAndKeepsIndex) {
+    HttpHeaders headers;
+    headers.add("Via", "a");
+    headers.set("Content-Length", "10");
+    headers.add("VIA", "b");
+    EXPECT_EQ(headers.erase("via"), 2u);
+    EXPECT_EQ(headers.size(), 1u);
+    EXPECT_EQ(headers.get(HeaderId::CONTENT_LENGTH), "10");
+}
+
+TEST(HttpHeadersTest, IteratesInInsertionOrder) {
+    HttpHeaders headers;
+    headers.set("B", "2");
+    headers.set("A", "1");
+    headers.set("C", "3");
+
+    std::vector<std::pair<std::string, std::string>> seen;
+    for (auto [name, value] : headers) {
+        seen.emplace_back(name, value);
+    }
+    std::vector<std::pair<std::string, std::string>> expected{{"B", "2"}, {"A", "1"}, {"C", "3"}};
+    EXPECT_EQ(seen, expected);
+}
+
+TEST(HttpHeadersTest, CopyIsIndependentAndUsesDefaultResource) {
+    std::pmr::monotonic_buffer_resource arena;
+    HttpHeaders original(&arena);
+    original.set("Content-Type", "text/html");
+
+    HttpHeaders copy(original);
+    original.set("Content-Type", "application/json");
+    EXPECT_EQ(copy.get(HeaderId::CONTENT_TYPE), "text/html");
+    EXPECT_EQ(copy.resource(), std::pmr::get_default_resource());
+}
+
+// ════════════════════════════════════════════════════════════
+// Parser integration
+// ════════════════════════════════════════════════════════════
+
+TEST(HttpHeadersTest, ParserReadsBodyWithLowercaseContentLength) {
+    constexpr std::string_view raw =
+        "POST /upload HTTP/1.1\r\n"
+        "content-length: 5\r\n"
+        "\r\n"
+        "hello";
+    HttpParser parser;
+    auto parsed = parser.parse(raw.data(), raw.size());
+    ASSERT_TRUE(parsed.is_ok());
+    ASSERT_TRUE(parsed.value());
+    EXPECT_EQ(parser.request().body_as_string(), "hello");
+    EXPECT_EQ(parser.request().get_header("Content-Length"), "5");
+}
+
+TEST(HttpHeadersTest, ParserRejectsNonNumericContentLength) {
+    constexpr std::string_view raw =
+        "POST /upload HTTP/1.1\r\n"
+        "Content-Length: 5x\r\n"
+        "\r\n";
+    HttpParser parser;
+    EXPECT_TRUE(parser.parse(raw.data(), raw.size()).is_error());
+}
+
+// ════════════════════════════════════════════════════════════
+// Conditional requests
+// ════════════════════════════════════════════════════════════
+
+TEST(HttpHeadersTest, EtagMatchesUsesWeakComparisonAndLists) {
+    EXPECT_TRUE(etag_matches("\"abc\"", "\"abc\""));
+    EXPECT_TRUE(etag_matches("W/\"abc\"", "\"abc\""));
+    EXPECT_TRUE(etag_matches("\"x\", \"abc\"", "\"abc\""));
+    EXPECT_TRUE(etag_matches("*", "\"abc\""));
+    EXPECT_FALSE(etag_matches("\"abd\"", "\"abc\""));
+    EXPECT_FALSE(etag_matches("", "\"abc\""));
+    EXPECT_FALSE(etag_matches("*", ""));
+}
+
+TEST(HttpHeadersTest, EtagMatchesIgnoresCodingSuffix) {
+    EXPECT_TRUE(etag_matches("\"abc-gzip\"", "\"abc\""));
+    EXPECT_TRUE(etag_matches("\"abc-zstd\"", "\"abc\""));
+    EXPECT_FALSE(etag_matches("\"abx-gzip\"", "\"abc\""));
+    EXPECT_FALSE(etag_matches("\"abc-br\"", "\"abc\""));
+}
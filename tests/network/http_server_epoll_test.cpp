@@ -0,0 +1,208 @@
+#include "dfs/network/http_server_epoll.hpp"
+
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace dfs::network;
+
+namespace {
+
+constexpr size_t kBulkBody = 64 * 1024;   // Body served for GET /bulk
+
+// Starts an epoll server on a free port and stops it on destruction
+class EpollServerFixture : public ::testing::Test {
+protected:
+    void start(std::chrono::milliseconds idle_timeout = std::chrono::seconds(30)) {
+        server_ = std::make_unique<HttpServerEpoll>(2, idle_timeout);
+        server_->set_handler([](const HttpRequest& request) {
+            HttpResponse response(HttpStatus::OK);
+            if (request.url == "/bulk") {
+                response.set_body(std::string(kBulkBody, 'x'));
+                return response;
+            }
+            response.set_body("echo:" + std::string(request.url) + ":" + request.body_as_string());
+            return response;
+        });
+        ASSERT_TRUE(server_->listen(0, "127.0.0.1").is_ok());
+        thread_ = std::thread([this] { server_->serve_forever(); });
+        while (!server_->is_running()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void TearDown() override {
+        if (server_) {
+            server_->stop();
+            thread_.join();
+        }
+    }
+
+    std::unique_ptr<Socket> connect_client() {
+        auto client = std::make_unique<Socket>();
+        EXPECT_TRUE(client->create(SocketType::TCP).is_ok());
+        EXPECT_TRUE(client->connect("127.0.0.1", server_->get_port()).is_ok());
+        return client;
+    }
+
+    static void send_text(Socket& socket, const std::string& text) {
+        ASSERT_TRUE(socket.send(std::vector<uint8_t>(text.begin(), text.end())).is_ok());
+    }
+
+    // Reads until `count` full responses (by Content-Length) have arrived
+    // or the peer closes.
+    static std::string read_responses(Socket& socket, int count) {
+        std::string data;
+        int complete = 0;
+        while (complete < count) {
+            auto chunk = socket.receive(4096);
+            if (chunk.is_error() || chunk.value().empty()) {
+                break;
+            }
+            data.append(chunk.value().begin(), chunk.value().end());
+
+            complete = 0;
+            size_t pos = 0;
+            while (true) {
+                size_t header_end = data.find("\r\n\r\n", pos);
+                if (header_end == std::string::npos) {
+                    break;
+                }
+                size_t length_at = data.find("Content-Length: ", pos);
+                size_t length = std::stoul(data.substr(length_at + 16));
+                if (data.size() < header_end + 4 + length) {
+                    break;
+                }
+                ++complete;
+                pos = header_end + 4 + length;
+            }
+        }
+        return data;
+    }
+
+    std::unique_ptr<HttpServerEpoll> server_;
+    std::thread thread_;
+};
+
+} // namespace
+
+TEST_F(EpollServerFixture, ServesSingleRequest) {
+    start();
+    auto client = connect_client();
+    send_text(*client, "GET /hello HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n");
+
+    std::string response = read_responses(*client, 1);
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("echo:/hello:"), std::string::npos);
+    EXPECT_NE(response.find("Connection: close"), std::string::npos);
+}
+
+TEST_F(EpollServerFixture, KeepAliveHandlesPipelinedRequests) {
+    start();
+    auto client = connect_client();
+    send_text(*client,
+              "POST /a HTTP/1.1\r\nContent-Length: 3\r\n\r\none"
+              "POST /b HTTP/1.1\r\nContent-Length: 3\r\n\r\ntwo");
+
+    std::string responses = read_responses(*client, 2);
+    size_t first = responses.find("echo:/a:one");
+    size_t second = responses.find("echo:/b:two");
+    ASSERT_NE(first, std::string::npos);
+    ASSERT_NE(second, std::string::npos);
+    EXPECT_LT(first, second);
+
+    // Same connection still usable
+    send_text(*client, "GET /c HTTP/1.1\r\n\r\n");
+    EXPECT_NE(read_responses(*client, 1).find("echo:/c:"), std::string::npos);
+    EXPECT_EQ(server_->get_total_processed(), 3u);
+}
+
+TEST_F(EpollServerFixture, ManyConcurrentClients) {
+    start();
+    constexpr int kClients = 32;
+    std::vector<std::unique_ptr<Socket>> clients;
+    for (int i = 0; i < kClients; ++i) {
+        clients.push_back(connect_client());
+    }
+    for (int i = 0; i < kClients; ++i) {
+        send_text(*clients[i], "GET /c" + std::to_string(i) + " HTTP/1.1\r\n\r\n");
+    }
+    for (int i = 0; i < kClients; ++i) {
+        std::string expected = "echo:/c" + std::to_string(i) + ":";
+        EXPECT_NE(read_responses(*clients[i], 1).find(expected), std::string::npos);
+    }
+}
+
+TEST_F(EpollServerFixture, MalformedRequestGets400AndClose) {
+    start();
+    auto client = connect_client();
+    send_text(*client, "BOGUS\r\n\r\n");
+    std::string response = read_responses(*client, 1);
+    EXPECT_EQ(response.rfind("HTTP/1.1 400", 0), 0u);
+}
+
+TEST_F(EpollServerFixture, IdleConnectionIsClosed) {
+    start(std::chrono::milliseconds(200));
+    auto client = connect_client();
+    while (server_->get_active_connections() == 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(3);
+    while (server_->get_active_connections() != 0 && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    EXPECT_EQ(server_->get_active_connections(), 0u);
+
+    auto eof = client->receive(16);
+    EXPECT_TRUE(eof.is_error() || eof.value().empty());
+}
+
+TEST_F(EpollServerFixture, PipelinedClientThatNeverReadsIsPaused) {
+    start();
+
+    // Size of one /bulk response, taken from a separate connection
+    auto probe = connect_client();
+    send_text(*probe, "GET /bulk HTTP/1.1\r\n\r\n");
+    const size_t response_size = read_responses(*probe, 1).size();
+    ASSERT_GT(response_size, kBulkBody);
+
+    // A small receive buffer keeps the kernel from absorbing the test
+    auto client = connect_client();
+    int rcvbuf = 64 * 1024;
+    ::setsockopt(client->native_handle(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    constexpr size_t kRequests = 300;    // ~19 MiB of responses
+    std::string requests;
+    for (size_t i = 0; i < kRequests; ++i) {
+        requests += "GET /bulk HTTP/1.1\r\n\r\n";
+    }
+    send_text(*client, requests);
+
+    // Wait until the server stops answering
+    size_t processed = 0;
+    do {
+        processed = server_->get_total_processed();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    } while (processed != server_->get_total_processed());
+
+    // Only the 1 MiB of queued output and what the socket buffers hold
+    // were answered, not the whole pipeline
+    EXPECT_LT(processed, kRequests / 2);
+
+    // Reading drains the queue and the server resumes where it paused
+    size_t received = 0;
+    while (received < kRequests * response_size) {
+        auto chunk = client->receive(256 * 1024);
+        ASSERT_TRUE(chunk.is_ok());
+        ASSERT_FALSE(chunk.value().empty());
+        received += chunk.value().size();
+    }
+    EXPECT_EQ(received, kRequests * response_size);
+    EXPECT_EQ(server_->get_total_processed(), kRequests + 1);
+}
@@ -0,0 +1,496 @@
+#include "dfs/network/http_server_epoll.hpp"
+#include "dfs/network/rpc.hpp"
+#include "dfs/core/work_stealing_pool.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/socket.h>
+#include <sys/time.h>
+
+using namespace dfs::network;
+
+namespace {
+
+std::vector<uint8_t> frame(uint8_t type, uint32_t id, const std::string& payload) {
+    std::vector<uint8_t> out;
+    RpcFrameHeader{type, 0, id, static_cast<uint32_t>(payload.size())}
+        .append_to(out, reinterpret_cast<const uint8_t*>(payload.data()));
+    return out;
+}
+
+std::vector<uint8_t> preamble() {
+    return std::vector<uint8_t>(kRpcPreamble.begin(), kRpcPreamble.end());
+}
+
+std::vector<uint8_t> bytes(const std::string& text) {
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+struct Frame {
+    RpcFrameHeader header;
+    std::string payload;
+};
+
+// RPC requests handled by the fixture's handler, by type
+enum : uint8_t {
+    kEcho = 1,       // Inline: "echo:" + payload
+    kDeferred = 2,   // From a thread after 100 ms: "late:" + payload
+    kPooled = 3,     // From a worker: payload
+    kDropped = 4,    // Never answered
+    kThrows = 5,
+    kParked = 6,     // Reply kept by the test
+    kOversized = 7,  // Replies with kRpcMaxPayload + 1 bytes
+    kBulk = 8,       // Inline: kBulkReply bytes
+};
+
+constexpr size_t kBulkReply = 64 * 1024;
+
+class RpcServerFixture : public ::testing::Test {
+protected:
+    void start(bool with_rpc = true) {
+        server_ = std::make_unique<HttpServerEpoll>(2);
+        server_->set_handler([](const HttpRequest& request) {
+            HttpResponse response(HttpStatus::OK);
+            response.set_body("http:" + std::string(request.url));
+            return response;
+        });
+        if (with_rpc) {
+            server_->set_rpc_handler([this](RpcRequest request, RpcReply reply) { handle(std::move(request), std::move(reply)); });
+        }
+        ASSERT_TRUE(server_->listen(0, "127.0.0.1").is_ok());
+        thread_ = std::thread([this] { server_->serve_forever(); });
+        while (!server_->is_running()) {
+            std::this_thread::yield();
+        }
+    }
+
+    void TearDown() override {
+        for (auto& thread : deferred_) {
+            thread.join();
+        }
+        pool_.wait_idle();
+        if (server_) {
+            server_->stop();
+            thread_.join();
+        }
+    }
+
+    void handle(RpcRequest request, RpcReply reply) {
+        std::string text(request.payload.begin(), request.payload.end());
+        switch (request.type) {
+        case kEcho:
+            reply.send(bytes("echo:" + text));
+            break;
+        case kDeferred: {
+            std::lock_guard lock(mutex_);
+            deferred_.emplace_back([text, reply = std::move(reply)]() mutable {
+                std::this_thread::sleep_for(std::chrono::milliseconds(100));
+                reply.send(bytes("late:" + text));
+            });
+            break;
+        }
+        case kPooled:
+            pool_.submit([payload = std::move(request.payload), reply = std::move(reply)]() mutable {
+                reply.send(std::move(payload));
+            });
+            break;
+        case kDropped:
+            break;
+        case kThrows:
+            throw std::runtime_error("boom");
+        case kParked: {
+            std::lock_guard lock(mutex_);
+            parked_ = std::move(reply);
+            break;
+        }
+        case kOversized:
+            reply.send(std::vector<uint8_t>(kRpcMaxPayload + 1));
+            break;
+        case kBulk:
+            reply.send(std::vector<uint8_t>(kBulkReply, 'x'));
+            break;
+        default:
+            reply.fail("unknown");
+        }
+    }
+
+    std::unique_ptr<Socket> connect_client() {
+        auto client = std::make_unique<Socket>();
+        EXPECT_TRUE(client->create(SocketType::TCP).is_ok());
+        timeval tv{5, 0};   // A missing reply fails the test instead of hanging it
+        ::setsockopt(client->native_handle(), SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        EXPECT_TRUE(client->connect("127.0.0.1", server_->get_port()).is_ok());
+        return client;
+    }
+
+    static void send_bytes(Socket& socket, const std::vector<uint8_t>& data) {
+        ASSERT_TRUE(socket.send(data).is_ok());
+    }
+
+    static bool read_exact(Socket& socket, uint8_t* data, size_t size) {
+        while (size > 0) {
+            auto n = socket.receive_into(data, size);
+            if (n.is_error() || n.value() == 0) {
+                return false;
+            }
+            data += n.value();
+            size -= n.value();
+        }
+        return true;
+    }
+
+    static std::optional<Frame> read_frame(Socket& socket) {
+        uint8_t header[kRpcHeaderSize];
+        if (!read_exact(socket, header, sizeof(header))) {
+            return std::nullopt;
+        }
+        Frame frame{RpcFrameHeader::decode(header), {}};
+        frame.payload.resize(frame.header.length);
+        if (!read_exact(socket, reinterpret_cast<uint8_t*>(frame.payload.data()), frame.payload.size())) {
+            return std::nullopt;
+        }
+        return frame;
+    }
+
+    // True if the server closed the connection (EOF before any byte)
+    static bool closed_by_peer(Socket& socket) {
+        uint8_t byte;
+        auto n = socket.receive_into(&byte, 1);
+        return n.is_ok() && n.value() == 0;
+    }
+
+    std::unique_ptr<HttpServerEpoll> server_;
+    std::thread thread_;
+    dfs::WorkStealingPool pool_{4};
+    std::mutex mutex_;
+    std::vector<std::thread> deferred_;
+    RpcReply parked_;
+};
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// Framing
+// ════════════════════════════════════════════════════════════
+
+TEST(RpcFrameTest, HeaderIsBigEndianAndRoundTrips) {
+    RpcFrameHeader header{7, kRpcReply | kRpcError, 0x01020304, 0x0A0B0C0D};
+    uint8_t wire[kRpcHeaderSize];
+    header.encode(wire);
+    const uint8_t expected[kRpcHeaderSize] = {7, 0x03, 1, 2, 3, 4, 0x0A, 0x0B, 0x0C, 0x0D};
+    EXPECT_EQ(std::vector<uint8_t>(wire, wire + kRpcHeaderSize),
+              std::vector<uint8_t>(expected, expected + kRpcHeaderSize));
+
+    auto decoded = RpcFrameHeader::decode(wire);
+    EXPECT_EQ(decoded.type, 7);
+    EXPECT_EQ(decoded.flags, kRpcReply | kRpcError);
+    EXPECT_EQ(decoded.request_id, 0x01020304u);
+    EXPECT_EQ(decoded.length, 0x0A0B0C0Du);
+
+    // Ten bytes of framing per request, against a few hundred for HTTP
+    auto request = frame(1, 9, "abc");
+    EXPECT_EQ(request.size(), kRpcHeaderSize + 3);
+}
+
+// ════════════════════════════════════════════════════════════
+// Serving
+// ════════════════════════════════════════════════════════════
+
+TEST_F(RpcServerFixture, AnswersPipelinedRequests) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    for (uint32_t id = 1; id <= 3; ++id) {
+        auto request = frame(kEcho, id, "m" + std::to_string(id));
+        wire.insert(wire.end(), request.begin(), request.end());
+    }
+    send_bytes(*client, wire);
+
+    for (uint32_t id = 1; id <= 3; ++id) {
+        auto reply = read_frame(*client);
+        ASSERT_TRUE(reply.has_value());
+        EXPECT_EQ(reply->header.type, kEcho);
+        EXPECT_EQ(reply->header.flags, kRpcReply);
+        EXPECT_EQ(reply->header.request_id, id);
+        EXPECT_EQ(reply->payload, "echo:m" + std::to_string(id));
+    }
+    EXPECT_EQ(server_->get_total_processed(), 3u);
+}
+
+TEST_F(RpcServerFixture, RepliesInCompletionOrder) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    auto slow = frame(kDeferred, 1, "slow");
+    auto fast = frame(kEcho, 2, "fast");
+    wire.insert(wire.end(), slow.begin(), slow.end());
+    wire.insert(wire.end(), fast.begin(), fast.end());
+    send_bytes(*client, wire);
+
+    auto first = read_frame(*client);
+    auto second = read_frame(*client);
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    EXPECT_EQ(first->header.request_id, 2u);
+    EXPECT_EQ(first->payload, "echo:fast");
+    EXPECT_EQ(second->header.request_id, 1u);
+    EXPECT_EQ(second->payload, "late:slow");
+}
+
+TEST_F(RpcServerFixture, RepliesFromWorkersReachTheirConnections) {
+    start();
+    constexpr uint32_t kRequests = 300;
+    std::vector<std::unique_ptr<Socket>> clients;
+    for (int i = 0; i < 3; ++i) {
+        clients.push_back(connect_client());
+        auto wire = preamble();
+        for (uint32_t id = 0; id < kRequests; ++id) {
+            auto request = frame(kPooled, id, std::to_string(i) + ":" + std::to_string(id));
+            wire.insert(wire.end(), request.begin(), request.end());
+        }
+        send_bytes(*clients.back(), wire);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        std::set<uint32_t> seen;
+        for (uint32_t n = 0; n < kRequests; ++n) {
+            auto reply = read_frame(*clients[i]);
+            ASSERT_TRUE(reply.has_value());
+            EXPECT_EQ(reply->payload, std::to_string(i) + ":" + std::to_string(reply->header.request_id));
+            seen.insert(reply->header.request_id);
+        }
+        EXPECT_EQ(seen.size(), kRequests);
+    }
+}
+
+TEST_F(RpcServerFixture, ReassemblesFramesSplitAcrossReads) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    auto request = frame(kEcho, 42, std::string(50000, 'z'));
+    wire.insert(wire.end(), request.begin(), request.end());
+
+    // Preamble and header cut mid-way, payload in pieces
+    const size_t cuts[] = {3, 11, 15, 4000, wire.size()};
+    size_t sent = 0;
+    for (size_t cut : cuts) {
+        send_bytes(*client, std::vector<uint8_t>(wire.begin() + static_cast<long>(sent), wire.begin() + static_cast<long>(cut)));
+        sent = cut;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->header.request_id, 42u);
+    EXPECT_EQ(reply->payload, "echo:" + std::string(50000, 'z'));
+}
+
+TEST_F(RpcServerFixture, ReassemblesFramesLargerThanTheReserve) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    std::string payload(300000, '\0');
+    for (size_t i = 0; i < payload.size(); ++i) {
+        payload[i] = static_cast<char>('a' + i % 26);
+    }
+    auto request = frame(kEcho, 7, payload);
+    wire.insert(wire.end(), request.begin(), request.end());
+
+    // The buffer grows piece by piece instead of up front
+    for (size_t sent = 0; sent < wire.size();) {
+        size_t piece = std::min<size_t>(70000, wire.size() - sent);
+        send_bytes(*client, std::vector<uint8_t>(wire.begin() + static_cast<long>(sent),
+                                                 wire.begin() + static_cast<long>(sent + piece)));
+        sent += piece;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+
+    auto reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->header.request_id, 7u);
+    EXPECT_EQ(reply->payload, "echo:" + payload);
+}
+
+TEST_F(RpcServerFixture, ClientThatNeverReadsStopsFrameDispatch) {
+    start();
+    auto client = connect_client();
+    int rcvbuf = 64 * 1024;   // Keep the kernel from absorbing the replies
+    ::setsockopt(client->native_handle(), SOL_SOCKET, SO_RCVBUF, &rcvbuf, sizeof(rcvbuf));
+
+    constexpr uint32_t kRequests = 300;   // ~19 MiB of replies
+    auto wire = preamble();
+    for (uint32_t id = 1; id <= kRequests; ++id) {
+        auto request = frame(kBulk, id, "");
+        wire.insert(wire.end(), request.begin(), request.end());
+    }
+    send_bytes(*client, wire);
+
+    // Wait until the server stops dispatching
+    size_t processed = 0;
+    do {
+        processed = server_->get_total_processed();
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    } while (processed != server_->get_total_processed());
+
+    // Frames behind 1 MiB of unsent replies were not dispatched
+    EXPECT_LT(processed, kRequests / 2);
+
+    // Reading the replies resumes dispatch until every request is answered
+    std::set<uint32_t> answered;
+    for (uint32_t i = 0; i < kRequests; ++i) {
+        auto reply = read_frame(*client);
+        ASSERT_TRUE(reply.has_value());
+        EXPECT_EQ(reply->header.flags, kRpcReply);
+        EXPECT_EQ(reply->payload.size(), kBulkReply);
+        answered.insert(reply->header.request_id);
+    }
+    EXPECT_EQ(answered.size(), kRequests);
+    EXPECT_EQ(server_->get_total_processed(), kRequests);
+}
+
+TEST_F(RpcServerFixture, SharesThePortWithHttp) {
+    start();
+    auto rpc = connect_client();
+    auto wire = preamble();
+    auto request = frame(kEcho, 1, "x");
+    wire.insert(wire.end(), request.begin(), request.end());
+    send_bytes(*rpc, wire);
+
+    auto http = connect_client();
+    send_bytes(*http, bytes("GET /plain HTTP/1.1\r\nHost: x\r\nConnection: close\r\n\r\n"));
+    std::string response;
+    while (true) {
+        auto chunk = http->receive(4096);
+        if (chunk.is_error() || chunk.value().empty()) {
+            break;
+        }
+        response.append(chunk.value().begin(), chunk.value().end());
+    }
+    EXPECT_EQ(response.rfind("HTTP/1.1 200 OK\r\n", 0), 0u);
+    EXPECT_NE(response.find("http:/plain"), std::string::npos);
+
+    auto reply = read_frame(*rpc);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, "echo:x");
+}
+
+// ════════════════════════════════════════════════════════════
+// Failures
+// ════════════════════════════════════════════════════════════
+
+TEST_F(RpcServerFixture, UnansweredRequestsGetAnError) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    for (auto type : {kDropped, kThrows}) {
+        auto request = frame(type, type, "");
+        wire.insert(wire.end(), request.begin(), request.end());
+    }
+    send_bytes(*client, wire);
+
+    for (int i = 0; i < 2; ++i) {
+        auto reply = read_frame(*client);
+        ASSERT_TRUE(reply.has_value());
+        EXPECT_EQ(reply->header.flags, kRpcReply | kRpcError);
+        EXPECT_FALSE(reply->payload.empty());
+    }
+
+    // The connection is still usable
+    send_bytes(*client, frame(kEcho, 3, "after"));
+    auto reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, "echo:after");
+}
+
+TEST_F(RpcServerFixture, OversizedReplyBecomesAnError) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    auto request = frame(kOversized, 1, "");
+    wire.insert(wire.end(), request.begin(), request.end());
+    send_bytes(*client, wire);
+
+    auto reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->header.flags, kRpcReply | kRpcError);
+    EXPECT_NE(reply->payload.find("exceeds the RPC limit"), std::string::npos) << reply->payload;
+
+    send_bytes(*client, frame(kEcho, 2, "after"));
+    reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, "echo:after");
+}
+
+TEST_F(RpcServerFixture, ReplyAfterDisconnectIsDropped) {
+    start();
+    {
+        auto client = connect_client();
+        auto wire = preamble();
+        auto request = frame(kParked, 1, "");
+        wire.insert(wire.end(), request.begin(), request.end());
+        send_bytes(*client, wire);
+        for (int i = 0; i < 200 && server_->get_total_processed() == 0; ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    while (server_->get_active_connections() > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    {
+        std::lock_guard lock(mutex_);
+        ASSERT_TRUE(parked_.pending());
+        parked_.send(bytes("too late"));
+    }
+
+    auto client = connect_client();
+    auto wire = preamble();
+    auto request = frame(kEcho, 1, "fresh");
+    wire.insert(wire.end(), request.begin(), request.end());
+    send_bytes(*client, wire);
+    auto reply = read_frame(*client);
+    ASSERT_TRUE(reply.has_value());
+    EXPECT_EQ(reply->payload, "echo:fresh");
+}
+
+TEST_F(RpcServerFixture, BadPreambleClosesTheConnection) {
+    start();
+    auto client = connect_client();
+    send_bytes(*client, bytes(std::string("\0DFSRPC9", 8)));
+    EXPECT_TRUE(closed_by_peer(*client));
+}
+
+TEST_F(RpcServerFixture, OversizedOrReplyFramesCloseTheConnection) {
+    start();
+    auto client = connect_client();
+    auto wire = preamble();
+    uint8_t header[kRpcHeaderSize];
+    RpcFrameHeader{kEcho, 0, 1, kRpcMaxPayload + 1}.encode(header);
+    wire.insert(wire.end(), header, header + kRpcHeaderSize);
+    send_bytes(*client, wire);
+    EXPECT_TRUE(closed_by_peer(*client));
+
+    auto other = connect_client();
+    wire = preamble();
+    RpcFrameHeader{kEcho, kRpcReply, 1, 0}.encode(header);
+    wire.insert(wire.end(), header, header + kRpcHeaderSize);
+    send_bytes(*other, wire);
+    EXPECT_TRUE(closed_by_peer(*other));
+}
+
+TEST_F(RpcServerFixture, PreambleIsABadRequestWithoutAnRpcHandler) {
+    start(false);
+    auto client = connect_client();
+    send_bytes(*client, preamble());
+    auto response = client->receive(4096);
+    ASSERT_TRUE(response.is_ok());
+    std::string text(response.value().begin(), response.value().end());
+    EXPECT_EQ(text.rfind("HTTP/1.1 400", 0), 0u) << text;
+}
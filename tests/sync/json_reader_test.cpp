@@ -0,0 +1,186 @@
+#include "dfs/sync/json_reader.hpp"
+#include "dfs/sync/json_writer.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <random>
+
+using namespace dfs::sync;
+using json = nlohmann::json;
+
+namespace {
+
+FileMetadata make_metadata(const std::string& path, std::uint64_t size) {
+    FileMetadata metadata;
+    metadata.file_path = path;
+    metadata.hash = "00112233aabbccdd";
+    metadata.size = size;
+    metadata.modified_time = 1700000000;
+    metadata.created_time = -5;
+    metadata.sync_state = dfs::metadata::SyncState::MODIFIED;
+    return metadata;
+}
+
+std::vector<std::uint32_t> index_of(std::string_view text) {
+    auto index = index_structurals(text);
+    EXPECT_TRUE(index.is_ok()) << index.error();
+    return index.is_ok() ? index.value() : std::vector<std::uint32_t>{};
+}
+
+} // namespace
+
+// ════════════════════════════════════════════════════════════
+// Structural index
+// ════════════════════════════════════════════════════════════
+
+TEST(JsonReaderTest, IndexSkipsStructuralsInsideStrings) {
+    std::string text = R"({"a{[":"x,\"]:","b":[1,2]})";
+    std::vector<std::uint32_t> expected;
+    // Quotes and structurals outside strings, computed the slow way
+    bool in_string = false;
+    for (std::size_t i = 0; i < text.size(); ++i) {
+        char c = text[i];
+        if (in_string && c == '\\') {
+            ++i;
+            continue;
+        }
+        if (c == '"') {
+            in_string = !in_string;
+            expected.push_back(static_cast<std::uint32_t>(i));
+        } else if (!in_string && std::string_view("{}[]:,").find(c) != std::string_view::npos) {
+            expected.push_back(static_cast<std::uint32_t>(i));
+        }
+    }
+    EXPECT_EQ(index_of(text), expected);
+}
+
+TEST(JsonReaderTest, IndexCarriesStringsAndEscapesAcrossBlocks) {
+    // A backslash run ending on each side of the 64-byte boundary
+    for (std::size_t pad = 55; pad < 70; ++pad) {
+        for (std::size_t slashes = 1; slashes <= 4; ++slashes) {
+            std::string text = "[\"" + std::string(pad, 'x') + std::string(slashes, '\\') + "\",1]";
+            if (slashes % 2 == 1) {
+                text.insert(text.size() - 3, "\"");   // Odd run: the quote is escaped, close after it
+            }
+            json expected = json::parse(text, nullptr, false);
+            ASSERT_FALSE(expected.is_discarded()) << text;
+            auto index = index_of(text);
+            ASSERT_EQ(index.size(), 5u) << text;
+            EXPECT_EQ(index[2], text.size() - 4) << text;   // Closing quote
+        }
+    }
+}
+
+TEST(JsonReaderTest, IndexRejectsUnterminatedStringsAndControlCharacters) {
+    EXPECT_TRUE(index_structurals(R"(["abc)").is_error());
+    EXPECT_TRUE(index_structurals(R"(["abc\"])").is_error());
+    EXPECT_TRUE(index_structurals("[\"a\nb\"]").is_error());
+    EXPECT_TRUE(index_structurals("[1,\n2]").is_ok());
+}
+
+// ════════════════════════════════════════════════════════════
+// Decoding
+// ════════════════════════════════════════════════════════════
+
+TEST(JsonReaderTest, ReadsWhatTheWriterWrites) {
+    std::vector<FileMetadata> files;
+    for (int i = 0; i < 500; ++i) {
+        files.push_back(make_metadata("/dir " + std::to_string(i) + "/\"q\"\\\t\xc3\xa9.txt", 1ull << (i % 63)));
+    }
+    std::string text;
+    write_metadata_array(files, text);
+
+    auto parsed = parse_metadata_array(text);
+    ASSERT_TRUE(parsed.is_ok()) << parsed.error();
+    ASSERT_EQ(parsed.value().size(), files.size());
+    for (std::size_t i = 0; i < files.size(); ++i) {
+        EXPECT_EQ(parsed.value()[i].file_path, files[i].file_path);
+        EXPECT_EQ(parsed.value()[i].hash, files[i].hash);
+        EXPECT_EQ(parsed.value()[i].size, files[i].size);
+        EXPECT_EQ(parsed.value()[i].modified_time, files[i].modified_time);
+        EXPECT_EQ(parsed.value()[i].created_time, files[i].created_time);
+        EXPECT_EQ(parsed.value()[i].sync_state, files[i].sync_state);
+    }
+}
+
+TEST(JsonReaderTest, DecodesEscapesLikeNlohmann) {
+    std::mt19937 rng(7);
+    for (int round = 0; round < 200; ++round) {
+        std::string path;
+        std::uniform_int_distribution<int> length(0, 80);
+        std::uniform_int_distribution<int> byte(1, 127);
+        for (int i = length(rng); i > 0; --i) {
+            path += static_cast<char>(byte(rng));
+        }
+        path += "\xf0\x9f\x98\x80";   // Outside the BMP
+        // nlohmann writes control characters as \u00XX; ensure_ascii adds surrogate pairs
+        std::string text = "[" + json{{"file_path", path}}.dump(-1, ' ', round % 2 == 0) + "]";
+        auto parsed = parse_metadata_array(text);
+        ASSERT_TRUE(parsed.is_ok()) << parsed.error() << " in " << text;
+        EXPECT_EQ(parsed.value()[0].file_path, path) << text;
+    }
+}
+
+TEST(JsonReaderTest, DiffRequestSkipsUnknownKeysInAnyOrder) {
+    std::string body = R"( {
+        "snapshot" : [ { "extra": {"nested": [1, {"x": null}], "s": "}"}, "size": 42,
+                         "file_path": "/a", "hash": "h", "flag": true, "ratio": -1.5e3, "zero": -0, "tiny": 0.25E-7 },
+                       {} ],
+        "client": "ignored",
+        "session_id": "s\u0031"
+    } )";
+    auto parsed = parse_diff_request(body);
+    ASSERT_TRUE(parsed.is_ok()) << parsed.error();
+    EXPECT_EQ(parsed.value().session_id, "s1");
+    ASSERT_EQ(parsed.value().snapshot.size(), 2u);
+    EXPECT_EQ(parsed.value().snapshot[0].file_path, "/a");
+    EXPECT_EQ(parsed.value().snapshot[0].hash, "h");
+    EXPECT_EQ(parsed.value().snapshot[0].size, 42u);
+    EXPECT_EQ(parsed.value().snapshot[1].file_path, "");   // Missing fields keep their defaults
+
+    auto empty = parse_diff_request("{}");
+    ASSERT_TRUE(empty.is_ok());
+    EXPECT_TRUE(empty.value().snapshot.empty());
+}
+
+TEST(JsonReaderTest, RejectsMalformedInput) {
+    const char* bad[] = {
+        "",
+        "[",
+        "{\"session_id\":\"s\"",
+        "{\"session_id\":\"s\"} x",
+        "{\"session_id\" x :\"s\"}",
+        "{\"session_id\":\"s\",}",
+        "{\"snapshot\":[{\"size\":-1}]}",
+        "{\"snapshot\":[{\"size\":1.5}]}",
+        "{\"snapshot\":[{\"size\":\"1\"}]}",
+        "{\"snapshot\":[{\"size\":1 2}]}",
+        "{\"snapshot\":[{\"x\":tru}]}",
+        "{\"snapshot\":[{\"x\":+1}]}",
+        "{\"snapshot\":[{\"x\":nan}]}",
+        "{\"snapshot\":[{\"x\":inf}]}",
+        "{\"snapshot\":[{\"x\":-infinity}]}",
+        "{\"snapshot\":[{\"x\":01}]}",
+        "{\"snapshot\":[{\"x\":.5}]}",
+        "{\"snapshot\":[{\"x\":5.}]}",
+        "{\"snapshot\":[{\"x\":1e}]}",
+        "{\"snapshot\":[{\"x\":-}]}",
+        "{\"snapshot\":[{\"size\":01}]}",
+        "{\"snapshot\":[{\"x\":\"\\q\"}]}",
+        "{\"snapshot\":[{\"x\":\"\\ud800\"}]}",
+        "{\"snapshot\":[1]}",
+        "[]",
+    };
+    for (const char* text : bad) {
+        auto parsed = parse_diff_request(text);
+        EXPECT_TRUE(parsed.is_error()) << text;
+    }
+
+    auto parsed = parse_diff_request("{\"snapshot\":[{\"size\":\"big\"}]}");
+    ASSERT_TRUE(parsed.is_error());
+    EXPECT_NE(parsed.error().find("offset 21"), std::string::npos) << parsed.error();
+
+    std::string deep(2000, '[');
+    EXPECT_TRUE(parse_diff_request("{\"x\":" + deep).is_error());
+}
@@ -0,0 +1,102 @@
+#include "dfs/sync/json_writer.hpp"
+
+#include <gtest/gtest.h>
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <limits>
+
+using namespace dfs::sync;
+using json = nlohmann::json;
+
+namespace {
+
+FileMetadata make_metadata(const std::string& path, std::uint64_t size) {
+    FileMetadata metadata;
+    metadata.file_path = path;
+    metadata.hash = "00112233aabbccdd";
+    metadata.size = size;
+    metadata.modified_time = 1700000000;
+    metadata.created_time = 1600000000;
+    metadata.sync_state = dfs::metadata::SyncState::MODIFIED;
+    return metadata;
+}
+
+} // namespace
+
+TEST(JsonWriterTest, PlacesCommasInNestedContainers) {
+    std::string out;
+    JsonWriter writer(out);
+    writer.begin_object()
+        .field("a", 1)
+        .key("list").begin_array().value(1).begin_object().end_object().begin_array().end_array().value("x").end_array()
+        .field("ok", true)
+        .key("empty").begin_object().end_object()
+        .end_object();
+    EXPECT_EQ(out, R"({"a":1,"list":[1,{},[],"x"],"ok":true,"empty":{}})");
+}
+
+TEST(JsonWriterTest, EscapesStringsAndKeepsUtf8) {
+    std::string text = "q\"b\\n\nt\tc\x01z \xc3\xa9";
+    std::string out;
+    JsonWriter(out).value(text);
+    EXPECT_EQ(out, "\"q\\\"b\\\\n\\nt\\tc\\u0001z \xc3\xa9\"");
+    EXPECT_EQ(json::parse(out).get<std::string>(), text);
+}
+
+TEST(JsonWriterTest, WritesIntegerExtremes) {
+    std::string out;
+    JsonWriter(out).begin_array()
+        .value(std::numeric_limits<std::uint64_t>::max())
+        .value(std::numeric_limits<std::int64_t>::min())
+        .value(0)
+        .end_array();
+    EXPECT_EQ(out, "[18446744073709551615,-9223372036854775808,0]");
+}
+
+TEST(JsonWriterTest, MetadataMatchesTheDomFields) {
+    auto metadata = make_metadata("/dir/\"odd\".txt", 1ull << 40);
+    auto parsed = json::parse(to_json(metadata));
+    EXPECT_EQ(parsed, (json{{"file_path", metadata.file_path},
+                            {"hash", metadata.hash},
+                            {"size", metadata.size},
+                            {"modified_time", metadata.modified_time},
+                            {"created_time", metadata.created_time},
+                            {"sync_state", static_cast<int>(metadata.sync_state)}}));
+}
+
+TEST(JsonWriterTest, SessionInfoAndDiffMatchTheDomFields) {
+    SyncSessionInfo info;
+    info.session_id = "s-1";
+    info.client_id = "c-1";
+    info.files_pending = 3;
+    info.bytes_pending = 4096;
+    info.state = SessionState::Failed;
+    info.last_error = "disk full";
+    EXPECT_EQ(json::parse(to_json(info)), (json{{"session_id", "s-1"},
+                                                {"client_id", "c-1"},
+                                                {"files_pending", 3},
+                                                {"bytes_pending", 4096},
+                                                {"state", static_cast<int>(SessionState::Failed)},
+                                                {"last_error", "disk full"}}));
+
+    DiffResponse diff;
+    diff.files_to_upload = {"/a", "/b"};
+    diff.files_to_download = {"/c"};
+    EXPECT_EQ(to_json(diff), R"({"files_to_upload":["/a","/b"],"files_to_download":["/c"],"files_to_delete_remote":[]})");
+}
+
+TEST(JsonWriterTest, MetadataArrayReplacesTheOutput) {
+    std::vector<FileMetadata> files{make_metadata("/a", 1), make_metadata("/b", 2)};
+    std::string out = "stale";
+    write_metadata_array(files, out);
+    auto parsed = json::parse(out);
+    ASSERT_TRUE(parsed.is_array());
+    ASSERT_EQ(parsed.size(), 2u);
+    EXPECT_EQ(parsed[1]["file_path"], "/b");
+    EXPECT_EQ(parsed[1]["size"], 2);
+    EXPECT_GE(out.capacity(), out.size());
+
+    write_metadata_array({}, out);
+    EXPECT_EQ(out, "[]");
+}
@@ -0,0 +1,130 @@
+#include "dfs/sync/rpc.hpp"
+#include "dfs/metadata/serializer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace dfs::sync;
+
+namespace {
+
+FileMetadata make_metadata(const std::string& path, uint64_t size) {
+    FileMetadata metadata;
+    metadata.file_path = path;
+    metadata.hash = "00112233aabbccdd";
+    metadata.size = size;
+    metadata.modified_time = 1700000000;
+    metadata.created_time = 1600000000;
+    metadata.sync_state = dfs::metadata::SyncState::SYNCED;
+    metadata.replicas.push_back({"node-a", 3, 1700000001});
+    return metadata;
+}
+
+} // namespace
+
+TEST(SyncRpcCodecTest, TextRoundTrips) {
+    auto payload = rpc::encode_text("client-7");
+    EXPECT_EQ(payload.size(), 4u + 8u);
+    auto decoded = rpc::decode_text(payload);
+    ASSERT_TRUE(decoded.is_ok());
+    EXPECT_EQ(decoded.value(), "client-7");
+
+    auto empty = rpc::decode_text(rpc::encode_text(""));
+    ASSERT_TRUE(empty.is_ok());
+    EXPECT_EQ(empty.value(), "");
+}
+
+TEST(SyncRpcCodecTest, DiffArgsEmbedSerializerRecords) {
+    std::vector<FileMetadata> snapshot{make_metadata("/a.txt", 10), make_metadata("/dir/b.bin", 1u << 20)};
+    auto payload = rpc::encode_diff_args("session-1", snapshot);
+
+    auto decoded = rpc::decode_diff_args(payload);
+    ASSERT_TRUE(decoded.is_ok()) << decoded.error();
+    EXPECT_EQ(decoded.value().session_id, "session-1");
+    ASSERT_EQ(decoded.value().snapshot.size(), 2u);
+    EXPECT_EQ(decoded.value().snapshot[1].file_path, "/dir/b.bin");
+    EXPECT_EQ(decoded.value().snapshot[1].size, 1u << 20);
+    EXPECT_EQ(decoded.value().snapshot[1].modified_time, 1700000000);
+    ASSERT_EQ(decoded.value().snapshot[1].replicas.size(), 1u);
+    EXPECT_EQ(decoded.value().snapshot[1].replicas[0].replica_id, "node-a");
+
+    // The records are exactly what Serializer::serialize() writes
+    auto record = dfs::metadata::Serializer::serialize(snapshot[0]);
+    size_t offset = 4 + 9 + 4;   // session id, then the count
+    EXPECT_TRUE(std::equal(record.begin(), record.end(), payload.begin() + static_cast<long>(offset)));
+}
+
+TEST(SyncRpcCodecTest, DiffResponseRoundTrips) {
+    DiffResponse diff;
+    diff.files_to_upload = {"/a", "/b"};
+    diff.files_to_download = {"/c"};
+    auto decoded = rpc::decode_diff_response(rpc::encode_diff_response(diff));
+    ASSERT_TRUE(decoded.is_ok()) << decoded.error();
+    EXPECT_EQ(decoded.value().files_to_upload, diff.files_to_upload);
+    EXPECT_EQ(decoded.value().files_to_download, diff.files_to_download);
+    EXPECT_TRUE(decoded.value().files_to_delete_remote.empty());
+}
+
+TEST(SyncRpcCodecTest, ChunkCarriesRawBytes) {
+    ChunkEnvelope chunk;
+    chunk.session_id = "s";
+    chunk.file_path = "/f.bin";
+    chunk.chunk_index = 3;
+    chunk.total_chunks = 9;
+    chunk.chunk_size = 4096;
+    chunk.chunk_hash = "abcdef";
+    chunk.data.resize(4096);
+    for (size_t i = 0; i < chunk.data.size(); ++i) {
+        chunk.data[i] = static_cast<uint8_t>(i * 7);
+    }
+
+    auto payload = rpc::encode_chunk(chunk);
+    // 4096 data bytes plus a few dozen of fields; hex in JSON would double it
+    EXPECT_LT(payload.size(), chunk.data.size() + 64);
+
+    auto decoded = rpc::decode_chunk(payload);
+    ASSERT_TRUE(decoded.is_ok()) << decoded.error();
+    EXPECT_EQ(decoded.value().file_path, "/f.bin");
+    EXPECT_EQ(decoded.value().chunk_index, 3u);
+    EXPECT_EQ(decoded.value().total_chunks, 9u);
+    EXPECT_EQ(decoded.value().chunk_size, 4096u);
+    EXPECT_EQ(decoded.value().chunk_hash, "abcdef");
+    EXPECT_EQ(decoded.value().data, chunk.data);
+}
+
+TEST(SyncRpcCodecTest, CompletionMetadataAndFileDataRoundTrip) {
+    auto args = rpc::decode_complete_args(rpc::encode_complete_args({"s", "/f", "hash"}));
+    ASSERT_TRUE(args.is_ok());
+    EXPECT_EQ(args.value().session_id, "s");
+    EXPECT_EQ(args.value().file_path, "/f");
+    EXPECT_EQ(args.value().expected_hash, "hash");
+
+    auto metadata = rpc::decode_metadata(rpc::encode_metadata(make_metadata("/m", 5)));
+    ASSERT_TRUE(metadata.is_ok());
+    EXPECT_EQ(metadata.value().file_path, "/m");
+
+    std::vector<uint8_t> data{0, 1, 2, 255};
+    auto file = rpc::decode_file_data(rpc::encode_file_data("h", data));
+    ASSERT_TRUE(file.is_ok());
+    EXPECT_EQ(file.value().hash, "h");
+    EXPECT_EQ(file.value().data, data);
+}
+
+TEST(SyncRpcCodecTest, RejectsTruncatedAndPaddedPayloads) {
+    auto payload = rpc::encode_diff_args("session", {make_metadata("/a", 1)});
+    for (size_t size = 0; size < payload.size(); ++size) {
+        std::vector<uint8_t> truncated(payload.begin(), payload.begin() + static_cast<long>(size));
+        EXPECT_TRUE(rpc::decode_diff_args(truncated).is_error()) << size;
+    }
+
+    auto padded = rpc::encode_text("x");
+    padded.push_back(0);
+    auto decoded = rpc::decode_text(padded);
+    ASSERT_TRUE(decoded.is_error());
+    EXPECT_NE(decoded.error().find("Trailing bytes"), std::string::npos);
+
+    // A count far beyond the payload fails without allocating for it
+    std::vector<uint8_t> huge{0xff, 0xff, 0xff, 0xff};
+    EXPECT_TRUE(rpc::decode_diff_response(huge).is_error());
+}
@@ -0,0 +1,148 @@
+#include "dfs/sync/snapshot_cache.hpp"
+#include "dfs/sync/merkle_tree.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <thread>
+#include <vector>
+
+using dfs::metadata::FileMetadata;
+using dfs::metadata::MetadataStore;
+using dfs::sync::MerkleTree;
+using dfs::sync::SnapshotCache;
+
+namespace {
+
+FileMetadata make_metadata(const std::string& path, const std::string& hash, std::size_t size = 0) {
+    FileMetadata metadata;
+    metadata.file_path = path;
+    metadata.hash = hash;
+    metadata.size = size;
+    return metadata;
+}
+
+// "/a,/b" - sorted so the output does not depend on map order
+void join_paths(const std::vector<FileMetadata>& files, std::string& out) {
+    std::vector<std::string> paths;
+    for (const auto& metadata : files) {
+        paths.push_back(metadata.file_path);
+    }
+    std::sort(paths.begin(), paths.end());
+    out.clear();
+    for (const auto& path : paths) {
+        out += (out.empty() ? "" : ",") + path;
+    }
+}
+
+} // namespace
+
+TEST(SnapshotCacheTest, SerializesOncePerStoreState) {
+    MetadataStore store;
+    store.add(make_metadata("/a.txt", "hashA", 1));
+    int serialized = 0;
+    SnapshotCache cache(store, [&serialized](const std::vector<FileMetadata>& files, std::string& out) {
+        ++serialized;
+        join_paths(files, out);
+    });
+
+    auto first = cache.current();
+    auto second = cache.current();
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(first->body, "/a.txt");
+    EXPECT_EQ(serialized, 1);
+    EXPECT_EQ(cache.hits(), 1u);
+
+    store.add(make_metadata("/b.txt", "hashB", 2));
+    auto third = cache.current();
+    EXPECT_EQ(third->body, "/a.txt,/b.txt");
+    EXPECT_EQ(third->version, store.version());
+    EXPECT_NE(third->etag, first->etag);
+    EXPECT_EQ(serialized, 2);
+
+    // The old snapshot stays valid for whoever still holds it
+    EXPECT_EQ(first->body, "/a.txt");
+}
+
+TEST(SnapshotCacheTest, EtagStartsWithMerkleRootAndSurvivesRestart) {
+    std::vector<FileMetadata> files{make_metadata("/a.txt", "hashA", 1), make_metadata("/b.txt", "hashB", 2)};
+    MerkleTree tree;
+    tree.build(files);
+
+    // Same contents reached through a different write history
+    MetadataStore store_a;
+    store_a.add(files[0]);
+    store_a.add(files[1]);
+    MetadataStore store_b;
+    store_b.add(make_metadata("/b.txt", "old", 9));
+    store_b.add(files[0]);
+    store_b.update(files[1]);
+    ASSERT_NE(store_a.version(), store_b.version());
+
+    SnapshotCache cache_a(store_a, join_paths);
+    SnapshotCache cache_b(store_b, join_paths);
+    EXPECT_EQ(cache_a.current()->root_hash, tree.root_hash());
+    EXPECT_EQ(cache_a.current()->etag.rfind("\"" + tree.root_hash() + "-", 0), 0u);
+    EXPECT_EQ(cache_a.current()->etag, cache_b.current()->etag);
+}
+
+TEST(SnapshotCacheTest, MetadataOnlyChangeAltersEtag) {
+    // Same path, hash and size, so the Merkle root stays put; the body
+    // still changes, so a client holding the old ETag must not get a 304
+    MetadataStore store;
+    auto metadata = make_metadata("/a.txt", "hashA", 1);
+    metadata.modified_time = 1700000000;
+    store.add(metadata);
+    SnapshotCache cache(store, join_paths);
+    auto before = cache.current();
+
+    metadata.modified_time += 60;
+    ASSERT_TRUE(store.update(metadata).is_ok());
+    auto touched = cache.current();
+    EXPECT_EQ(touched->root_hash, before->root_hash);
+    EXPECT_NE(touched->etag, before->etag);
+
+    metadata.sync_state = dfs::metadata::SyncState::MODIFIED;
+    ASSERT_TRUE(store.update(metadata).is_ok());
+    auto modified = cache.current();
+    EXPECT_NE(modified->etag, touched->etag);
+
+    metadata.created_time = 1600000000;
+    ASSERT_TRUE(store.update(metadata).is_ok());
+    EXPECT_NE(cache.current()->etag, modified->etag);
+
+    // Back to the first state: back to the first ETag
+    auto reverted = make_metadata("/a.txt", "hashA", 1);
+    reverted.modified_time = 1700000000;
+    ASSERT_TRUE(store.update(reverted).is_ok());
+    EXPECT_EQ(cache.current()->etag, before->etag);
+}
+
+TEST(SnapshotCacheTest, EmptyStoreHasAnEtag) {
+    MetadataStore store;
+    SnapshotCache cache(store, join_paths);
+    EXPECT_EQ(cache.current()->etag, "\"empty\"");
+    EXPECT_EQ(cache.current()->file_count, 0u);
+}
+
+TEST(SnapshotCacheTest, ConcurrentReadersShareOneRebuild) {
+    MetadataStore store;
+    for (int i = 0; i < 1000; ++i) {
+        store.add(make_metadata("/f" + std::to_string(i), "h", 1));
+    }
+    SnapshotCache cache(store, join_paths);
+
+    std::vector<std::thread> readers;
+    for (int t = 0; t < 8; ++t) {
+        readers.emplace_back([&cache] {
+            for (int i = 0; i < 100; ++i) {
+                EXPECT_EQ(cache.current()->file_count, 1000u);
+            }
+        });
+    }
+    for (auto& reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(cache.builds(), 1u);
+    EXPECT_EQ(cache.hits(), 799u);
+}
@@ -31,10 +31,6 @@ std::string write_file(const fs::path& path, const std::string& content) {
     return content;
 }
 
-std::vector<dfs::metadata::FileMetadata> snapshot_from_store(MetadataStore& store) {
-    return store.list_all();
-}
-
 } // namespace
 
 TEST(SyncServiceTest, UploadLifecycleCompletesSession) {
@@ -62,7 +58,12 @@ TEST(SyncServiceTest, UploadLifecycleCompletesSession) {
     dfs::metadata::FileMetadata local_meta;
     local_meta.file_path = "docs/note.txt";
     local_meta.hash = [] (const std::string& text) {
-        const std::size_t raw = std::hash<std::string>{}(text);
+        // FNV-1a 64, matching SyncService's file hash
+        std::uint64_t raw = 0xcbf29ce484222325ULL;
+        for (unsigned char byte : text) {
+            raw ^= byte;
+            raw *= 0x100000001b3ULL;
+        }
         std::ostringstream hex;
         hex << std::hex << std::setw(sizeof(raw) * 2) << std::setfill('0') << raw;
         return hex.str();
@@ -91,9 +92,35 @@ TEST(SyncServiceTest, UploadLifecycleCompletesSession) {
     auto info = service.session_info(session_id);
     ASSERT_TRUE(info.is_ok());
     EXPECT_EQ(info.value().state, dfs::sync::SessionState::Complete);
+    EXPECT_EQ(service.active_sessions(), 0u);
 
     auto stored = store.get("docs/note.txt");
     ASSERT_TRUE(stored.is_ok());
     EXPECT_EQ(stored.value().hash, local_meta.hash);
     EXPECT_EQ(stored.value().size, content.size());
 }
+
+TEST(SyncServiceTest, ActiveSessionsFollowsTransitions) {
+    EventBus bus;
+    MetadataStore store;
+    auto data_root = create_temp_dir("dfs_sync_active_data");
+    auto staging_root = create_temp_dir("dfs_sync_active_stage");
+    SyncService service(data_root, staging_root, bus, store);
+
+    const auto client = service.register_client();
+    auto first = service.start_session(client);
+    auto second = service.start_session(client);
+    ASSERT_TRUE(first.is_ok());
+    ASSERT_TRUE(second.is_ok());
+    EXPECT_EQ(service.active_sessions(), 2u);
+
+    // Nothing was staged for this path, so finalizing fails the session
+    auto failed = service.finalize_upload(first.value().session_id, "missing.txt", "0000000000000000");
+    ASSERT_TRUE(failed.is_error());
+    EXPECT_EQ(service.session_info(first.value().session_id).value().state, dfs::sync::SessionState::Failed);
+    EXPECT_EQ(service.active_sessions(), 1u);
+
+    // A session that already ended is not counted twice
+    EXPECT_TRUE(service.finalize_upload(first.value().session_id, "missing.txt", "0000000000000000").is_error());
+    EXPECT_EQ(service.active_sessions(), 1u);
+}
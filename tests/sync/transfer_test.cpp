@@ -2,6 +2,7 @@
 
 #include <gtest/gtest.h>
 
+#include <algorithm>
 #include <atomic>
 #include <filesystem>
 #include <fstream>
@@ -35,7 +36,12 @@ std::string read_file(const fs::path& path) {
 }
 
 std::string hash_string(const std::string& data) {
-    const std::size_t raw_hash = std::hash<std::string>{}(data);
+    // FNV-1a 64, matching FileTransferService's integrity hash
+    std::uint64_t raw_hash = 0xcbf29ce484222325ULL;
+    for (unsigned char byte : data) {
+        raw_hash ^= byte;
+        raw_hash *= 0x100000001b3ULL;
+    }
     std::ostringstream hex;
     hex << std::hex << std::setw(sizeof(raw_hash) * 2) << std::setfill('0') << raw_hash;
     return hex.str();
@@ -93,3 +99,17 @@ TEST(FileTransferServiceTest, DetectsCorruptedChunk) {
     auto result = service.apply_chunk(chunk, staging_dir);
     EXPECT_TRUE(result.is_error());
 }
+
+TEST(FileTransferServiceTest, ContentHasherMatchesContentHashAcrossPieces) {
+    std::vector<uint8_t> data(10000);
+    for (std::size_t i = 0; i < data.size(); ++i) {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    FileTransferService::ContentHasher hasher;
+    for (std::size_t offset = 0; offset < data.size(); offset += 4096) {
+        hasher.update(data.data() + offset, std::min<std::size_t>(4096, data.size() - offset));
+    }
+    EXPECT_EQ(hasher.hex(), FileTransferService::content_hash(data));
+    EXPECT_EQ(FileTransferService::ContentHasher().hex(), FileTransferService::content_hash({}));
+}